@@ -46,9 +46,9 @@
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/raw_os_ostream.h"
 
+#include <algorithm>
 #include <atomic>
 #include <limits>
-#include <list>
 #include <mutex>
 #include <system_error>
 
@@ -232,7 +232,9 @@ class StackRuntime {
 
     llvm::Optional<::hermes::vm::StackRuntime> rt;
 
-    stack->provider_ = vm::StorageProvider::mmapProvider();
+    stack->provider_ = config.getUseHugePages()
+        ? vm::StorageProvider::hugePageProvider(config.getPreferLocalNUMANode())
+        : vm::StorageProvider::mmapProvider();
     stack->runtime_ = &rt;
     stack->startup_.set_value();
     stack->shutdown_.get_future().wait();
@@ -264,8 +266,6 @@ class HermesRuntimeImpl final : public HermesRuntime,
                                 private InstallHermesFatalErrorHandler,
                                 private jsi::Instrumentation {
  public:
-  static constexpr int64_t kSentinelNativeValue = 0x6ef71fe1;
-
   HermesRuntimeImpl(const vm::RuntimeConfig &runtimeConfig)
       :
 #ifdef HERMESJSI_ON_STACK
@@ -284,26 +284,20 @@ class HermesRuntimeImpl final : public HermesRuntime,
     // Register the memory for the runtime if it isn't stored on the stack.
     crashMgr_->registerMemory(&runtime_, sizeof(vm::Runtime));
 #endif
-    runtime_.addCustomRootsFunction([this](
-                                        vm::GC *, vm::SlotAcceptor &acceptor) {
-      for (auto it = hermesValues_->begin(); it != hermesValues_->end();) {
-        if (it->get() == 0) {
-          it = hermesValues_->erase(it);
-        } else {
-          acceptor.accept(const_cast<vm::PinnedHermesValue &>(it->phv));
-          ++it;
-        }
-      }
-      for (auto it = weakHermesValues_->begin();
-           it != weakHermesValues_->end();) {
-        if (it->get() == 0) {
-          it = weakHermesValues_->erase(it);
-        } else {
-          acceptor.accept(const_cast<vm::WeakRef<vm::HermesValue> &>(it->wr));
-          ++it;
-        }
-      }
-    });
+    runtime_.addCustomGenerationalRootsFunction(
+        [this](vm::GC *, vm::SlotAcceptor &acceptor, bool markLongLived) {
+          auto acceptValue = [&acceptor](HermesPointerValue &value) {
+            acceptor.accept(const_cast<vm::PinnedHermesValue &>(value.phv));
+          };
+          if (markLongLived)
+            hermesValues_.markAll(acceptValue);
+          else
+            hermesValues_.markYoung(acceptValue);
+          weakHermesValues_.markAll([&acceptor](WeakRefPointerValue &value) {
+            acceptor.accept(
+                const_cast<vm::WeakRef<vm::HermesValue> &>(value.wr));
+          });
+        });
   }
 
  public:
@@ -400,13 +394,11 @@ class HermesRuntimeImpl final : public HermesRuntime,
   T add(::hermes::vm::HermesValue hv) {
     static_assert(
         std::is_base_of<jsi::Pointer, T>::value, "this type cannot be added");
-    hermesValues_->emplace_front(hv);
-    return make<T>(&(hermesValues_->front()));
+    return make<T>(hermesValues_.add(hv));
   }
 
   jsi::WeakObject addWeak(::hermes::vm::WeakRef<vm::HermesValue> wr) {
-    weakHermesValues_->emplace_front(wr);
-    return make<jsi::WeakObject>(&(weakHermesValues_->front()));
+    return make<jsi::WeakObject>(weakHermesValues_.add(wr));
   }
 
   // overriden from jsi::Instrumentation
@@ -738,6 +730,55 @@ class HermesRuntimeImpl final : public HermesRuntime,
   size_t getLength(vm::Handle<vm::ArrayImpl> arr);
   size_t getByteLength(vm::Handle<vm::JSArrayBuffer> arr);
 
+  // Implementations of the batched accessors of HermesRuntime.
+  void getProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      jsi::Value *values,
+      size_t count);
+  void setProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      const jsi::Value *values,
+      size_t count);
+  template <typename T>
+  void getArrayElements(
+      const jsi::Array &arr,
+      size_t start,
+      T *values,
+      size_t count);
+  template <typename T>
+  void setArrayElements(
+      const jsi::Array &arr,
+      size_t start,
+      const T *values,
+      size_t count);
+  void checkArrayRange(
+      const char *what,
+      vm::Handle<vm::JSArray> arr,
+      size_t start,
+      size_t count);
+  jsi::ArrayBuffer createExternalArrayBuffer(
+      uint8_t *data,
+      size_t size,
+      std::function<void()> release);
+  void fromArrayElement(size_t index, vm::HermesValue hv, jsi::Value &out) {
+    out = valueFromHermesValue(hv);
+  }
+  void fromArrayElement(size_t index, vm::HermesValue hv, double &out) {
+    if (LLVM_UNLIKELY(!hv.isNumber())) {
+      throw makeJSError(
+          *this, "getArrayElements: element ", index, " is not a number");
+    }
+    out = hv.getNumber();
+  }
+  static vm::HermesValue toArrayElement(const jsi::Value &value) {
+    return hvFromValue(value);
+  }
+  static vm::HermesValue toArrayElement(double value) {
+    return vm::HermesValue::encodeNumberValue(value);
+  }
+
   struct JsiProxyBase : public vm::HostObjectProxy {
     JsiProxyBase(HermesRuntimeImpl &rt, std::shared_ptr<jsi::HostObject> ho)
         : rt_(rt), ho_(ho) {}
@@ -907,43 +948,180 @@ class HermesRuntimeImpl final : public HermesRuntime,
     }
   };
 
+  /// A table of the ref-counted values of type \p T which are GC roots. The
+  /// values are stored in fixed-size chunks, threading the unused slots in a
+  /// free list, so adding a value normally doesn't allocate. A slot whose value
+  /// dropped to a ref count of zero is reclaimed when the table is swept: by
+  /// markAll(), by add() when the free list is empty, and by popScope() for
+  /// the values added in the scope.
+  ///
+  /// A young-gen collection promotes every object which survives it, so a
+  /// value added before the last young-gen collection can only refer to the
+  /// old generation (values are never modified except by the GC). The table
+  /// remembers the slots filled since then, and markYoung() only visits those.
   template <typename T>
-  struct ManagedValues {
-#ifdef ASSERT_ON_DANGLING_VM_REFS
-    // If we have active HermesValuePointers whhen deconstructing, these will
-    // now be dangling. We deliberately allocate and immediately leak heap
-    // memory to hold the internal list. This keeps alive memory holding the
-    // ref-count of the now dangling references, allowing them to detect the
-    // dangling case safely and assert when they are eventually released. By
-    // deferring the assert it's a bit easier to see what's holding the pointers
-    // for too long.
+  class ManagedValues {
+   public:
+    ManagedValues() = default;
+    ManagedValues(const ManagedValues &) = delete;
+    ManagedValues &operator=(const ManagedValues &) = delete;
+
     ~ManagedValues() {
+#ifdef ASSERT_ON_DANGLING_VM_REFS
+      // If we have active HermesValuePointers when deconstructing, these will
+      // now be dangling. We deliberately leak the chunks holding them. This
+      // keeps alive memory holding the ref-count of the now dangling
+      // references, allowing them to detect the dangling case safely and
+      // assert when they are eventually released. By deferring the assert it's
+      // a bit easier to see what's holding the pointers for too long.
       bool anyDangling = false;
-      for (auto it = values.begin(); it != values.end();) {
-        if (it->get() == 0) {
-          it = values.erase(it);
-        } else {
+      forEachOccupied([&anyDangling](Slot &slot) {
+        if (slot.value.get() != 0) {
           anyDangling = true;
-          it->markDangling();
-          ++it;
+          slot.value.markDangling();
         }
-      }
+      });
       if (anyDangling) {
         // This is the deliberate memory leak described above.
-        new std::list<T>(std::move(values));
+        for (auto &chunk : chunks_)
+          (void)chunk.release();
+        return;
       }
-    }
 #endif
+      forEachOccupied([](Slot &slot) { slot.value.~T(); });
+    }
+
+    /// Construct a value from \p args in a free slot.
+    /// \return the new value.
+    template <typename... Args>
+    T *add(Args &&... args) {
+      if (LLVM_UNLIKELY(!freeList_))
+        reserve();
+      Slot *slot = freeList_;
+      freeList_ = slot->nextFree;
+      new (&slot->value) T(std::forward<Args>(args)...);
+      slot->occupied = true;
+      ++numOccupied_;
+      if (!slot->young) {
+        slot->young = true;
+        young_.push_back(slot);
+      }
+      return &slot->value;
+    }
+
+    /// Call \p accept on every value with a non-zero ref count, and reclaim
+    /// the slots of the others.
+    template <typename F>
+    void markAll(const F &accept) {
+      forEachOccupied([this, &accept](Slot &slot) {
+        if (slot.value.get() == 0)
+          release(slot);
+        else
+          accept(slot.value);
+      });
+    }
+
+    /// Like markAll(), but only for the values added since the previous call.
+    template <typename F>
+    void markYoung(const F &accept) {
+      for (Slot *slot : young_) {
+        slot->young = false;
+        if (!slot->occupied)
+          continue;
+        if (slot->value.get() == 0)
+          release(*slot);
+        else
+          accept(slot->value);
+      }
+      young_.clear();
+      std::fill(scopes_.begin(), scopes_.end(), 0);
+    }
+
+    /// Start a scope, which must be ended by a matching popScope().
+    void pushScope() {
+      scopes_.push_back(young_.size());
+    }
+
+    /// End the innermost scope, reclaiming the slots added in it whose values
+    /// are no longer referenced.
+    void popScope() {
+      assert(!scopes_.empty() && "popScope() without pushScope()");
+      for (size_t i = scopes_.back(), e = young_.size(); i != e; ++i) {
+        Slot *slot = young_[i];
+        if (slot->occupied && slot->value.get() == 0)
+          release(*slot);
+      }
+      scopes_.pop_back();
+    }
+
+    /// \return the number of values which haven't been reclaimed.
+    size_t size() const {
+      return numOccupied_;
+    }
+
+   private:
+    /// The number of slots in a chunk.
+    static constexpr size_t kChunkSize = 256;
+
+    struct Slot {
+      union {
+        T value;
+        Slot *nextFree;
+      };
+      /// Whether value is constructed.
+      bool occupied{false};
+      /// Whether the slot is in young_.
+      bool young{false};
+
+      Slot() : nextFree(nullptr) {}
+      ~Slot() {}
+    };
+
+    struct Chunk {
+      Slot slots[kChunkSize];
+    };
+
+    template <typename F>
+    void forEachOccupied(const F &f) {
+      for (auto &chunk : chunks_) {
+        for (Slot &slot : chunk->slots) {
+          if (slot.occupied)
+            f(slot);
+        }
+      }
+    }
 
-    std::list<T> *operator->() {
-      return &values;
+    void release(Slot &slot) {
+      slot.value.~T();
+      slot.occupied = false;
+      slot.nextFree = freeList_;
+      freeList_ = &slot;
+      --numOccupied_;
     }
 
-    const std::list<T> *operator->() const {
-      return &values;
+    /// Refill the empty free list, sweeping the table first. New chunks are
+    /// added until at most half of the slots are occupied, which bounds the
+    /// cost of the sweeps to a constant per added value.
+    void reserve() {
+      markAll([](T &) {});
+      while (numOccupied_ * 2 >= chunks_.size() * kChunkSize) {
+        chunks_.emplace_back(new Chunk());
+        Slot *slots = chunks_.back()->slots;
+        for (size_t i = kChunkSize; i-- != 0;) {
+          slots[i].nextFree = freeList_;
+          freeList_ = &slots[i];
+        }
+      }
     }
 
-    std::list<T> values;
+    std::vector<std::unique_ptr<Chunk>> chunks_{};
+    Slot *freeList_{nullptr};
+    size_t numOccupied_{0};
+    /// The slots filled since the last call to markYoung(). A slot may have
+    /// been freed since.
+    std::vector<Slot *> young_{};
+    /// For each open scope, the size of young_ when it started.
+    std::vector<size_t> scopes_{};
   };
 
  protected:
@@ -1076,6 +1254,116 @@ uint64_t HermesRuntime::getUniqueID(const jsi::Object &o) const {
       ->getDebugAllocationId();
 }
 
+void HermesRuntime::getProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    jsi::Value *values,
+    size_t count) {
+  impl(this)->getProperties(obj, names, values, count);
+}
+
+void HermesRuntime::setProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    const jsi::Value *values,
+    size_t count) {
+  impl(this)->setProperties(obj, names, values, count);
+}
+
+void HermesRuntime::getArrayElements(
+    const jsi::Array &arr,
+    size_t start,
+    jsi::Value *values,
+    size_t count) {
+  impl(this)->getArrayElements(arr, start, values, count);
+}
+
+void HermesRuntime::getArrayElements(
+    const jsi::Array &arr,
+    size_t start,
+    double *values,
+    size_t count) {
+  impl(this)->getArrayElements(arr, start, values, count);
+}
+
+void HermesRuntime::setArrayElements(
+    const jsi::Array &arr,
+    size_t start,
+    const jsi::Value *values,
+    size_t count) {
+  impl(this)->setArrayElements(arr, start, values, count);
+}
+
+void HermesRuntime::setArrayElements(
+    const jsi::Array &arr,
+    size_t start,
+    const double *values,
+    size_t count) {
+  impl(this)->setArrayElements(arr, start, values, count);
+}
+
+jsi::ArrayBuffer HermesRuntime::createExternalArrayBuffer(
+    uint8_t *data,
+    size_t size,
+    std::function<void()> release) {
+  return impl(this)->createExternalArrayBuffer(data, size, std::move(release));
+}
+
+size_t HermesRuntime::collectGarbageWhileIdle(
+    std::chrono::steady_clock::time_point deadline) {
+  return impl(this)->runtime_.collectWhileIdle(deadline);
+}
+
+size_t HermesRuntime::handleMemoryPressure(
+    ::hermes::vm::MemoryPressureLevel level) {
+  return impl(this)->runtime_.handleMemoryPressure(level);
+}
+
+void HermesRuntime::startAllocationSampling(size_t samplingInterval) {
+  const size_t maxInterval = std::numeric_limits<uint32_t>::max();
+  impl(this)->runtime_.startAllocationSampling(
+      static_cast<uint32_t>(std::min(samplingInterval, maxInterval)));
+}
+
+void HermesRuntime::stopAllocationSampling() {
+  impl(this)->runtime_.stopAllocationSampling();
+}
+
+void HermesRuntime::dumpAllocationProfile(llvm::raw_ostream &os) {
+  auto *profiler = impl(this)->runtime_.getAllocationProfiler();
+  if (!profiler) {
+    throw jsi::JSINativeException("Allocation sampling is not started");
+  }
+  profiler->serialize(os);
+}
+
+void HermesRuntime::dumpAllocationProfileToFile(const std::string &fileName) {
+  std::error_code ec;
+  llvm::raw_fd_ostream os(fileName.c_str(), ec, llvm::sys::fs::F_Text);
+  if (ec) {
+    throw std::system_error(ec);
+  }
+  dumpAllocationProfile(os);
+}
+
+bool HermesRuntime::createBinaryHeapSnapshotToFD(int fd) {
+  ::hermes::vm::GC &gc = impl(this)->runtime_.getHeap();
+  gc.collect();
+  return gc.createBinarySnapshotToFD(fd);
+}
+
+bool HermesRuntime::createBinaryHeapSnapshotToFile(
+    const std::string &fileName) {
+  ::hermes::vm::GC &gc = impl(this)->runtime_.getHeap();
+  gc.collect();
+  return gc.createBinarySnapshotToFile(fileName);
+}
+
+void HermesRuntime::detachArrayBuffer(const jsi::ArrayBuffer &buffer) {
+  impl(this)->arrayBufferHandle(buffer)->detach(
+      &impl(this)->runtime_.getHeap());
+}
+
 #ifdef HERMESVM_API_TRACE
 /// Get a structure representing the enviroment-dependent behavior, so
 /// it can be written into the trace for later replay.
@@ -1138,7 +1426,7 @@ void HermesRuntime::unregisterForProfiling() {
 }
 
 size_t HermesRuntime::rootsListLength() const {
-  return impl(this)->hermesValues_->size();
+  return impl(this)->hermesValues_.size();
 }
 
 namespace {
@@ -1649,6 +1937,141 @@ void HermesRuntimeImpl::setValueAtIndexImpl(
   });
 }
 
+void HermesRuntimeImpl::getProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    jsi::Value *values,
+    size_t count) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    auto h = handle(obj);
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      auto res =
+          h->getNamedOrIndexed(h, &runtime_, phv(names[i]).getSymbol());
+      checkStatus(res.getStatus());
+      values[i] = valueFromHermesValue(*res);
+    }
+  });
+}
+
+void HermesRuntimeImpl::setProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    const jsi::Value *values,
+    size_t count) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    auto h = handle(obj);
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      checkStatus(h->putNamedOrIndexed(
+                       h,
+                       &runtime_,
+                       phv(names[i]).getSymbol(),
+                       vmHandleFromValue(values[i]),
+                       vm::PropOpFlags().plusThrowOnError())
+                      .getStatus());
+    }
+  });
+}
+
+void HermesRuntimeImpl::checkArrayRange(
+    const char *what,
+    vm::Handle<vm::JSArray> arr,
+    size_t start,
+    size_t count) {
+  size_t length = getLength(arr);
+  if (LLVM_UNLIKELY(start > length || count > length - start)) {
+    throw makeJSError(
+        *this,
+        what,
+        ": range [",
+        start,
+        ", ",
+        start + count,
+        ") is out of bounds [0, ",
+        length,
+        ")");
+  }
+}
+
+template <typename T>
+void HermesRuntimeImpl::getArrayElements(
+    const jsi::Array &arr,
+    size_t start,
+    T *values,
+    size_t count) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    auto h = arrayHandle(arr);
+    checkArrayRange("getArrayElements", h, start, count);
+    vm::MutableHandle<> index{&runtime_};
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      index = vm::HermesValue::encodeNumberValue(start + i);
+      auto res = vm::JSObject::getComputed_RJS(h, &runtime_, index);
+      checkStatus(res.getStatus());
+      fromArrayElement(start + i, *res, values[i]);
+    }
+  });
+}
+
+template <typename T>
+void HermesRuntimeImpl::setArrayElements(
+    const jsi::Array &arr,
+    size_t start,
+    const T *values,
+    size_t count) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    auto h = arrayHandle(arr);
+    checkArrayRange("setArrayElements", h, start, count);
+    vm::MutableHandle<> value{&runtime_};
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      value = toArrayElement(values[i]);
+      vm::JSArray::setElementAt(h, &runtime_, start + i, value);
+    }
+  });
+}
+
+jsi::ArrayBuffer HermesRuntimeImpl::createExternalArrayBuffer(
+    uint8_t *data,
+    size_t size,
+    std::function<void()> release) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    runtime_.initLazyBuiltins(vm::LazyBuiltins::TypedArray);
+    auto res = vm::JSArrayBuffer::create(
+        &runtime_,
+        vm::Handle<vm::JSObject>::vmcast(&runtime_.arrayBufferPrototype));
+    if (LLVM_UNLIKELY(res == vm::ExecutionStatus::EXCEPTION)) {
+      // No buffer took ownership of the memory, so release it now, as if a
+      // buffer had been created and collected.
+      release();
+      checkStatus(res.getStatus());
+    }
+    auto buffer = runtime_.makeHandle<vm::JSArrayBuffer>(*res);
+    // Nothing below can fail, so the buffer now owns the callback.
+    buffer->setExternalDataBlock(
+        &runtime_,
+        reinterpret_cast<char *>(data),
+        size,
+        new std::function<void()>(std::move(release)),
+        [](void *context) {
+          std::unique_ptr<std::function<void()>> release{
+              static_cast<std::function<void()> *>(context)};
+          (*release)();
+        });
+    return add<jsi::Object>(buffer.getHermesValue()).getArrayBuffer(*this);
+  });
+}
+
 jsi::Function HermesRuntimeImpl::createFunctionFromHostFunction(
     const jsi::PropNameID &name,
     unsigned int paramCount,
@@ -1839,39 +2262,14 @@ bool HermesRuntimeImpl::instanceOf(
 }
 
 jsi::Runtime::ScopeState *HermesRuntimeImpl::pushScope() {
-  hermesValues_->emplace_front(
-      vm::HermesValue::encodeNativeValue(kSentinelNativeValue));
-  return reinterpret_cast<ScopeState *>(&hermesValues_->front());
+  // Scopes are strictly nested, so the table keeps track of them itself.
+  hermesValues_.pushScope();
+  return nullptr;
 }
 
 void HermesRuntimeImpl::popScope(ScopeState *prv) {
-  HermesPointerValue *sentinel = reinterpret_cast<HermesPointerValue *>(prv);
-  assert(sentinel->phv.isNativeValue());
-  assert(sentinel->phv.getNativeValue() == kSentinelNativeValue);
-
-  for (auto it = hermesValues_->begin(); it != hermesValues_->end();) {
-    auto &value = *it;
-
-    if (&value == sentinel) {
-      hermesValues_->erase(it);
-      return;
-    }
-
-    if (value.phv.isNativeValue()) {
-      // We reached another sentinel value or we started added another native
-      // value to the hermesValue_ list. This should not happen.
-      std::terminate();
-    }
-
-    if (value.get() == 0) {
-      it = hermesValues_->erase(it);
-    } else {
-      ++it;
-    }
-  }
-
-  // We did not find a sentinel value.
-  std::terminate();
+  assert(!prv && "pushScope() only returns nullptr");
+  hermesValues_.popScope();
 }
 
 void HermesRuntimeImpl::checkStatus(vm::ExecutionStatus status) {
@@ -7,7 +7,9 @@
 #ifndef HERMES_HERMES_H
 #define HERMES_HERMES_H
 
+#include <chrono>
 #include <exception>
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
@@ -97,6 +99,118 @@ class HermesRuntime : public jsi::Runtime {
   /// values.
   uint64_t getUniqueID(const jsi::Object &o) const;
 
+  /// Batched versions of the jsi::Runtime property and array accessors. Each
+  /// one behaves like the corresponding sequence of individual calls, but
+  /// enters the VM once, which makes a large difference when marshalling big
+  /// native structures into and out of JS.
+
+  /// Read the properties \p names[0, count) of \p obj into \p values.
+  void getProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      jsi::Value *values,
+      size_t count);
+
+  /// Set the properties \p names[0, count) of \p obj to \p values.
+  void setProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      const jsi::Value *values,
+      size_t count);
+
+  /// Copy the elements [start, start + count) of \p arr into \p values.
+  /// Throws a jsi::JSError if the range is out of bounds.
+  void getArrayElements(
+      const jsi::Array &arr,
+      size_t start,
+      jsi::Value *values,
+      size_t count);
+
+  /// Like the above, for an array of numbers. Throws a jsi::JSError if one of
+  /// the elements is not a number.
+  void getArrayElements(
+      const jsi::Array &arr,
+      size_t start,
+      double *values,
+      size_t count);
+
+  /// Copy \p values[0, count) into the elements [start, start + count) of
+  /// \p arr. Throws a jsi::JSError if the range is out of bounds.
+  void setArrayElements(
+      const jsi::Array &arr,
+      size_t start,
+      const jsi::Value *values,
+      size_t count);
+
+  /// Like the above, for an array of numbers.
+  void setArrayElements(
+      const jsi::Array &arr,
+      size_t start,
+      const double *values,
+      size_t count);
+
+  /// Create an ArrayBuffer over the \p size bytes at \p data, without copying
+  /// them. The memory remains owned by the caller and must stay valid until
+  /// \p release is called. This happens once, when the ArrayBuffer is
+  /// detached, garbage collected, or at the latest when the runtime is
+  /// destroyed. \p release may run during a garbage collection, and must not
+  /// call into the runtime. If the ArrayBuffer can't be created, \p release
+  /// is called before the exception is thrown.
+  jsi::ArrayBuffer createExternalArrayBuffer(
+      uint8_t *data,
+      size_t size,
+      std::function<void()> release);
+
+  /// Do the garbage collection work which is expected to complete by
+  /// \p deadline, judging by the durations of previous collections, so that
+  /// fewer collections are needed while the embedder is busy.  Call it when
+  /// the runtime is idle, e.g. between requests; it does nothing if no
+  /// collection is expected to fit.
+  /// \return the number of bytes of free space created in the heap.
+  size_t collectGarbageWhileIdle(
+      std::chrono::steady_clock::time_point deadline);
+
+  /// Free as much memory as possible, e.g. when the OS warns that the process
+  /// is using too much.  At \c Moderate, caches of the runtime are dropped,
+  /// the heap is compacted and its free memory returned to the OS.  At
+  /// \c Critical, the heap is also shrunk and the property maps of hidden
+  /// classes are dropped, which slows execution until they are recreated.
+  /// \return an estimate of the number of bytes freed.
+  size_t handleMemoryPressure(::hermes::vm::MemoryPressureLevel level);
+
+  /// Start sampling the allocations of this runtime, with a mean of
+  /// \p samplingInterval bytes between samples, and attributing each sample
+  /// to the JS stack which made it.  The interval trades the precision of the
+  /// profile against its overhead.  Any previous profile is discarded.
+  void startAllocationSampling(size_t samplingInterval = 512 * 1024);
+
+  /// Stop sampling allocations and discard the profile.
+  void stopAllocationSampling();
+
+  /// Write the profile of the sampled allocations to \p os, as a Chrome
+  /// DevTools sampling heap profile, which can be loaded as a .heapprofile
+  /// file.  Sampling must have been started.
+  void dumpAllocationProfile(llvm::raw_ostream &os);
+
+  /// Write the profile of the sampled allocations to the given file name.
+  void dumpAllocationProfileToFile(const std::string &fileName);
+
+  /// Collect garbage, then write a snapshot of the heap to the open file
+  /// descriptor \p fd, which is left open, in a compact binary format.  It
+  /// is much smaller and faster to write than the snapshots of
+  /// jsi::Instrumentation, and is written in bounded memory.  Convert it to a
+  /// Chrome .heapsnapshot file with the heapsnapshot-convert tool.
+  /// \return false if it could not be written, or if the GC doesn't support
+  /// binary snapshots.
+  bool createBinaryHeapSnapshotToFD(int fd);
+
+  /// Like createBinaryHeapSnapshotToFD, but writes to the given file name.
+  bool createBinaryHeapSnapshotToFile(const std::string &fileName);
+
+  /// Detach \p buffer from its data, leaving it with a size of zero. If it
+  /// is an external ArrayBuffer, its release callback is called immediately.
+  void detachArrayBuffer(const jsi::ArrayBuffer &buffer);
+
 #ifdef HERMESVM_API_TRACE
   /// Get a structure representing the enviroment-dependent behavior, so
   /// it can be written into the trace for later replay.
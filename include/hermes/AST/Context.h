@@ -12,6 +12,8 @@
 #include "hermes/Support/SourceErrorManager.h"
 #include "hermes/Support/StringTable.h"
 
+#include <mutex>
+
 namespace hermes {
 
 namespace hbc {
@@ -183,6 +185,11 @@ class Context {
   /// on its destructor.
   std::shared_ptr<hbc::BackendContext> hbcBackendContext_{};
 
+  /// Held while a function is compiled lazily in this context, and while the
+  /// runtime looks up the source locations of such functions, since they may
+  /// happen on different threads.
+  std::mutex lazyCompilationMutex_{};
+
  public:
   explicit Context(
       SourceErrorManager &sm,
@@ -233,6 +240,10 @@ class Context {
     return sm_;
   }
 
+  std::mutex &getLazyCompilationMutex() {
+    return lazyCompilationMutex_;
+  }
+
   /// \return the table for static require resolution, nullptr if not supplied.
   const std::vector<SegmentRange> &getSegmentRanges() const {
     return segmentRanges_;
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_BCGEN_HBC_BYTECODECOMPRESSION_H
+#define HERMES_BCGEN_HBC_BYTECODECOMPRESSION_H
+
+#include "hermes/BCGen/HBC/BytecodeFileFormat.h"
+#include "hermes/Public/Buffer.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace hermes {
+namespace hbc {
+
+/// \return true if this build can write and load compressed bytecode.
+bool isBytecodeCompressionAvailable();
+
+/// \return true if \p aref starts with the header of a compressed bytecode
+/// container. It may still be malformed.
+inline bool isCompressedBytecode(llvm::ArrayRef<uint8_t> aref) {
+  const auto *header =
+      reinterpret_cast<const CompressedBytecodeHeader *>(aref.data());
+  return aref.size() >= sizeof(CompressedBytecodeHeader) &&
+      header->magic == COMPRESSED_MAGIC;
+}
+
+/// Check that \p aref is a well-formed compressed bytecode container, without
+/// decompressing it.
+/// \return true if it is, false and the reason in \p errorMessage (if
+/// supplied) if not.
+bool compressedBytecodeSanityCheck(
+    llvm::ArrayRef<uint8_t> aref,
+    std::string *errorMessage = nullptr);
+
+/// Compress the bytecode file \p bytecode, which may be followed by an
+/// epilogue, and write it to \p OS as a compressed container.
+/// \return true if successful, false if the file could not be compressed, in
+/// which case the reason is returned in \p outError.
+bool compressBytecode(
+    llvm::ArrayRef<uint8_t> bytecode,
+    llvm::raw_ostream &OS,
+    std::string *outError);
+
+/// A bytecode file decompressed from a compressed container. The memory of
+/// the whole file is reserved up front, but the blocks of function bodies
+/// are only decompressed when ensureFunctionBody() is called for one of their
+/// functions, so the pages of the functions which never run are never
+/// touched. The bytecode points into this memory, so decompressed blocks are
+/// kept for the lifetime of the buffer.
+class DecompressedBytecodeBuffer final : public Buffer {
+ public:
+  /// Decompress the eagerly loaded blocks of \p container.
+  /// \return the buffer, or nullptr and the reason in \p outError if the
+  /// container is malformed.
+  static std::unique_ptr<DecompressedBytecodeBuffer> create(
+      std::unique_ptr<const Buffer> container,
+      std::string *outError);
+
+  ~DecompressedBytecodeBuffer() override;
+
+  /// Make sure that the function body at \p offset in the decompressed file
+  /// has been decompressed. May be called on several threads at once.
+  void ensureFunctionBody(uint32_t offset) const {
+    if (offset >= header_->lazyBegin && offset < header_->lazyEnd)
+      decompressLazyBlock(offset);
+  }
+
+  /// \return the compressed container, including its epilogue.
+  llvm::ArrayRef<uint8_t> getContainer() const {
+    return {container_->data(), container_->size()};
+  }
+
+ private:
+  DecompressedBytecodeBuffer(
+      std::unique_ptr<const Buffer> container,
+      uint8_t *memory,
+      size_t memorySize);
+
+  /// Decompress the block containing \p offset if it has not been already.
+  void decompressLazyBlock(uint32_t offset) const;
+
+  /// Decompress the block at \p index into memory_.
+  /// \return true on success.
+  bool decompressBlock(size_t index) const;
+
+  std::unique_ptr<const Buffer> container_;
+
+  const CompressedBytecodeHeader *header_;
+
+  llvm::ArrayRef<CompressedBytecodeBlock> blocks_;
+
+  /// The decompressed file, allocated with oscompat::vm_allocate.
+  uint8_t *memory_;
+  size_t memorySize_;
+
+  /// Whether each block has been decompressed.
+  std::unique_ptr<std::atomic<bool>[]> decompressed_;
+
+  /// Held while a lazy block is decompressed, so that it only happens once.
+  mutable std::mutex mutex_;
+};
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_BYTECODECOMPRESSION_H
@@ -7,6 +7,7 @@
 #ifndef HERMES_BCGEN_HBC_BYTECODEDATAPROVIDER_H
 #define HERMES_BCGEN_HBC_BYTECODEDATAPROVIDER_H
 
+#include "hermes/BCGen/HBC/BytecodeCompression.h"
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/BCGen/HBC/DebugInfo.h"
 #include "hermes/Public/Buffer.h"
@@ -19,6 +20,7 @@
 #include "llvm/ADT/ArrayRef.h"
 
 #include <atomic>
+#include <mutex>
 #include <thread>
 
 namespace hermes {
@@ -132,6 +134,10 @@ class BCProviderBase {
   /// when first needed. Most likely we should never need to use it.
   const hbc::DebugInfo *debugInfo_{};
 
+  /// Guards the creation of debugInfo_, since a provider may be used by
+  /// several runtimes on different threads.
+  mutable std::once_flag debugInfoOnce_{};
+
   /// Error message when there is an error parsing the bytecode.
   /// We can use this to throw an exception to JSI.
   std::string errstr_{};
@@ -200,9 +206,9 @@ class BCProviderBase {
 
   /// Get the global debug info, lazily create it.
   const hbc::DebugInfo *getDebugInfo() const {
-    if (!debugInfo_) {
+    std::call_once(debugInfoOnce_, [this]() {
       const_cast<BCProviderBase *>(this)->createDebugInfo();
-    }
+    });
     return debugInfo_;
   }
 
@@ -295,6 +301,10 @@ class BCProviderBase {
 /// a bytecode buffer (from a file). In this code path, no extra classes need
 /// to be created but we only need to maintain a few pointers to point into
 /// the buffer in order to provide all the bytecode data.
+/// The buffer is never modified (except by breakpoints installed by the
+/// debugger), so one provider may be shared by any number of runtimes, on
+/// different threads. Each runtime keeps its own mutable state, such as the
+/// SymbolIDs of the strings, in its RuntimeModule.
 class BCProviderFromBuffer final : public BCProviderBase {
   /// The continuous bytecode buffer.
   std::unique_ptr<const Buffer> buffer_;
@@ -302,6 +312,10 @@ class BCProviderFromBuffer final : public BCProviderBase {
   /// Pointer to buffer_->data(), to avoid calling it every time.
   const uint8_t *bufferPtr_;
 
+  /// If the bytecode was loaded from a compressed container, this is
+  /// buffer_, which decompresses the function bodies as they are needed.
+  const DecompressedBytecodeBuffer *decompressed_{};
+
   /// List of function headers.
   const hbc::SmallFuncHeader *functionHeaders_{};
 
@@ -324,6 +338,10 @@ class BCProviderFromBuffer final : public BCProviderBase {
 
   std::unique_ptr<volatile PageAccessTracker> tracker_;
 
+  /// Serializes starting and stopping the warmup thread and the tracker, which
+  /// every runtime sharing this provider may request.
+  std::mutex startMutex_;
+
   /// Tells any running warmup thread to abort and then joins that thread.
   void stopWarmup();
 
@@ -348,13 +366,14 @@ class BCProviderFromBuffer final : public BCProviderBase {
     return {errstr.empty() ? std::move(ret) : nullptr, errstr};
   }
 
-  /// Checks whether the data is actually bytecode.
+  /// Checks whether the data is actually bytecode, possibly compressed.
   static bool isBytecodeStream(llvm::ArrayRef<uint8_t> aref) {
     const auto *header =
         reinterpret_cast<const hbc::BytecodeFileHeader *>(aref.data());
     return (
-        aref.size() >= sizeof(hbc::BytecodeFileHeader) &&
-        header->magic == hbc::MAGIC);
+        (aref.size() >= sizeof(hbc::BytecodeFileHeader) &&
+         header->magic == hbc::MAGIC) ||
+        isCompressedBytecode(aref));
   }
 
   /// Checks whether the buffer is actually bytecode.
@@ -426,7 +445,11 @@ class BCProviderFromBuffer final : public BCProviderBase {
   }
 
   const uint8_t *getBytecode(uint32_t functionID) const {
-    return bufferPtr_ + getFunctionHeader(functionID).offset();
+    const uint32_t offset = getFunctionHeader(functionID).offset();
+    if (LLVM_UNLIKELY(decompressed_)) {
+      decompressed_->ensureFunctionBody(offset);
+    }
+    return bufferPtr_ + offset;
   }
 
   llvm::ArrayRef<hbc::HBCExceptionHandlerInfo> getExceptionTable(
@@ -27,9 +27,14 @@ const static uint64_t MAGIC = 0x1F1903C103BC1FC6;
 // bytecode file is in a form suitable for delta diffing, not execution.
 const static uint64_t DELTA_MAGIC = ~MAGIC;
 
+// The compressed form: a different magic number indicating that the bytecode
+// file is stored in a compressed container (see CompressedBytecodeHeader),
+// which is decompressed when it is loaded.
+const static uint64_t COMPRESSED_MAGIC = MAGIC ^ 0xFF;
+
 // Bytecode version generated by this version of the compiler.
 // Updated: Jun 22, 2019
-const static uint32_t BYTECODE_VERSION = 59;
+const static uint32_t BYTECODE_VERSION = 60;
 
 /// Property cache index which indicates no caching.
 static constexpr uint8_t PROPERTY_CACHING_DISABLED = 0;
@@ -368,6 +373,32 @@ struct DebugFileRegion {
   uint32_t sourceMappingUrlId;
 };
 
+/// Header of a compressed bytecode container. It is followed by blockCount
+/// CompressedBytecodeBlocks, and by the compressed data of the blocks. Any
+/// data after containerLength is the epilogue, which is not compressed.
+/// The blocks which are entirely in [lazyBegin, lazyEnd), the function bodies,
+/// start at a function body and are only decompressed when one of their
+/// functions is first run. The others are decompressed on load.
+struct CompressedBytecodeHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint8_t sourceHash[SHA1_NUM_BYTES];
+  uint32_t fileLength; // Bytes in the decompressed bytecode file.
+  uint32_t containerLength; // Bytes in the container, without the epilogue.
+  uint32_t blockCount;
+  uint32_t lazyBegin;
+  uint32_t lazyEnd;
+};
+
+/// A block of the decompressed bytecode file, compressed independently of
+/// the others.
+struct CompressedBytecodeBlock {
+  uint32_t offset; // Offset of the block in the decompressed file.
+  uint32_t size; // Bytes in the decompressed block.
+  uint32_t compressedOffset; // Offset of the data in the container.
+  uint32_t compressedSize; // Bytes in the compressed data.
+};
+
 LLVM_PACKED_END
 
 /// Visit each segment in a bytecode file in order.
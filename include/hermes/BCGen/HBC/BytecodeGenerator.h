@@ -200,6 +200,11 @@ class BytecodeFunctionGenerator : public BytecodeInstructionGenerator {
   void
   updateJumpTableOffset(offset_t loc, uint32_t jumpTableOffset, uint32_t cs);
 
+  /// Replace the first instruction of every pair of adjacent instructions
+  /// that has a superinstruction (see BytecodeList.def) with it. This only
+  /// rewrites opcodes, so it can run after jump relocation.
+  void selectSuperinstructions();
+
   /// Change the opcode of a long jump instruction into a short jump.
   inline void longToShortJump(offset_t loc) {
     switch (opcodes_[loc]) {
@@ -87,6 +87,10 @@ class UniquingStringLiteralAccumulator final : public StringLiteralIDMapping {
   /// information is used to order the resulting storage.
   std::vector<size_t> numIdentifierRefs_;
 
+  /// Whether a string is used by one of the functions run at startup. Like
+  /// numIdentifierRefs_, this is only tracked for newly added strings.
+  std::vector<bool> isStartup_;
+
  public:
   UniquingStringLiteralAccumulator() = default;
   using StringLiteralIDMapping::StringLiteralIDMapping;
@@ -96,6 +100,10 @@ class UniquingStringLiteralAccumulator final : public StringLiteralIDMapping {
   /// identifier.
   inline void addString(llvm::StringRef str, bool isIdentifier);
 
+  /// Mark the previously added string \p str as used at startup, so that it is
+  /// placed before the other strings in its part of the resulting storage.
+  inline void markStartupString(llvm::StringRef str);
+
   /// \return a StringLiteralTable with the same strings as the accumulator
   /// \p strings.  If \p optimize is set, attempt to pack the strings to
   /// reduce the size taken up by the character buffer.  The mapping from ID
@@ -151,6 +159,7 @@ inline void UniquingStringLiteralAccumulator::addString(
   if (id == fresh) {
     isIdentifier_.push_back(false);
     numIdentifierRefs_.push_back(0);
+    isStartup_.push_back(false);
   }
 
   if (isIdentifier) {
@@ -163,6 +172,16 @@ inline void UniquingStringLiteralAccumulator::addString(
   }
 }
 
+inline void UniquingStringLiteralAccumulator::markStartupString(
+    llvm::StringRef str) {
+  auto iter = strings_.find(str);
+  assert(iter != strings_.end() && "Marking a string that was not added");
+  size_t id = std::distance(strings_.begin(), iter);
+  if (id >= storage_.count()) {
+    isStartup_[id - storage_.count()] = true;
+  }
+}
+
 } // namespace hbc
 } // namespace hermes
 
@@ -314,6 +314,16 @@ class RegisterAllocator {
       DenseMap<Instruction *, Instruction *> &map,
       ArrayRef<BasicBlock *> order);
 
+  /// Assign registers to the live intervals, allowing intervals to share a
+  /// register whenever their segments don't overlap, and preferring the
+  /// register of the other side of a MOV to eliminate the copy. \p coalesced
+  /// maps the intervals that were merged by coalesce() to the interval whose
+  /// register they share. Values in \p liveIntoCatch are live into a catch
+  /// block, and keep their register over their whole span.
+  void allocateFillingHoles(
+      DenseMap<Instruction *, Instruction *> &coalesced,
+      const BitVector &liveIntoCatch);
+
  protected:
   /// Keeps track of the already allocated values.
   llvm::DenseMap<Value *, Register> allocated{};
@@ -330,6 +340,10 @@ class RegisterAllocator {
   /// degenerate cases.
   uint64_t memoryLimit = -1;
 
+  /// If set, registers are reused in the lifetime holes of other values,
+  /// which minimizes the frame size at some compile time cost.
+  bool fillLifetimeHoles = false;
+
   /// Allocate the registers for the instructions in the function in a trivial,
   /// suboptimal, but very fast way.
   void allocateFastPass(ArrayRef<BasicBlock *> order);
@@ -359,6 +373,10 @@ class RegisterAllocator {
     memoryLimit = memoryLimitInBytes;
   }
 
+  void setFillLifetimeHoles(bool fill) {
+    fillLifetimeHoles = fill;
+  }
+
   /// \returns the index of instruction \p I.
   unsigned getInstructionNumber(Instruction *I);
 
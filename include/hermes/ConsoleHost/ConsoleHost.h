@@ -48,6 +48,11 @@ struct ExecuteOptions {
   /// Stop after creating the RuntimeModule.
   bool stopAfterInit{false};
 
+  /// If not empty, write the IDs of the functions of the bytecode in the
+  /// order in which they were first used to this file, for hermesc
+  /// -function-order.
+  std::string functionOrderFile;
+
 #ifdef HERMESVM_PROFILER_EXTERN
   /// Patch the symbols so that the external profiler can be used.
   bool patchProfilerSymbols{false};
@@ -110,6 +110,24 @@ static opt<std::string> ProfilerSymbolsFile(
 static opt<bool>
     ES6Symbol("Xes6-symbol", desc("Enable support for ES6 Symbol"), init(true));
 
+static opt<bool> UseRuntimeImage(
+    "Xruntime-image",
+    desc("Initialize the runtime by copying the heap of an initialized "
+         "runtime instead of creating the builtins"),
+    init(false));
+
+static opt<bool> LazyBuiltins(
+    "Xlazy-builtins",
+    desc("Create the Date, RegExp, typed array, Set, Map, WeakMap, WeakSet "
+         "and Symbol builtins when they are first used"),
+    init(false));
+
+static opt<bool> BackgroundLazyCompilation(
+    "Xbackground-lazy-compilation",
+    desc("Compile lazy functions on a background thread before they are "
+         "first called"),
+    init(false));
+
 static llvm::cl::opt<bool> StopAfterInit(
     "stop-after-module-init",
     llvm::cl::desc("Exit once module loading is finished. Useful "
@@ -120,6 +138,13 @@ static opt<bool> TrackBytecodeIO(
     desc(
         "Track bytecode I/O when executing bytecode. Only works with bytecode mode"));
 
+static opt<std::string> DumpFunctionOrder(
+    "dump-function-order",
+    desc("Write the IDs of the functions in the bytecode, in the order in "
+         "which they are first used, to this file. hermesc -function-order "
+         "uses it to lay out the functions run at startup together."),
+    llvm::cl::value_desc("file"));
+
 static opt<uint32_t> VMExperimentFlags(
     "Xvm-experiment-flags",
     llvm::cl::desc("VM experiment flags."),
@@ -465,6 +465,21 @@ class Value {
   }
 };
 
+/// While an instance of this class is alive, changes to operand and use lists
+/// and the creation of uniqued literals are serialized by a global lock. This
+/// makes it possible to transform distinct functions of the same Module on
+/// separate threads: the functions themselves are disjoint, but values such as
+/// literals are shared, and their use lists point into every function.
+/// Scopes may be nested; the lock is not taken when no scope is alive.
+class ConcurrentIRMutationScope {
+ public:
+  ConcurrentIRMutationScope();
+  ~ConcurrentIRMutationScope();
+
+  ConcurrentIRMutationScope(const ConcurrentIRMutationScope &) = delete;
+  void operator=(const ConcurrentIRMutationScope &) = delete;
+};
+
 /// This represents a function parameter.
 class Parameter : public Value {
   Parameter(const Parameter &) = delete;
@@ -99,10 +99,23 @@ enum class ProtectMode { ReadWrite };
 bool vm_protect(void *p, size_t sz, ProtectMode mode);
 
 /// Issue an madvise() call.
+/// HugePage asks the OS to back the region with transparent huge pages, where
+/// it supports them.
 /// \return true on success, false on error.
-enum class MAdvice { Random, Sequential };
+enum class MAdvice { Random, Sequential, HugePage };
 bool vm_madvise(void *p, size_t sz, MAdvice advice);
 
+/// \return the NUMA node of the CPU the current thread is running on, or -1 if
+/// it is unknown or NUMA is not supported.
+int numa_node_of_current_thread();
+
+/// Ask the OS to place the pages of the \p sz byte region of memory starting
+/// at \p p on the NUMA node \p node, falling back to other nodes when it is
+/// out of memory. This only affects pages which have not been touched yet.
+/// \p p must be page-aligned.
+/// \return true if successful, false on error or if NUMA is not supported.
+bool vm_prefer_numa_node(void *p, size_t sz, int node);
+
 /// Return the number of pages in the given region that are currently in RAM.
 /// If \p runs is provided, then populate it with the lengths of runs of
 /// consecutive pages with the same resident/non-resident status, alternating
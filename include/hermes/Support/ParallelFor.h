@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_SUPPORT_PARALLELFOR_H
+#define HERMES_SUPPORT_PARALLELFOR_H
+
+#include "llvm/ADT/STLExtras.h"
+
+#include <cstddef>
+
+namespace hermes {
+
+/// \return the number of threads to use when the user requested \p requested
+/// threads, where 0 means "as many as there are hardware threads".
+unsigned resolveThreadCount(unsigned requested);
+
+/// Invoke \p fn(i) for every i in [0, count), distributing the calls over at
+/// most \p numThreads threads, one of which is the calling thread. Indices are
+/// handed out in increasing order, but the calls may complete in any order,
+/// so \p fn must be safe to invoke concurrently for distinct indices.
+/// Returns once every call has completed.
+void parallelFor(
+    size_t count,
+    unsigned numThreads,
+    llvm::function_ref<void(size_t)> fn);
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_PARALLELFOR_H
@@ -21,6 +21,7 @@ struct DummyCounter {
   DummyCounter &operator=(int) {
     return *this;
   }
+  void updateMax(unsigned) {}
 };
 } // namespace hermes
 
@@ -7,6 +7,9 @@
 #ifndef HERMES_UTILS_OPTIONS_H
 #define HERMES_UTILS_OPTIONS_H
 
+#include <cstdint>
+#include <vector>
+
 namespace hermes {
 
 enum OutputFormatKind {
@@ -50,9 +53,31 @@ struct BytecodeGenerationOptions {
   /// Strip all function names to reduce string table size.
   bool stripFunctionNames = false;
 
+  /// Whether register allocation should minimize frame sizes by reusing
+  /// registers in the lifetime holes of other values, at some compile time
+  /// cost.
+  bool compactFrames = false;
+
+  /// Whether to replace frequent pairs of instructions with superinstructions.
+  /// Not done for code compiled for the debugger.
+  bool superinstructions = false;
+
   /// Add this much garbage after each function body (relative to its size).
   unsigned padFunctionBodiesPercent = 0;
 
+  /// IDs of the functions whose bytecode is laid out first, in this order,
+  /// followed by the remaining functions in ID order. The strings they use
+  /// are grouped together too, as far as the string table ordering allows.
+  /// This is meant to make the code run at startup contiguous in the bytecode
+  /// file. IDs that are out of range or repeated are ignored.
+  std::vector<uint32_t> functionOrder{};
+
+  /// Number of threads used to run the per-function stages of bytecode
+  /// generation (register allocation and the passes that depend on it).
+  /// 0 means one thread per hardware thread. The output does not depend on
+  /// this setting.
+  unsigned numThreads = 1;
+
   /* implicit */ BytecodeGenerationOptions(OutputFormatKind format)
       : format(format) {}
 
@@ -20,6 +20,7 @@
 #include "hermes/VM/MarkBitArrayNC.h"
 #include "hermes/VM/SweepResultNC.h"
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/MathExtras.h"
 
 #include <cstdint>
@@ -237,6 +238,11 @@ class AlignedHeapSegment final {
   /// Grow the allocation region as big as possible.
   inline void growToLimit();
 
+  /// Return the pages of the segment above its level to the OS.  Like
+  /// setLevel<AdviseUnused::Yes>(), this is a no-op in debug builds, which
+  /// keep the dead memory cleared instead.
+  void markUnusedAboveLevel();
+
   /// Try to increase the size of the allocation region in this segment so that
   /// at least \p amount bytes become available. Updates the bounds of the
   /// segment and \returns true on success, and \returns false otherwise (If the
@@ -287,6 +293,24 @@ class AlignedHeapSegment final {
   /// (indicated by incrementing *vTableBegin).
   void compact(SweepResult::VTablesRemaining &vTables);
 
+  /// Assumes marking is complete.  Leaves the marked cells where they are,
+  /// and replaces each run of unmarked cells between them by a FillerCell,
+  /// keeping the card object boundaries valid.  The run after the last marked
+  /// cell is only replaced if \p fillTail is true.  Calls \p onDead with the
+  /// bounds of each run that was replaced.
+  /// \return the end of the last marked cell, or start() if there is none.
+  char *sweepInPlace(
+      GC *gc,
+      bool fillTail,
+      llvm::function_ref<void(char *, char *)> onDead);
+
+  /// \return whether any cell of the segment is marked.
+  bool hasMarkedCells() const;
+
+  /// Call \p callback with each of the marked cells, in address order.
+  template <typename F>
+  inline void forMarkedObjs(F callback) const;
+
   /// \return the sum of all the malloc sizes reported by objects in this
   ///     segment.
   size_t countMallocSize() const;
@@ -467,6 +491,21 @@ MarkBitArrayNC &AlignedHeapSegment::markBitArray() const {
   return contents()->markBitArray_;
 }
 
+template <typename F>
+void AlignedHeapSegment::forMarkedObjs(F callback) const {
+  if (used() == 0) {
+    return;
+  }
+  MarkBitArrayNC &markBits = markBitArray();
+  const size_t indexLimit = markBits.addressToIndex(level() - 1) + 1;
+  for (size_t ind = markBits.findNextMarkedBitFrom(
+           markBits.addressToIndex(start()));
+       ind < indexLimit;
+       ind = markBits.findNextMarkedBitFrom(ind + 1)) {
+    callback(reinterpret_cast<GCCell *>(markBits.indexToAddress(ind)));
+  }
+}
+
 AlignedHeapSegment::Contents *AlignedHeapSegment::contents() const {
   return contents(lowLim());
 }
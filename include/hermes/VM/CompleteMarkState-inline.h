@@ -20,6 +20,8 @@ namespace vm {
 
 struct CompleteMarkState::FullMSCMarkTransitiveAcceptor final
     : public SlotAcceptorDefault {
+  static constexpr bool shouldDeferEphemerons = true;
+
   MarkBitArray *markBits;
   CompleteMarkState *markState;
   FullMSCMarkTransitiveAcceptor(
@@ -54,6 +56,8 @@ struct CompleteMarkState::FullMSCMarkTransitiveAcceptor final
 
 struct CompleteMarkState::FullMSCMarkTransitiveAcceptor final
     : public SlotAcceptorDefault {
+  static constexpr bool shouldDeferEphemerons = true;
+
   CompleteMarkState *markState;
   FullMSCMarkTransitiveAcceptor(GC &gc, CompleteMarkState *markState)
       : SlotAcceptorDefault(gc), markState(markState) {}
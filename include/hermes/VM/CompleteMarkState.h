@@ -59,6 +59,12 @@ struct CompleteMarkState {
   void drainMarkStack(GC *gc, FullMSCMarkTransitiveAcceptor &acceptor);
   /// @}
 
+  /// Push the marked \p cell on the appropriate mark stack, unless it is full.
+  void pushCell(GCCell *cell);
+
+  /// Empty the mark stacks, after one of them has overflowed.
+  void clearMarkStacks();
+
 #endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
 
   /// The maximum size of the mark stack.
@@ -89,6 +95,25 @@ struct CompleteMarkState {
   /// yet fully scanned.
   std::vector<GCCell *> varSizeMarkStack_;
 
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+  /// A variable sized cell which is too large to be scanned at once, and the
+  /// start of the part of it which hasn't been scanned yet.
+  struct LargeCellCursor {
+    GCCell *cell;
+    const char *next;
+  };
+
+  /// The number of bytes of a large cell scanned at once.  It holds few enough
+  /// pointers that they never overflow the empty mark stacks.
+  static const size_t kLargeCellSliceSize = 2048;
+
+  /// The large variable sized cells that have been marked but not yet fully
+  /// scanned.  They are scanned a slice at a time, when the other mark stacks
+  /// are empty, so that the cells are scanned only once, however many
+  /// pointers they push.
+  std::vector<LargeCellCursor> largeCellMarkStack_;
+#endif
+
   /// Check if the current object going through complete marking is var sized.
   bool markingVarSizeCell = false;
 
@@ -326,6 +326,16 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
   /// estimate of the allocation size of the object.
   static constexpr uint64_t kAlignPadding = alignof(std::max_align_t) - 1;
 
+  /// The largest allocation size of a DictPropertyMap.  Growing a map needs
+  /// both the old and the new map to be alive, so NCGen keeps maps within a
+  /// heap segment, even though it can allocate larger cells.
+  static constexpr uint32_t kMaxAllocationSize =
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+      AlignedHeapSegment::maxSize();
+#else
+      GC::maxAllocationSize();
+#endif
+
   /// Calculate a conservative approximate size of DictPropertyMap in bytes,
   /// given a capacity. The calculation is performed using 64-bit arithmetic to
   /// avoid overflow.
@@ -349,11 +359,11 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
   }
 
   /// Return true if DictPropertyMap with the specified capacity is guaranteed
-  /// to fit within the GC's maxumum allocation size. The check is conservative:
+  /// to fit within kMaxAllocationSize. The check is conservative:
   /// it might a few return false negatives at the end of the range.
   /// NOTE: it must not be used at runtime since it might be slow.
   static constexpr bool constWouldFitAllocation(uint32_t cap) {
-    return constApproxAllocSize64(cap) <= GC::maxAllocationSize();
+    return constApproxAllocSize64(cap) <= kMaxAllocationSize;
   }
 
   /// In the range of capacity values [first ... first + len), find the largest
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_EPHEMERONCHUNK_H
+#define HERMES_VM_EPHEMERONCHUNK_H
+
+#include "hermes/VM/HermesValue-inline.h"
+#include "hermes/VM/Metadata.h"
+#include "hermes/VM/Runtime.h"
+
+#include "llvm/Support/TrailingObjects.h"
+
+namespace hermes {
+namespace vm {
+
+/// A GC-managed array of (key, value) entries with ephemeron semantics: a full
+/// collection keeps the value of an entry alive only if its key is reachable
+/// by other means, and clears the entries whose keys are unreachable. This is
+/// what lets a WeakMap entry be collected even when its value references its
+/// own key.
+///
+/// The entries are described as ordinary fields in the metadata, so every
+/// visitor other than the marker of a full collection (young generation
+/// collections, reference updates after compaction, heap snapshots, heap
+/// checks) treats them as strong references. Acceptors that set
+/// shouldDeferEphemerons skip them instead: GCBase::markCell hands the chunk
+/// to GCBase::recordEphemeronChunk, and the GC marks the values of the
+/// reachable keys once the rest of the heap has been marked.
+///
+/// The key of an empty entry is empty. The key of a deleted entry is null, and
+/// its value is empty.
+class EphemeronChunk final
+    : public VariableSizeRuntimeCell,
+      private llvm::TrailingObjects<EphemeronChunk, GCHermesValue> {
+  friend TrailingObjects;
+  friend class GCBase;
+  friend void EphemeronChunkBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+
+ public:
+  using size_type = uint32_t;
+
+  static VTable vt;
+
+  /// The largest number of entries in a chunk. Larger tables are split across
+  /// several chunks, which keeps every chunk out of the large object space.
+  static constexpr size_type kMaxEntries = 4096;
+
+  /// Gets the amount of memory used by a chunk of \p numEntries entries.
+  static constexpr uint32_t allocationSize(size_type numEntries) {
+    return totalSizeToAlloc<GCHermesValue>(numEntries * 2);
+  }
+
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == CellKind::EphemeronChunkKind;
+  }
+
+  /// Create a new chunk of \p numEntries empty entries.
+  /// Requires that \p numEntries <= kMaxEntries.
+  static CallResult<HermesValue> create(
+      Runtime *runtime,
+      size_type numEntries) {
+    assert(numEntries <= kMaxEntries && "too many entries in one chunk");
+    void *mem = runtime->alloc</*fixedSize*/ false>(allocationSize(numEntries));
+    return HermesValue::encodeObjectValue(
+        new (mem) EphemeronChunk(runtime, numEntries));
+  }
+
+  size_type numEntries() const {
+    return numSlots_ / 2;
+  }
+
+  /// \return a reference to the key of the entry at \p index.
+  GCHermesValue &key(size_type index) {
+    assert(index < numEntries() && "index out of range");
+    return data()[index * 2];
+  }
+
+  /// \return a reference to the value of the entry at \p index.
+  GCHermesValue &value(size_type index) {
+    assert(index < numEntries() && "index out of range");
+    return data()[index * 2 + 1];
+  }
+
+ private:
+  /// The number of HermesValues following the cell: two per entry.
+  const size_type numSlots_;
+
+  /// The full collection which last recorded this chunk, see
+  /// GCBase::recordEphemeronChunk. Zero means none.
+  uint32_t markEpoch_{0};
+
+  EphemeronChunk(Runtime *runtime, size_type numEntries)
+      : VariableSizeRuntimeCell(
+            &runtime->getHeap(),
+            &vt,
+            allocationSize(numEntries)),
+        numSlots_(numEntries * 2) {
+    GCHermesValue::fill(
+        data(), data() + numSlots_, HermesValue::encodeEmptyValue());
+  }
+
+  GCHermesValue *data() {
+    return getTrailingObjects<GCHermesValue>();
+  }
+  const GCHermesValue *data() const {
+    return getTrailingObjects<GCHermesValue>();
+  }
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_EPHEMERONCHUNK_H
@@ -31,6 +31,11 @@ inline void GCBase::markCell(
     GCCell *cell,
     const VTable *vt,
     GC *gc) {
+  if (Acceptor::shouldDeferEphemerons &&
+      vt->kind == CellKind::EphemeronChunkKind) {
+    gc->recordEphemeronChunk(cell);
+    return;
+  }
   visitor.visit(cell, gc->metaTable_[static_cast<size_t>(vt->kind)]);
   if (Acceptor::shouldMarkWeak) {
     vt->markWeakIfExists(cell, gc);
@@ -45,6 +50,11 @@ inline void GCBase::markCellWithinRange(
     GC *gc,
     const char *begin,
     const char *end) {
+  if (Acceptor::shouldDeferEphemerons &&
+      vt->kind == CellKind::EphemeronChunkKind) {
+    gc->recordEphemeronChunk(cell);
+    return;
+  }
   visitor.visitWithinRange(
       cell, gc->metaTable_[static_cast<size_t>(vt->kind)], begin, end);
   if (Acceptor::shouldMarkWeak) {
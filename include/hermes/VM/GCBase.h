@@ -30,6 +30,7 @@
 #include "hermes/VM/VTable.h"
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/ErrorHandling.h"
 
 #include <cassert>
@@ -44,6 +45,7 @@
 namespace hermes {
 namespace vm {
 
+class EphemeronChunk;
 class GCCell;
 
 // A specific GC class extend GCBase, and override its virtual functions.
@@ -82,6 +84,20 @@ class GCCell;
 /// Force a garbage collection cycle.
 ///   void collect();
 ///
+/// Do the collection work which is expected to complete by \p deadline, if
+/// any, for example while the embedder is idle.  Return the number of bytes
+/// by which it increased the free space of the heap.
+///   size_t collectWhileIdle(TimePoint deadline);
+///
+/// Give memory back in response to memory pressure of the given \p level:
+/// collect, and release the memory the heap does not need.  Return the number
+/// of bytes of the heap that were freed.
+///   size_t handleMemoryPressure(MemoryPressureLevel level);
+///
+/// Call \p callback with every cell of the heap, which may include cells that
+/// have become unreachable since the last collection.
+///   void forAllObjs(const std::function<void(GCCell *)> &callback);
+///
 /// The maximum size of any one allocation allowable by the GC in any state.
 ///   static constexpr uint32_t maxAllocationSize();
 ///
@@ -381,6 +397,20 @@ class GCBase {
   /// objects exist, their sizes, and what they point to.
   virtual void createSnapshot(llvm::raw_ostream &os, bool compact) = 0;
 
+  /// Creates a snapshot of the heap in the compact binary format of
+  /// BinaryHeapSnapshot, which is written as the heap is walked.
+  /// \return false if this GC does not support binary snapshots.
+  virtual bool createBinarySnapshot(llvm::raw_ostream &os) {
+    return false;
+  }
+  /// Creates a binary snapshot of the heap and writes it to the open file
+  /// descriptor \p fd, which is left open.  Only a bounded buffer is used.
+  /// \return true on success, false on failure.
+  bool createBinarySnapshotToFD(int fd);
+  /// Creates a binary snapshot of the heap and writes it to the given
+  /// \p fileName.  \return true on success, false on failure.
+  bool createBinarySnapshotToFile(const std::string &fileName);
+
   /// Default implementations for the external memory credit/debit APIs: do
   /// nothing.
   void creditExternalMemory(GCCell *alloc, uint32_t size) {}
@@ -444,6 +474,11 @@ class GCBase {
       const VTable *vt,
       GC *gc);
 
+  /// Record that the full collection in progress reached the EphemeronChunk
+  /// \p cell, whose entries the marker skipped. Called by \c markCell for
+  /// acceptors that set shouldDeferEphemerons.
+  void recordEphemeronChunk(GCCell *cell);
+
   /// @}
 
   bool inGC() const {
@@ -475,6 +510,15 @@ class GCBase {
       std::chrono::microseconds start,
       std::chrono::microseconds end);
 
+  /// \return whether a collection taking as long as the average of those
+  /// recorded in \p stats is expected to complete by \p deadline.  If no
+  /// collection has been recorded, \return \p ifUnknown, unless the deadline
+  /// has passed.
+  static bool expectedToCompleteBy(
+      const CumulativeHeapStats &stats,
+      TimePoint deadline,
+      bool ifUnknown);
+
 // Mangling scheme used by MSVC encode public/private into the name.
 // As a result, vanilla "ifdef public" trick leads to link errors.
 #if defined(UNIT_TEST) || defined(_MSC_VER)
@@ -518,6 +562,27 @@ class GCBase {
     gcCallbacks_->markWeakRoots(this, acceptor);
   }
 
+  /// Forget the EphemeronChunks recorded so far, to start a full collection.
+  void beginEphemeronMarking();
+
+  /// Call \p markValue on the value of every entry of the recorded
+  /// EphemeronChunks whose key \p isMarked, unless the value is an object
+  /// which is already marked. \p markValue may record more chunks, which are
+  /// visited as well.
+  /// \return true if any object was marked, in which case more keys may have
+  ///   become reachable and the caller should call this again.
+  bool markEphemeronValues(
+      llvm::function_ref<bool(GCCell *)> isMarked,
+      llvm::function_ref<void(HermesValue &)> markValue);
+
+  /// Clear the entries of the recorded EphemeronChunks whose keys are not
+  /// marked according to \p isMarked, then forget the chunks. The key and the
+  /// value of every remaining entry are passed to \p updateLive, for GCs which
+  /// need to update them.
+  void clearUnreachableEphemerons(
+      llvm::function_ref<bool(GCCell *)> isMarked,
+      llvm::function_ref<void(HermesValue &)> updateLive);
+
   /// Print the cumulative statistics.
   /// \p os The output stream to print the stats to.
   /// \p trailingComma true if the end of the JSON string should have a trailing
@@ -555,6 +620,13 @@ class GCBase {
   /// Number of finalized objects in the last collection.
   unsigned numFinalizedObjects_{0};
 
+  /// The EphemeronChunks reached by the full collection in progress.
+  std::vector<EphemeronChunk *> ephemeronChunks_;
+
+  /// Identifies the full collection in progress to the EphemeronChunks, so
+  /// that each one is recorded once. Never zero while marking.
+  uint32_t ephemeronEpoch_{0};
+
   /// The total number of bytes allocated in the execution.
   uint64_t totalAllocatedBytes_{0};
 
@@ -54,6 +54,12 @@ class GCCell {
   GCCell(const GCCell &) = delete;
   void operator=(const GCCell &) = delete;
 
+  /// Finish setting up a cell whose bytes were copied verbatim from a cell in
+  /// another heap into memory allocated by \p gc. Like the constructors, this
+  /// assigns a new allocation ID and reports the allocation to the memory
+  /// profiler.
+  void initAfterCopy(GC *gc);
+
   /// Return the allocated size of the object in bytes.
   uint32_t getAllocatedSize() const;
 
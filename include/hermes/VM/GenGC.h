@@ -177,6 +177,21 @@ class GenGC final : public GCBase {
   /// compaction is within each generation separately).
   void collect();
 
+  /// Do a full collection if the previous ones suggest that it will complete
+  /// by \p deadline.
+  /// (Part of general GC API defined in GC.h).
+  /// \return the number of bytes it freed.
+  size_t collectWhileIdle(TimePoint deadline);
+
+  /// Do a full collection, which is all this GC can do to give back memory.
+  /// (Part of general GC API defined in GC.h).
+  /// \return the number of bytes it freed.
+  size_t handleMemoryPressure(MemoryPressureLevel level);
+
+  /// Iterate over all objects in the heap.
+  /// (Part of general GC API defined in GC.h).
+  void forAllObjs(const std::function<void(GCCell *)> &callback);
+
   static constexpr uint32_t maxAllocationSize() {
     // GenGC imposes no limit on individual allocations.
     return std::numeric_limits<uint32_t>::max();
@@ -469,6 +484,11 @@ class GenGC final : public GCBase {
   /// close the mark bits.
   void completeMarking();
 
+  /// Mark the values of the ephemerons whose keys were reached by
+  /// completeMarking, and what they reach in turn, until no more keys become
+  /// reachable. Then clear the ephemerons whose keys are unreachable.
+  void completeEphemeronMarking();
+
   /// Does any work necessary for GC stats at the end of collection.
   /// Returns the number of allocated objects before collection starts.
   /// (In optimized builds, does nothing, and returns zero.)
@@ -23,6 +23,7 @@
 #include "hermes/VM/GCPointer.h"
 #include "hermes/VM/GCSegmentAddressIndex.h"
 #include "hermes/VM/HermesValue.h"
+#include "hermes/VM/LargeObjectSpace.h"
 #include "hermes/VM/LogFailStorageProvider.h"
 #include "hermes/VM/OldGenNC.h"
 #include "hermes/VM/SweepResultNC.h"
@@ -56,6 +57,10 @@ class WeakRef;
 /// The old generation is also a single contiguous-allocation space,
 /// but it is collected using mark-sweep-compact.  (Actually, a full
 /// collection collects both generations.)
+///
+/// Variable-sized cells too large to fit in a segment are allocated in a
+/// LargeObjectSpace.  They are marked with the rest of the heap
+/// but never moved, and are charged to the old generation.
 class GenGC final : public GCBase {
  public:
   class Size final {
@@ -170,11 +175,14 @@ class GenGC final : public GCBase {
 
   /// The given value is being written at the given loc (required to
   /// be in the heap).  If value is a pointer, execute a write barrier.
-  void writeBarrier(void *loc, HermesValue value);
+  /// Stores into the young generation, which include all the initializing
+  /// stores into freshly allocated objects, are filtered inline; only the
+  /// others call out to writeBarrierImpl.
+  inline void writeBarrier(void *loc, HermesValue value);
 
   /// The given pointer value is being written at the given loc (required to
   /// be in the heap).  The value is may be null.  Execute a write barrier.
-  void writeBarrier(void *loc, void *value);
+  inline void writeBarrier(void *loc, void *value);
 
 #ifndef NDEBUG
   /// Count the number of barriers executed.
@@ -183,10 +191,10 @@ class GenGC final : public GCBase {
   /// index indicates the number of write barrier calls of the kind
   /// indicated by the first index that get past a "filter level"
   /// indicated by the second index.  The HermesValue case has a test
-  /// not done for the void* case; this is index 1, and is unused in
+  /// not done for the void* case; this is index 2, and is unused in
   /// the void* case.  We introduce symbolic names for those indices
   /// below (they must be defined in non-debug builds).
-  static constexpr unsigned kNumFilterLevels = 4;
+  static constexpr unsigned kNumFilterLevels = 5;
   /// Note; the initializer of this array initializes all elements to zero.
   uint64_t numWriteBarriers_[2][kNumFilterLevels] = {{0}, { 0 }};
   uint64_t numRangeBarriers_{0};
@@ -213,23 +221,24 @@ class GenGC final : public GCBase {
 
   /// Symbolic constants for indexing numWriteBarriers_.
   static constexpr unsigned kNumWriteBarrierTotalCountIdx = 0;
-  static constexpr unsigned kNumWriteBarrierOfObjectPtrIdx = 1;
-  static constexpr unsigned kNumWriteBarrierWithDifferentSegsIdx = 2;
-  static constexpr unsigned kNumWriteBarrierPtrInYGIdx = 3;
+  static constexpr unsigned kNumWriteBarrierLocOutsideYGIdx = 1;
+  static constexpr unsigned kNumWriteBarrierOfObjectPtrIdx = 2;
+  static constexpr unsigned kNumWriteBarrierWithDifferentSegsIdx = 3;
+  static constexpr unsigned kNumWriteBarrierPtrInYGIdx = 4;
 
   /// We copied HermesValues into the given region.  Note that \p numHVs is
   /// the number of HermesValues in the the range, not the char length.
   /// Do any necessary barriers.
   ///
   /// \pre The range described must be wholly contained within one segment of
-  ///     the heap.
+  ///     the heap, or one large object.
   void writeBarrierRange(HermesValue *start, uint32_t numHVs);
 
   /// We filled numHVs slots starting at start with the given value.
   /// Do any necessary barriers.
   ///
   /// \pre The range described must be wholly contained within one segment of
-  ///     the heap.
+  ///     the heap, or one large object.
   void
   writeBarrierRangeFill(HermesValue *start, uint32_t numHVs, HermesValue value);
 
@@ -244,10 +253,26 @@ class GenGC final : public GCBase {
   ///     result of this collection.
   void collect(bool canEffectiveOOM = false);
 
+  /// Do the collection work which is expected to complete by \p deadline,
+  /// judging by the durations of previous collections of the same kind.  This
+  /// is a young-gen collection, if the young gen holds anything, followed by a
+  /// full collection if the old gen could not otherwise take a worst-case
+  /// promotion of the next young-gen collection.
+  /// (Part of general GC API defined in GC.h).
+  /// \return the number of bytes by which the free space of the heap grew.
+  size_t collectWhileIdle(TimePoint deadline);
+
+  /// Do a full collection which compacts the old gen, even in mark-region
+  /// mode, and return the pages of the heap that are not in use to the OS.
+  /// At the Critical \p level, also shrink the heap, and thus the young gen,
+  /// to the minimum size that its live data allows.
+  /// (Part of general GC API defined in GC.h).
+  /// \return the number of bytes of the heap that were freed.
+  size_t handleMemoryPressure(MemoryPressureLevel level);
+
   static constexpr uint32_t maxAllocationSize() {
-    // The largest allocation allowable in NCGen is the max size a single
-    // segment supports.
-    return AlignedHeapSegment::maxSize();
+    // Cells larger than a segment are allocated in the large object space.
+    return LargeObjectSpace::kMaxCellSize;
   }
 
   /// The occupancy target guides heap sizing -- the fraction of the heap
@@ -319,6 +344,10 @@ class GenGC final : public GCBase {
   /// objects exist, their sizes, and what they point to.
   virtual void createSnapshot(llvm::raw_ostream &os, bool compact) override;
 
+  /// Creates a snapshot of the heap in the binary format of
+  /// BinaryHeapSnapshot.
+  virtual bool createBinarySnapshot(llvm::raw_ostream &os) override;
+
   /// Returns the number of bytes allocated allocated since the last GC.
   gcheapsize_t bytesAllocatedSinceLastGC() const override;
 
@@ -330,7 +359,8 @@ class GenGC final : public GCBase {
 
   // Stats maintainence.
 
-  /// For testing purposes the ability to iterate over all objects in the heap.
+  /// Iterate over all objects in the heap.
+  /// (Part of general GC API defined in GC.h).
   void forAllObjs(const std::function<void(GCCell *)> &callback);
 
 #ifndef NDEBUG
@@ -457,12 +487,17 @@ class GenGC final : public GCBase {
   /// arguments.
   void *allocSlow(uint32_t sz, bool fixedSize, HasFinalizer hasFinalizer);
 
+  /// Allocate a cell of \p sz bytes in the large object space, collecting
+  /// first if the old generation doesn't have room for it.
+  void *allocLarge(uint32_t sz, HasFinalizer hasFinalizer);
+
   /// The given pointer value is being written at the given loc (required to
   /// be in the heap).  The value is may be null.  Execute a write
   /// barrier.  The \p hv argument indicates whether this is being
   /// called from the HV (true) or void* (false) version of the write
   /// barrier; this is used only in debug builds, for statistics.
-  inline void writeBarrierImpl(void *loc, void *value, bool hv);
+  /// Requires that \p loc is not in the young generation.
+  void writeBarrierImpl(void *loc, void *value, bool hv);
 
   /// Returns the desired heap size for the given number of used bytes --
   /// determined by the occupancyTarget() ratio and the max heap size
@@ -563,6 +598,15 @@ class GenGC final : public GCBase {
     AllocContextYieldThenClaim yielder_;
   };
 
+  /// Write the nodes, then the edges, of the heap graph to \p snap, which is
+  /// a V8HeapSnapshot or a BinaryHeapSnapshot.  \p stringToID gives the
+  /// string IDs of the names of the nodes and edges.
+  template <typename Snapshot>
+  void writeSnapshotGraph(
+      Snapshot &snap,
+      const std::function<V8HeapSnapshot::StringID(llvm::StringRef)>
+          &stringToID);
+
 #ifndef NDEBUG
   /// Traverse the generations, adding the GC cells allocated since
   /// the last GC to the alloc-tracking histogram.
@@ -631,6 +675,24 @@ class GenGC final : public GCBase {
   /// the chunks used during compaction.
   void compact(const SweepResult &sweepResult);
 
+  /// In mark-region mode, reclaim the dead cells of the old gen without
+  /// moving the live ones (see OldGen::sweepInPlace).  \return false, leaving
+  /// the heap to be compacted, if too much of the old gen was dead, which
+  /// makes compacting it worthwhile, or if the live cells of the young gen
+  /// might not fit in what is left of it.
+  bool sweepOldGenInPlace();
+
+  /// Complete a full collection after sweepOldGenInPlace() succeeded: clear
+  /// the weak references to dead cells, and evacuate the young gen into the
+  /// old gen.  \return the number of allocated objects before collection,
+  /// like recordStatsNC().
+  unsigned evacuateYoungGenAfterInPlaceSweep();
+
+  /// If the last full collection left the live cells of the old gen in place,
+  /// do another one that compacts them, for an allocation which may not fit
+  /// in the space it left.  \return whether it collected.
+  bool compactAfterInPlaceCollection();
+
   /// Helper routines used by marking:
 
   /// Complete the marking phase: after marking from roots has set mark
@@ -638,6 +700,11 @@ class GenGC final : public GCBase {
   /// close the mark bits.
   void completeMarking();
 
+  /// Mark the values of the ephemerons whose keys were reached by
+  /// completeMarking, and what they reach in turn, until no more keys become
+  /// reachable. Then clear the ephemerons whose keys are unreachable.
+  void completeEphemeronMarking();
+
   /// Does any work necessary for GC stats at the end of collection.
   /// Returns the number of allocated objects before collection starts.
   /// (In optimized builds, does nothing, and returns zero.)
@@ -718,6 +785,15 @@ class GenGC final : public GCBase {
   /// This version uses internal mark bits.
   void updateWeakReference(WeakRefSlot *slot, bool fullGC);
 
+  /// Like updateWeakReferences(true), in a full collection that did not move
+  /// the cells: clear the pointers of freed objects, free the weak slots that
+  /// are no longer in use, and unmark the others.
+  void updateWeakReferencesInPlace();
+
+  /// Remove the slots whose values no longer point into the young gen from
+  /// weakRefSlotsWithPossibleYoungReferent_.
+  void filterWeakRefSlotsWithPossibleYoungReferent();
+
   /// Set all the marked weak references to unmarked.
   void unmarkWeakReferences();
 
@@ -761,6 +837,9 @@ class GenGC final : public GCBase {
   YoungGen youngGen_;
   OldGen oldGen_;
 
+  /// The cells too large for the segments of the generations.
+  LargeObjectSpace largeObjects_;
+
   /// The current allocation context: what segment we are allocating
   /// into, where to accumulate finalizable objects, the count of
   /// allocated objects.  Should be valid when allocating.  When doing
@@ -775,6 +854,21 @@ class GenGC final : public GCBase {
   /// allocation (if had been doing OG allocation).
   const bool revertToYGAtTTI_;
 
+  /// Whether full collections try to leave the live cells of the old gen in
+  /// place (see GCConfig::getOldGenMarkRegion).
+  const bool oldGenMarkRegion_;
+
+  /// Whether the last full collection left the live cells of the old gen in
+  /// place.
+  bool lastFullCollectionInPlace_{false};
+
+  /// Set to make the next full collection compact the old gen.
+  bool forceCompaction_{false};
+
+  /// A full collection in mark-region mode compacts the old gen when more
+  /// than this fraction of the space up to its level is dead.
+  static constexpr double kMaxInPlaceDeadFraction = 0.5;
+
 #ifndef NDEBUG
   bool allocInYoung_{true};
 #endif
@@ -834,6 +928,10 @@ class GenGC final : public GCBase {
   double sweepSecs_ = 0.0;
   double updateReferencesSecs_ = 0.0;
   double compactSecs_ = 0.0;
+  double evacuateYoungSecs_ = 0.0;
+
+  /// The number of full collections that left the old gen's cells in place.
+  unsigned numInPlaceCollections_ = 0;
 
   /// The sum of the pre-collection sizes of the heap before/after
   /// full collections.
@@ -866,6 +964,10 @@ inline void *GenGC::alloc(uint32_t sz) {
     collect();
   }
 
+  if (!fixedSize && LLVM_UNLIKELY(sz >= LargeObjectSpace::kMinCellSize)) {
+    return allocLarge(sz, hasFinalizer);
+  }
+
 #ifdef HERMESVM_GC_GENERATIONAL_MARKSWEEPCOMPACT
   AllocResult res = oldGen_.alloc(sz, hasFinalizer);
   assert(res.success && "Should never fail to allocate at the top level");
@@ -897,6 +999,9 @@ inline void *GenGC::allocLongLived(uint32_t size) {
     // is almost as good.
     collect();
   }
+  if (LLVM_UNLIKELY(size >= LargeObjectSpace::kMinCellSize)) {
+    return allocLarge(size, hasFinalizer);
+  }
   AllocResult res;
   if (allocContextFromYG_) {
     res = oldGen_.alloc(size, hasFinalizer);
@@ -960,24 +1065,26 @@ const GCSegmentAddressIndex &GenGC::segmentIndex() const {
 }
 #endif // UNIT_TEST
 
-inline void GenGC::writeBarrierImpl(void *loc, void *value, bool hv) {
-  HERMES_SLOW_ASSERT(dbgContains(loc));
-
-  char *locPtr = reinterpret_cast<char *>(loc);
-
-  // value may be null.  But if that occurs: locPtr and value will not
-  // be in the same AlignedStorage, so the first test below will fail,
-  // and we will not return early.  But youngGen_.contains(value) will
-  // fail, so we will (correctly) not dirty the card for loc.
-  HERMES_SLOW_ASSERT(value == nullptr || dbgContains(value));
-  if (AlignedStorage::containedInSame(locPtr, value)) {
+inline void GenGC::writeBarrier(void *loc, HermesValue value) {
+  countWriteBarrier(/*hv*/ true, kNumWriteBarrierTotalCountIdx);
+  if (youngGen_.contains(loc)) {
+    return;
+  }
+  countWriteBarrier(/*hv*/ true, kNumWriteBarrierLocOutsideYGIdx);
+  if (!value.isPointer()) {
     return;
   }
-  countWriteBarrier(hv, kNumWriteBarrierWithDifferentSegsIdx);
-  if (youngGen_.contains(value)) {
-    countWriteBarrier(hv, kNumWriteBarrierPtrInYGIdx);
-    AlignedHeapSegment::cardTableCovering(locPtr)->dirtyCardForAddress(locPtr);
+  countWriteBarrier(/*hv*/ true, kNumWriteBarrierOfObjectPtrIdx);
+  writeBarrierImpl(loc, value.getPointer(), /*hv*/ true);
+}
+
+inline void GenGC::writeBarrier(void *loc, void *value) {
+  countWriteBarrier(/*hv*/ false, kNumWriteBarrierTotalCountIdx);
+  if (youngGen_.contains(loc)) {
+    return;
   }
+  countWriteBarrier(/*hv*/ false, kNumWriteBarrierLocOutsideYGIdx);
+  writeBarrierImpl(loc, value, /*hv*/ false);
 }
 
 inline bool GenGC::allocContextClaimed() const {
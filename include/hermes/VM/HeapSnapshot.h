@@ -14,6 +14,7 @@
 #include "hermes/VM/StringRefUtils.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -284,6 +285,88 @@ class V8HeapSnapshot {
   static uint32_t nodeTypeIndex(Node::Type);
 };
 
+/// A serialization formatter for a heap snapshot in a compact binary format,
+/// which holds the same graph as a V8HeapSnapshot but is much smaller and
+/// faster to write, and can be converted to it offline with
+/// convertBinaryHeapSnapshot.  It is written as it goes, in memory bounded
+/// independently of the size of the heap.
+///
+/// The format is a magic number and a version, followed by records which each
+/// start with a RecordTag byte.  Numbers are LEB128 varints: unsigned unless
+/// noted.
+///   String: length, UTF-8 bytes.  Strings are numbered from 0 in the order
+///     they are written, and are written before they are used.
+///   Node: type, name, signed delta of the id from the previous node's,
+///     self size, edge count.
+///   Edge: (type << 1) | named, name or index, signed delta of the target
+///     node id from the previous edge's.
+///   End: terminates the snapshot.
+/// All the nodes are written before the edges, and the edges of each node are
+/// written in the order of the nodes.
+class BinaryHeapSnapshot {
+ public:
+  using StringID = V8HeapSnapshot::StringID;
+  using Node = V8HeapSnapshot::Node;
+  using Edge = V8HeapSnapshot::Edge;
+
+  static constexpr char magic[4] = {'H', 'B', 'H', 'S'};
+  static constexpr uint32_t version = 1;
+
+  enum class RecordTag : uint8_t { String = 1, Node, Edge, End };
+
+  /// Writes the header to \p os.
+  explicit BinaryHeapSnapshot(llvm::raw_ostream &os);
+
+  /// NOTE: this destructor writes to \p os.
+  ~BinaryHeapSnapshot();
+
+  void beginNodes();
+  void addNode(Node &&node);
+  void endNodes();
+
+  void beginEdges();
+  void addEdge(Edge &&edge);
+  void endEdges();
+
+  /// \return the ID of \p str, writing it if it wasn't written recently.
+  /// Only recently used strings are remembered, to bound the memory, so a
+  /// string may be written more than once.
+  StringID addString(llvm::StringRef str);
+
+ private:
+  /// Maximum number of bytes of strings remembered by addString.
+  static constexpr size_t kMaxRememberedStringBytes = 1 << 22;
+
+  llvm::raw_ostream &os_;
+  bool inNodes_{false};
+  bool inEdges_{false};
+
+  /// The id of the last node written, which the next one is relative to.
+  Node::ID lastNodeID_{0};
+  /// The target of the last edge written, which the next one is relative to.
+  Node::ID lastEdgeTarget_{0};
+
+  /// The ID of the next string to write.
+  StringID nextStringID_{0};
+  /// The strings which were written since the last time this was cleared.
+  llvm::StringMap<StringID> stringIDs_;
+  /// The number of bytes of the strings in stringIDs_.
+  size_t rememberedStringBytes_{0};
+
+  void writeTag(RecordTag tag) {
+    os_ << static_cast<char>(tag);
+  }
+};
+
+/// Convert the binary heap snapshot in \p input, written by a
+/// BinaryHeapSnapshot, to a V8 heap snapshot written to \p json.
+/// \return true on success, or false with a description of the problem in
+/// \p error if the input is malformed.
+bool convertBinaryHeapSnapshot(
+    llvm::StringRef input,
+    JSONEmitter &json,
+    std::string &error);
+
 } // namespace vm
 } // namespace hermes
 
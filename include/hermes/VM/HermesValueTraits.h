@@ -59,8 +59,9 @@ HERMES_VM_GCOBJECT(JSError);
 HERMES_VM_GCOBJECT(JSGenerator);
 HERMES_VM_GCOBJECT(Domain);
 HERMES_VM_GCOBJECT(RequireContext);
-HERMES_VM_GCOBJECT(HashMapEntry);
+HERMES_VM_GCOBJECT(OrderedHashTable);
 HERMES_VM_GCOBJECT(OrderedHashMap);
+HERMES_VM_GCOBJECT(EphemeronChunk);
 HERMES_VM_GCOBJECT(JSWeakMapImplBase);
 HERMES_VM_GCOBJECT(JSArrayIterator);
 HERMES_VM_GCOBJECT(JSStringIterator);
@@ -115,6 +115,7 @@ struct ClassFlags {
 /// (except the first time).
 class HiddenClass final : public GCCell {
   friend void HiddenClassBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+  friend class RuntimeImage;
 
  public:
   /// Adding more than this number of properties will switch to "dictionary
@@ -174,6 +175,12 @@ class HiddenClass final : public GCCell {
     forInCache_ = nullptr;
   }
 
+  /// Free the for-in cache and the property map of this class, if they can be
+  /// recreated when they are next needed.  The property map of a class in
+  /// dictionary mode, or descending from an orphan class, is the only record
+  /// of its properties, and is kept.
+  void clearRecreatableCaches(Runtime *runtime);
+
   /// An opaque class representing a reference to a valid property in the
   /// property map.
   using PropertyPos = DictPropertyMap::PropertyPos;
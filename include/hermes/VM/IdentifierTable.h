@@ -70,6 +70,20 @@ class IdentifierTable {
   /// Initialize the identifier table.
   IdentifierTable();
 
+  /// Replace the contents of this table with a copy of \p other. The string
+  /// primitives referenced by the entries are not copied; if they live in
+  /// another heap, the caller must redirect them to copies in this runtime's
+  /// heap before the next GC.
+  IdentifierTable &operator=(const IdentifierTable &other);
+
+  /// Extend the table with empty entries up to \p end, without making them
+  /// available for new identifiers. This allows the GC to mark SymbolIDs below
+  /// \p end held by cells before the table itself has been populated.
+  void reserveSymbolIDs(uint32_t end) {
+    if (lookupVector_.size() < end)
+      lookupVector_.resize(end);
+  }
+
   /// Given a UTF16 string \p str, retrieve a unique SymbolID for that
   /// string.
   /// If the SymbolID for a string has been previously requested,
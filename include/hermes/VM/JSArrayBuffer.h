@@ -25,6 +25,10 @@ class JSArrayBuffer final : public JSObject {
   // amount is larger than the native platform's `size_t`
   using size_type = std::size_t;
 
+  /// The function called to release an external data block, with the context
+  /// passed to setExternalDataBlock().
+  using FinalizeDataBlockPtr = void (*)(void *context);
+
   static ObjectVTable vt;
 
   static bool classof(const GCCell *cell) {
@@ -60,6 +64,24 @@ class JSArrayBuffer final : public JSObject {
   ExecutionStatus
   createDataBlock(Runtime *runtime, size_type size, bool zero = true);
 
+  /// Make this JSArrayBuffer use the \p size bytes at \p data, which are
+  /// owned by the caller, replacing the currently used data block. They are
+  /// neither copied nor charged to the GC heap. \p finalize is called with
+  /// \p context when the block is released: when the buffer is detached, and
+  /// at the latest when it is finalized.
+  void setExternalDataBlock(
+      Runtime *runtime,
+      char *data,
+      size_type size,
+      void *context,
+      FinalizeDataBlockPtr finalize);
+
+  /// \return whether the data block is owned by someone else, see
+  /// setExternalDataBlock().
+  bool isExternal() const {
+    return externalFinalize_ != nullptr;
+  }
+
   /// Retrieves a pointer to the held buffer.
   /// \return A pointer to the buffer owned by this object. This can be null
   ///   if the ArrayBuffer is empty.
@@ -82,8 +104,9 @@ class JSArrayBuffer final : public JSObject {
   }
 
   /// Detaches this buffer from its data block, effectively freeing the storage
-  /// and setting this ArrayBuffer to have zero size.  The \p gc argument allows
-  /// the GC to be informed of this external memory deletion.
+  /// (or releasing an external block) and setting this ArrayBuffer to have
+  /// zero size.  The \p gc argument allows the GC to be informed of this
+  /// external memory deletion.
   void detach(GC *gc);
 
   /// If the given cell is a JSArrayBuffer, returns the size of its
@@ -98,6 +121,10 @@ class JSArrayBuffer final : public JSObject {
   char *data_;
   size_type size_;
   bool attached_;
+  /// If non-null, data_ is an external block which is released by calling
+  /// this with externalContext_.
+  FinalizeDataBlockPtr externalFinalize_{nullptr};
+  void *externalContext_{nullptr};
 
   JSArrayBuffer(Runtime *runtime, JSObject *parent, HiddenClass *clazz);
 
@@ -109,7 +136,7 @@ inline uint32_t JSArrayBuffer::externalMemorySize(const GCCell *cell) {
   // TODO (T27363944): a more general way of doing this, if we ever have more
   // gc kinds with external memory charges.
   if (const auto asJSArrayBuffer = dyn_vmcast<JSArrayBuffer>(cell)) {
-    return asJSArrayBuffer->size();
+    return asJSArrayBuffer->isExternal() ? 0 : asJSArrayBuffer->size();
   } else {
     return 0;
   }
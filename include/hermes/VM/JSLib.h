@@ -16,6 +16,9 @@
 #include "hermes/VM/Domain.h"
 #include "hermes/VM/Handle.h"
 #include "hermes/VM/HermesValue.h"
+#include "hermes/VM/SymbolID.h"
+
+#include "llvm/ADT/Optional.h"
 
 #include <memory>
 
@@ -26,8 +29,18 @@ namespace vm {
 class Runtime;
 struct RuntimeCommonStorage;
 
+enum class LazyBuiltins : uint8_t;
+
 void initGlobalObject(Runtime *runtime);
 
+/// Create the builtins of \p group, whose creation has been deferred by
+/// initGlobalObject().
+void createLazyBuiltins(Runtime *runtime, LazyBuiltins group);
+
+/// \return the group of builtins which defines the global property \p name,
+/// or llvm::None if \p name isn't defined by a group which can be deferred.
+llvm::Optional<LazyBuiltins> getLazyBuiltinsOfGlobal(SymbolID name);
+
 std::shared_ptr<RuntimeCommonStorage> createRuntimeCommonStorage();
 
 /// eval() entry point. Evaluate the given source \p utf8code within the given
@@ -54,9 +54,9 @@ class JSMapImpl final : public JSObject {
     return static_cast<bool>(storage_);
   }
 
-  /// Advance iterator and return the next.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry) {
-    return storage_.get(runtime)->iteratorNext(runtime, entry);
+  /// \return the table a new iteration starts from.
+  OrderedHashTable *iterationTable(Runtime *runtime) {
+    return storage_.get(runtime)->getTable(runtime);
   }
 
   /// Add a value.
@@ -102,9 +102,10 @@ class JSMapImpl final : public JSObject {
   }
 
   /// Clear all elements from the storage.
-  static void clear(Handle<JSMapImpl> self, Runtime *runtime) {
+  static ExecutionStatus clear(Handle<JSMapImpl> self, Runtime *runtime) {
     self->assertInitialized();
-    self->storage_.get(runtime)->clear(runtime);
+    return OrderedHashMap::clear(
+        runtime->makeHandle<OrderedHashMap>(self->storage_), runtime);
   }
 
   /// Call \p callbackfn for each entry, with \p thisArg as this.
@@ -114,12 +115,17 @@ class JSMapImpl final : public JSObject {
       Handle<Callable> callbackfn,
       Handle<> thisArg) {
     self->assertInitialized();
-    MutableHandle<HashMapEntry> entry{runtime};
-    for (entry = self->storage_.get(runtime)->iteratorNext(runtime); entry;
-         entry =
-             self->storage_.get(runtime)->iteratorNext(runtime, entry.get())) {
-      HermesValue key = entry->key;
-      HermesValue value = entry->value;
+    MutableHandle<OrderedHashTable> table{runtime,
+                                          self->iterationTable(runtime)};
+    for (OrderedHashMap::size_type index = 0;; ++index) {
+      OrderedHashTable *current = table.get();
+      index = OrderedHashMap::iteratorNext(runtime, current, index);
+      if (index == OrderedHashTable::kEnd) {
+        break;
+      }
+      table = current;
+      HermesValue key = current->key(index);
+      HermesValue value = current->value(index);
       assert(!key.isEmpty() && "Invalid key encountered");
       assert(!value.isEmpty() && "Invalid value encountered");
       if (LLVM_UNLIKELY(
@@ -187,6 +193,9 @@ class JSMapIteratorImpl final : public JSObject {
       Handle<JSMapImpl<JSMapTypeTraits<C>::ContainerKind>> data,
       IterationKind kind) {
     data_.set(runtime, data.get(), &runtime->getHeap());
+    itrTable_.set(
+        runtime, data->iterationTable(runtime), &runtime->getHeap());
+    itrIndex_ = 0;
     iterationKind_ = kind;
 
     assert(data_ && "Invalid storage data");
@@ -208,18 +217,18 @@ class JSMapIteratorImpl final : public JSObject {
       // Iteration has not yet reached the end previously.
       assert(self->data_ && "Storage uninitialized");
       // Advance the iterator.
-      self->itr_.set(
-          runtime,
-          self->data_.get(runtime)->iteratorNext(
-              runtime, self->itr_.get(runtime)),
-          &runtime->getHeap());
-      if (self->itr_) {
+      OrderedHashTable *table = self->itrTable_.get(runtime);
+      auto index =
+          OrderedHashMap::iteratorNext(runtime, table, self->itrIndex_);
+      if (index != OrderedHashTable::kEnd) {
+        self->itrTable_.set(runtime, table, &runtime->getHeap());
+        self->itrIndex_ = index + 1;
         switch (self->iterationKind_) {
           case IterationKind::Key:
-            value = self->itr_.get(runtime)->key;
+            value = table->key(index);
             break;
           case IterationKind::Value:
-            value = self->itr_.get(runtime)->value;
+            value = table->value(index);
             break;
           case IterationKind::Entry: {
             // If we are iterating both key and value, we need to create an
@@ -229,9 +238,9 @@ class JSMapIteratorImpl final : public JSObject {
               return ExecutionStatus::EXCEPTION;
             }
             auto arrHandle = toHandle(runtime, std::move(*arrRes));
-            value = self->itr_.get(runtime)->key;
+            value = self->itrTable_.get(runtime)->key(index);
             JSArray::setElementAt(arrHandle, runtime, 0, value);
-            value = self->itr_.get(runtime)->value;
+            value = self->itrTable_.get(runtime)->value(index);
             JSArray::setElementAt(arrHandle, runtime, 1, value);
             value = arrHandle.getHermesValue();
             break;
@@ -242,6 +251,7 @@ class JSMapIteratorImpl final : public JSObject {
         // reached the end.
         self->iterationFinished_ = true;
         self->data_ = nullptr;
+        self->itrTable_ = nullptr;
       }
     }
     return createIterResultObject(runtime, value, self->iterationFinished_)
@@ -262,8 +272,12 @@ class JSMapIteratorImpl final : public JSObject {
   /// initialized or the iteration has ended.
   GCPointer<JSMapImpl<JSMapTypeTraits<C>::ContainerKind>> data_{nullptr};
 
-  /// Iteration pointer to the element storage in the Map.
-  GCPointer<HashMapEntry> itr_{nullptr};
+  /// The table of the Map the iteration is in. nullptr once the iteration
+  /// has ended.
+  GCPointer<OrderedHashTable> itrTable_{nullptr};
+
+  /// The index in itrTable_ of the next entry to visit.
+  OrderedHashTable::size_type itrIndex_{0};
 
   IterationKind iterationKind_;
 
@@ -119,6 +119,8 @@ struct ObjectFlags {
 
   /// this is lazily created object that must be initialized before it can be
   /// used. Note that lazy objects must have no properties defined on them,
+  /// except for the global object, which is lazy while some of the builtins
+  /// it defines haven't been created.
   uint32_t lazyObject : 1;
 
   static constexpr unsigned kHashWidth = 25;
@@ -389,6 +391,12 @@ class JSObject : public GCCell {
     return flags_.lazyObject;
   }
 
+  /// Set whether this object is lazy. Only the global object is made lazy
+  /// this way, when the creation of some builtins is deferred.
+  void setLazy(bool lazy) {
+    flags_.lazyObject = lazy;
+  }
+
   /// \return true if this is a HostObject.
   bool isHostObject() const {
     return flags_.hostObject;
@@ -415,6 +423,15 @@ class JSObject : public GCCell {
       Runtime *runtime,
       Handle<JSObject> lazyObject);
 
+  /// Initialize the lazy object \p lazyObject enough for its own property
+  /// \p name to exist, if it has one. Lazy functions are fully initialized,
+  /// while the global object only creates the builtins defining \p name.
+  /// \return true if properties may have been added to \p lazyObject.
+  static bool initializeLazyProperty(
+      Runtime *runtime,
+      Handle<JSObject> lazyObject,
+      SymbolID name);
+
   /// Get the objectID, which must already have been assigned using \c
   /// getObjectID().
   ObjectID getAlreadyAssignedObjectID() const {
@@ -890,7 +907,7 @@ class JSObject : public GCCell {
   static void freeze(Handle<JSObject> selfHandle, Runtime *runtime);
   /// ES5.1 15.2.3.10.
   /// Set [[Extensible]] to false, preventing adding more properties.
-  static void preventExtensions(JSObject *self);
+  static void preventExtensions(Handle<JSObject> selfHandle, Runtime *runtime);
 
   /// ES5.1 15.2.3.11.
   /// No properties are configurable.
@@ -7,103 +7,28 @@
 #ifndef HERMES_VM_JSWEAKMAPIMPL_H
 #define HERMES_VM_JSWEAKMAPIMPL_H
 
+#include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/CallResult.h"
 #include "hermes/VM/CellKind.h"
+#include "hermes/VM/EphemeronChunk.h"
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/Runtime.h"
-#include "hermes/VM/WeakRef.h"
 
 namespace hermes {
 namespace vm {
 
-namespace detail {
-
-/// Used as the key to the DenseMap in JSWeakMapImpl.
-/// Packages the hash with the WeakRef itself.
-/// Uses WeakRefs using invalid locations as slots for empty and tombstone keys.
-struct WeakRefKey {
-  /// Actual weak ref stored as the key.
-  WeakRef<JSObject> ref;
-
-  /// GC-stable hash value of the JSObject pointed to by ref, while it's alive.
-  uint32_t hash;
-
-  WeakRefKey(WeakRef<JSObject> ref, uint32_t hash) : ref(ref), hash(hash) {}
-};
-
-/// Enable using WeakRef<JSObject> in DenseMap.
-struct WeakRefInfo {
- public:
-  /// \return Empty key which is simply null.
-  static inline WeakRefKey getEmptyKey() {
-    return WeakRefKey{
-        WeakRef<JSObject>(reinterpret_cast<WeakRefSlot *>(kEmptyKey)),
-        kEmptyKey};
-  }
-  /// \return Empty key which is simply a pointer to 0x1 - don't dereference.
-  static inline WeakRefKey getTombstoneKey() {
-    return WeakRefKey{
-        WeakRef<JSObject>(reinterpret_cast<WeakRefSlot *>(kTombstoneKey)),
-        kTombstoneKey};
-  }
-  /// \return the hash in \p key.
-  static inline unsigned getHashValue(const WeakRefKey &key) {
-    return key.hash;
-  }
-  /// \return true both arguments are empty, both are tombstone,
-  /// or both point to the same JSObject.
-  static inline bool isEqual(const WeakRefKey &a, const WeakRefKey &b) {
-    const auto *aSlot = a.ref.unsafeGetSlot();
-    const auto *bSlot = b.ref.unsafeGetSlot();
-    // Check if the keys are empty or tombstones, to avoid deferencing them.
-    if (aSlot == bSlot) {
-      return true;
-    }
-    if (reinterpret_cast<uintptr_t>(aSlot) <= kTombstoneKey ||
-        reinterpret_cast<uintptr_t>(bSlot) <= kTombstoneKey) {
-      // aSlot != bSlot and one or both are empty or tombstone.
-      return false;
-    }
-    // Check if the refs are valid.
-    // The underlying object may have been collected already,
-    // but markWeakRefs may not have run at this point.
-    // The value will be cleared on the next GC cycle, but for now,
-    // isValid needs to be checked to avoid an invalid vmcast.
-    return WeakRef<JSObject>::isSlotValid(aSlot) &&
-        WeakRef<JSObject>::isSlotValid(bSlot) &&
-        vmcast<JSObject>(aSlot->value) == vmcast<JSObject>(bSlot->value);
-  }
-
- private:
-  /// The empty key (used as a pointer and a hash).
-  static constexpr uint32_t kEmptyKey = 0;
-
-  /// The tombstone key (used as a pointer and a hash).
-  static constexpr uint32_t kTombstoneKey = 1;
-
-  static_assert(
-      kEmptyKey < kTombstoneKey,
-      "empty key must be less than tombstone key");
-};
-
-} // namespace detail
-
 /// Base implementation of JSWeakMapImpl methods,
 /// used by both WeakMap and WeakSet, with no templating.
 class JSWeakMapImplBase : public JSObject {
   using Super = JSObject;
-  using WeakRefKey = detail::WeakRefKey;
-  using DenseMapT = llvm::DenseMap<WeakRefKey, uint32_t, detail::WeakRefInfo>;
 
  protected:
   JSWeakMapImplBase(
       Runtime *runtime,
       const VTable *vtp,
       JSObject *parent,
-      HiddenClass *clazz,
-      BigStorage *valueStorage)
-      : JSObject(runtime, vtp, parent, clazz),
-        valueStorage_(runtime, valueStorage, &runtime->getHeap()) {}
+      HiddenClass *clazz)
+      : JSObject(runtime, vtp, parent, clazz) {}
 
  public:
   static const ObjectVTable vt;
@@ -146,102 +71,69 @@ class JSWeakMapImplBase : public JSObject {
       Runtime *runtime,
       Handle<JSObject> key);
 
-  /// \return the size of the internal map.
+  /// \return the number of entries in the map.
   /// Used for testing purposes.
-  /// Note: the returned value may differ from the number of reachable keys.
-  static uint32_t debugGetSize(JSWeakMapImplBase *self) {
-    return self->map_.size();
-  }
+  /// Note: entries whose keys became unreachable are only removed by the next
+  /// full collection, so this may exceed the number of reachable keys.
+  static uint32_t debugGetSize(JSWeakMapImplBase *self, PointerBase *base);
 
- protected:
-  static void _finalizeImpl(GCCell *cell, GC *gc) {
-    auto *self = vmcast<JSWeakMapImplBase>(cell);
-    self->~JSWeakMapImplBase();
-  }
+ private:
+  /// Value of lookup() when the key isn't in the map.
+  static constexpr uint32_t kNotFound = UINT32_MAX;
 
-  static void _markWeakImpl(GCCell *cell, GC *gc) {
-    auto *self = vmcast_during_gc<JSWeakMapImplBase>(cell, gc);
-    self->markWeakRefs(gc);
-  }
+  /// Capacity of the smallest non-empty table.
+  static constexpr uint32_t kMinCapacity = 8;
 
-  static size_t _mallocSizeImpl(GCCell *cell) {
-    auto *self = vmcast<JSWeakMapImplBase>(cell);
-    return self->getMallocSize();
-  }
+  /// \return the hash of \p key, assigning it an ID if needed.
+  static uint32_t hashKey(Runtime *runtime, JSObject *key);
 
-  /// \return the number of bytes allocated by this object on the heap.
-  size_t getMallocSize() const {
-    return map_.getMemorySize();
-  }
+  /// \return the chunk holding the entry at \p index.
+  EphemeronChunk *chunkFor(PointerBase *base, uint32_t index) const;
 
-  /// Mark weak references and set hasFreeableSlots_ if invalidated slots
-  /// were found.
-  void markWeakRefs(GC *gc);
+  /// \return the index of the entry of \p key, whose hash is \p hash, or
+  /// kNotFound.
+  uint32_t lookup(PointerBase *base, JSObject *key, uint32_t hash) const;
 
-  /// Iterate the slots in map_ and call deleteInternal on any invalid
-  /// references, adding all available slots to the free list.
-  void findAndDeleteFreeSlots(PointerBase *base);
+  /// \return the number of entries with live keys.
+  uint32_t countLive(PointerBase *base) const;
 
-  /// Erase the map entry and corresponding valueStorage entry
-  /// pointed to by the iterator \p it.
-  /// Add the newly opened valueStorage slot to the free list.
-  void deleteInternal(PointerBase *base, DenseMapT::iterator it);
+  /// Store \p key and \p value in the first free entry of the probe sequence
+  /// of \p hash. \pre the key isn't in the map, and there is a free entry.
+  void insertNew(
+      Runtime *runtime,
+      HermesValue key,
+      uint32_t hash,
+      HermesValue value);
 
- private:
-  /// Get the index to insert a new value into valueStorage_.
-  /// Resize valueStorage_ if no such spots exist.
-  /// \return the index into which to insert, or EXCEPTION if resize failed.
-  static CallResult<uint32_t> getFreeValueStorageIndex(
+  /// Move the live entries into a new table, sized for them and one more.
+  static ExecutionStatus rehash(
       Handle<JSWeakMapImplBase> self,
       Runtime *runtime);
 
- private:
-  /// The underlying weak value map.
-  DenseMapT map_;
-
-  /// Value storage, used to keep the HermesValues out of the DenseMap.
-  /// If a value is kFreeListInvalid it's free to use.
-  /// If a value can be found by following indices starting at freeListHead_,
-  /// it's also free to use.
-  /// The last member of this linked list of free spots is kFreeListInvalid.
-  GCPointer<BigStorage> valueStorage_;
-
-  /// Number indicating the end of the free list.
-  static constexpr uint32_t kFreeListInvalid{UINT32_MAX};
-
-  /// Index of the first free spot in the valueStorage_ free list.
-  /// If kFreeListInvalid, then the free list is completely empty,
-  /// and the nextIndex_ should be used.
-  uint32_t freeListHead_{kFreeListInvalid};
-
-  /// Next index to use when the free list runs out of elements.
-  uint32_t nextIndex_{0};
-
-  /// This is set to true when markWeakRefs sees an invalid slot which can be
-  /// freed later.
-  /// When set to true, the WeakMap should look for free slots the next time
-  /// the user tries to add an element.
-  bool hasFreeableSlots_{false};
+  /// The entries, in an open-addressed hash table with linear probing. The
+  /// table is split into EphemeronChunks of kMaxEntries entries, or is a
+  /// single smaller chunk. Null until the first insertion.
+  GCPointer<ArrayStorage> chunks_;
+
+  /// Number of entries in the table: zero, or a power of two.
+  uint32_t capacity_{0};
+
+  /// Number of entries which aren't empty, including the deleted ones, which
+  /// still lengthen the probe sequences.
+  uint32_t occupied_{0};
 };
 
 /// Underlying representation of the WeakMap and WeakSet objects.
 ///
-/// The keys are stored in a `DenseMap<WeakRefKey, uint32_t>`,
-/// which allows storing the hashes with the keys,
-/// so that the DenseMap can compute the hashes
-/// without being given a Runtime.
-/// We can't store the hashes separately because the DenseMap
-/// needs to be able to compute hashes based on only the KeyT,
-/// because the map rehashes when growing itself,
-/// and it doesn't store the LookupKeyT if using find_as or insert_as.
+/// The entries live in EphemeronChunks, which the GC traces as ephemerons: a
+/// value is kept alive by its key being reachable from elsewhere, not by the
+/// map, and a full collection clears the entries whose keys are unreachable.
+/// The map itself holds no weak references and needs no finalizer.
 ///
-/// The values in the map_ are indices into valueStorage_,
-/// which is where we store the actual values.
-/// valueStorage_ is a GC-managed PropStorage,
-/// and the indices in map_ are gotten either via the free list
-/// or, if that's empty, via the nextIndex_ field.
-/// If we run out of slots, we double the size of valueStorage_.
-/// Currently, we never shrink it.
+/// Keys are found by the hash of their object ID, which doesn't change when
+/// the GC moves them, and compared by identity. The table grows when three
+/// quarters of its entries are occupied, counting the deleted ones, and
+/// rehashing drops the deleted entries.
 template <CellKind C>
 class JSWeakMapImpl final : public JSWeakMapImplBase {
   using Super = JSWeakMapImplBase;
@@ -261,12 +153,8 @@ class JSWeakMapImpl final : public JSWeakMapImplBase {
   static void WeakMapOrSetBuildMeta(const GCCell *cell, Metadata::Builder &mb);
 
  protected:
-  JSWeakMapImpl(
-      Runtime *runtime,
-      JSObject *parent,
-      HiddenClass *clazz,
-      BigStorage *valueStorage)
-      : JSWeakMapImplBase(runtime, &vt.base, parent, clazz, valueStorage) {}
+  JSWeakMapImpl(Runtime *runtime, JSObject *parent, HiddenClass *clazz)
+      : JSWeakMapImplBase(runtime, &vt.base, parent, clazz) {}
 };
 
 using JSWeakMap = JSWeakMapImpl<CellKind::WeakMapKind>;
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_LARGEOBJECTSPACE_H
+#define HERMES_VM_LARGEOBJECTSPACE_H
+
+#include "hermes/VM/AlignedHeapSegment.h"
+#include "hermes/VM/AlignedStorage.h"
+#include "hermes/VM/CardTableNC.h"
+#include "hermes/VM/GCBase.h"
+#include "hermes/VM/GCCell.h"
+
+#include "llvm/ADT/STLExtras.h"
+
+#include <functional>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+struct CompleteMarkState;
+struct FullMSCUpdateAcceptor;
+
+/// The space holding the cells of GenGC which are too large to be allocated
+/// in its segments.  A range of virtual memory is reserved for it when the
+/// first large cell is allocated, and each cell is allocated at the start of
+/// its own run of AlignedStorage-sized chunks of that range, which is only
+/// backed by memory once it is written.  Its cells are never moved.
+///
+/// A cell starts at the same offset in its first chunk as the allocation
+/// region of an AlignedHeapSegment, so that it has a mark bit in the same
+/// place as the cells of segments.  A card table covering the whole range
+/// records the cards of the cells into which pointers to young objects were
+/// written.
+class LargeObjectSpace {
+ public:
+  /// Variable-sized cells at least this large, which do not fit in a segment,
+  /// are allocated in this space.
+  static constexpr uint32_t kMinCellSize =
+      AlignedHeapSegment::maxSize() + HeapAlign;
+
+  /// The largest cell this space allocates.  Larger allocations are refused
+  /// with a RangeError before they reach the GC, rather than exhausting a
+  /// typical heap.
+  static constexpr uint32_t kMaxCellSize =
+      2 * AlignedStorage::size() - AlignedHeapSegment::offsetOfAllocRegion;
+
+  /// Create a space that can hold cells up to a total of about
+  /// \p maxHeapSize bytes.  Nothing is reserved until the first allocation.
+  explicit LargeObjectSpace(size_t maxHeapSize);
+  ~LargeObjectSpace();
+
+  LargeObjectSpace(const LargeObjectSpace &) = delete;
+  LargeObjectSpace &operator=(const LargeObjectSpace &) = delete;
+
+  /// \return whether \p ptr is in the range reserved for this space.
+  bool contains(const void *ptr) const {
+    return lowLim_ <= ptr && ptr < hiLim_;
+  }
+
+  /// Allocate a cell of \p size bytes, which must be heap-aligned.
+  /// \return the uninitialized cell, or nullptr if there is no room for it in
+  ///     the reserved range, or the range could not be reserved.
+  GCCell *alloc(uint32_t size, HasFinalizer hasFinalizer);
+
+  /// \return the sum of the sizes of the cells in this space.
+  size_t used() const {
+    return used_;
+  }
+
+  /// \return the number of bytes of the chunks used by the cells.
+  size_t size() const {
+    return numUsedChunks_ * AlignedStorage::size();
+  }
+
+  /// \return the number of bytes allocated in this space since the last call
+  ///     to resetBytesAllocated().
+  size_t bytesAllocated() const {
+    return bytesAllocated_;
+  }
+  void resetBytesAllocated() {
+    bytesAllocated_ = 0;
+  }
+
+  /// Dirty the card of \p addr, which must be in a cell of this space.
+  void dirtyCardForAddress(const void *addr) {
+    assert(contains(addr) && "address must be in the space");
+    cards_[cardIndex(addr)] = 1;
+  }
+
+  /// Dirty the cards intersecting the closed interval [low, high], which must
+  /// be in the same cell.
+  void dirtyCardsForAddressRange(const void *low, const void *high);
+
+  /// Call \p callback with each of the cells in address order.
+  void forAllObjs(const std::function<void(GCCell *)> &callback);
+
+  /// For each sequence of dirty cards, call \p visit with the cell which
+  /// contains it and the address range it covers, clamped to the cell.  The
+  /// cards are then cleaned.
+  void scanDirtyCards(
+      llvm::function_ref<void(GCCell *, const char *, const char *)> visit);
+
+  /// Clean the cards of all the cells.
+  void clearCards();
+
+  /// Clear the mark bits of all the cells.
+  void clearMarkBits();
+
+  /// Complete the marking of the marked cells, in address order, starting
+  /// from the \p from'th one, and up to the first one at or above \p limit,
+  /// or up to the last one if \p limit is null.  Like
+  /// AlignedHeapSegment::completeMarking, returns early if the mark stack
+  /// overflows.
+  /// \return the index of the first cell that was not visited.
+  size_t completeMarking(
+      GC *gc,
+      CompleteMarkState *markState,
+      size_t from,
+      const void *limit);
+
+  /// Run the finalizers of the cells that are not marked, and free them.
+  /// \return the sum of the sizes of the freed cells.
+  size_t finalizeUnreachableObjects(GC *gc);
+
+  /// Replace the VTable pointer of each cell by a forwarding pointer to
+  /// itself, since cells in this space are not moved, and save the VTable
+  /// pointers.  All the cells must be marked.
+  void installForwardingPointers();
+
+  /// Update the pointers in the cells, using the saved VTable pointers.
+  void updateReferences(GC *gc, FullMSCUpdateAcceptor &acceptor);
+
+  /// Restore the VTable pointers saved by installForwardingPointers().
+  void restoreVTables();
+
+  /// \return the sum of the malloc sizes of the cells.
+  size_t countMallocSize() const;
+
+#ifndef NDEBUG
+  /// \return whether \p ptr points into a cell of this space which is valid.
+  bool validPointer(const void *ptr) const;
+
+  /// \return whether \p cell is the last cell allocated in this space, and
+  ///     has a finalizer.
+  bool isMostRecentFinalizableObj(const GCCell *cell) const;
+#endif
+
+#ifdef HERMES_SLOW_DEBUG
+  void checkWellFormed(GC *gc) const;
+#endif
+
+ private:
+  static constexpr size_t kLogCardSize = CardTable::kLogCardSize;
+
+  /// A cell of the space.
+  struct Object {
+    GCCell *cell;
+    /// The allocated size of the cell.
+    uint32_t size;
+    /// The number of chunks used by the cell.
+    uint32_t numChunks;
+    bool hasFinalizer;
+    /// The VTable pointer of the cell, while it is replaced by a forwarding
+    /// pointer during a full collection.
+    const VTable *savedVT;
+
+    /// \return the end of the memory used by the cell.
+    char *end() const {
+      return reinterpret_cast<char *>(cell) + size;
+    }
+  };
+
+  /// Reserve the range of the space.  \return whether it succeeded.
+  bool reserve();
+
+  /// \return the first chunk of \p object.
+  char *firstChunk(const Object &object) const {
+    return reinterpret_cast<char *>(object.cell) -
+        AlignedHeapSegment::offsetOfAllocRegion;
+  }
+
+  /// \return the index of the chunk starting at \p chunk.
+  size_t chunkIndex(const char *chunk) const {
+    return (chunk - lowLim_) >> AlignedStorage::kLogSize;
+  }
+
+  /// \return the index of the card of \p addr.
+  size_t cardIndex(const void *addr) const {
+    return (static_cast<const char *>(addr) - lowLim_) >> kLogCardSize;
+  }
+
+  /// Clean the cards of \p object.
+  void clearCards(const Object &object);
+
+  /// Release the memory of \p object, and mark its chunks as free.
+  void free(const Object &object);
+
+  /// The size of the range to reserve.
+  const size_t reservationSize_;
+
+  /// The reserved range, or null if it has not been reserved yet.
+  char *lowLim_{nullptr};
+  char *hiLim_{nullptr};
+
+  /// Whether reserving the range failed, in which case it is not retried.
+  bool reservationFailed_{false};
+
+  /// One byte for each card of the reserved range, non-zero if it is dirty.
+  uint8_t *cards_{nullptr};
+  size_t cardsSize_{0};
+
+  /// Whether each chunk of the reserved range is used by a cell.
+  std::vector<bool> usedChunks_{};
+  size_t numUsedChunks_{0};
+
+  /// The cells, in address order.
+  std::vector<Object> objects_{};
+
+  size_t used_{0};
+  size_t bytesAllocated_{0};
+
+#ifndef NDEBUG
+  /// The last cell allocated.
+  const GCCell *lastAllocated_{nullptr};
+#endif
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_LARGEOBJECTSPACE_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_LAZYCOMPILATIONTHREAD_H
+#define HERMES_VM_LAZYCOMPILATIONTHREAD_H
+
+#ifndef HERMESVM_LEAN
+#include "hermes/BCGen/HBC/Bytecode.h"
+#include "hermes/IRGen/IRGen.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace hermes {
+namespace vm {
+
+/// Compile the lazy function described by \p lazyData on the calling thread.
+/// It holds the lazy compilation mutex of the function's Context, so that
+/// functions of the same Context may be compiled on different threads.
+/// \return the BytecodeModule of the function.
+std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
+    hbc::LazyCompilationData *lazyData);
+
+/// Manages a thread that compiles lazy functions before they are first
+/// called. The runtime queues a function when a closure is created for it,
+/// which usually happens shortly before the call. When it is called, its
+/// bytecode is taken from the thread if it is ready, waited for if it is being
+/// compiled, and otherwise compiled on the calling thread like without this
+/// class.
+/// Despite managing another thread itself, this class is not thread-safe: it
+/// must only be called from the thread of its runtime.
+class LazyCompilationThread {
+ public:
+  LazyCompilationThread();
+
+  /// Stops the thread, after waiting for the function it is compiling.
+  ~LazyCompilationThread();
+
+  /// Queue the lazy function \p lazyData for compilation, unless it has
+  /// already been queued. The data is copied, since the function may be freed
+  /// before it is compiled.
+  void prefetch(const hbc::LazyCompilationData &lazyData);
+
+  /// \return the BytecodeModule of the lazy function \p lazyData.
+  std::unique_ptr<hbc::BytecodeModule> compile(
+      hbc::LazyCompilationData *lazyData);
+
+  /// Drop the functions waiting to be compiled and the results which haven't
+  /// been taken yet, to free their memory. A function which is being compiled
+  /// is kept, and dropped functions are compiled again when they are called.
+  void dropPending();
+
+ private:
+  /// A function which was queued by prefetch().
+  struct Job {
+    explicit Job(const hbc::LazyCompilationData &data) : data(data) {}
+
+    /// A copy of the function's data, which keeps its Context alive.
+    hbc::LazyCompilationData data;
+
+    /// Whether the thread is compiling the function.
+    bool compiling{false};
+
+    /// The result, once the thread has compiled the function.
+    std::unique_ptr<hbc::BytecodeModule> result{};
+  };
+
+  /// The key of \p lazyData in jobs_: the start of its source, which is owned
+  /// by its Context, and so cannot be reused while its Job is alive.
+  static const char *keyOf(const hbc::LazyCompilationData &lazyData) {
+    return lazyData.span.Start.getPointer();
+  }
+
+  /// The code to run in the thread.
+  void run();
+
+  /// Guards all the fields below.
+  std::mutex mutex_;
+
+  /// Notified when the thread is stopped, when a function is queued, and when
+  /// a function has been compiled.
+  std::condition_variable cond_;
+
+  /// Used to stop the thread.
+  bool stop_{false};
+
+  /// Number of functions compile() is compiling on the calling thread.
+  unsigned compilingOnCaller_{0};
+
+  /// All the functions which were queued and not taken by compile() yet.
+  llvm::DenseMap<const char *, std::unique_ptr<Job>> jobs_{};
+
+  /// The functions which haven't been compiled yet, oldest first. The oldest
+  /// are dropped when there are too many, since their closures were created
+  /// long ago and they may never be called. It may also hold functions which
+  /// were removed from jobs_, and are skipped.
+  std::deque<const char *> queue_{};
+
+  /// The functions which have been compiled, oldest first. When the thread
+  /// is waiting for them to be taken, the oldest is dropped to make room for
+  /// each new function, so that the results of functions which are never
+  /// called don't stop it. A dropped function which is called after all is
+  /// compiled again on the calling thread.
+  std::deque<const char *> done_{};
+
+  std::thread thread_;
+};
+
+} // namespace vm
+} // namespace hermes
+#endif // HERMESVM_LEAN
+
+#endif // HERMES_VM_LAZYCOMPILATIONTHREAD_H
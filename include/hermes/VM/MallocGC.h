@@ -185,6 +185,17 @@ class MallocGC final : public GCBase {
   /// weak pointers that point to dead objects.
   void collect();
 
+  /// Do a collection if the previous ones suggest that it will complete by
+  /// \p deadline.  \return the number of bytes it freed.
+  size_t collectWhileIdle(TimePoint deadline);
+
+  /// Do a collection, which is all this GC can do to give back memory.
+  /// \return the number of bytes it freed.
+  size_t handleMemoryPressure(MemoryPressureLevel level);
+
+  /// Iterate over all objects in the heap.
+  void forAllObjs(const std::function<void(GCCell *)> &callback);
+
   static constexpr uint32_t maxAllocationSize() {
     // MallocGC imposes no limit on individual allocations.
     return std::numeric_limits<uint32_t>::max();
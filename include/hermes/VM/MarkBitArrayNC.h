@@ -51,6 +51,10 @@ class MarkBitArrayNC {
   /// range of the array.
   inline void mark(size_t ind);
 
+  /// Clears the bit for the given index, which is required to be within the
+  /// range of the array.
+  inline void unmark(size_t ind);
+
   /// Clears the bit array.
   inline void clear();
 
@@ -139,6 +143,14 @@ void MarkBitArrayNC::mark(size_t ind) {
   bitArray_[ind / kBitsPerVal] |= (size_t)1 << (ind % kBitsPerVal);
 }
 
+void MarkBitArrayNC::unmark(size_t ind) {
+  assert(
+      ind < kValidIndices &&
+      "precondition: ind must be within the index range");
+
+  bitArray_[ind / kBitsPerVal] &= ~((size_t)1 << (ind % kBitsPerVal));
+}
+
 void MarkBitArrayNC::clear() {
   ::memset(bitArray_, 0, sizeof(bitArray_));
 }
@@ -203,6 +203,18 @@ class OldGen : public GCGeneration {
     }
   };
 
+  /// A location in the holes of the old gen: the index of a hole, and a
+  /// pointer into it.
+  struct HoleLocation {
+    size_t holeNum;
+    char *ptr;
+  };
+
+  /// The position in the holes at which the next allocation in them occurs.
+  HoleLocation holeLevel() const {
+    return {holeIndex_, holeLevel_};
+  }
+
   /// The current allocation position.  The first version may be used always;
   /// the availableDirect version may only be used when the generation owns its
   /// allocation context, but is faster.
@@ -234,9 +246,11 @@ class OldGen : public GCGeneration {
   /// first of these is at \p toScan.  Apply the given \p acceptor to
   /// these promoted objects.  This may, in turn, promote more
   /// objects; continue until all of the promoted objects have been
-  /// scanned.
+  /// scanned.  Objects promoted into holes are scanned starting from
+  /// \p holeToScan.
   void youngGenTransitiveClosure(
       const Location &toScan,
+      const HoleLocation &holeToScan,
       YoungGen::EvacAcceptor &acceptor);
 
   /// Called after the GC's heap has been copied to a new location, in order to
@@ -276,6 +290,39 @@ class OldGen : public GCGeneration {
   void recordLevelAfterCompaction(
       CompactionResult::ChunksRemaining &usedChunks);
 
+  /// Runs of dead space at least this large, left between live cells by
+  /// sweepInPlace(), are allocated into.
+  static constexpr size_t kMinHoleSize = 256;
+
+  /// The sums of the sizes of the live cells that sweepInPlace() left in
+  /// place, and of the dead space it left between them.
+  struct InPlaceSweepResult {
+    size_t liveBytes;
+    size_t deadBytes;
+  };
+
+  /// Assumes marking is complete.  Reclaims the dead cells without moving the
+  /// live ones: the runs of dead space between live cells are filled by
+  /// FillerCells, and those of at least kMinHoleSize bytes become holes that
+  /// are allocated into before the level.  The segments after the one holding
+  /// the last live cell are released, and the level is lowered to the end of
+  /// that cell.
+  InPlaceSweepResult sweepInPlace(GC *gc);
+
+  /// Free the segments kept for reuse by the generation.
+  /// \return the number of bytes they held.
+  size_t releaseSegmentCache();
+
+  /// Forget the holes, which must be sealed, e.g. because the generation is
+  /// about to be compacted.
+  void clearHoles();
+
+  /// Fill the rest of the hole being allocated into with a FillerCell, so
+  /// that the generation can be walked.  This is done lazily, rather than
+  /// after each allocation in a hole, and must be called before the objects
+  /// of the generation are visited.
+  void sealHole();
+
 #ifdef HERMES_SLOW_DEBUG
   void checkWellFormed(const GC *gc) const;
 #endif
@@ -294,6 +341,15 @@ class OldGen : public GCGeneration {
       uint32_t allocSize,
       HasFinalizer hasFinalizer);
 
+  /// Attempt to allocate in the holes.  Allocations which do not fit in what
+  /// is left of the current hole move on to the next one if it is too small
+  /// to be worth keeping, and fail otherwise, so that they are allocated at
+  /// the level instead.
+  AllocResult allocInHole(uint32_t size, HasFinalizer hasFinalizer);
+
+  /// Seal the current hole, and start allocating in the next one, if any.
+  void nextHole();
+
   /// The number of bytes wasted due to space at the end of segments we could
   /// not allocate in.
   inline size_t fragmentationLoss() const;
@@ -399,6 +455,38 @@ class OldGen : public GCGeneration {
 
   /// Whether to return unused memory to OS.
   bool releaseUnused_;
+
+  /// A run of dead space between live cells, allocated into after an
+  /// in-place full collection.
+  struct Hole {
+    char *start;
+    char *end;
+  };
+
+  /// The holes left by the last sweepInPlace(), in logical order.
+  std::vector<Hole> holes_;
+
+  /// The index of the hole being allocated into.  The holes are exhausted
+  /// when it reaches the number of holes.
+  size_t holeIndex_{0};
+
+  /// The allocation position in the current hole.
+  char *holeLevel_{nullptr};
+
+  /// The next card boundary that an allocation in the current hole is going
+  /// to cross.
+  CardTable::Boundary holeBoundary_;
+
+  /// Whether the space left in the current hole is covered by a FillerCell.
+  bool holeSealed_{true};
+
+  /// The number of bytes allocated in holes since the last GC.
+  size_t bytesAllocatedInHoles_{0};
+
+#ifndef NDEBUG
+  /// The position in the holes at the end of the last GC.
+  HoleLocation holeLevelAtEndOfLastGC_{0, nullptr};
+#endif
 };
 
 size_t OldGen::Size::maxSegments() const {
@@ -424,6 +512,12 @@ AllocResult OldGen::alloc(uint32_t size, HasFinalizer hasFinalizer) {
 
 AllocResult OldGen::allocRaw(uint32_t size, HasFinalizer hasFinalizer) {
   assert(ownsAllocContext());
+  if (LLVM_UNLIKELY(holeIndex_ < holes_.size())) {
+    AllocResult result = allocInHole(size, hasFinalizer);
+    if (result.success) {
+      return result;
+    }
+  }
   AllocResult result = GCGeneration::allocRaw(size, hasFinalizer);
 
   if (LLVM_UNLIKELY(!result.success)) {
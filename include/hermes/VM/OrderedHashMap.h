@@ -11,77 +11,181 @@
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Runtime.h"
 
-#include <vector>
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TrailingObjects.h"
 
 namespace hermes {
 namespace vm {
 
-/// HashMapEntry is a gc-managed entry in the OrderedHashMap.
-/// We use HashMapEntry to form two separate linked lists,
-/// one that tracks the insertion order for iteration purpose, one
-/// tracks the list of entries in a hash table bucket for hash operations.
-class HashMapEntry final : public GCCell {
+/// OrderedHashTable is the storage of an OrderedHashMap. Its entries are laid
+/// out densely in insertion order, three HermesValues each: the key, the value
+/// and the index of the next entry in the same hash bucket. They are split
+/// into ArrayStorage chunks of at most kEntriesPerChunk entries, which keeps
+/// large tables out of the large object space. The cell itself holds the
+/// pointers to the chunks, followed by the buckets: the index of the first
+/// entry of each hash chain.
+///
+/// New entries are always appended. The key and value of a deleted entry are
+/// set to empty, but the entry stays in its chain and keeps its position until
+/// the table is rehashed, so that iteration indices remain stable.
+///
+/// A table is never resized. When it is replaced by a rehash or by a clear,
+/// it becomes obsolete: it points at the table which replaced it, the entries
+/// which were carried over are set to undefined and the others are empty. An
+/// iterator positioned in an obsolete table moves to the replacement at the
+/// number of carried over entries before its position, see
+/// OrderedHashMap::iteratorNext.
+class OrderedHashTable final
+    : public VariableSizeRuntimeCell,
+      private llvm::TrailingObjects<OrderedHashTable, GCHermesValue, uint32_t> {
+  friend TrailingObjects;
+  friend class OrderedHashMap;
+  friend void OrderedHashTableBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+
  public:
-  static VTable vt;
+  using size_type = uint32_t;
 
-  /// The key.
-  GCHermesValue key;
+  static VTable vt;
 
-  /// The value.
-  GCHermesValue value;
+  /// The index ending a hash chain, and returned when an iteration is over.
+  static constexpr size_type kEnd = UINT32_MAX;
 
-  /// Previous entry in insertion order.
-  GCPointer<HashMapEntry> prevIterationEntry{nullptr};
+  static constexpr size_type kLogEntriesPerChunk = 12;
+  /// The largest number of entries in one chunk.
+  static constexpr size_type kEntriesPerChunk = 1u << kLogEntriesPerChunk;
 
-  /// Next entry in insertion order.
-  GCPointer<HashMapEntry> nextIterationEntry{nullptr};
+  /// The number of buckets is half the capacity, but no more than this, which
+  /// bounds the size of the cell. Larger tables get longer chains instead.
+  static constexpr size_type kMaxBuckets = 1u << 20;
 
-  /// Next entry in the hash table bucket.
-  GCPointer<HashMapEntry> nextEntryInBucket{nullptr};
+  /// The capacity is a power of two, and no more than this.
+  static constexpr size_type kMaxCapacity = 1u << 31;
 
   static bool classof(const GCCell *cell) {
-    return cell->getKind() == CellKind::HashMapEntryKind;
+    return cell->getKind() == CellKind::OrderedHashTableKind;
   }
 
-  static CallResult<HermesValue> create(Runtime *runtime);
+  /// Create an empty table with room for \p capacity entries, which must be a
+  /// power of two no larger than kMaxCapacity.
+  static CallResult<HermesValue> create(Runtime *runtime, size_type capacity);
 
-  /// Indicates whether this entry has been deleted.
-  bool isDeleted() const {
-    assert(key.isEmpty() == value.isEmpty() && "Inconsistent deleted status");
-    return value.isEmpty();
+  /// \return the number of entries which can be appended in total.
+  size_type capacity() const {
+    return capacity_;
   }
 
-  /// Mark this entry as deleted.
-  void markDeleted() {
-    key.setNonPtr(HermesValue::encodeEmptyValue());
-    value.setNonPtr(HermesValue::encodeEmptyValue());
+  /// \return the number of entries appended, including the deleted ones.
+  size_type numEntries() const {
+    return numEntries_;
   }
 
- protected:
-  HashMapEntry(Runtime *runtime) : GCCell(&runtime->getHeap(), &vt) {}
-}; // HashMapEntry
+  /// \return the key of the entry at \p index, empty if it was deleted.
+  HermesValue key(size_type index) {
+    return slot(index, KeySlot);
+  }
+
+  /// \return the value of the entry at \p index, empty if it was deleted.
+  HermesValue value(size_type index) {
+    return slot(index, ValueSlot);
+  }
+
+ private:
+  /// The layout of the HermesValues of an entry in its chunk.
+  enum EntrySlot { KeySlot, ValueSlot, NextSlot, NumSlotsPerEntry };
+
+  /// The table which replaced this one, nullptr unless this table is obsolete.
+  GCPointer<OrderedHashTable> nextTable_{nullptr};
+
+  const size_type capacity_;
+
+  /// The number of chunk pointers following the cell.
+  const size_type numChunks_;
+
+  /// The number of buckets following the chunk pointers, a power of two.
+  const size_type numBuckets_;
+
+  size_type numEntries_{0};
+
+  static size_type numChunksFor(size_type capacity) {
+    return (capacity + kEntriesPerChunk - 1) >> kLogEntriesPerChunk;
+  }
+
+  static size_type numBucketsFor(size_type capacity) {
+    return std::max(std::min(capacity / 2, kMaxBuckets), 1u);
+  }
+
+  static uint32_t allocationSize(size_type capacity) {
+    return totalSizeToAlloc<GCHermesValue, uint32_t>(
+        numChunksFor(capacity), numBucketsFor(capacity));
+  }
+
+  OrderedHashTable(Runtime *runtime, size_type capacity);
+
+  size_t numTrailingObjects(OverloadToken<GCHermesValue>) const {
+    return numChunks_;
+  }
+
+  GCHermesValue *chunks() {
+    return getTrailingObjects<GCHermesValue>();
+  }
+  const GCHermesValue *chunks() const {
+    return getTrailingObjects<GCHermesValue>();
+  }
+
+  uint32_t *buckets() {
+    return getTrailingObjects<uint32_t>();
+  }
+
+  /// \return the HermesValue \p field of the entry at \p index.
+  GCHermesValue &slot(size_type index, EntrySlot field) {
+    assert(index < numEntries_ && "index out of range");
+    auto *chunk = vmcast<ArrayStorage>(chunks()[index >> kLogEntriesPerChunk]);
+    return chunk->at(
+        (index & (kEntriesPerChunk - 1)) * NumSlotsPerEntry + field);
+  }
+
+  size_type bucketFor(uint32_t hash) const {
+    return hash & (numBuckets_ - 1);
+  }
+
+  /// \return the index of the live entry whose key is \p key, which hashes to
+  /// \p hash, or kEnd if there is none.
+  size_type find(HermesValue key, uint32_t hash);
+
+  /// Append an entry at the end of the table, and link it into the bucket of
+  /// \p hash. Requires that the table is not full.
+  void
+  append(Runtime *runtime, HermesValue key, HermesValue value, uint32_t hash);
+
+  /// Mark the entry at \p index deleted. It stays in its hash chain.
+  void markDeleted(size_type index) {
+    slot(index, KeySlot).setNonPtr(HermesValue::encodeEmptyValue());
+    slot(index, ValueSlot).setNonPtr(HermesValue::encodeEmptyValue());
+  }
+
+  /// \return the number of entries before \p index which were carried over to
+  /// the next table. Requires that the table is obsolete.
+  size_type numMovedBefore(size_type index);
+}; // OrderedHashTable
 
 /// OrderedHashMap is a gc-managed hash map that maintains insertion order.
-/// The map contains two conceptual parts: a standard chained hash table,
-/// to store and lookup HermesValue; a linked list to maintain the insertion
-/// order.
-/// When an element is added, it's always appended to the end of the linked
-/// list. When an element is deleted, we mark it as deleted and remove it
-/// from the linked list, unless it's the last element.
-/// Iterators are pointers to the entries, which are always linked according
-/// to insertion order.
-/// When the size of the hash table becomes unreasonably large or small
-/// comparing to the number of alive elements, we will rehash the table.
-/// We always make sure that any entry at any moment can successfully find
-/// the next entry according to insertion order, and rely on GC to manage
-/// the "deleted" entries", free them when no more iterators are before
-/// that entry.
+/// The entries are stored in an OrderedHashTable, which is replaced by a new
+/// one when it fills up or becomes mostly deleted entries. The replacement
+/// drops the deleted entries and is sized to twice the number of live ones.
+///
+/// An iteration is a table and the index of the next entry to visit in it.
+/// Entries inserted or deleted while iterating are seen or skipped as the
+/// specification requires, including across rehashes and clears.
 class OrderedHashMap final : public GCCell {
   friend void OrderedHashMapBuildMeta(
       const GCCell *cell,
       Metadata::Builder &mb);
 
  public:
+  using size_type = OrderedHashTable::size_type;
+
   static VTable vt;
 
   static bool classof(const GCCell *cell) {
@@ -98,11 +202,6 @@ class OrderedHashMap final : public GCCell {
   static HermesValue
   get(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Lookup \p key in the table and \return the value if exists.
-  /// Otherwise \return nullptr.
-  static HashMapEntry *
-  find(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
-
   /// Insert a key/value pair into the map, if not already existing.
   static ExecutionStatus insert(
       Handle<OrderedHashMap> self,
@@ -114,77 +213,64 @@ class OrderedHashMap final : public GCCell {
   static bool
   erase(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Clear the map.  The \p gc parameter is necessary for write barriers.
-  void clear(Runtime *runtime);
+  /// Clear the map.
+  static ExecutionStatus clear(Handle<OrderedHashMap> self, Runtime *runtime);
 
   /// \return the size of the map.
   uint32_t size() const {
     return size_;
   }
 
-  /// \return the next element in insertion order.
-  /// If \p entry is nullptr, we are starting the iteration from the first
-  /// entry that is not deleted.
-  /// Otherwise, we look for the next element after \p entry that is not
-  /// deleted.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry = nullptr)
-      const;
+  /// \return the table a new iteration starts from, at index 0.
+  OrderedHashTable *getTable(PointerBase *base) const {
+    return table_.get(base);
+  }
+
+  /// Find the next entry of an iteration which is at \p index in \p table.
+  /// If the table is obsolete, \p table is updated to the current one, and
+  /// the index adjusted accordingly.
+  /// \return the index in \p table of the first entry at or after the
+  ///   position of the iteration which is not deleted, or
+  ///   OrderedHashTable::kEnd if there is none.
+  static size_type
+  iteratorNext(PointerBase *base, OrderedHashTable *&table, size_type index);
 
  protected:
-  OrderedHashMap(Runtime *runtime, Handle<ArrayStorage> hashTableStorage);
+  OrderedHashMap(Runtime *runtime, Handle<OrderedHashTable> table);
 
  private:
-  /// The hashtable, with size always equal to capacity_. The number of
-  /// reachable entries from hashTable_ should be equal to size_.
-  GCPointer<ArrayStorage> hashTable_{nullptr};
-
-  /// The first entry ever inserted. We need this entry to begin an iteration.
-  GCPointer<HashMapEntry> firstIterationEntry_{nullptr};
-
-  /// The last entry inserted. We need it to add new elements afterwards.
-  GCPointer<HashMapEntry> lastIterationEntry_{nullptr};
+  /// The current table.
+  GCPointer<OrderedHashTable> table_{nullptr};
 
-  /// Initial capacity of the hash table.
-  static constexpr uint32_t INITIAL_CAPACITY = 16;
+  /// Initial capacity of the table.
+  static constexpr size_type INITIAL_CAPACITY = 8;
 
-  /// Maximum capacity cannot exceed the maximum capacity of the underlying
-  /// ArrayStorage.
-  // It needs to be less than 1/4th the max 32-bit integer in order to use an
-  // integer-based load factor check of 0.75.
-  /// TODO(T31421960): Use constexpr std::min.
-  static constexpr uint32_t MAX_CAPACITY =
-      ArrayStorage::maxElements() < UINT32_MAX / 4 ? ArrayStorage::maxElements()
-                                                   : UINT32_MAX / 4;
-
-  /// Capacity of the hash table.
-  uint32_t capacity_{INITIAL_CAPACITY};
-
-  /// Number of alive entries in the storage.
+  /// Number of alive entries in the table.
   uint32_t size_{0};
 
-  /// Hash a HermesValue to an index to our hash table.
-  static uint32_t
-  hashToBucket(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key) {
-    auto hash = runtime->gcStableHashHermesValue(key);
-    assert(
-        (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-        "capacity_ must be power of 2");
-    return hash & (self->capacity_ - 1);
+  /// Hash a HermesValue for the table.
+  static uint32_t hash(Runtime *runtime, Handle<> key) {
+    return static_cast<uint32_t>(runtime->gcStableHashHermesValue(key));
   }
 
-  /// Remove a node from the linked list.
-  void removeLinkedListNode(Runtime *runtime, HashMapEntry *entry, GC *gc);
-
-  /// Lookup an entry with key as \p key in a given \p bucket.
-  HashMapEntry *
-  lookupInBucket(Runtime *runtime, uint32_t bucket, HermesValue key);
-
-  /// Adjust the capacity of the hashtable and rehash if necessary.
-  /// We make decisions based on the Load Factor (size / capacity).
-  /// Rehash if load factor is outside of the range of [0.25, 0.75].
-  static ExecutionStatus rehashIfNecessary(
+  /// Replace the table with one of capacity \p newCapacity which contains the
+  /// live entries of the current one, in the same order.
+  static ExecutionStatus rehash(
       Handle<OrderedHashMap> self,
-      Runtime *runtime);
+      Runtime *runtime,
+      size_type newCapacity);
+
+  /// \return the capacity to rehash to when the map has \p size entries:
+  /// twice the size, rounded up to a power of two, and no more than
+  /// OrderedHashTable::kMaxCapacity. Computed in 64 bits so that sizes above
+  /// 2^30 don't wrap around.
+  static size_type capacityFor(size_type size) {
+    uint64_t capacity = llvm::PowerOf2Ceil(uint64_t(size) * 2);
+    return std::max(
+        INITIAL_CAPACITY,
+        static_cast<size_type>(std::min<uint64_t>(
+            capacity, OrderedHashTable::kMaxCapacity)));
+  }
 }; // OrderedHashMap
 } // namespace vm
 } // namespace hermes
@@ -8,15 +8,26 @@
 #define HERMES_VM_PROFILER_H
 
 #ifdef HERMESVM_PROFILER_OPCODE
-#include <x86intrin.h>
+#include "hermes/Inst/InstDecode.h"
 
-#define INIT_OPCODE_PROFILER      \
-  uint64_t startTime = __rdtsc(); \
-  unsigned curOpcode = (unsigned)OpCode::Call;
+#include <x86intrin.h>
 
-#define RECORD_OPCODE_START_TIME                \
-  curOpcode = (unsigned)ip->opCode;             \
-  runtime->opcodeExecuteFrequency[curOpcode]++; \
+#define INIT_OPCODE_PROFILER                   \
+  uint64_t startTime = __rdtsc();              \
+  unsigned curOpcode = (unsigned)OpCode::Call; \
+  const Inst *prevIP = nullptr;
+
+/// Opcode pairs are only recorded when the second instruction immediately
+/// follows the first one in the bytecode, since only those can be fused into
+/// a superinstruction.
+#define RECORD_OPCODE_START_TIME                                              \
+  if (prevIP &&                                                               \
+      (const uint8_t *)prevIP + inst::getInstSize((OpCode)curOpcode) ==       \
+          (const uint8_t *)ip)                                                \
+    runtime->opcodePairFrequency[curOpcode * 256 + (unsigned)ip->opCode]++;   \
+  prevIP = ip;                                                                \
+  curOpcode = (unsigned)ip->opCode;                                           \
+  runtime->opcodeExecuteFrequency[curOpcode]++;                               \
   startTime = __rdtsc();
 
 #define UPDATE_OPCODE_TIME_SPENT \
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
+#define HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
+
+#include "llvm/Support/Compiler.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace llvm {
+class raw_ostream;
+} // namespace llvm
+
+namespace hermes {
+
+class JSONEmitter;
+
+namespace vm {
+
+class Runtime;
+
+/// Samples allocations in the JS heap, and attributes them to the JS stack
+/// which made them, so that allocation hotspots can be found at a much lower
+/// cost than a heap snapshot.
+/// The number of bytes between samples is drawn from an exponential
+/// distribution, which makes the samples a Poisson process over the allocated
+/// bytes: an allocation of S bytes is sampled with probability
+/// 1 - exp(-S / interval), whatever the sizes of the allocations around it.
+/// The size of each sample is scaled by the inverse of that probability to
+/// estimate the bytes allocated at each stack.
+/// Only the runtime's thread may use this class.
+class AllocationProfiler {
+ public:
+  /// Sample allocations with a mean of \p samplingInterval bytes between
+  /// samples, taking the stacks from \p runtime.
+  AllocationProfiler(Runtime *runtime, uint32_t samplingInterval);
+
+  /// Account for an allocation of \p size bytes, which is about to be made.
+  /// This is called before every allocation while sampling, so the common
+  /// case only counts down the bytes before the next sample.
+  void countAlloc(uint32_t size) {
+    if (LLVM_LIKELY(size < bytesBeforeSample_)) {
+      bytesBeforeSample_ -= size;
+      return;
+    }
+    takeSample(size);
+  }
+
+  /// \return the number of samples taken so far.
+  size_t numSamples() const {
+    return samples_.size();
+  }
+
+  /// Write the profile to \p os as JSON, in the format of a Chrome DevTools
+  /// sampling heap profile (.heapprofile).
+  void serialize(llvm::raw_ostream &os) const;
+
+ private:
+  /// A function which made allocations.
+  struct Frame {
+    std::string functionName;
+    std::string url;
+    /// Zero-based line and column of the start of the function, or -1 if they
+    /// are unknown.
+    int line;
+    int column;
+
+    bool operator<(const Frame &other) const {
+      return std::tie(functionName, url, line, column) <
+          std::tie(other.functionName, other.url, other.line, other.column);
+    }
+  };
+
+  /// A node of the tree of stacks which made allocations. The root node has no
+  /// frame.
+  struct Node {
+    Node(uint32_t frame, uint32_t parent) : frame(frame), parent(parent) {}
+
+    /// The index in frames_ of the function, or kNoFrame for the root.
+    uint32_t frame;
+    /// The index in nodes_ of the caller, or kNoFrame for the root.
+    uint32_t parent;
+    /// The estimated number of bytes allocated by the function itself.
+    double selfSize{0};
+    /// The indices in nodes_ of the callees, in the order they were added.
+    std::vector<uint32_t> children{};
+  };
+
+  /// An allocation which was sampled.
+  struct Sample {
+    /// The size of the allocation.
+    uint32_t size;
+    /// The index in nodes_ of the stack which made it.
+    uint32_t node;
+  };
+
+  static constexpr uint32_t kNoFrame = UINT32_MAX;
+
+  /// Maximum number of frames recorded per sample. The frames closest to the
+  /// allocation are kept.
+  static constexpr size_t kMaxStackDepth = 500;
+
+  /// Record a sample of an allocation of \p size bytes, and draw the distance
+  /// to the next one.
+  void takeSample(uint32_t size);
+
+  /// \return the number of bytes to allocate before the next sample.
+  uint64_t nextSampleDistance();
+
+  /// \return the index in frames_ of \p frame, adding it if needed.
+  uint32_t internFrame(Frame &&frame);
+
+  /// \return the index in nodes_ of the callee \p frame of \p parent, adding
+  /// it if needed.
+  uint32_t childNode(uint32_t parent, uint32_t frame);
+
+  /// \return the estimated number of bytes allocated by all the allocations
+  /// which a sample of \p size bytes stands for.
+  double scaledSize(uint32_t size) const;
+
+  /// Write the node \p index and its descendants to \p json.
+  void serializeNode(JSONEmitter &json, uint32_t index) const;
+
+  Runtime *const runtime_;
+
+  /// The mean number of bytes between samples.
+  const double samplingInterval_;
+
+  /// Bytes left to allocate before the next sample.
+  uint64_t bytesBeforeSample_;
+
+  std::minstd_rand randomEngine_;
+  std::exponential_distribution<double> distribution_;
+
+  /// The functions which made the sampled allocations.
+  std::vector<Frame> frames_{};
+  std::map<Frame, uint32_t> frameIndices_{};
+
+  /// The tree of stacks; the first node is the root.
+  std::vector<Node> nodes_{};
+  /// Maps a (parent node, frame) pair to the child node.
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> childIndices_{};
+
+  /// Scratch storage for the frames of the stack being sampled, innermost
+  /// first, kept to avoid reallocating it for every sample.
+  std::vector<uint32_t> stackFrames_{};
+
+  /// The sampled allocations, oldest first.
+  std::vector<Sample> samples_{};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
@@ -18,6 +18,8 @@ inline NativeFunction *Runtime::getBuiltinNativeFunction(
   assert(
       builtinMethodID < inst::BuiltinMethod::_count &&
       "invalid builtinMethodID");
+  if (LLVM_UNLIKELY(!builtins_[builtinMethodID]))
+    return getLazyBuiltinNativeFunction(builtinMethodID);
   return builtins_[builtinMethodID];
 }
 
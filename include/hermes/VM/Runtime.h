@@ -27,6 +27,7 @@
 #include "hermes/VM/PointerBase.h"
 #include "hermes/VM/Predefined.h"
 #include "hermes/VM/Profiler.h"
+#include "hermes/VM/Profiler/AllocationProfiler.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/PropertyDescriptor.h"
 #include "hermes/VM/RegExpMatch.h"
@@ -63,8 +64,10 @@ class ArrayStorage;
 class Environment;
 class Interpreter;
 class JSObject;
+class LazyCompilationThread;
 class PropertyAccessor;
 struct RuntimeCommonStorage;
+class RuntimeImage;
 struct RuntimeOffsets;
 class ScopedNativeDepthTracker;
 class ScopedNativeCallFrame;
@@ -94,6 +97,22 @@ using VMExperimentFlags = uint32_t;
 /// Type used to assign object unique integer identifiers.
 using ObjectID = uint32_t;
 
+/// Groups of builtin constructors and prototypes whose creation can be
+/// deferred until first use, see RuntimeConfig::LazyBuiltins.
+enum class LazyBuiltins : uint8_t {
+  Date,
+  RegExp,
+  /// ArrayBuffer, DataView, %TypedArray% and the typed array constructors.
+  TypedArray,
+  Set,
+  Map,
+  WeakMap,
+  WeakSet,
+  /// Symbol.prototype, and the Symbol constructor if ES6 Symbol is enabled.
+  Symbol,
+  _count
+};
+
 #define PROP_CACHE_IDS(V) V(RegExpLastIndex, Predefined::lastIndex)
 
 /// Fixed set of ids used by the property cache in Runtime.
@@ -114,12 +133,20 @@ class Runtime : public HandleRootOwner,
 
   ~Runtime();
 
-  /// Add a custom function that should match the signature \c void(GC*). It
-  /// will be executed at the start of every garbage collection to mark
-  /// additional GC roots that may not be known to the Runtime.
+  /// Add a custom function that should match the signature
+  /// \c void(GC*, SlotAcceptor&). It will be executed at the start of every
+  /// garbage collection to mark additional GC roots that may not be known to
+  /// the Runtime.
   template <typename F>
   void addCustomRootsFunction(const F &markRootsFn);
 
+  /// Like addCustomRootsFunction(), for a function which should match the
+  /// signature \c void(GC*, SlotAcceptor&, bool markLongLived). When
+  /// \p markLongLived is false, the function may skip the roots which can only
+  /// refer to long-lived objects, as described in GCCallbacks::markRoots().
+  template <typename F>
+  void addCustomGenerationalRootsFunction(const F &markRootsFn);
+
   /// Make the runtime read from \p env to replay its environment-dependent
   /// behavior.
   void setMockedEnvironment(const MockedEnvironment &env);
@@ -202,6 +229,22 @@ class Runtime : public HandleRootOwner,
   template <HasFinalizer hasFinalizer = HasFinalizer::No>
   void *allocLongLived(uint32_t size);
 
+  /// Start sampling the allocations in the JS heap, with a mean of
+  /// \p samplingInterval bytes between samples, discarding the previous
+  /// allocation profile if any.
+  void startAllocationSampling(uint32_t samplingInterval);
+
+  /// Stop sampling allocations and discard the allocation profile.
+  void stopAllocationSampling() {
+    allocationProfiler_.reset();
+  }
+
+  /// \return the profiler which is sampling allocations, or nullptr if
+  /// allocations are not being sampled.
+  AllocationProfiler *getAllocationProfiler() {
+    return allocationProfiler_.get();
+  }
+
   /// Used as a placeholder for places where we should be checking for OOM
   /// but aren't yet.
   /// TODO: do something when there is an uncaught exception, e.g. print
@@ -222,6 +265,17 @@ class Runtime : public HandleRootOwner,
     heap_.collect();
   }
 
+  /// Do the garbage collection work which is expected to complete by
+  /// \p deadline.  \return the number of bytes of free space it created.
+  size_t collectWhileIdle(std::chrono::steady_clock::time_point deadline) {
+    return heap_.collectWhileIdle(deadline);
+  }
+
+  /// Free as much memory as possible at the given pressure \p level: drop
+  /// the caches which can be recreated, then collect and return unused heap
+  /// memory to the OS.  \return an estimate of the number of bytes freed.
+  size_t handleMemoryPressure(MemoryPressureLevel level);
+
   /// Potentially move the heap if handle sanitization is on.
   void potentiallyMoveHeap();
 
@@ -433,6 +487,13 @@ class Runtime : public HandleRootOwner,
   JITContext &getJITContext() {
     return jitContext_;
   }
+
+#ifndef HERMESVM_LEAN
+  /// \return the thread compiling lazy functions before their first call,
+  /// which is created on first use, or nullptr if it is disabled by
+  /// RuntimeConfig::BackgroundLazyCompilation.
+  LazyCompilationThread *getLazyCompilationThread();
+#endif
   /// Returns trailing data for all runtime modules.
   std::vector<llvm::ArrayRef<uint8_t>> getEpilogues();
 
@@ -673,6 +734,12 @@ class Runtime : public HandleRootOwner,
   /// Track time spent of each opcode in the interpreter, in CPU cycles.
   uint64_t timeSpent[256] = {0};
 
+  /// Track the frequency of each pair of adjacent opcodes executed one after
+  /// the other, indexed by (first opcode * 256 + second opcode). This is the
+  /// profile used to pick superinstructions.
+  std::vector<uint32_t> opcodePairFrequency =
+      std::vector<uint32_t>(256 * 256, 0);
+
   /// Dump opcode stats to a stream.
   void dumpOpcodeStats(llvm::raw_ostream &os) const;
 #endif
@@ -730,6 +797,28 @@ class Runtime : public HandleRootOwner,
     return hasES6Symbol_;
   }
 
+  /// \return whether the creation of the builtins of \p group is deferred
+  /// until they are first used.
+  bool areBuiltinsDeferred(LazyBuiltins group) const {
+    return lazyBuiltins_ & (1u << static_cast<unsigned>(group));
+  }
+
+  /// Create the builtins of \p group if their creation has been deferred.
+  /// Native code must call this before using the prototypes of the group
+  /// stored in the runtime.
+  void initLazyBuiltins(LazyBuiltins group) {
+    if (LLVM_UNLIKELY(areBuiltinsDeferred(group)))
+      createDeferredBuiltins(group);
+  }
+
+  /// If the global property \p name belongs to a group of builtins whose
+  /// creation has been deferred, create the group.
+  /// \return true if builtins were created.
+  bool initLazyGlobal(SymbolID name);
+
+  /// Create all the builtins whose creation has been deferred.
+  void initAllLazyBuiltins();
+
   bool builtinsAreFrozen() const {
     return builtinsFrozen_;
   }
@@ -776,6 +865,21 @@ class Runtime : public HandleRootOwner,
   /// the GC of all runtime weak roots.
   void markWeakRoots(GCBase *gc, SlotAcceptorWithNames &acceptor) override;
 
+  /// Mark the pointers held directly in instance variables of the runtime.
+  void markInstanceVarRoots(SlotAcceptorWithNames &acceptor);
+
+  /// Mark the standard prototypes, constructors and other well-known objects
+  /// created by \c initGlobalObject().
+  void markPrototypeRoots(SlotAcceptorWithNames &acceptor);
+
+  /// Visit the roots which only refer to objects created during
+  /// initialization: the instance variables, the character strings, the
+  /// builtins, the prototypes, the identifier table and the symbol registry.
+  /// The order of the visit only depends on the configuration, which lets
+  /// \c RuntimeImage record these roots in one runtime and restore them in
+  /// another.
+  void markImageRoots(SlotAcceptorWithNames &acceptor);
+
   /// Visits every entry in the identifier table and calls acceptor with
   /// the entry and its id as arguments. This is intended to be used only for
   /// snapshots, as it is slow. The function passed as acceptor shouldn't
@@ -814,6 +918,10 @@ class Runtime : public HandleRootOwner,
   /// character.
   void initCharacterStrings();
 
+  /// Create the root hidden class, the global object with all the builtins,
+  /// and the other objects which exist before any code runs.
+  void initBuiltinObjects();
+
   /// Enumerate the builtin methods, and invoke the callback on each method.
   /// The parameters for the callback are:
   /// \param methodIndex is the index of the method in the table that lists
@@ -830,9 +938,18 @@ class Runtime : public HandleRootOwner,
                                      SymbolID methodID)> &callback);
 
   /// Populate the builtins table by extracting the values from the global
-  /// object.
+  /// object. Entries belonging to builtin objects which haven't been created
+  /// yet are left null.
   void initBuiltinTable();
 
+  /// Create the deferred builtins of \p group and add them to the builtins
+  /// table.
+  void createDeferredBuiltins(LazyBuiltins group);
+
+  /// The slow path of \c getBuiltinNativeFunction(), for a builtin method
+  /// whose object hasn't been created yet.
+  NativeFunction *getLazyBuiltinNativeFunction(unsigned builtinMethodID);
+
   /// Walk all the builtin methods, assert that they are not overridden. If they
   /// are, throw an exception. This will be called at most once, before freezing
   /// the builtins.
@@ -867,7 +984,8 @@ class Runtime : public HandleRootOwner,
 
  private:
   GC heap_;
-  std::vector<std::function<void(GC *, SlotAcceptor &)>> customMarkRootFuncs_;
+  std::vector<std::function<void(GC *, SlotAcceptor &, bool)>>
+      customMarkRootFuncs_;
 
   /// All state related to JIT compilation.
   JITContext jitContext_;
@@ -875,6 +993,9 @@ class Runtime : public HandleRootOwner,
   /// Set to true if we should enable ES6 Symbol.
   const bool hasES6Symbol_;
 
+  /// Bit set of the LazyBuiltins groups whose creation is deferred.
+  uint32_t lazyBuiltins_{0};
+
   /// Set to true if we should randomize stack placement etc.
   const bool shouldRandomizeMemoryLayout_;
 
@@ -884,6 +1005,15 @@ class Runtime : public HandleRootOwner,
   // Signal-based I/O tracking. Slows down execution.
   const bool trackIO_;
 
+  /// Set to true if lazy functions should be compiled on a background thread
+  /// before their first call.
+  const bool backgroundLazyCompilation_;
+
+#ifndef HERMESVM_LEAN
+  /// Created by getLazyCompilationThread().
+  std::unique_ptr<LazyCompilationThread> lazyCompilationThread_{};
+#endif
+
   /// This value can be passed to the runtime as flags to test experimental
   /// features. Each experimental feature decides how to interpret these
   /// values. Generally each experiment is associated with one or more bits of
@@ -901,6 +1031,7 @@ class Runtime : public HandleRootOwner,
   friend class JITContext;
   friend class ScopedNativeDepthTracker;
   friend class ScopedNativeCallFrame;
+  friend class RuntimeImage;
 
   class MarkRootsPhaseTimer;
 
@@ -1031,6 +1162,9 @@ class Runtime : public HandleRootOwner,
   /// we are sure it's safe to unregisterRuntime in destructor.
   std::shared_ptr<SamplingProfiler> samplingProfiler_;
 
+  /// Samples the allocations, while it is set.
+  std::unique_ptr<AllocationProfiler> allocationProfiler_;
+
 #ifdef HERMES_ENABLE_DEBUGGER
   Debugger debugger_{this};
 
@@ -1271,16 +1405,28 @@ class ScopedNativeCallFrame {
 
 template <typename F>
 inline void Runtime::addCustomRootsFunction(const F &markRootsFn) {
+  customMarkRootFuncs_.push_back(
+      [markRootsFn](GC *gc, SlotAcceptor &acceptor, bool) {
+        markRootsFn(gc, acceptor);
+      });
+}
+
+template <typename F>
+inline void Runtime::addCustomGenerationalRootsFunction(const F &markRootsFn) {
   customMarkRootFuncs_.push_back(markRootsFn);
 }
 
 template <bool fixedSize, HasFinalizer hasFinalizer>
 inline void *Runtime::alloc(uint32_t sz) {
+  if (LLVM_UNLIKELY(allocationProfiler_))
+    allocationProfiler_->countAlloc(sz);
   return heap_.alloc<fixedSize, hasFinalizer>(sz);
 }
 
 template <HasFinalizer hasFinalizer>
 inline void *Runtime::allocLongLived(uint32_t size) {
+  if (LLVM_UNLIKELY(allocationProfiler_))
+    allocationProfiler_->countAlloc(size);
   return heap_.allocLongLived<hasFinalizer>(size);
 }
 
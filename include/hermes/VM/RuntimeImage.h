@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_RUNTIMEIMAGE_H
+#define HERMES_VM_RUNTIMEIMAGE_H
+
+#include "hermes/VM/HermesValue.h"
+#include "hermes/VM/HiddenClass.h"
+#include "hermes/VM/IdentifierTable.h"
+#include "hermes/VM/Runtime.h"
+
+#include <memory>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// A relocatable copy of the heap of a freshly initialized Runtime: the
+/// builtin objects, functions, hidden classes and strings created by
+/// initCharacterStrings() and initGlobalObject(), together with the runtime
+/// roots that refer to them and the identifier table.
+///
+/// Restoring an image allocates every cell with allocLongLived(), copies its
+/// bytes and patches its pointers, which is much cheaper than running the
+/// initialization code again. An image is independent of the address of the
+/// runtime it was captured from, and can be restored into any number of
+/// runtimes in the process, in any thread.
+///
+/// The image does not contain anything that refers to bytecode (the special
+/// code block runtime module, CodeBlocks, Domains) or to malloc memory owned by
+/// a cell. Capturing fails if such a cell is reachable from the roots; the
+/// runtime then falls back to the regular initialization.
+class RuntimeImage {
+ public:
+  /// \return the image of a runtime initialized with the given configuration,
+  /// capturing it on first use. The image is shared by every caller in the
+  /// process. Returns nullptr if an image can't be captured.
+  static std::shared_ptr<const RuntimeImage> get(
+      bool hasES6Symbol,
+      bool lazyBuiltins);
+
+  /// Capture the image of \p runtime, which must have just been constructed.
+  /// \return nullptr if the heap of \p runtime contains cells which can't be
+  /// copied into another runtime.
+  static std::unique_ptr<RuntimeImage> capture(Runtime *runtime);
+
+  /// Populate the heap and the roots of \p runtime from the image. This
+  /// replaces everything in the Runtime constructor from initCharacterStrings()
+  /// on, except for the initialization of the special code block runtime
+  /// module. The identifier table of \p runtime must still be empty.
+  void restore(Runtime *runtime) const;
+
+  /// \return the number of cells in the image.
+  size_t getNumCells() const {
+    return cells_.size();
+  }
+
+  /// \return the total size of the cells in the image, in bytes.
+  size_t getHeapSize() const {
+    return heap_.size();
+  }
+
+ private:
+  /// Marks an entry without a target cell.
+  static constexpr uint32_t kNoTarget = ~0u;
+
+  /// The kind of slot a relocation applies to.
+  enum class SlotKind : uint8_t { Raw, Pointer, Value };
+
+  /// A cell in the image.
+  struct CellInfo {
+    /// Offset of the cell's bytes in heap_.
+    uint32_t offset;
+    /// Size of the cell in bytes.
+    uint32_t size;
+    /// Whether the cell must be allocated with a finalizer.
+    bool hasFinalizer;
+  };
+
+  /// A pointer slot inside a cell which must be redirected to the copy of
+  /// another cell after the cells have been allocated.
+  struct Relocation {
+    /// The index of the cell containing the slot.
+    uint32_t cell;
+    /// The offset of the slot from the start of the cell.
+    uint32_t offset;
+    /// The index of the cell the slot points to.
+    uint32_t target;
+    SlotKind kind;
+    /// For SlotKind::Value, the original value, which supplies the tag.
+    HermesValue value;
+  };
+
+  /// A root slot, in the order of Runtime::markImageRoots().
+  struct Root {
+    /// The index of the cell the slot points to, or kNoTarget.
+    uint32_t target;
+    /// The original value of a HermesValue slot.
+    HermesValue value;
+  };
+
+  /// A transition between two hidden classes in the image.
+  struct Transition {
+    uint32_t from;
+    uint32_t to;
+    HiddenClass::Transition key;
+  };
+
+  /// Records the slots passed to an acceptor.
+  struct SlotRecorder;
+  /// Writes the recorded roots to the roots of a runtime.
+  struct RootWriter;
+
+  RuntimeImage() = default;
+
+  /// The bytes of all cells, with every pointer replaced by null.
+  std::vector<char> heap_{};
+  std::vector<CellInfo> cells_{};
+  std::vector<Relocation> relocations_{};
+  std::vector<Root> roots_{};
+  std::vector<Transition> transitions_{};
+
+  /// The identifier table. Its string primitives point into the heap of the
+  /// captured runtime, and are redirected by the corresponding roots.
+  IdentifierTable identifiers_{};
+
+  /// The sizes of the variable size root arrays.
+  size_t numCharStrings_{0};
+  size_t numBuiltins_{0};
+
+  /// The next object ID of the captured runtime.
+  ObjectID nextObjectID_{0};
+
+  /// The groups of builtins whose creation the captured runtime deferred.
+  uint32_t lazyBuiltins_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_RUNTIMEIMAGE_H
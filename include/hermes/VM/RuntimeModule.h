@@ -44,6 +44,10 @@ union RuntimeModuleFlags {
     /// Whether this runtime module's epilogue should be hidden in
     /// runtime.getEpilogues().
     bool hidesEpilogue : 1;
+
+    /// Whether this runtime module records the order in which its functions
+    /// are first used, see RuntimeModule::getFunctionOrder().
+    bool recordsFunctionOrder : 1;
   };
   uint8_t flags;
   RuntimeModuleFlags() : flags(0) {}
@@ -77,6 +81,21 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// SymbolID.
   std::vector<SymbolID> stringIDMap_;
 
+  /// A run of consecutive strings of the same kind in the string table of
+  /// the bytecode.
+  struct StringRun {
+    /// The string ID of the first string of the run.
+    StringID first;
+    /// The index of the translation of the first string, if the run consists
+    /// of identifiers.
+    uint32_t firstTranslation;
+    StringKind::Kind kind;
+  };
+
+  /// The runs of the string table, sorted by string ID, if the identifiers of
+  /// this module are imported when they are first used. Otherwise empty.
+  std::vector<StringRun> stringRuns_{};
+
   /// Weak pointer to a GC-managed Domain that owns this RuntimeModule.
   /// NOTE: This will not be made invalid through marking, because the domain
   /// updates the WeakRefs on the RuntimeModule when it is marked.
@@ -89,12 +108,19 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// The table maps from a function index to a CodeBlock.
   std::vector<CodeBlock *> functionMap_{};
 
-  /// The byte-code provider for this RuntimeModule. The RuntimeModule is
-  /// designed to own the provider exclusively, especially because in some
-  /// cases the bytecode can be modified (e.g. for breakpoints). This however
-  /// is a shared_ptr<> instead of unique_ptr<> for a pragmatic reason - when
-  /// we run performance tests, we want to re-use a BCProvider between runtimes
-  /// in order to minimize the noise.
+  /// The indices of the functions in the order in which their CodeBlocks were
+  /// created, if flags_.recordsFunctionOrder is set.
+  std::vector<uint32_t> functionOrder_{};
+
+  /// The byte-code provider for this RuntimeModule. A provider loaded from a
+  /// buffer is immutable and may be shared by the RuntimeModules of several
+  /// runtimes, also on different threads (e.g. one runtime per worker thread
+  /// evaluating the same jsi::PreparedJavaScript). Everything that depends on
+  /// the runtime, like stringIDMap_ and functionMap_, is kept here instead.
+  /// The exception is the debugger, which installs breakpoints by patching
+  /// the bytecode, so a shared provider should only be debugged in one
+  /// runtime at a time. Providers compiled from source with lazy compilation
+  /// are modified when a function is compiled and must not be shared.
   std::shared_ptr<hbc::BCProvider> bcProvider_{};
 
   /// Flags associated with the module.
@@ -110,6 +136,12 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// Cacheing will be skipped if keyBufferIndex is >= 2^24.
   llvm::DenseMap<uint32_t, HiddenClass *> objectLiteralHiddenClasses_;
 
+  /// A map from NewObjectWithBuffer's <valBufferIndex, numLiterals> tuple to
+  /// the decoded values of the literal, hashed like the keys of
+  /// objectLiteralHiddenClasses_. Together with the cached hidden class, this
+  /// is the template from which later executions create the object.
+  llvm::DenseMap<uint32_t, std::vector<HermesValue>> objectLiteralValues_;
+
   /// A map from template object ids to template objects.
   llvm::DenseMap<uint32_t, JSObject *> templateMap_;
 
@@ -200,14 +232,15 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   void prepareForRuntimeShutdown();
 
   /// For opcodes that use a stringID as identifier explicitly, we know that
-  /// the compiler would have marked the stringID as identifier, and hence
-  /// we should have created the symbol during identifier table initialization.
-  /// The symbol must already exist in the map. This is a fast path.
+  /// the compiler would have marked the stringID as identifier. Its symbol
+  /// was either created during identifier table initialization, or, in a
+  /// persistent module, is registered as a lazy identifier on first use, which
+  /// doesn't allocate in the GC heap. This is a fast path.
   SymbolID getSymbolIDMustExist(StringID stringID) {
-    assert(
-        stringIDMap_[stringID].isValid() &&
-        "Symbol must exist for this string ID");
-    return stringIDMap_[stringID];
+    SymbolID id = stringIDMap_[stringID];
+    if (LLVM_UNLIKELY(!id.isValid()))
+      id = importIdentifier(stringID);
+    return id;
   }
 
   /// \return the \c SymbolID for a string by string index. The symbol may not
@@ -217,8 +250,7 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     SymbolID id = stringIDMap_[stringID];
     if (LLVM_UNLIKELY(!id.isValid())) {
       // Materialize this lazily created symbol.
-      auto entry = bcProvider_->getStringTableEntry(stringID);
-      id = createSymbolFromStringIDMayAllocate(stringID, entry, llvm::None);
+      id = importStringMayAllocate(stringID);
     }
     assert(id.isValid() && "Failed to create symbol for stringID");
     return id;
@@ -290,6 +322,14 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     return functionMap_;
   }
 
+  /// \return the indices of the functions whose CodeBlocks have been created,
+  /// in the order in which that happened. This approximates the order in
+  /// which the functions are first run, and is only recorded if the module
+  /// was created with the recordsFunctionOrder flag.
+  llvm::ArrayRef<uint32_t> getFunctionOrder() const {
+    return functionOrder_;
+  }
+
   /// \return the sourceURL, or an empty string if none.
   llvm::StringRef getSourceURL() const {
     return sourceURL_;
@@ -319,6 +359,11 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// RuntimeModule.
   size_t additionalMemorySize() const;
 
+  /// Drop the caches of object literal hidden classes and values, which are
+  /// recreated when the literals are used again. The template object map is
+  /// kept, since template objects must keep their identity.
+  void clearCaches();
+
   /// Find the cached hidden class for an object literal, if one exists.
   /// \param keyBufferIndex value of NewObjectWithBuffer instruction.
   /// \param numLiterals number of literals used from key buffer of
@@ -334,6 +379,17 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// \param clazz the hidden class to cache.
   void tryCacheLiteralHiddenClass(unsigned keyBufferIndex, HiddenClass *clazz);
 
+  /// \return the values of an object literal decoded from the value buffer,
+  /// or None if they can't be cached. They are decoded the first time, and
+  /// the strings among them are stored as the SymbolIDs of their identifiers,
+  /// so that none of the values is a pointer into the GC heap.
+  /// \param valBufferIndex value of NewObjectWithBuffer instruction.
+  /// \param numLiterals number of literals used from value buffer of
+  /// NewObjectWithBuffer instruction.
+  llvm::Optional<llvm::ArrayRef<HermesValue>> getLiteralValuesMayAllocate(
+      unsigned valBufferIndex,
+      unsigned numLiterals);
+
   /// Given \p templateObjectID, retrieve the cached template object.
   /// if it doesn't exist, return a nullptr.
   JSObject *findCachedTemplateObject(uint32_t templateObjID) {
@@ -358,6 +414,9 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// Import the string table from the supplied module.
   void importStringIDMapMayAllocate();
 
+  /// Map string ID 0 to the empty string, for a module without strings.
+  void mapEmptyString();
+
   /// Initialize functionMap_, without actually creating the code blocks.
   /// They will be created lazily when needed.
   void initializeFunctionMap();
@@ -385,6 +444,20 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// predefined string, an assertion will be triggered (if they are enabled).
   SymbolID mapPredefined(StringID stringID, uint32_t rawSymbolID);
 
+  /// \return the run of the string table containing \p stringID, or nullptr
+  /// if identifiers are imported eagerly.
+  const StringRun *findStringRun(StringID stringID) const;
+
+  /// Create the symbol of \p stringID, which is an identifier that hasn't been
+  /// used yet, using the hash precomputed by the compiler. Doesn't allocate in
+  /// the GC heap. \return the symbol ID.
+  SymbolID importIdentifier(StringID stringID);
+
+  /// Create the symbol of \p stringID, which hasn't been used yet, using the
+  /// hash precomputed by the compiler if it is an identifier. \return the
+  /// symbol ID.
+  SymbolID importStringMayAllocate(StringID stringID);
+
   /// Create a symbol from a given \p stringID, which is an index to the
   /// string table, corresponding to the entry \p entry. If \p mhash is not
   /// None, use it as the hash; otherwise compute the hash from the string
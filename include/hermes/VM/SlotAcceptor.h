@@ -22,6 +22,10 @@ class WeakRefBase;
 /// This is used by a visitor, see \c SlotVisitor.
 struct SlotAcceptor {
   static constexpr bool shouldMarkWeak = true;
+  /// Set by the marking acceptors of full collections, which skip the entries
+  /// of EphemeronChunks and let the GC mark them once the rest of the heap has
+  /// been marked. See GCBase::recordEphemeronChunk.
+  static constexpr bool shouldDeferEphemerons = false;
 
   virtual ~SlotAcceptor() {}
   virtual void accept(void *&ptr) = 0;
@@ -17,17 +17,19 @@ namespace hermes {
 namespace vm {
 
 struct SnapshotEdgeAcceptor final : public SlotAcceptorWithNamesDefault {
-  V8HeapSnapshot &snap;
+  /// Adds an edge to the snapshot, which may be a V8HeapSnapshot or a
+  /// BinaryHeapSnapshot.
+  std::function<void(V8HeapSnapshot::Edge &&edge)> addEdge;
   std::function<uintptr_t(const void *)> ptrToOffset;
   std::function<V8HeapSnapshot::StringID(llvm::StringRef str)> stringToID;
 
   SnapshotEdgeAcceptor(
       GC &gc,
-      V8HeapSnapshot &snap,
+      std::function<void(V8HeapSnapshot::Edge &&edge)> addEdge,
       std::function<uintptr_t(const void *)> ptrToOffset,
       std::function<V8HeapSnapshot::StringID(llvm::StringRef str)> stringToID)
       : SlotAcceptorWithNamesDefault(gc),
-        snap(snap),
+        addEdge(addEdge),
         ptrToOffset(ptrToOffset),
         stringToID(stringToID) {}
 
@@ -343,6 +343,11 @@ class ContigAllocGCSpace : public GCSpace {
   /// Dump detailed heap contents to the given output stream, \p os.
   void dump(llvm::raw_ostream &os) const;
 
+  /// Invokes callback on all GCCells in the space.
+  void forAllObjs(std::function<void(GCCell *)> callback) {
+    forObjsInRange(callback, start_, level_);
+  }
+
 #ifndef NDEBUG
   /// Returns true iff \p p is located within a valid section of the space, and
   /// not at dead memory.
@@ -387,17 +392,10 @@ class ContigAllocGCSpace : public GCSpace {
   /// Keeps track of all cells on the heap with finalizers.
   std::vector<GCCell *> cellsWithFinalizers_;
 
-#ifndef NDEBUG
   /// Assumes that \p low is the address of an allocated GC cell.
   /// Invokes \p callback on all GCCells whose start address is in [low, high).
   void
   forObjsInRange(std::function<void(GCCell *)> callback, char *low, char *high);
-
-  /// Invokes callback on all GCCells in the space.
-  void forAllObjs(std::function<void(GCCell *)> callback) {
-    forObjsInRange(callback, start_, level_);
-  }
-#endif
 };
 
 // Inline function implementations
@@ -42,6 +42,15 @@ class StorageProvider {
   /// Provide storage via malloc.
   static std::unique_ptr<StorageProvider> mallocProvider();
 
+  /// Provide storage from mmap'ed regions of several storages each, which
+  /// the OS is asked to back with transparent huge pages to reduce TLB misses
+  /// during heap traversals. Regions are kept until the provider is destroyed;
+  /// deleted storages have their pages returned to the OS and are re-used.
+  /// \param preferLocalNUMANode If true, ask the OS to place the pages on the
+  ///   NUMA node of the thread calling this function, when it has the memory.
+  static std::unique_ptr<StorageProvider> hugePageProvider(
+      bool preferLocalNUMANode);
+
   /// @}
 
   /// Create a new segment memory space.
@@ -182,6 +182,10 @@ class YoungGen : public GCGeneration {
   /// Static override of GCGeneration::didFinishGC().
   void didFinishGC();
 
+  /// Copy the reachable objects into the nextGen, like collect(), as part of
+  /// a full collection which left the objects of the nextGen in place.
+  void evacuate();
+
   /// Called after the GC's heap has been copied to a new location, in order to
   /// update the references in this space (and the space's own limits) to the
   /// new location.
@@ -213,6 +217,9 @@ class YoungGen : public GCGeneration {
       HasFinalizer hasFinalizer,
       bool fixedSizeAlloc);
 
+  /// The GC collects the young generation directly when idle.
+  friend class GenGC;
+
 #ifndef NDEBUG
   /// In debug builds, we expose the collect call to tests.
  public:
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/BCGen/HBC/BytecodeCompression.h"
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/Support/ErrorHandling.h"
+#include "hermes/Support/OSCompat.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Compression.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+
+namespace {
+
+/// Size of the blocks outside of the function bodies, which are all
+/// decompressed on load, so they may be large.
+constexpr uint32_t kEagerBlockSize = 256 * 1024;
+
+/// Minimum size of the blocks of function bodies. A block ends at the start
+/// of the first function past this size, so that the body of every function
+/// is in a single block. Smaller blocks touch less memory for the functions
+/// that never run, but compress worse.
+constexpr uint32_t kLazyBlockSize = 32 * 1024;
+
+} // namespace
+
+bool isBytecodeCompressionAvailable() {
+  return llvm::zlib::isAvailable();
+}
+
+bool compressedBytecodeSanityCheck(
+    llvm::ArrayRef<uint8_t> aref,
+    std::string *errorMessage) {
+  auto fail = [errorMessage](const char *msg) {
+    if (errorMessage) {
+      *errorMessage = msg;
+    }
+    return false;
+  };
+  if (!isCompressedBytecode(aref)) {
+    return fail("Incorrect magic number");
+  }
+  const auto *header =
+      reinterpret_cast<const CompressedBytecodeHeader *>(aref.data());
+  if (header->version != BYTECODE_VERSION) {
+    if (errorMessage) {
+      llvm::raw_string_ostream errs(*errorMessage);
+      errs << "Wrong bytecode version. Expected " << BYTECODE_VERSION
+           << " but got " << header->version;
+    }
+    return false;
+  }
+  if (header->containerLength > aref.size()) {
+    return fail("Compressed bytecode is truncated");
+  }
+  if (sizeof(CompressedBytecodeHeader) +
+          uint64_t(header->blockCount) * sizeof(CompressedBytecodeBlock) >
+      header->containerLength) {
+    return fail("Compressed bytecode block table is truncated");
+  }
+  if (header->fileLength < sizeof(BytecodeFileHeader) ||
+      header->lazyBegin > header->lazyEnd ||
+      header->lazyEnd > header->fileLength) {
+    return fail("Compressed bytecode header is invalid");
+  }
+
+  // The blocks must cover the decompressed file in order, and each one must
+  // be either entirely in the function bodies, or entirely outside of them.
+  const auto *blocks = reinterpret_cast<const CompressedBytecodeBlock *>(
+      aref.data() + sizeof(CompressedBytecodeHeader));
+  uint64_t expectedOffset = 0;
+  for (uint32_t i = 0; i < header->blockCount; ++i) {
+    const CompressedBytecodeBlock &block = blocks[i];
+    if (block.offset != expectedOffset || block.size == 0) {
+      return fail("Compressed bytecode blocks are not contiguous");
+    }
+    expectedOffset += block.size;
+    const bool inBodies = block.offset >= header->lazyBegin &&
+        expectedOffset <= header->lazyEnd;
+    const bool outsideBodies = expectedOffset <= header->lazyBegin ||
+        block.offset >= header->lazyEnd;
+    if (!inBodies && !outsideBodies) {
+      return fail("Compressed bytecode block straddles the function bodies");
+    }
+    if (uint64_t(block.compressedOffset) + block.compressedSize >
+        header->containerLength) {
+      return fail("Compressed bytecode block is truncated");
+    }
+  }
+  if (expectedOffset != header->fileLength) {
+    return fail("Compressed bytecode blocks don't cover the file");
+  }
+  return true;
+}
+
+bool compressBytecode(
+    llvm::ArrayRef<uint8_t> bytecode,
+    llvm::raw_ostream &OS,
+    std::string *outError) {
+  if (!isBytecodeCompressionAvailable()) {
+    *outError = "Bytecode compression is not supported by this build";
+    return false;
+  }
+  if (isCompressedBytecode(bytecode)) {
+    *outError = "Bytecode is already compressed";
+    return false;
+  }
+  if (!BCProviderFromBuffer::bytecodeStreamSanityCheck(bytecode, outError)) {
+    return false;
+  }
+  const auto *fileHeader =
+      reinterpret_cast<const BytecodeFileHeader *>(bytecode.data());
+  const uint32_t fileLength = fileHeader->fileLength;
+  if (fileLength > bytecode.size()) {
+    *outError = "Bytecode is truncated";
+    return false;
+  }
+  auto ret = BCProviderFromBuffer::createBCProviderFromBuffer(
+      llvm::make_unique<Buffer>(bytecode.data(), fileLength));
+  if (!ret.first) {
+    *outError = ret.second;
+    return false;
+  }
+
+  // Find the start of every function body. The function bodies are
+  // contiguous, and followed by the function info, so they end at the first
+  // info offset.
+  std::vector<uint32_t> bodies{};
+  bodies.reserve(fileHeader->functionCount);
+  uint32_t lazyEnd = std::min(fileLength, fileHeader->debugInfoOffset);
+  for (uint32_t i = 0; i < fileHeader->functionCount; ++i) {
+    RuntimeFunctionHeader header = ret.first->getFunctionHeader(i);
+    bodies.push_back(header.offset());
+    lazyEnd = std::min(lazyEnd, header.infoOffset());
+  }
+  std::sort(bodies.begin(), bodies.end());
+  bodies.erase(std::unique(bodies.begin(), bodies.end()), bodies.end());
+  const uint32_t lazyBegin = std::min(bodies.front(), lazyEnd);
+
+  // Lay out the blocks.
+  std::vector<CompressedBytecodeBlock> blocks{};
+  auto addEagerBlocks = [&blocks](uint32_t begin, uint32_t end) {
+    for (uint32_t offset = begin; offset < end; offset += kEagerBlockSize) {
+      blocks.push_back(
+          {offset, std::min(kEagerBlockSize, end - offset), 0, 0});
+    }
+  };
+  addEagerBlocks(0, lazyBegin);
+  uint32_t blockStart = lazyBegin;
+  for (uint32_t body : bodies) {
+    if (body < lazyEnd && body - blockStart >= kLazyBlockSize) {
+      blocks.push_back({blockStart, body - blockStart, 0, 0});
+      blockStart = body;
+    }
+  }
+  if (blockStart < lazyEnd) {
+    blocks.push_back({blockStart, lazyEnd - blockStart, 0, 0});
+  }
+  addEagerBlocks(lazyEnd, fileLength);
+
+  // Compress them.
+  const uint64_t dataStart = sizeof(CompressedBytecodeHeader) +
+      blocks.size() * sizeof(CompressedBytecodeBlock);
+  std::string data{};
+  llvm::SmallVector<char, 0> compressed{};
+  for (CompressedBytecodeBlock &block : blocks) {
+    llvm::StringRef input{
+        reinterpret_cast<const char *>(bytecode.data()) + block.offset,
+        block.size};
+    if (llvm::Error err = llvm::zlib::compress(
+            input, compressed, llvm::zlib::BestSizeCompression)) {
+      *outError = llvm::toString(std::move(err));
+      return false;
+    }
+    if (dataStart + data.size() + compressed.size() > UINT32_MAX) {
+      *outError = "Compressed bytecode is too large";
+      return false;
+    }
+    block.compressedOffset = dataStart + data.size();
+    block.compressedSize = compressed.size();
+    data.append(compressed.begin(), compressed.end());
+  }
+
+  CompressedBytecodeHeader header{};
+  header.magic = COMPRESSED_MAGIC;
+  header.version = BYTECODE_VERSION;
+  std::copy(
+      fileHeader->sourceHash,
+      fileHeader->sourceHash + SHA1_NUM_BYTES,
+      header.sourceHash);
+  header.fileLength = fileLength;
+  header.containerLength = dataStart + data.size();
+  header.blockCount = blocks.size();
+  header.lazyBegin = lazyBegin;
+  header.lazyEnd = lazyEnd;
+
+  OS.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  OS.write(
+      reinterpret_cast<const char *>(blocks.data()),
+      blocks.size() * sizeof(CompressedBytecodeBlock));
+  OS << data;
+  // The epilogue is kept as is, so that it can be read without decompressing.
+  OS.write(
+      reinterpret_cast<const char *>(bytecode.data()) + fileLength,
+      bytecode.size() - fileLength);
+  return true;
+}
+
+DecompressedBytecodeBuffer::DecompressedBytecodeBuffer(
+    std::unique_ptr<const Buffer> container,
+    uint8_t *memory,
+    size_t memorySize)
+    : container_(std::move(container)),
+      header_(reinterpret_cast<const CompressedBytecodeHeader *>(
+          container_->data())),
+      blocks_(
+          reinterpret_cast<const CompressedBytecodeBlock *>(
+              container_->data() + sizeof(CompressedBytecodeHeader)),
+          header_->blockCount),
+      memory_(memory),
+      memorySize_(memorySize),
+      decompressed_(new std::atomic<bool>[header_->blockCount]) {
+  data_ = memory_;
+  size_ = header_->fileLength;
+  for (uint32_t i = 0; i < header_->blockCount; ++i) {
+    decompressed_[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+DecompressedBytecodeBuffer::~DecompressedBytecodeBuffer() {
+  oscompat::vm_free(memory_, memorySize_);
+}
+
+std::unique_ptr<DecompressedBytecodeBuffer> DecompressedBytecodeBuffer::create(
+    std::unique_ptr<const Buffer> container,
+    std::string *outError) {
+  if (!isBytecodeCompressionAvailable()) {
+    *outError = "Compressed bytecode is not supported by this build";
+    return nullptr;
+  }
+  if (!compressedBytecodeSanityCheck(
+          {container->data(), container->size()}, outError)) {
+    return nullptr;
+  }
+  const auto *header =
+      reinterpret_cast<const CompressedBytecodeHeader *>(container->data());
+  // The pages of the reserved memory are only backed once they are written.
+  const size_t memorySize =
+      llvm::alignTo(header->fileLength, oscompat::page_size());
+  auto memory = oscompat::vm_allocate(memorySize);
+  if (!memory) {
+    *outError = "Could not allocate memory for the decompressed bytecode: " +
+        memory.getError().message();
+    return nullptr;
+  }
+  std::unique_ptr<DecompressedBytecodeBuffer> buffer{
+      new DecompressedBytecodeBuffer(
+          std::move(container), static_cast<uint8_t *>(*memory), memorySize)};
+  for (size_t i = 0, e = buffer->blocks_.size(); i < e; ++i) {
+    const CompressedBytecodeBlock &block = buffer->blocks_[i];
+    if (block.offset >= header->lazyBegin && block.offset < header->lazyEnd) {
+      continue;
+    }
+    if (!buffer->decompressBlock(i)) {
+      *outError = "Could not decompress the bytecode";
+      return nullptr;
+    }
+    buffer->decompressed_[i].store(true, std::memory_order_relaxed);
+  }
+  return buffer;
+}
+
+void DecompressedBytecodeBuffer::decompressLazyBlock(uint32_t offset) const {
+  // Find the last block starting at or before offset.
+  auto it = std::upper_bound(
+      blocks_.begin(),
+      blocks_.end(),
+      offset,
+      [](uint32_t offset, const CompressedBytecodeBlock &block) {
+        return offset < block.offset;
+      });
+  assert(it != blocks_.begin() && "the blocks start at offset 0");
+  const size_t index = it - blocks_.begin() - 1;
+  if (decompressed_[index].load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (decompressed_[index].load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (!decompressBlock(index)) {
+    hermes_fatal("Could not decompress a block of function bodies");
+  }
+  decompressed_[index].store(true, std::memory_order_release);
+}
+
+bool DecompressedBytecodeBuffer::decompressBlock(size_t index) const {
+  const CompressedBytecodeBlock &block = blocks_[index];
+  llvm::StringRef input{
+      reinterpret_cast<const char *>(container_->data()) +
+          block.compressedOffset,
+      block.compressedSize};
+  size_t size = block.size;
+  if (llvm::Error err = llvm::zlib::uncompress(
+          input, reinterpret_cast<char *>(memory_) + block.offset, size)) {
+    llvm::consumeError(std::move(err));
+    return false;
+  }
+  return size == block.size;
+}
+
+} // namespace hbc
+} // namespace hermes
@@ -5,6 +5,7 @@
  * file in the root directory of this source tree.
  */
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/BCGen/HBC/BytecodeCompression.h"
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/Support/ErrorHandling.h"
 #include "hermes/Support/OSCompat.h"
@@ -296,6 +297,7 @@ warmup(const uint8_t *data, uint32_t size, std::atomic<bool> *abortFlag) {
 }
 
 void BCProviderFromBuffer::stopWarmup() {
+  std::lock_guard<std::mutex> lock{startMutex_};
   if (warmupThread_) {
     warmupAbortFlag_.store(true, std::memory_order_release);
     warmupThread_->join();
@@ -304,6 +306,12 @@ void BCProviderFromBuffer::stopWarmup() {
 }
 
 void BCProviderFromBuffer::startWarmup(uint8_t percent) {
+  // The function bodies of a compressed file are decompressed as they are
+  // first run, touching its pages ahead of time would only waste memory.
+  if (decompressed_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock{startMutex_};
   if (!warmupThread_) {
     uint32_t warmupSize = buffer_->size();
     assert(percent <= 100);
@@ -447,15 +455,31 @@ void BCProviderFromBuffer::willNeedStringTable() {
 #undef ASSERT_TOTAL_ARRAY_LEN
 
 void BCProviderFromBuffer::startPageAccessTracker() {
-  auto size = buffer_->size();
+  // Function bodies are decompressed into the buffer of a compressed file as
+  // they are first run, and the tracker only grants read access. Track the
+  // reads of the compressed file instead, which is where the I/O happens.
+  llvm::ArrayRef<uint8_t> tracked = decompressed_
+      ? decompressed_->getContainer()
+      : llvm::ArrayRef<uint8_t>(bufferPtr_, buffer_->size());
+  std::lock_guard<std::mutex> lock{startMutex_};
   if (!tracker_) {
-    tracker_ =
-        PageAccessTracker::create(const_cast<uint8_t *>(bufferPtr_), size);
+    tracker_ = PageAccessTracker::create(
+        const_cast<uint8_t *>(tracked.data()), tracked.size());
   }
 }
 
 BCProviderFromBuffer::BCProviderFromBuffer(std::unique_ptr<const Buffer> buffer)
     : buffer_(std::move(buffer)), bufferPtr_(buffer_->data()) {
+  if (isCompressedBytecode({bufferPtr_, buffer_->size()})) {
+    auto decompressed =
+        DecompressedBytecodeBuffer::create(std::move(buffer_), &errstr_);
+    if (!decompressed) {
+      return;
+    }
+    decompressed_ = decompressed.get();
+    buffer_ = std::move(decompressed);
+    bufferPtr_ = buffer_->data();
+  }
   ConstBytecodeFileFields fields;
   if (!fields.populateFromBuffer({bufferPtr_, buffer_->size()}, &errstr_)) {
     return;
@@ -483,8 +507,10 @@ BCProviderFromBuffer::BCProviderFromBuffer(std::unique_ptr<const Buffer> buffer)
 }
 
 llvm::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogue() const {
+  // The epilogue of a compressed file is only in its container.
   return BCProviderFromBuffer::getEpilogueFromBytecode(
-      llvm::ArrayRef<uint8_t>(bufferPtr_, buffer_->size()));
+      decompressed_ ? decompressed_->getContainer()
+                    : llvm::ArrayRef<uint8_t>(bufferPtr_, buffer_->size()));
 }
 
 SHA1 BCProviderFromBuffer::getSourceHash() const {
@@ -495,6 +521,10 @@ SHA1 BCProviderFromBuffer::getSourceHash() const {
 llvm::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogueFromBytecode(
     llvm::ArrayRef<uint8_t> buffer) {
   const uint8_t *p = buffer.data();
+  if (isCompressedBytecode(buffer)) {
+    const auto *header = castData<hbc::CompressedBytecodeHeader>(p);
+    return buffer.slice(header->containerLength);
+  }
   const auto *fileHeader = castData<hbc::BytecodeFileHeader>(p);
   const auto *begin = buffer.data() + fileHeader->fileLength;
   const auto *end = buffer.data() + buffer.size();
@@ -505,6 +535,12 @@ SHA1 BCProviderFromBuffer::getSourceHashFromBytecode(
     llvm::ArrayRef<uint8_t> buffer) {
   SHA1 hash;
   const uint8_t *p = buffer.data();
+  if (isCompressedBytecode(buffer)) {
+    const auto *header = castData<hbc::CompressedBytecodeHeader>(p);
+    std::copy(
+        header->sourceHash, header->sourceHash + SHA1_NUM_BYTES, hash.begin());
+    return hash;
+  }
   const auto *fileHeader = castData<hbc::BytecodeFileHeader>(p);
   std::copy(
       fileHeader->sourceHash,
@@ -588,6 +624,15 @@ void BCProviderFromBuffer::prefetch(llvm::ArrayRef<uint8_t> aref) {
   assert(
       reinterpret_cast<uintptr_t>(aref.data()) % oscompat::page_size() == 0 &&
       "Precondition: pointer is page-aligned.");
+  if (isCompressedBytecode(aref)) {
+    // Most of the container is read when it is loaded.
+    if (compressedBytecodeSanityCheck(aref)) {
+      const auto *header =
+          reinterpret_cast<const hbc::CompressedBytecodeHeader *>(aref.data());
+      prefetchRegion(aref.data(), header->containerLength);
+    }
+    return;
+  }
   ConstBytecodeFileFields fields;
   std::string errstr;
   if (!fields.populateFromBuffer(aref, &errstr)) {
@@ -621,6 +666,9 @@ void BCProviderFromBuffer::prefetch(llvm::ArrayRef<uint8_t> aref) {
 bool BCProviderFromBuffer::bytecodeStreamSanityCheck(
     llvm::ArrayRef<uint8_t> aref,
     std::string *errorMessage) {
+  if (isCompressedBytecode(aref)) {
+    return compressedBytecodeSanityCheck(aref, errorMessage);
+  }
   return sanityCheck(aref, BytecodeForm::Execution, errorMessage);
 }
 
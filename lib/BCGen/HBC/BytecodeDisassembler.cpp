@@ -797,7 +797,11 @@ BytecodeSectionWalker::BytecodeSectionWalker(
       bcProvider->getCJSModuleTable().begin(),
       bcProvider->getCJSModuleTable().end());
 
+  // Function bodies may be laid out in any order.
   auto firstFuncStart = bcProvider->getBytecode(0);
+  for (uint32_t i = 1, e = bcProvider->getFunctionCount(); i < e; ++i) {
+    firstFuncStart = std::min(firstFuncStart, bcProvider->getBytecode(i));
+  }
   auto firstFuncHeader = bcProvider->getFunctionHeader(0);
   auto firstFuncInfoStart = bytecodeStart + firstFuncHeader.infoOffset();
   auto debugInfoStart = bytecodeStart + fileHeader->debugInfoOffset;
@@ -8,7 +8,9 @@
 
 #include "hermes/BCGen/HBC/ConsecutiveStringStorage.h"
 #include "hermes/Inst/Builtins.h"
+#include "hermes/Inst/InstDecode.h"
 #include "hermes/Support/OSCompat.h"
+#include "hermes/Support/Statistic.h"
 #include "hermes/Support/UTF8.h"
 
 #include "llvm/ADT/SmallString.h"
@@ -18,6 +20,10 @@
 #include <locale>
 #include <unordered_map>
 
+#define DEBUG_TYPE "hbc-backend"
+
+STATISTIC(NumSuperinstructions, "Number of superinstructions selected");
+
 using hermes::oscompat::to_string;
 
 namespace hermes {
@@ -112,6 +118,22 @@ void BytecodeFunctionGenerator::shrinkJump(offset_t loc) {
   longToShortJump(loc - 1);
 }
 
+void BytecodeFunctionGenerator::selectSuperinstructions() {
+  offset_t next;
+  for (offset_t loc = 0, e = opcodes_.size(); loc < e; loc = next) {
+    next = loc + inst::getInstSize((inst::OpCode)opcodes_[loc]);
+    if (next >= e)
+      break;
+#define DEFINE_SUPERINSTRUCTION(name, first, second)              \
+  if (opcodes_[loc] == first##Op && opcodes_[next] == second##Op) { \
+    opcodes_[loc] = name##Op;                                     \
+    ++NumSuperinstructions;                                       \
+    continue;                                                     \
+  }
+#include "hermes/BCGen/HBC/BytecodeList.def"
+  }
+}
+
 void BytecodeFunctionGenerator::updateJumpTarget(
     offset_t loc,
     int newVal,
@@ -9,6 +9,33 @@
 using namespace hermes;
 using namespace hbc;
 
+namespace {
+
+/// \return the IDs of \p numFunctions functions in the order in which their
+/// bytecode is laid out: the valid IDs in \p order first, without
+/// duplicates, then the remaining ones in ascending order.
+std::vector<uint32_t> functionLayoutOrder(
+    uint32_t numFunctions,
+    llvm::ArrayRef<uint32_t> order) {
+  std::vector<uint32_t> result;
+  result.reserve(numFunctions);
+  std::vector<bool> placed(numFunctions, false);
+  for (uint32_t id : order) {
+    if (id < numFunctions && !placed[id]) {
+      placed[id] = true;
+      result.push_back(id);
+    }
+  }
+  for (uint32_t id = 0; id < numFunctions; ++id) {
+    if (!placed[id]) {
+      result.push_back(id);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 // ============================ File ============================
 void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
   bytecodeModule_ = &BM;
@@ -157,7 +184,9 @@ void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
   using DedupKey =
       std::pair<llvm::ArrayRef<opcode_atom_t>, llvm::ArrayRef<uint32_t>>;
   llvm::DenseMap<DedupKey, uint32_t> bcMap;
-  for (auto &entry : BM.getFunctionTable()) {
+  for (uint32_t id :
+       functionLayoutOrder(BM.getNumFunctions(), options_.functionOrder)) {
+    auto &entry = BM.getFunctionTable()[id];
     if (options_.optimizationEnabled) {
       // If identical bytecode exists, we'll reuse it.
       bool reuse = false;
@@ -25,11 +25,20 @@
 #include "hermes/IR/Instrs.h"
 #include "hermes/Optimizer/PassManager/Pass.h"
 #include "hermes/Optimizer/PassManager/PassManager.h"
+#include "hermes/Support/ParallelFor.h"
 #include "hermes/Support/PerfSection.h"
+#include "hermes/Support/Statistic.h"
 #include "hermes/Support/UTF8.h"
 
 #define DEBUG_TYPE "hbc-backend"
 
+STATISTIC(NumFrames, "Number of function frames allocated");
+STATISTIC(TotalFrameSize, "Sum of the frame sizes of all functions");
+STATISTIC(MaxFrameSize, "Largest frame size of any function");
+STATISTIC(
+    NumWideFrames,
+    "Number of frames with registers that don't fit in 8-bit operands");
+
 using namespace hermes;
 using namespace hbc;
 
@@ -94,6 +103,81 @@ void lowerIR(Module *M, const BytecodeGenerationOptions &options) {
   }
 }
 
+/// Allocate registers for the function \p F and run the lowering passes that
+/// depend on the allocation.
+/// This only modifies \p F itself and the use lists of values shared with
+/// other functions, so it may run concurrently for different functions of the
+/// same module while a ConcurrentIRMutationScope is alive.
+/// \return the register allocator holding the allocation for \p F.
+std::unique_ptr<HVMRegisterAllocator> allocateRegisters(
+    Function *F,
+    const BytecodeGenerationOptions &options) {
+  auto RA = llvm::make_unique<HVMRegisterAllocator>(F);
+  if (!options.optimizationEnabled) {
+    if (!options.compactFrames)
+      RA->setFastPassThreshold(kFastRegisterAllocationThreshold);
+    RA->setMemoryLimit(kRegisterAllocationMemoryLimit);
+  }
+  RA->setFillLifetimeHoles(options.compactFrames);
+  PostOrderAnalysis PO(F);
+  /// The order of the blocks is reverse-post-order, which is a simply
+  /// topological sort.
+  llvm::SmallVector<BasicBlock *, 16> order(PO.rbegin(), PO.rend());
+  RA->allocate(order);
+
+  if (options.format == DumpRA) {
+    RA->dump();
+  }
+
+  PassManager PM;
+  PM.addPass(new LowerStoreInstrs(*RA));
+  PM.addPass(new LowerCalls(*RA));
+  if (options.optimizationEnabled) {
+    PM.addPass(new MovElimination(*RA));
+    PM.addPass(new RecreateCheapValues(*RA));
+    PM.addPass(new LoadConstantValueNumbering(*RA));
+  }
+  PM.addPass(new SpillRegisters(*RA));
+  if (options.basicBlockProfiling) {
+    // Insert after all other passes so that it sees final basic block
+    // list.
+    PM.addPass(new InsertProfilePoint());
+  }
+  PM.run(F);
+
+  unsigned frameSize = RA->getMaxRegisterUsage();
+  LLVM_DEBUG(
+      llvm::dbgs() << "Frame size of " << F->getInternalNameStr() << ": "
+                   << frameSize << "\n");
+  ++NumFrames;
+  TotalFrameSize += frameSize;
+  MaxFrameSize.updateMax(frameSize);
+  if (frameSize > UINT8_MAX)
+    ++NumWideFrames;
+
+  if (options.format == DumpLRA)
+    RA->dump();
+
+  if (options.format == DumpPostRA)
+    F->dump();
+
+  return RA;
+}
+
+/// \return the number of threads to use for register allocation in \p M.
+unsigned registerAllocationThreads(
+    Module *M,
+    const BytecodeGenerationOptions &options) {
+  // Dumps are printed as each function is processed, so they would be
+  // interleaved if functions were processed concurrently.
+  if (options.format == DumpRA || options.format == DumpLRA ||
+      options.format == DumpPostRA ||
+      M->getContext().getCodeGenerationSettings().dumpIRBetweenPasses) {
+    return 1;
+  }
+  return resolveThreadCount(options.numThreads);
+}
+
 /// Used in delta optimizing mode.
 /// \return a UniquingStringLiteralAccumulator seeded with strings  from a
 /// bytecode provider \p bcProvider.
@@ -190,6 +274,30 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
       traverseCJSModuleNames(M, shouldGenerate, addString);
     }
 
+    if (!options.functionOrder.empty()) {
+      // Functions are numbered in module order when they are added below.
+      std::vector<Function *> generated;
+      for (auto &F : *M) {
+        if (shouldGenerate(&F)) {
+          generated.push_back(&F);
+        }
+      }
+      llvm::DenseSet<Function *> startupFunctions;
+      for (uint32_t id : options.functionOrder) {
+        if (id < generated.size()) {
+          startupFunctions.insert(generated[id]);
+        }
+      }
+      traverseLiteralStrings(
+          M,
+          [&startupFunctions](Function *F) {
+            return startupFunctions.count(F) > 0;
+          },
+          [&strings](llvm::StringRef str, bool) {
+            strings.markStartupString(str);
+          });
+    }
+
     BMGen.initializeStringTable(UniquingStringLiteralAccumulator::toTable(
         std::move(strings), options.optimizationEnabled));
   }
@@ -218,61 +326,54 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
 
   // Construct the relative function scope depth map.
   FunctionScopeAnalysis scopeAnalysis{entryPoint};
-  // Bytecode generation for each function.
+
+  llvm::SmallVector<Function *, 32> functions;
   for (auto &F : *M) {
-    if (!shouldGenerate(&F)) {
-      continue;
+    if (shouldGenerate(&F)) {
+      functions.push_back(&F);
     }
+  }
+
+  // Register allocation is the bulk of the per-function work and only touches
+  // the function being allocated, so it can be done for several functions at
+  // once. Instruction selection populates module-wide tables (literal
+  // buffers, filenames, debug info) in the order in which functions are
+  // visited, so it always runs sequentially in module order, which keeps the
+  // output independent of the number of threads.
+  std::vector<std::unique_ptr<HVMRegisterAllocator>> allocators(
+      functions.size());
+  unsigned numThreads = registerAllocationThreads(M, options);
+  if (numThreads > 1) {
+    ConcurrentIRMutationScope concurrentScope{};
+    parallelFor(functions.size(), numThreads, [&](size_t i) {
+      if (!functions[i]->isLazy())
+        allocators[i] = allocateRegisters(functions[i], options);
+    });
+  }
 
+  // Bytecode generation for each function.
+  for (size_t i = 0, e = functions.size(); i < e; ++i) {
+    Function *F = functions[i];
     std::unique_ptr<BytecodeFunctionGenerator> funcGen;
 
-    if (F.isLazy()) {
+    if (F->isLazy()) {
       funcGen = BytecodeFunctionGenerator::create(BMGen, 0);
     } else {
-      HVMRegisterAllocator RA(&F);
-      if (!options.optimizationEnabled) {
-        RA.setFastPassThreshold(kFastRegisterAllocationThreshold);
-        RA.setMemoryLimit(kRegisterAllocationMemoryLimit);
-      }
-      PostOrderAnalysis PO(&F);
-      /// The order of the blocks is reverse-post-order, which is a simply
-      /// topological sort.
-      llvm::SmallVector<BasicBlock *, 16> order(PO.rbegin(), PO.rend());
-      RA.allocate(order);
-
-      if (options.format == DumpRA) {
-        RA.dump();
-      }
-
-      PassManager PM;
-      PM.addPass(new LowerStoreInstrs(RA));
-      PM.addPass(new LowerCalls(RA));
-      if (options.optimizationEnabled) {
-        PM.addPass(new MovElimination(RA));
-        PM.addPass(new RecreateCheapValues(RA));
-        PM.addPass(new LoadConstantValueNumbering(RA));
-      }
-      PM.addPass(new SpillRegisters(RA));
-      if (options.basicBlockProfiling) {
-        // Insert after all other passes so that it sees final basic block
-        // list.
-        PM.addPass(new InsertProfilePoint());
-      }
-      PM.run(&F);
-
-      if (options.format == DumpLRA)
-        RA.dump();
-
-      if (options.format == DumpPostRA)
-        F.dump();
+      // Release each allocation as soon as the function has been emitted.
+      std::unique_ptr<HVMRegisterAllocator> RA = std::move(allocators[i]);
+      if (!RA)
+        RA = allocateRegisters(F, options);
 
       funcGen =
-          BytecodeFunctionGenerator::create(BMGen, RA.getMaxRegisterUsage());
-      HBCISel hbciSel(&F, funcGen.get(), RA, scopeAnalysis);
+          BytecodeFunctionGenerator::create(BMGen, RA->getMaxRegisterUsage());
+      HBCISel hbciSel(F, funcGen.get(), *RA, scopeAnalysis);
       hbciSel.generate(sourceMapGen);
+      if (options.superinstructions &&
+          F->getContext().getDebugInfoSetting() != DebugInfoSetting::ALL)
+        funcGen->selectSuperinstructions();
     }
 
-    BMGen.setFunctionGenerator(&F, std::move(funcGen));
+    BMGen.setFunctionGenerator(F, std::move(funcGen));
   }
 
   return BMGen.generate();
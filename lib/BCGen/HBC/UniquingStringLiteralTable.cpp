@@ -79,6 +79,7 @@ std::vector<StringKind::Entry> StringLiteralTable::getStringKinds() const {
   auto &strings = accum.strings_;
   auto &isIdentifier = accum.isIdentifier_;
   auto &numIdentifierRefs = accum.numIdentifierRefs_;
+  auto &isStartup = accum.isStartup_;
 
   const size_t existingStrings = storage.count();
   const size_t allStrings = strings.size();
@@ -92,14 +93,21 @@ std::vector<StringKind::Entry> StringLiteralTable::getStringKinds() const {
     size_t origIndex;
     llvm::StringRef str;
     StringKind::Kind kind;
+    bool startup;
 
-    Index(size_t origIndex, llvm::StringRef str, StringKind::Kind kind)
-        : origIndex(origIndex), str(str), kind(kind) {}
+    Index(
+        size_t origIndex,
+        llvm::StringRef str,
+        StringKind::Kind kind,
+        bool startup)
+        : origIndex(origIndex), str(str), kind(kind), startup(startup) {}
 
-    using Key = std::tuple<StringKind::Kind, llvm::StringRef>;
+    // Strings used at startup come first within each kind, so that they end
+    // up next to each other in the storage.
+    using Key = std::tuple<StringKind::Kind, bool, llvm::StringRef>;
 
     inline Key key() const {
-      return std::make_tuple(kind, str);
+      return std::make_tuple(kind, !startup, str);
     }
 
     inline bool operator<(const Index &that) const {
@@ -133,7 +141,11 @@ std::vector<StringKind::Entry> StringLiteralTable::getStringKinds() const {
   indices.reserve(newStrings);
 
   for (size_t i = existingStrings; i < allStrings; ++i) {
-    indices.emplace_back(i, strings[i], kind(strings[i], isIdentifier[i]));
+    indices.emplace_back(
+        i,
+        strings[i],
+        kind(strings[i], isIdentifier[i]),
+        isStartup[i - existingStrings]);
   }
 
   // Sort indices of new strings by frequency of identifier references.
@@ -18,6 +18,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <queue>
 
 #define DEBUG_TYPE "regalloc"
@@ -621,6 +622,21 @@ void RegisterAllocator::allocate(ArrayRef<BasicBlock *> order) {
   // Calculate the live intervals for each instruction.
   calculateLiveIntervals(order);
 
+  // Values that are live into a catch block may be read after an exception is
+  // thrown anywhere in the try region, which the liveness information doesn't
+  // model, so they must not share their register with values in their holes.
+  BitVector liveIntoCatch;
+  if (fillLifetimeHoles) {
+    liveIntoCatch.resize(maxIdx);
+    for (auto *BB : order) {
+      if (auto *TSI = dyn_cast<TryStartInst>(BB->getTerminator())) {
+        auto it = blockLiveness_.find(TSI->getCatchTarget());
+        if (it != blockLiveness_.end())
+          liveIntoCatch |= it->second.liveIn_;
+      }
+    }
+  }
+
   // Free the memory used for liveness.
   blockLiveness_.clear();
 
@@ -629,6 +645,11 @@ void RegisterAllocator::allocate(ArrayRef<BasicBlock *> order) {
 
   coalesce(coalesced, order);
 
+  if (fillLifetimeHoles) {
+    allocateFillingHoles(coalesced, liveIntoCatch);
+    return;
+  }
+
   // Compare two intervals and return the one that starts first.
   auto startsFirst = [&](unsigned a, unsigned b) {
     Interval &IA = instructionInterval_[a];
@@ -738,6 +759,178 @@ void RegisterAllocator::allocate(ArrayRef<BasicBlock *> order) {
   }
 }
 
+namespace {
+/// The segments occupied by the values assigned to a single register, kept
+/// sorted and disjoint so that conflicts can be found with a binary search.
+class RegisterOccupancy {
+  std::vector<Segment> segments_{};
+
+ public:
+  /// \return true if the segment \p S overlaps an occupied segment.
+  bool intersects(Segment S) const {
+    // Find the first occupied segment that ends after S starts.
+    auto it = std::upper_bound(
+        segments_.begin(),
+        segments_.end(),
+        S.start_,
+        [](size_t loc, const Segment &seg) { return loc < seg.end_; });
+    return it != segments_.end() && it->start_ < S.end_;
+  }
+
+  /// \return true if any segment of \p ivl overlaps an occupied segment.
+  bool intersects(const Interval &ivl) const {
+    for (auto &S : ivl.segments_) {
+      if (!S.empty() && intersects(S))
+        return true;
+    }
+    return false;
+  }
+
+  /// Mark the segments of \p ivl as occupied.
+  void add(const Interval &ivl) {
+    for (Segment S : ivl.segments_) {
+      if (S.empty())
+        continue;
+      // Merge S with all the segments it overlaps or touches.
+      auto it = std::lower_bound(
+          segments_.begin(),
+          segments_.end(),
+          S.start_,
+          [](const Segment &seg, size_t loc) { return seg.end_ < loc; });
+      while (it != segments_.end() && it->start_ <= S.end_) {
+        S.merge(*it);
+        it = segments_.erase(it);
+      }
+      segments_.insert(it, S);
+    }
+  }
+};
+} // namespace
+
+void RegisterAllocator::allocateFillingHoles(
+    DenseMap<Instruction *, Instruction *> &coalesced,
+    const BitVector &liveIntoCatch) {
+  // The instructions whose registers are shared by each interval.
+  DenseMap<Instruction *, llvm::SmallVector<Instruction *, 2>> members;
+  for (auto &RP : coalesced) {
+    members[RP.second].push_back(RP.first);
+  }
+
+  // Compute the segments that the register of each remaining interval has to
+  // be reserved for. Every instruction writes its register when it executes,
+  // even if the result is never read, so include that point as well.
+  unsigned numInstrs = getMaxInstrIndex();
+  llvm::SmallVector<Interval, 32> occupied(numInstrs);
+  llvm::SmallVector<unsigned, 32> worklist;
+  for (unsigned idx = 0; idx < numInstrs; ++idx) {
+    Instruction *I = instructionsByNumbers_[idx];
+    if (coalesced.count(I))
+      continue;
+
+    Interval &ivl = occupied[idx];
+    bool fullSpan = liveIntoCatch.test(idx);
+    ivl.add(instructionInterval_[idx]);
+    ivl.add(Segment(idx + 1, idx + 2));
+    auto it = members.find(I);
+    if (it != members.end()) {
+      for (Instruction *member : it->second) {
+        unsigned memberIdx = getInstructionNumber(member);
+        fullSpan |= liveIntoCatch.test(memberIdx);
+        ivl.add(Segment(memberIdx + 1, memberIdx + 2));
+      }
+    }
+    if (fullSpan) {
+      ivl = Interval(ivl.start(), ivl.end());
+    }
+    worklist.push_back(idx);
+  }
+
+  // Handle the intervals in the order in which they start.
+  std::sort(worklist.begin(), worklist.end(), [&](unsigned a, unsigned b) {
+    size_t startA = occupied[a].start(), startB = occupied[b].start();
+    return startA < startB || (startA == startB && a < b);
+  });
+
+  std::vector<RegisterOccupancy> registers{};
+  auto fits = [&](Register R, const Interval &ivl) {
+    return R.isValid() && R.getIndex() < registers.size() &&
+        !registers[R.getIndex()].intersects(ivl);
+  };
+
+  for (unsigned idx : worklist) {
+    Instruction *I = instructionsByNumbers_[idx];
+    const Interval &ivl = occupied[idx];
+
+    if (!isAllocated(I)) {
+      // Prefer the register on the other side of a MOV, which turns the MOV
+      // into a no-op.
+      llvm::SmallVector<Instruction *, 4> group{I};
+      auto it = members.find(I);
+      if (it != members.end())
+        group.append(it->second.begin(), it->second.end());
+
+      Register R{};
+      for (Instruction *member : group) {
+        if (auto *mov = dyn_cast<MovInst>(member)) {
+          Value *op = mov->getSingleOperand();
+          if (isAllocated(op) && fits(getRegister(op), ivl)) {
+            R = getRegister(op);
+            break;
+          }
+        }
+        for (auto *U : member->getUsers()) {
+          if (isa<MovInst>(U) && isAllocated(U) &&
+              fits(getRegister(U), ivl)) {
+            R = getRegister(U);
+            break;
+          }
+        }
+        if (R.isValid())
+          break;
+      }
+
+      // Otherwise use the lowest register that is free for the whole interval.
+      for (unsigned i = 0, e = registers.size(); !R.isValid() && i < e; ++i) {
+        if (fits(Register(i), ivl))
+          R = Register(i);
+      }
+
+      if (!R.isValid()) {
+        R = file.allocateRegister();
+        assert(
+            R.getIndex() == registers.size() &&
+            "registers are only released at the end");
+      }
+      updateRegister(I, R);
+    }
+
+    Register R = getRegister(I);
+    if (R.getIndex() >= registers.size())
+      registers.resize(R.getIndex() + 1);
+    registers[R.getIndex()].add(ivl);
+
+    LLVM_DEBUG(
+        dbgs() << "Assigned " << R << " to @" << idx << " " << ivl << "\n");
+  }
+
+  // All the registers that were created are free again once the function has
+  // been allocated, just like in the classic allocation.
+  for (unsigned i = 0, e = file.getMaxRegisterUsage(); i < e; ++i) {
+    if (file.isUsed(Register(i)))
+      file.killRegister(Register(i));
+  }
+
+  for (unsigned idx : worklist) {
+    handleInstruction(instructionsByNumbers_[idx]);
+  }
+
+  // Allocate registers for the coalesced registers.
+  for (auto &RP : coalesced) {
+    assert(!isAllocated(RP.first) && "Register should not be allocated");
+    updateRegister(RP.first, getRegister(RP.second));
+  }
+}
+
 void RegisterAllocator::calculateLiveIntervals(ArrayRef<BasicBlock *> order) {
   /// Calculate the live intervals for each instruction. Start with a list of
   /// intervals that only contain the instruction itself.
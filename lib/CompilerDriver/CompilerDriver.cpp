@@ -10,7 +10,9 @@
 #include "hermes/AST/Context.h"
 #include "hermes/AST/ESTreeJSONDumper.h"
 #include "hermes/AST/SemValidate.h"
+#include "hermes/BCGen/HBC/BytecodeCompression.h"
 #include "hermes/BCGen/HBC/BytecodeDisassembler.h"
+#include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/BCGen/HBC/HBC.h"
 #include "hermes/BCGen/RegAlloc.h"
 #include "hermes/ConsoleHost/ConsoleHost.h"
@@ -36,6 +38,7 @@
 #include "hermes/Utils/Dumper.h"
 #include "hermes/Utils/Options.h"
 
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
@@ -47,6 +50,7 @@
 
 #include "zip/src/zip.h"
 
+#include <cstddef>
 #include <sstream>
 
 #define DEBUG_TYPE "hermes"
@@ -394,6 +398,19 @@ static CLFlag StripFunctionNames(
 static CLFlag
     EnableTDZ('f', "enable-tdz", true, "Enable TDZ checks for let/const");
 
+static CLFlag CompactFrames(
+    'f',
+    "compact-frames",
+    false,
+    "register allocation that reuses registers in the lifetime holes of "
+    "other values to minimize frame sizes");
+
+static CLFlag Superinstructions(
+    'f',
+    "superinstructions",
+    false,
+    "fusing of frequent instruction pairs into superinstructions");
+
 static opt<bool> OutliningPlaceNearCaller(
     "outline-near-caller",
     init(OutliningSettings{}.placeNearCaller),
@@ -435,6 +452,38 @@ static opt<std::string> BaseBytecodeFile(
     llvm::cl::desc("input base bytecode for delta optimizing mode"),
     llvm::cl::init(""));
 
+static opt<std::string> CacheDir(
+    "cache-dir",
+    desc("Directory in which the bytecode of each segment is cached across "
+         "runs, keyed by the SHA1 of its sources and the compiler flags. "
+         "Caching is per segment: after an edit, the edited segment and the "
+         "ones after it are recompiled. With -O, -fstatic-require or "
+         "-custom-opt, segments depend on each other and any edit recompiles "
+         "all of them. So the cache helps unoptimized builds with several "
+         "segments."),
+    value_desc("dir"));
+
+static opt<bool> CompressBytecode(
+    "compress-bytecode",
+    desc("Write the bytecode in a compressed container, whose function bodies "
+         "are decompressed when they first run"),
+    init(false));
+
+static opt<unsigned> NumThreads(
+    "j",
+    desc("Number of threads used to generate bytecode for functions in "
+         "parallel (0 means one per hardware thread). The output does not "
+         "depend on this setting."),
+    value_desc("threads"),
+    init(1));
+
+static opt<std::string> FunctionOrderFile(
+    "function-order",
+    desc("File listing the IDs of the functions whose bytecode is laid out "
+         "first, one per line, in the format written by hermes "
+         "-dump-function-order"),
+    value_desc("file"));
+
 static opt<unsigned> PadFunctionBodiesPercent(
     "pad-function-bodies-percent",
     desc(
@@ -534,6 +583,324 @@ static std::unique_ptr<raw_fd_ostream> openFileForWrite(
   return result;
 }
 
+/// \return the final value of the hash computed by \p hasher.
+SHA1 finalizeHash(llvm::SHA1 &hasher) {
+  auto rawFinalHash = hasher.final();
+  SHA1 hash{};
+  assert(
+      rawFinalHash.size() == SHA1_NUM_BYTES && "Incorrect length of SHA1 hash");
+  std::copy(rawFinalHash.begin(), rawFinalHash.end(), hash.begin());
+  return hash;
+}
+
+/// \return true if the bytecode of each segment depends only on the sources of
+/// the modules in that segment, so that the modules of a segment found in the
+/// compilation cache don't need to be parsed at all. This is not the case when
+/// optimizations look across modules: -O inlines and analyzes the whole
+/// program, and static require resolution succeeds for all modules or none.
+bool segmentsCompileIndependently() {
+  return cl::OptimizationLevel != cl::OptLevel::OMax &&
+      cl::CustomOptimize.empty() && !cl::StaticRequire;
+}
+
+/// Compute the hash of the executable the compiler is running in, which
+/// identifies its build: any change to the compiler produces a different
+/// executable, while identical builds produce the same one.
+/// \return false if the executable could not be read.
+bool hashCompilerBuild(SHA1 &hash) {
+  static int anchor;
+  std::string exePath =
+      llvm::sys::fs::getMainExecutable("hermesc", static_cast<void *>(&anchor));
+  if (exePath.empty())
+    return false;
+  auto exeBuf = llvm::MemoryBuffer::getFile(
+      exePath, /* FileSize */ -1, /* RequiresNullTerminator */ false);
+  if (!exeBuf)
+    return false;
+  llvm::SHA1 hasher;
+  hasher.update((*exeBuf)->getBuffer());
+  hash = finalizeHash(hasher);
+  return true;
+}
+
+/// Print every setting that affects the generated bytecode, other than the
+/// sources of the segments, to \p OS. The result is part of the key of
+/// every segment in the compilation cache.
+/// \param fileBufs the input files, of which the last one decides whether
+///   static builtins are enabled when they are auto-detected.
+/// \return false if a file named on the command line or the compiler itself
+///   could not be read, in which case an error will have been printed.
+bool printCacheKeySettings(
+    llvm::raw_ostream &OS,
+    const Context &context,
+    const SegmentTable &fileBufs) {
+  OS << "version=" << hbc::BYTECODE_VERSION << '\n';
+#ifdef HERMES_RELEASE_VERSION
+  OS << "release=" << HERMES_RELEASE_VERSION << '\n';
+#endif
+  // Any change to the compiler itself must invalidate the cache too.
+  SHA1 buildHash;
+  if (!hashCompilerBuild(buildHash)) {
+    llvm::errs()
+        << "Error: cannot identify the compiler build for -cache-dir\n";
+    return false;
+  }
+  OS << "build=" << llvm::toHex(buildHash) << '\n';
+
+  OS << "opt=" << static_cast<int>(cl::OptimizationLevel.getValue()) << '\n';
+  for (const auto &opt : cl::CustomOptimize) {
+    OS << "custom-opt=" << opt << '\n';
+  }
+  OS << "static-builtins=" << static_cast<int>(cl::StaticBuiltins.getValue())
+     << '\n'
+     << "strict=" << cl::StrictMode << '\n'
+     << "non-strict=" << cl::NonStrictMode << '\n'
+     << "lazy=" << cl::LazyCompilation << '\n'
+     << "basic-block-profiling=" << cl::BasicBlockProfiling << '\n'
+     << "enable-eval=" << cl::EnableEval << '\n'
+     << "g=" << cl::EmitDebugInfo << '\n'
+     << "enable-cla=" << cl::EnableClosureAnalysis << '\n'
+     << "enable-cpo=" << cl::EnableCPO << '\n'
+     << "enable-umo=" << cl::EnableUMO << '\n'
+     << "enable-xm="
+     << static_cast<int>(cl::EnableCrossModuleCLA.getValue()) << '\n'
+     << "commonjs=" << cl::CommonJS << '\n'
+     << "static-require=" << cl::StaticRequire << '\n'
+     << "reuse-prop-cache=" << cl::ReusePropCache << '\n'
+     << "inline=" << cl::Inline << '\n'
+     << "outline=" << cl::Outline << '\n'
+     << "outline-near-caller=" << cl::OutliningPlaceNearCaller << '\n'
+     << "outline-max-rounds=" << cl::OutliningMaxRounds << '\n'
+     << "outline-min-length=" << cl::OutliningMinLength << '\n'
+     << "outline-min-params=" << cl::OutliningMinParameters << '\n'
+     << "outline-max-params=" << cl::OutliningMaxParameters << '\n'
+     << "strip-function-names=" << cl::StripFunctionNames << '\n'
+     << "enable-tdz=" << cl::EnableTDZ << '\n'
+     << "compact-frames=" << cl::CompactFrames << '\n'
+     << "superinstructions=" << cl::Superinstructions << '\n'
+     << "pad-function-bodies-percent=" << cl::PadFunctionBodiesPercent
+     << '\n';
+
+  for (const auto &fileName : cl::IncludeGlobals) {
+    auto fileBuf = memoryBufferFromFile(fileName);
+    if (!fileBuf)
+      return false;
+    llvm::SHA1 hasher;
+    hasher.update(fileBuf->getBuffer());
+    OS << "include-globals=" << llvm::toHex(finalizeHash(hasher)) << '\n';
+  }
+
+  if (!cl::FunctionOrderFile.empty()) {
+    auto fileBuf = memoryBufferFromFile(cl::FunctionOrderFile);
+    if (!fileBuf)
+      return false;
+    llvm::SHA1 hasher;
+    hasher.update(fileBuf->getBuffer());
+    OS << "function-order=" << llvm::toHex(finalizeHash(hasher)) << '\n';
+  }
+
+  // The resolution table is a hash table, so sort it to make the key
+  // independent of the iteration order.
+  if (const auto *resolutionTable = context.getResolutionTable()) {
+    std::vector<std::string> entries{};
+    for (const auto &file : *resolutionTable) {
+      for (const auto &entry : file.second) {
+        entries.push_back(
+            (file.first + "\n" + entry.first + "\n" + entry.second).str());
+      }
+    }
+    std::sort(entries.begin(), entries.end());
+    for (const auto &entry : entries) {
+      OS << "resolve=" << entry << '\n';
+    }
+  }
+
+  // Every module sets the static builtins setting for the whole program when
+  // it is parsed, so the last one wins.
+  if (cl::StaticBuiltins == cl::StaticBuiltinSetting::AutoDetect) {
+    const auto &lastFile = fileBufs.rbegin()->second.back().file;
+    llvm::SHA1 hasher;
+    hasher.update(lastFile->getBuffer());
+    OS << "static-builtins-source=" << llvm::toHex(finalizeHash(hasher))
+       << '\n';
+  }
+  return true;
+}
+
+/// \return the path of the compilation cache entry with the key \p key.
+std::string cacheEntryPath(const SHA1 &key) {
+  llvm::SmallString<64> path{cl::CacheDir};
+  llvm::sys::path::append(
+      path, llvm::toHex(key, /* LowerCase */ true) + ".hbc");
+  return path.str().str();
+}
+
+/// \return the bytecode stored in the compilation cache under the key \p key,
+/// or nullptr if there is no such entry or it is not a valid bytecode file.
+std::unique_ptr<llvm::MemoryBuffer> lookupCacheEntry(const SHA1 &key) {
+  auto fileBuf =
+      memoryBufferFromFile(cacheEntryPath(key), false, /* silent */ true);
+  if (!fileBuf || fileBuf->getBufferSize() < sizeof(hbc::BytecodeFileHeader))
+    return nullptr;
+  const auto *header = reinterpret_cast<const hbc::BytecodeFileHeader *>(
+      fileBuf->getBufferStart());
+  if (header->magic != hbc::MAGIC || header->version != hbc::BYTECODE_VERSION ||
+      header->fileLength != fileBuf->getBufferSize())
+    return nullptr;
+  return fileBuf;
+}
+
+/// Store \p bytecode in the compilation cache under the key \p key. The cache
+/// is only an optimization, so failures are silently ignored.
+void storeCacheEntry(const SHA1 &key, llvm::StringRef bytecode) {
+  if (llvm::sys::fs::create_directories(cl::CacheDir))
+    return;
+  // Write to a temporary file first, so that concurrent compilations never
+  // see a partially written entry.
+  std::string path = cacheEntryPath(key);
+  int fd;
+  llvm::SmallString<64> tempPath{};
+  if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tempPath))
+    return;
+  bool failed;
+  {
+    raw_fd_ostream OS{fd, /* shouldClose */ true};
+    OS << bytecode;
+    OS.close();
+    failed = OS.has_error();
+    OS.clear_error();
+  }
+  if (failed || llvm::sys::fs::rename(tempPath, path))
+    llvm::sys::fs::remove(tempPath);
+}
+
+/// Write the bytecode file \p bytecode, which may have been compiled from
+/// different versions of the other segments, to \p OS, with its source hash
+/// replaced by \p sourceHash.
+void writeBytecodeWithSourceHash(
+    llvm::raw_ostream &OS,
+    llvm::StringRef bytecode,
+    const SHA1 &sourceHash) {
+  const size_t hashOffset = offsetof(hbc::BytecodeFileHeader, sourceHash);
+  OS << bytecode.substr(0, hashOffset);
+  OS.write(
+      reinterpret_cast<const char *>(sourceHash.data()), sourceHash.size());
+  OS << bytecode.substr(hashOffset + sourceHash.size());
+}
+
+/// Compute the compilation cache key of every segment in \p fileBufs, and look
+/// up their bytecode in the cache. When the bytecode of a segment is found,
+/// its modules are replaced by empty ones with the same names, which are
+/// cheap to parse and compile but keep the module IDs of the other segments
+/// unchanged. The unit of reuse is a segment, not a module: an edit misses
+/// the cache for its segment and every later one, and for all segments when
+/// they don't compile independently.
+/// \param sourceHash the hash of all input files, which is part of the keys
+///   unless segments compile independently.
+/// \param[out] cacheKeys the key of each segment.
+/// \param[out] cachedSegments the bytecode of each segment found in the cache.
+/// \return false on error, in which case an error will have been printed.
+bool lookupCachedSegments(
+    const Context &context,
+    SegmentTable &fileBufs,
+    const SHA1 &sourceHash,
+    std::map<uint32_t, SHA1> &cacheKeys,
+    std::map<uint32_t, std::unique_ptr<llvm::MemoryBuffer>> &cachedSegments) {
+  std::string settings;
+  llvm::raw_string_ostream settingsOS{settings};
+  if (!printCacheKeySettings(settingsOS, context, fileBufs))
+    return false;
+  settingsOS.flush();
+
+  bool independent = segmentsCompileIndependently();
+  // The bytecode of a segment also depends on the segments before it, which
+  // decide its module IDs and are generated into the same module first. So the
+  // key of a segment covers the inputs of all the segments up to it. The
+  // ranges are in increasing segment order.
+  std::string inputsSoFar{};
+  for (const auto &range : context.getSegmentRanges()) {
+    llvm::SHA1 inputHasher;
+    // Hash the size of each string too, so that the boundaries between them
+    // are unambiguous.
+    auto hashString = [&inputHasher](llvm::StringRef str) {
+      inputHasher.update(oscompat::to_string(str.size()) + ":");
+      inputHasher.update(str);
+    };
+    for (const auto &fileAndMap : fileBufs[range.segment]) {
+      hashString(fileAndMap.file->getBufferIdentifier());
+      hashString(fileAndMap.file->getBuffer());
+      hashString(
+          fileAndMap.sourceMap ? fileAndMap.sourceMap->getBuffer() : "");
+    }
+    inputsSoFar += ("segment=" + llvm::Twine(range.segment) + " " +
+                    llvm::Twine(range.first) + " " + llvm::Twine(range.last) +
+                    " " + llvm::toHex(finalizeHash(inputHasher)) + "\n")
+                       .str();
+
+    llvm::SHA1 hasher;
+    hasher.update(settings);
+    if (!independent) {
+      hasher.update(sourceHash);
+    }
+    hasher.update(inputsSoFar);
+    SHA1 key = finalizeHash(hasher);
+    cacheKeys[range.segment] = key;
+    if (auto bytecode = lookupCacheEntry(key)) {
+      LLVM_DEBUG(
+          llvm::dbgs() << "Found segment " << range.segment
+                       << " in the compilation cache\n");
+      cachedSegments[range.segment] = std::move(bytecode);
+    }
+  }
+
+  // If the segments depend on each other, all of them have to be parsed unless
+  // none of them needs to be compiled.
+  if (!independent && cachedSegments.size() != cacheKeys.size())
+    return true;
+
+  const llvm::MemoryBuffer *lastFile =
+      fileBufs.rbegin()->second.back().file.get();
+  for (const auto &entry : cachedSegments) {
+    for (auto &fileAndMap : fileBufs[entry.first]) {
+      // The last file decides whether static builtins are auto-detected.
+      if (fileAndMap.file.get() == lastFile &&
+          cl::StaticBuiltins == cl::StaticBuiltinSetting::AutoDetect)
+        continue;
+      fileAndMap.file = llvm::MemoryBuffer::getMemBufferCopy(
+          "", fileAndMap.file->getBufferIdentifier());
+      fileAndMap.sourceMap = nullptr;
+    }
+  }
+  return true;
+}
+
+/// Read the function IDs listed one per line in the file \p fileName into
+/// \p order. Empty lines and lines starting with '#' are ignored.
+/// \return false if the file could not be read or is malformed, in which case
+///   an error will have been printed.
+bool readFunctionOrder(
+    llvm::StringRef fileName,
+    std::vector<uint32_t> &order) {
+  auto fileBuf = memoryBufferFromFile(fileName);
+  if (!fileBuf)
+    return false;
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  fileBuf->getBuffer().split(lines, '\n');
+  for (llvm::StringRef line : lines) {
+    line = line.trim();
+    if (line.empty() || line.startswith("#"))
+      continue;
+    uint32_t id;
+    if (line.getAsInteger(10, id)) {
+      llvm::errs() << "Error: invalid function ID '" << line << "' in "
+                   << fileName << '\n';
+      return false;
+    }
+    order.push_back(id);
+  }
+  return true;
+}
+
 /// Loads global definitions from MemoryBuffer and adds the definitions to \p
 /// declFileList.
 /// \return true on success, false on error.
@@ -738,6 +1105,35 @@ bool validateFlags() {
       err("-output-source-map only works with -emit-binary");
   }
 
+  // Validate compilation cache flags.
+  if (!cl::CacheDir.empty()) {
+    if (cl::BytecodeMode)
+      err("-cache-dir doesn't make sense with bytecode");
+    if (cl::DumpTarget != EmitBundle)
+      err("-cache-dir only works with -emit-binary");
+    if (cl::BytecodeOutputFilename.empty())
+      err("-cache-dir requires -out to be set");
+    if (cl::OutputSourceMap)
+      err("-cache-dir doesn't support -output-source-map");
+    if (!cl::BaseBytecodeFile.empty())
+      err("-cache-dir doesn't support -base-bytecode");
+  }
+
+  // Validate bytecode compression flags.
+  if (cl::CompressBytecode) {
+    if (cl::BytecodeMode)
+      err("-compress-bytecode doesn't make sense with bytecode");
+    if (cl::DumpTarget != EmitBundle)
+      err("-compress-bytecode only works with -emit-binary");
+    if (cl::BytecodeFormat != cl::BytecodeFormatKind::HBC)
+      err("-compress-bytecode requires HBC target");
+    if (!hbc::isBytecodeCompressionAvailable())
+      err("-compress-bytecode is not supported by this build");
+  }
+
+  if (!cl::FunctionOrderFile.empty() && cl::BytecodeMode)
+    err("-function-order doesn't make sense with bytecode");
+
   // Validate bytecode dumping flags.
   if (cl::BytecodeMode && cl::DumpTarget != None) {
     if (cl::BytecodeFormat != cl::BytecodeFormatKind::HBC)
@@ -1377,11 +1773,7 @@ CompileResult processSourceFiles(
           llvm::StringRef(file->getBufferStart(), file->getBufferSize()));
     }
   }
-  auto rawFinalHash = hasher.final();
-  SHA1 sourceHash{};
-  assert(
-      rawFinalHash.size() == SHA1_NUM_BYTES && "Incorrect length of SHA1 hash");
-  std::copy(rawFinalHash.begin(), rawFinalHash.end(), sourceHash.begin());
+  SHA1 sourceHash = finalizeHash(hasher);
 #ifndef NDEBUG
   if (cl::LexerOnly) {
     unsigned count = 0;
@@ -1400,6 +1792,16 @@ CompileResult processSourceFiles(
   }
 #endif
 
+  // The compilation cache key of each segment, and the bytecode of the
+  // segments that were found in the cache.
+  std::map<uint32_t, SHA1> cacheKeys{};
+  std::map<uint32_t, std::unique_ptr<llvm::MemoryBuffer>> cachedSegments{};
+  if (!cl::CacheDir.empty() &&
+      !lookupCachedSegments(
+          *context, fileBufs, sourceHash, cacheKeys, cachedSegments)) {
+    return InputFileError;
+  }
+
   // A list of parsed global definition files.
   DeclarationFileListTy declFileList;
 
@@ -1542,7 +1944,20 @@ CompileResult processSourceFiles(
   // The static builtin setting should be set correctly after command line
   // options parsing and js parsing. Set the bytecode header flag here.
   genOptions.staticBuiltinsEnabled = context->getStaticBuiltinOptimization();
+  genOptions.compactFrames = cl::CompactFrames;
+  genOptions.superinstructions = cl::Superinstructions;
   genOptions.padFunctionBodiesPercent = cl::PadFunctionBodiesPercent;
+  genOptions.numThreads = cl::NumThreads;
+  if (!cl::FunctionOrderFile.empty()) {
+    // Function IDs are only meaningful within a single bytecode file.
+    if (context->getSegmentRanges().size() > 1) {
+      llvm::errs() << "Error: -function-order doesn't support splitting "
+                      "the output into segments\n";
+      return InvalidFlags;
+    }
+    if (!readFunctionOrder(cl::FunctionOrderFile, genOptions.functionOrder))
+      return InputFileError;
+  }
 
   // If the user requests to output a source map, then do not also emit debug
   // info into the bytecode.
@@ -1567,6 +1982,79 @@ CompileResult processSourceFiles(
     }
   }
 
+  /// Serialize the bytecode of the segment \p range (or of the only segment,
+  /// if \p range is None) to \p OS, taking it from the compilation cache if
+  /// possible and adding it to the cache otherwise.
+  auto serializeSegment = [&](raw_ostream &OS,
+                              OptValue<Context::SegmentRange> range)
+      -> CompileResult {
+    if (cl::CacheDir.empty()) {
+      return generateBytecodeForSerialization(
+          OS,
+          M,
+          genOptions,
+          sourceHash,
+          range,
+          sourceMapGen ? sourceMapGen.getPointer() : nullptr,
+          baseBytecodeMap);
+    }
+    uint32_t segment =
+        range ? range->segment : context->getSegmentRanges()[0].segment;
+    auto it = cachedSegments.find(segment);
+    if (it != cachedSegments.end()) {
+      // Generating a segment lowers the IR of the whole module and allocates
+      // registers in the global function, which changes the bytecode of the
+      // following segments. Generate the stubbed segment anyway, which is
+      // cheap, so that they match a compilation without the cache.
+      llvm::raw_null_ostream nullOS{};
+      auto result = generateBytecodeForSerialization(
+          nullOS, M, genOptions, sourceHash, range, nullptr, baseBytecodeMap);
+      if (result.status != Success) {
+        return result;
+      }
+      writeBytecodeWithSourceHash(OS, it->second->getBuffer(), sourceHash);
+      return CompileResult{Success};
+    }
+    std::string bytecode;
+    llvm::raw_string_ostream bytecodeOS{bytecode};
+    auto result = generateBytecodeForSerialization(
+        bytecodeOS, M, genOptions, sourceHash, range, nullptr, baseBytecodeMap);
+    if (result.status != Success) {
+      return result;
+    }
+    storeCacheEntry(cacheKeys[segment], bytecodeOS.str());
+    OS << bytecode;
+    return result;
+  };
+
+  /// Write the bytecode of the segment \p range to \p OS, compressing it if
+  /// requested. The compilation cache holds uncompressed bytecode.
+  auto emitSegment = [&](raw_ostream &OS,
+                         OptValue<Context::SegmentRange> range)
+      -> CompileResult {
+    if (!cl::CompressBytecode) {
+      return serializeSegment(OS, range);
+    }
+    std::string bytecode;
+    llvm::raw_string_ostream bytecodeOS{bytecode};
+    auto result = serializeSegment(bytecodeOS, range);
+    if (result.status != Success) {
+      return result;
+    }
+    bytecodeOS.flush();
+    std::string error;
+    if (!hbc::compressBytecode(
+            llvm::ArrayRef<uint8_t>(
+                reinterpret_cast<const uint8_t *>(bytecode.data()),
+                bytecode.size()),
+            OS,
+            &error)) {
+      llvm::errs() << "Error compressing bytecode: " << error << '\n';
+      return OutputFileError;
+    }
+    return result;
+  };
+
   CompileResult result{Success};
   std::unique_ptr<raw_fd_ostream> fileOS{};
   StringRef base = cl::BytecodeOutputFilename;
@@ -1577,14 +2065,7 @@ CompileResult processSourceFiles(
         return OutputFileError;
     }
     auto &OS = fileOS ? *fileOS : llvm::outs();
-    auto result = generateBytecodeForSerialization(
-        OS,
-        M,
-        genOptions,
-        sourceHash,
-        llvm::None,
-        sourceMapGen ? sourceMapGen.getPointer() : nullptr,
-        baseBytecodeMap);
+    auto result = emitSegment(OS, llvm::None);
     if (result.status != Success) {
       return result;
     }
@@ -1607,14 +2088,7 @@ CompileResult processSourceFiles(
           return OutputFileError;
       }
       auto &OS = base.empty() ? llvm::outs() : *fileOS;
-      auto segResult = generateBytecodeForSerialization(
-          OS,
-          M,
-          genOptions,
-          sourceHash,
-          range,
-          sourceMapGen ? sourceMapGen.getPointer() : nullptr,
-          baseBytecodeMap);
+      auto segResult = emitSegment(OS, range);
       if (segResult.status != Success) {
         return segResult;
       }
@@ -19,6 +19,8 @@
 #include "hermes/VM/StringView.h"
 #include "hermes/VM/instrumentation/PerfEvents.h"
 
+#include "llvm/Support/FileSystem.h"
+
 namespace hermes {
 
 /// Raises an uncatchable quit exception.
@@ -37,6 +39,26 @@ static void printStats(vm::Runtime *runtime, llvm::raw_ostream &os) {
   os << stats;
 }
 
+/// Write the order in which the functions of the main bytecode module were
+/// first used to the file \p fileName, one function ID per line.
+/// \return false if the file could not be written.
+static bool dumpFunctionOrder(vm::Runtime *runtime, llvm::StringRef fileName) {
+  std::error_code EC;
+  llvm::raw_fd_ostream OS{fileName, EC, llvm::sys::fs::F_Text};
+  if (EC) {
+    llvm::errs() << "Failed to open " << fileName << ": " << EC.message()
+                 << '\n';
+    return false;
+  }
+  // Only the module created from the main bytecode records the order.
+  for (auto &module : runtime->getRuntimeModules()) {
+    for (uint32_t id : module.getFunctionOrder()) {
+      OS << id << '\n';
+    }
+  }
+  return true;
+}
+
 static vm::CallResult<vm::HermesValue>
 createHeapSnapshot(void *, vm::Runtime *runtime, vm::NativeArgs args) {
   using namespace vm;
@@ -177,6 +199,7 @@ bool executeHBCBytecode(
 
   vm::RuntimeModuleFlags flags;
   flags.persistent = true;
+  flags.recordsFunctionOrder = !options.functionOrderFile.empty();
 
   if (options.stopAfterInit) {
     vm::Handle<vm::Domain> domain =
@@ -219,6 +242,11 @@ bool executeHBCBytecode(
         llvm::errs(), runtime->makeHandle(runtime->getThrownValue()));
   }
 
+  if (!options.functionOrderFile.empty() &&
+      !dumpFunctionOrder(runtime.get(), options.functionOrderFile)) {
+    return false;
+  }
+
 #ifdef HERMESVM_PROFILER_OPCODE
   runtime->dumpOpcodeStats(llvm::outs());
 #endif
@@ -16,6 +16,8 @@
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Utils/Dumper.h"
 
+#include <atomic>
+#include <mutex>
 #include <set>
 #include <type_traits>
 
@@ -50,6 +52,42 @@ using llvm::dyn_cast;
 #include "hermes/IR/ValueKinds.def"
 #undef QUOTE
 
+namespace {
+
+/// The number of live ConcurrentIRMutationScope instances.
+std::atomic<unsigned> concurrentMutationScopes{0};
+
+/// Serializes use-list updates while a ConcurrentIRMutationScope is alive.
+/// It is recursive because the operand mutators call each other.
+std::recursive_mutex &useListMutex() {
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+/// Holds the use-list lock for the duration of a mutation, but only if some
+/// ConcurrentIRMutationScope is alive, so single threaded compilation doesn't
+/// pay for it.
+class UseListLock {
+  std::unique_lock<std::recursive_mutex> lock_;
+
+ public:
+  UseListLock() {
+    if (LLVM_UNLIKELY(
+            concurrentMutationScopes.load(std::memory_order_acquire) != 0))
+      lock_ = std::unique_lock<std::recursive_mutex>(useListMutex());
+  }
+};
+
+} // namespace
+
+ConcurrentIRMutationScope::ConcurrentIRMutationScope() {
+  concurrentMutationScopes.fetch_add(1, std::memory_order_acq_rel);
+}
+
+ConcurrentIRMutationScope::~ConcurrentIRMutationScope() {
+  concurrentMutationScopes.fetch_sub(1, std::memory_order_acq_rel);
+}
+
 void Value::destroy(Value *V) {
   if (!V)
     return;
@@ -249,6 +287,7 @@ Instruction::Instruction(
 }
 
 void Instruction::pushOperand(Value *Val) {
+  UseListLock lock;
   Operands.push_back({nullptr, 0});
   setOperand(Val, getNumOperands() - 1);
 }
@@ -266,6 +305,7 @@ bool Instruction::canSetOperand(ValueKind kind, unsigned index) const {
 
 void Instruction::setOperand(Value *Val, unsigned Index) {
   assert(Index < Operands.size() && "Not all operands have been pushed!");
+  UseListLock lock;
 
   Value *CurrentValue = Operands[Index].first;
 
@@ -300,6 +340,7 @@ unsigned Instruction::getNumOperands() const {
 void Instruction::removeOperand(unsigned index) {
   // We call to setOperand before deleting the operand because setOperand
   // un-registers the user from the user list.
+  UseListLock lock;
   setOperand(nullptr, index);
   Operands.erase(Operands.begin() + index);
 }
@@ -317,6 +358,7 @@ void Instruction::replaceFirstOperandWith(Value *OldValue, Value *NewValue) {
 void Instruction::eraseOperand(Value *Value) {
   // Overwrite all of the operands that we are removing with null. This will
   // unregister them from the use list.
+  UseListLock lock;
   for (int i = 0, e = getNumOperands(); i < e; ++i) {
     if (getOperand(i) == Value)
       setOperand(nullptr, i);
@@ -723,6 +765,7 @@ void Module::dump() {
 }
 
 LiteralNumber *Module::getLiteralNumber(double value) {
+  UseListLock lock;
   // Check to see if we've already seen this tuple before.
   llvm::FoldingSetNodeID ID;
 
@@ -739,6 +782,7 @@ LiteralNumber *Module::getLiteralNumber(double value) {
 }
 
 LiteralString *Module::getLiteralString(Identifier value) {
+  UseListLock lock;
   // Check to see if we've already seen this tuple before.
   llvm::FoldingSetNodeID ID;
 
@@ -10,6 +10,7 @@
 #include "hermes/Support/OSCompat.h"
 
 #include <cassert>
+#include <climits>
 #include <vector>
 
 #include <signal.h>
@@ -265,10 +266,52 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
     case MAdvice::Sequential:
       param = MADV_SEQUENTIAL;
       break;
+    case MAdvice::HugePage:
+#ifdef MADV_HUGEPAGE
+      param = MADV_HUGEPAGE;
+      break;
+#else
+      return false;
+#endif
   }
   return madvise(p, sz, param) == 0;
 }
 
+int numa_node_of_current_thread() {
+#if defined(__linux__) && defined(__NR_getcpu)
+  unsigned cpu, node;
+  if (syscall(__NR_getcpu, &cpu, &node, nullptr) != 0) {
+    return -1;
+  }
+  return node;
+#else
+  return -1;
+#endif
+}
+
+bool vm_prefer_numa_node(void *p, size_t sz, int node) {
+#if defined(__linux__) && defined(__NR_mbind)
+  // MPOL_PREFERRED from <linux/mempolicy.h>, which isn't available on all
+  // the platforms we build for.
+  constexpr int kMPolPreferred = 1;
+  unsigned long nodeMask = 0;
+  constexpr int kMaxNodes = sizeof(nodeMask) * CHAR_BIT;
+  if (node < 0 || node >= kMaxNodes) {
+    return false;
+  }
+  nodeMask = 1UL << node;
+  // The kernel reads one bit less than the given number of nodes.
+  long err =
+      syscall(__NR_mbind, p, sz, kMPolPreferred, &nodeMask, kMaxNodes + 1, 0);
+  return err == 0;
+#else
+  (void)p;
+  (void)sz;
+  (void)node;
+  return false;
+#endif
+}
+
 int pages_in_ram(const void *p, size_t sz, llvm::SmallVectorImpl<int> *runs) {
   const auto PS = page_size();
   {
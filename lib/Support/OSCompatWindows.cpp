@@ -303,6 +303,16 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
   return false;
 }
 
+int numa_node_of_current_thread() {
+  // Not implemented.
+  return -1;
+}
+
+bool vm_prefer_numa_node(void *p, size_t sz, int node) {
+  // Not implemented.
+  return false;
+}
+
 int pages_in_ram(const void *p, size_t sz, llvm::SmallVectorImpl<int> *runs) {
   // Not yet supported.
   return -1;
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/Support/ParallelFor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace hermes {
+
+unsigned resolveThreadCount(unsigned requested) {
+  if (requested)
+    return requested;
+  // hardware_concurrency() may return 0 if the value can't be determined.
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void parallelFor(
+    size_t count,
+    unsigned numThreads,
+    llvm::function_ref<void(size_t)> fn) {
+  if (numThreads <= 1 || count <= 1) {
+    for (size_t i = 0; i < count; ++i)
+      fn(i);
+    return;
+  }
+
+  // Work items are handed out one at a time from a shared counter, so that a
+  // few expensive items don't leave the other threads idle.
+  std::atomic<size_t> next{0};
+  auto worker = [&next, count, fn]() {
+    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+      fn(i);
+  };
+
+  size_t numHelpers = std::min<size_t>(numThreads, count) - 1;
+  std::vector<std::thread> helpers;
+  helpers.reserve(numHelpers);
+  for (size_t i = 0; i < numHelpers; ++i)
+    helpers.emplace_back(worker);
+  worker();
+  for (auto &t : helpers)
+    t.join();
+}
+
+} // namespace hermes
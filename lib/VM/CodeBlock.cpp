@@ -14,6 +14,7 @@
 #include "hermes/Support/Conversions.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PerfSection.h"
+#include "hermes/VM/LazyCompilationThread.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/SerializedLiteralParser.h"
@@ -230,6 +231,9 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
   auto *func = ((hbc::BCProviderLazy *)runtimeModule_->getBytecode())
                    ->getBytecodeFunction();
   auto *lazyData = func->getLazyCompilationData();
+  // The lookup updates a cache which lazy compilation on another thread uses.
+  std::lock_guard<std::mutex> lock{
+      lazyData->context->getLazyCompilationMutex()};
   lazyData->context->getSourceErrorManager().findBufferLineAndLoc(
       start ? lazyData->span.Start : lazyData->span.End, coords);
 #endif
@@ -237,30 +241,15 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
 }
 
 #ifndef HERMESVM_LEAN
-namespace {
-std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
-    hbc::LazyCompilationData *lazyData) {
-  assert(lazyData);
-  LLVM_DEBUG(
-      llvm::dbgs() << "Compiling lazy function " << lazyData->originalName
-                   << "\n");
-
-  Module M{lazyData->context};
-  Function *entryPoint = hermes::generateLazyFunctionIR(lazyData, &M);
-
-  auto bytecodeModule = hbc::generateBytecodeModule(
-      &M, entryPoint, BytecodeGenerationOptions::defaults());
-
-  return bytecodeModule;
-}
-} // namespace
-
 void CodeBlock::lazyCompileImpl(Runtime *runtime) {
   assert(isLazy() && "Laziness has not been checked");
   PerfSection perf("Lazy function compilation");
   auto *func = ((hbc::BCProviderLazy *)runtimeModule_->getBytecode())
                    ->getBytecodeFunction();
-  auto bcMod = compileLazyFunction(func->getLazyCompilationData());
+  auto *lazyData = func->getLazyCompilationData();
+  LazyCompilationThread *thread = runtime->getLazyCompilationThread();
+  auto bcMod =
+      thread ? thread->compile(lazyData) : compileLazyFunction(lazyData);
   runtimeModule_->initializeLazyMayAllocate(
       hbc::BCProviderFromSrc::createBCProviderFromSrc(std::move(bcMod)));
   // Reset all meta data of the CodeBlock to point to the newly
@@ -16,25 +16,25 @@ namespace vm {
 
 struct DictPropertyMap::detail {
   /// The upper bound of the search when trying to find the maximum capacity
-  /// of this object, given GC::maxAllocationSize().
+  /// of this object, given kMaxAllocationSize.
   /// It was chosen to be a value that is certain to not fit into an allocation;
   /// at the same time we want to make it smaller, so/ we have arbitrarily
   /// chosen to divide the max allocation size by two, which is still guaranteed
   /// not to fit.
-  static constexpr uint32_t kSearchUpperBound = GC::maxAllocationSize() / 2;
+  static constexpr uint32_t kSearchUpperBound = kMaxAllocationSize / 2;
 
   static_assert(
       !DictPropertyMap::constWouldFitAllocation(kSearchUpperBound),
       "kSearchUpperBound should not fit into an allocation");
 
-  /// The maximum capacity of DictPropertyMap, given GC::maxAllocationSize().
+  /// The maximum capacity of DictPropertyMap, given kMaxAllocationSize.
   static constexpr uint32_t kMaxCapacity =
       DictPropertyMap::constFindMaxCapacity(0, kSearchUpperBound);
 
   // Double-check that kMaxCapacity is reasonable.
   static_assert(
       DictPropertyMap::constApproxAllocSize64(kMaxCapacity) <=
-          GC::maxAllocationSize(),
+          kMaxAllocationSize,
       "invalid kMaxCapacity");
 
   // Ensure that it is safe to double capacities without checking for overflow
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/EphemeronChunk.h"
+
+#include "hermes/VM/Metadata.h"
+
+namespace hermes {
+namespace vm {
+
+constexpr EphemeronChunk::size_type EphemeronChunk::kMaxEntries;
+
+VTable EphemeronChunk::vt(
+    CellKind::EphemeronChunkKind,
+    0,
+    nullptr,
+    nullptr,
+    nullptr);
+
+void EphemeronChunkBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  const auto *self = static_cast<const EphemeronChunk *>(cell);
+  mb.addNonPointerField("@numSlots", &self->numSlots_);
+  mb.addNonPointerField("@markEpoch", &self->markEpoch_);
+  mb.addArray<Metadata::ArrayData::ArrayType::HermesValue>(
+      "@entries", self->data(), &self->numSlots_, sizeof(GCHermesValue));
+}
+
+} // namespace vm
+} // namespace hermes
@@ -12,6 +12,7 @@
 
 #include "hermes/Support/OSCompat.h"
 #include "hermes/VM/CellKind.h"
+#include "hermes/VM/EphemeronChunk.h"
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/VTable.h"
@@ -118,6 +119,36 @@ bool GCBase::createSnapshotToFile(const std::string &fileName, bool compact) {
   return true;
 }
 
+bool GCBase::createBinarySnapshotToFD(int fd) {
+  llvm::raw_fd_ostream os(fd, /* shouldClose */ false);
+  if (!createBinarySnapshot(os)) {
+    return false;
+  }
+  os.flush();
+  if (os.has_error()) {
+    os.clear_error();
+    return false;
+  }
+  return true;
+}
+
+bool GCBase::createBinarySnapshotToFile(const std::string &fileName) {
+  std::error_code code;
+  llvm::raw_fd_ostream os(fileName, code, llvm::sys::fs::FileAccess::FA_Write);
+  if (code) {
+    return false;
+  }
+  if (!createBinarySnapshot(os)) {
+    return false;
+  }
+  os.flush();
+  if (os.has_error()) {
+    os.clear_error();
+    return false;
+  }
+  return true;
+}
+
 void GCBase::checkTripwire(
     size_t dataSize,
     std::chrono::time_point<std::chrono::steady_clock> now) {
@@ -300,6 +331,70 @@ uint64_t GCBase::nextObjectID() {
 }
 #endif
 
+void GCBase::recordEphemeronChunk(GCCell *cell) {
+  auto *chunk = vmcast<EphemeronChunk>(cell);
+  // Marking may visit a cell more than once, for instance after the mark stack
+  // overflows.
+  if (chunk->markEpoch_ == ephemeronEpoch_) {
+    return;
+  }
+  chunk->markEpoch_ = ephemeronEpoch_;
+  ephemeronChunks_.push_back(chunk);
+}
+
+void GCBase::beginEphemeronMarking() {
+  ephemeronChunks_.clear();
+  // New chunks have an epoch of zero, which must not match.
+  if (++ephemeronEpoch_ == 0) {
+    ++ephemeronEpoch_;
+  }
+}
+
+bool GCBase::markEphemeronValues(
+    llvm::function_ref<bool(GCCell *)> isMarked,
+    llvm::function_ref<void(HermesValue &)> markValue) {
+  bool markedAny = false;
+  // markValue may record more chunks, so don't hold on to an iterator.
+  for (size_t i = 0; i < ephemeronChunks_.size(); ++i) {
+    EphemeronChunk *chunk = ephemeronChunks_[i];
+    for (uint32_t j = 0, e = chunk->numEntries(); j < e; ++j) {
+      const HermesValue &key = chunk->key(j);
+      if (!key.isObject() || !isMarked(static_cast<GCCell *>(key.getObject())))
+        continue;
+      GCHermesValue &value = chunk->value(j);
+      if (value.isPointer()) {
+        if (!isMarked(static_cast<GCCell *>(value.getPointer()))) {
+          markValue(value);
+          markedAny = true;
+        }
+      } else if (value.isSymbol()) {
+        markValue(value);
+      }
+    }
+  }
+  return markedAny;
+}
+
+void GCBase::clearUnreachableEphemerons(
+    llvm::function_ref<bool(GCCell *)> isMarked,
+    llvm::function_ref<void(HermesValue &)> updateLive) {
+  for (EphemeronChunk *chunk : ephemeronChunks_) {
+    for (uint32_t j = 0, e = chunk->numEntries(); j < e; ++j) {
+      GCHermesValue &key = chunk->key(j);
+      if (!key.isObject())
+        continue;
+      if (isMarked(static_cast<GCCell *>(key.getObject()))) {
+        updateLive(key);
+        updateLive(chunk->value(j));
+      } else {
+        key.setNonPtr(HermesValue::encodeNullValue());
+        chunk->value(j).setNonPtr(HermesValue::encodeEmptyValue());
+      }
+    }
+  }
+  ephemeronChunks_.clear();
+}
+
 void GCBase::oom(std::error_code reason) {
 #ifdef HERMESVM_EXCEPTION_ON_OOM
   HeapInfo heapInfo;
@@ -372,6 +467,22 @@ double GCBase::clockDiffSeconds(
   return elapsed.count();
 }
 
+/*static*/
+bool GCBase::expectedToCompleteBy(
+    const CumulativeHeapStats &stats,
+    TimePoint deadline,
+    bool ifUnknown) {
+  const double remaining =
+      clockDiffSeconds(std::chrono::steady_clock::now(), deadline);
+  if (remaining <= 0) {
+    return false;
+  }
+  if (stats.gcWallTime.count() == 0) {
+    return ifUnknown;
+  }
+  return stats.gcWallTime.average() <= remaining;
+}
+
 llvm::raw_ostream &operator<<(
     llvm::raw_ostream &os,
     const DurationFormatObj &dfo) {
@@ -32,6 +32,13 @@ GCCell::GCCell(GC *gc, const VTable *vtp, AllocEventOption doNotEmit)
 }
 #endif
 
+void GCCell::initAfterCopy(GC *gc) {
+#ifdef HERMESVM_GCCELL_ID
+  _debugAllocationId_ = gc->nextObjectID();
+#endif
+  trackAlloc(gc, vtp_);
+}
+
 #ifdef HERMESVM_MEMORY_PROFILER
 void GCCell::trackAlloc(GC *gc, const VTable *vtp) {
   if (auto *met = gc->memEventTracker()) {
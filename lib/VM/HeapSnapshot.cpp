@@ -11,7 +11,13 @@
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/StringPrimitive.h"
 
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/LEB128.h"
+
+#include <algorithm>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 
 namespace hermes {
@@ -520,6 +526,381 @@ uint32_t V8HeapSnapshot::edgeTypeIndex(V8HeapSnapshot::Edge::Type type) {
   return static_cast<uint32_t>(type);
 }
 
+constexpr char BinaryHeapSnapshot::magic[4];
+constexpr uint32_t BinaryHeapSnapshot::version;
+
+BinaryHeapSnapshot::BinaryHeapSnapshot(llvm::raw_ostream &os) : os_(os) {
+  os_.write(magic, sizeof(magic));
+  llvm::encodeULEB128(version, os_);
+}
+
+BinaryHeapSnapshot::~BinaryHeapSnapshot() {
+  assert(!inNodes_ && !inEdges_ && "Section was not ended");
+  writeTag(RecordTag::End);
+  os_.flush();
+}
+
+void BinaryHeapSnapshot::beginNodes() {
+  assert(!inNodes_ && !inEdges_);
+  inNodes_ = true;
+}
+
+void BinaryHeapSnapshot::addNode(Node &&node) {
+  assert(inNodes_);
+  writeTag(RecordTag::Node);
+  llvm::encodeULEB128(static_cast<uint32_t>(node.type), os_);
+  llvm::encodeULEB128(node.name, os_);
+  // Nodes are mostly written in address order, so their ids are close.
+  llvm::encodeSLEB128(static_cast<int64_t>(node.id - lastNodeID_), os_);
+  lastNodeID_ = node.id;
+  llvm::encodeULEB128(node.selfSize, os_);
+  llvm::encodeULEB128(node.edgeCount, os_);
+}
+
+void BinaryHeapSnapshot::endNodes() {
+  assert(inNodes_);
+  inNodes_ = false;
+}
+
+void BinaryHeapSnapshot::beginEdges() {
+  assert(!inNodes_ && !inEdges_);
+  inEdges_ = true;
+}
+
+void BinaryHeapSnapshot::addEdge(Edge &&edge) {
+  assert(inEdges_);
+  writeTag(RecordTag::Edge);
+  const bool named = edge.pointerKind == Edge::PKNamed;
+  llvm::encodeULEB128((static_cast<uint32_t>(edge.type) << 1) | named, os_);
+  llvm::encodeULEB128(named ? edge.name() : edge.index(), os_);
+  llvm::encodeSLEB128(
+      static_cast<int64_t>(edge.toNode - lastEdgeTarget_), os_);
+  lastEdgeTarget_ = edge.toNode;
+}
+
+void BinaryHeapSnapshot::endEdges() {
+  assert(inEdges_);
+  inEdges_ = false;
+}
+
+BinaryHeapSnapshot::StringID BinaryHeapSnapshot::addString(
+    llvm::StringRef str) {
+  auto it = stringIDs_.find(str);
+  if (it != stringIDs_.end())
+    return it->second;
+  if (rememberedStringBytes_ + str.size() > kMaxRememberedStringBytes) {
+    stringIDs_.clear();
+    rememberedStringBytes_ = 0;
+  }
+  StringID id = nextStringID_++;
+  stringIDs_[str] = id;
+  rememberedStringBytes_ += str.size();
+  writeTag(RecordTag::String);
+  llvm::encodeULEB128(str.size(), os_);
+  os_ << str;
+  return id;
+}
+
+namespace {
+
+/// Reads the records of a binary heap snapshot.
+class BinaryHeapSnapshotReader {
+ public:
+  using RecordTag = BinaryHeapSnapshot::RecordTag;
+
+  BinaryHeapSnapshotReader(llvm::StringRef input, std::string &error)
+      : cur_(input.bytes_begin()), end_(input.bytes_end()), error_(error) {}
+
+  /// Check the magic number and version. \return false on failure.
+  bool readHeader() {
+    const auto *magic = BinaryHeapSnapshot::magic;
+    if (static_cast<size_t>(end_ - cur_) < sizeof(BinaryHeapSnapshot::magic) ||
+        !std::equal(magic, magic + sizeof(BinaryHeapSnapshot::magic), cur_)) {
+      return fail("not a binary heap snapshot");
+    }
+    cur_ += sizeof(BinaryHeapSnapshot::magic);
+    uint64_t version;
+    if (!readULEB(version))
+      return false;
+    if (version != BinaryHeapSnapshot::version)
+      return fail("unsupported version " + oscompat::to_string(version));
+    return true;
+  }
+
+  /// Read the tag of the next record into \p tag. \return false on failure.
+  bool readTag(RecordTag &tag) {
+    if (cur_ == end_)
+      return fail("missing end of snapshot");
+    uint8_t byte = *cur_++;
+    if (byte < static_cast<uint8_t>(RecordTag::String) ||
+        byte > static_cast<uint8_t>(RecordTag::End)) {
+      return fail("unknown record " + oscompat::to_string(byte));
+    }
+    tag = static_cast<RecordTag>(byte);
+    return true;
+  }
+
+  /// Read the string of a String record into \p str. \return false on
+  /// failure.
+  bool readString(llvm::StringRef &str) {
+    uint64_t size;
+    if (!readULEB(size))
+      return false;
+    if (size > static_cast<uint64_t>(end_ - cur_))
+      return fail("truncated string");
+    str = llvm::StringRef(reinterpret_cast<const char *>(cur_), size);
+    cur_ += size;
+    return true;
+  }
+
+  /// Read an unsigned varint into \p value. \return false on failure.
+  bool readULEB(uint64_t &value) {
+    unsigned size;
+    const char *err = nullptr;
+    value = llvm::decodeULEB128(cur_, &size, end_, &err);
+    if (err)
+      return fail(err);
+    cur_ += size;
+    return true;
+  }
+
+  /// Read an unsigned varint which must fit in 32 bits into \p value.
+  /// \return false on failure.
+  bool readULEB32(uint32_t &value) {
+    uint64_t value64;
+    if (!readULEB(value64))
+      return false;
+    if (value64 > std::numeric_limits<uint32_t>::max())
+      return fail("value out of range");
+    value = static_cast<uint32_t>(value64);
+    return true;
+  }
+
+  /// Read a signed varint into \p value. \return false on failure.
+  bool readSLEB(int64_t &value) {
+    unsigned size;
+    const char *err = nullptr;
+    value = llvm::decodeSLEB128(cur_, &size, end_, &err);
+    if (err)
+      return fail(err);
+    cur_ += size;
+    return true;
+  }
+
+  /// Set the error to \p msg. \return false.
+  bool fail(const llvm::Twine &msg) {
+    error_ = msg.str();
+    return false;
+  }
+
+ private:
+  const uint8_t *cur_;
+  const uint8_t *const end_;
+  std::string &error_;
+};
+
+/// The fields of a Node record, with the id already resolved.
+struct NodeRecord {
+  uint32_t type;
+  V8HeapSnapshot::StringID name;
+  V8HeapSnapshot::Node::ID id;
+  HeapSizeType selfSize;
+  HeapSizeType edgeCount;
+};
+
+/// The fields of an Edge record, with the target already resolved.
+struct EdgeRecord {
+  uint32_t typeAndNamed;
+  uint32_t nameOrIndex;
+  V8HeapSnapshot::Node::ID toNode;
+};
+
+/// Read the fields of a Node record following \p lastID into \p node.
+bool readNode(
+    BinaryHeapSnapshotReader &reader,
+    V8HeapSnapshot::Node::ID lastID,
+    NodeRecord &node) {
+  int64_t delta;
+  if (!reader.readULEB32(node.type) || !reader.readULEB32(node.name) ||
+      !reader.readSLEB(delta) || !reader.readULEB32(node.selfSize) ||
+      !reader.readULEB32(node.edgeCount)) {
+    return false;
+  }
+  node.id = lastID + static_cast<V8HeapSnapshot::Node::ID>(delta);
+  return true;
+}
+
+/// Read the fields of an Edge record following \p lastTarget into \p edge.
+bool readEdge(
+    BinaryHeapSnapshotReader &reader,
+    V8HeapSnapshot::Node::ID lastTarget,
+    EdgeRecord &edge) {
+  int64_t delta;
+  if (!reader.readULEB32(edge.typeAndNamed) ||
+      !reader.readULEB32(edge.nameOrIndex) || !reader.readSLEB(delta)) {
+    return false;
+  }
+  edge.toNode = lastTarget + static_cast<V8HeapSnapshot::Node::ID>(delta);
+  return true;
+}
+
+} // namespace
+
+bool convertBinaryHeapSnapshot(
+    llvm::StringRef input,
+    JSONEmitter &json,
+    std::string &error) {
+  using RecordTag = BinaryHeapSnapshot::RecordTag;
+  constexpr uint32_t numNodeTypes = 0
+#define CELL_KIND(name) +1
+#include "hermes/VM/CellKinds.def"
+      ;
+  constexpr uint32_t numEdgeTypes =
+      static_cast<uint32_t>(V8HeapSnapshot::Edge::Type::Weak) + 1;
+
+  // Check the whole input first, since V8HeapSnapshot can't stop halfway, and
+  // gather the strings, which V8HeapSnapshot writes last.
+  std::vector<llvm::StringRef> strings;
+  {
+    BinaryHeapSnapshotReader reader{input, error};
+    if (!reader.readHeader())
+      return false;
+    llvm::DenseSet<V8HeapSnapshot::Node::ID> nodeIDs;
+    V8HeapSnapshot::Node::ID lastID = 0;
+    V8HeapSnapshot::Node::ID lastTarget = 0;
+    uint64_t expectedEdges = 0;
+    uint64_t numEdges = 0;
+    // The edges of the nodes are checked after all the nodes are read, since
+    // they may point to any node.
+    std::vector<V8HeapSnapshot::Node::ID> edgeTargets;
+    std::vector<uint32_t> nodeNames;
+    std::vector<uint32_t> edgeNames;
+    RecordTag tag;
+    do {
+      if (!reader.readTag(tag))
+        return false;
+      switch (tag) {
+        case RecordTag::String: {
+          llvm::StringRef str;
+          if (!reader.readString(str))
+            return false;
+          strings.push_back(str);
+          break;
+        }
+        case RecordTag::Node: {
+          NodeRecord node;
+          if (!readNode(reader, lastID, node))
+            return false;
+          lastID = node.id;
+          if (numEdges)
+            return reader.fail("node after edges");
+          if (node.type >= numNodeTypes)
+            return reader.fail("invalid node type");
+          if (node.name >= strings.size())
+            return reader.fail("node name is not a string");
+          if (!nodeIDs.insert(node.id).second)
+            return reader.fail("duplicate node id");
+          expectedEdges += node.edgeCount;
+          break;
+        }
+        case RecordTag::Edge: {
+          EdgeRecord edge;
+          if (!readEdge(reader, lastTarget, edge))
+            return false;
+          lastTarget = edge.toNode;
+          ++numEdges;
+          if ((edge.typeAndNamed >> 1) >= numEdgeTypes)
+            return reader.fail("invalid edge type");
+          if ((edge.typeAndNamed & 1) && edge.nameOrIndex >= strings.size())
+            return reader.fail("edge name is not a string");
+          if (!nodeIDs.count(edge.toNode))
+            return reader.fail("edge to an unknown node");
+          break;
+        }
+        case RecordTag::End:
+          break;
+      }
+    } while (tag != RecordTag::End);
+    if (numEdges != expectedEdges)
+      return reader.fail("edge count does not match the nodes");
+  }
+
+  BinaryHeapSnapshotReader reader{input, error};
+  reader.readHeader();
+  V8HeapSnapshot snap(json);
+  V8HeapSnapshot::Node::ID lastID = 0;
+  V8HeapSnapshot::Node::ID lastTarget = 0;
+  bool inEdges = false;
+  snap.beginNodes();
+  RecordTag tag;
+  do {
+    reader.readTag(tag);
+    switch (tag) {
+      case RecordTag::String: {
+        llvm::StringRef str;
+        reader.readString(str);
+        break;
+      }
+      case RecordTag::Node: {
+        NodeRecord node;
+        readNode(reader, lastID, node);
+        lastID = node.id;
+        snap.addNode(V8HeapSnapshot::Node{static_cast<CellKind>(node.type),
+                                          node.name,
+                                          node.id,
+                                          node.selfSize,
+                                          node.edgeCount});
+        break;
+      }
+      case RecordTag::Edge: {
+        EdgeRecord edge;
+        readEdge(reader, lastTarget, edge);
+        lastTarget = edge.toNode;
+        if (!inEdges) {
+          snap.endNodes();
+          snap.beginEdges();
+          inEdges = true;
+        }
+        auto type =
+            static_cast<V8HeapSnapshot::Edge::Type>(edge.typeAndNamed >> 1);
+        if (edge.typeAndNamed & 1) {
+          snap.addEdge(V8HeapSnapshot::Edge{V8HeapSnapshot::Edge::Named{},
+                                            type,
+                                            edge.toNode,
+                                            edge.nameOrIndex});
+        } else {
+          snap.addEdge(V8HeapSnapshot::Edge{V8HeapSnapshot::Edge::Unnamed{},
+                                            type,
+                                            edge.toNode,
+                                            edge.nameOrIndex});
+        }
+        break;
+      }
+      case RecordTag::End:
+        break;
+    }
+  } while (tag != RecordTag::End);
+  if (!inEdges) {
+    snap.endNodes();
+    snap.beginEdges();
+  }
+  snap.endEdges();
+
+  snap.beginTraceFunctionInfos();
+  snap.endTraceFunctionInfos();
+  snap.beginTraceTree();
+  snap.endTraceTree();
+  snap.beginSamples();
+  snap.endSamples();
+  snap.beginLocations();
+  snap.endLocations();
+  snap.beginStrings();
+  for (llvm::StringRef str : strings)
+    snap.addString(str);
+  snap.endStrings();
+  return true;
+}
+
 std::string escapeJSON(llvm::StringRef s) {
   std::ostringstream o;
   for (const unsigned char c : s) {
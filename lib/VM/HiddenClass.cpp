@@ -663,6 +663,21 @@ ExecutionStatus HiddenClass::addToPropertyMap(
   return ExecutionStatus::RETURNED;
 }
 
+void HiddenClass::clearRecreatableCaches(Runtime *runtime) {
+  clearForInCache();
+  if (!propertyMap_ || isDictionary())
+    return;
+  // initializeMissingPropertyMap() recreates the map from the chain of
+  // transitions leading to this class, which must reach a class without
+  // properties.
+  for (const HiddenClass *cur = this; cur->numProperties_ > 0;
+       cur = cur->parent_.get(runtime)) {
+    if (!cur->parent_)
+      return;
+  }
+  propertyMap_ = nullptr;
+}
+
 void HiddenClass::initializeMissingPropertyMap(
     Handle<HiddenClass> selfHandle,
     Runtime *runtime) {
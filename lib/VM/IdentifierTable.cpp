@@ -35,6 +35,14 @@ IdentifierTable::IdentifierTable() {
   hashTable_.setIdentifierTable(this);
 }
 
+IdentifierTable &IdentifierTable::operator=(const IdentifierTable &other) {
+  lookupVector_ = other.lookupVector_;
+  hashTable_ = other.hashTable_;
+  hashTable_.setIdentifierTable(this);
+  firstFreeID_ = other.firstFreeID_;
+  return *this;
+}
+
 CallResult<Handle<SymbolID>> IdentifierTable::getSymbolHandle(
     Runtime *runtime,
     UTF16Ref str,
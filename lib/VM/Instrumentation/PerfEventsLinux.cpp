@@ -54,6 +54,11 @@ static PerfCounter counters[] = {
      PERF_TYPE_HW_CACHE,
      (PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))},
+    {-1,
+     "dTLB-load-misses",
+     PERF_TYPE_HW_CACHE,
+     (PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))},
     {-1, "major-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ},
 };
 
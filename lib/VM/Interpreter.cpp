@@ -551,6 +551,33 @@ CallResult<HermesValue> Interpreter::createObjectFromBuffer(
           ? JSObject::create(runtime, optCachedHiddenClassHandle.getValue())
           : JSObject::create(runtime, numLiterals));
 
+  // Once the hidden class is cached, the literal is likely to be created
+  // again, so also cache its decoded values. Then the object can be filled
+  // without decoding the buffers.
+  llvm::Optional<llvm::ArrayRef<HermesValue>> optValues{};
+  if (optCachedHiddenClassHandle.hasValue())
+    optValues =
+        runtimeModule->getLiteralValuesMayAllocate(valBufferIndex, numLiterals);
+
+  if (optValues.hasValue()) {
+    assert(
+        optValues->size() ==
+            optCachedHiddenClassHandle.getValue()->getNumProperties() &&
+        "cached values should match the cached hidden class");
+    uint32_t propIndex = 0;
+    for (HermesValue cached : *optValues) {
+      // Strings are cached as the SymbolIDs of their identifiers. Getting the
+      // string may allocate, so do it before obj.get().
+      const HermesValue val = cached.isSymbol()
+          ? HermesValue::encodeStringValue(
+                runtime->getStringPrimFromSymbolID(cached.getSymbol()))
+          : cached;
+      JSObject::setNamedSlotValue(obj.get(), runtime, propIndex, val);
+      ++propIndex;
+    }
+    return HermesValue::encodeObjectValue(*obj);
+  }
+
   MutableHandle<> tmpHandleKey(runtime);
   MutableHandle<> tmpHandleVal(runtime);
   auto &gcScope = *runtime->getTopGCScope();
@@ -1328,6 +1355,39 @@ tailCall:
     DISPATCH;                   \
   }
 
+/// Finish the first half of the superinstruction \p name and continue with its
+/// second half, an instruction of type \p second, without dispatching. The
+/// second instruction is dispatched normally when single stepping or when it
+/// has been replaced by a debugger breakpoint.
+#define DISPATCH_FUSED(name, second)                                          \
+  ip = NEXTINST(name);                                                        \
+  if (!SingleStep && LLVM_LIKELY(ip->opCode == OpCode::second)) {             \
+    goto fused_##second;                                                      \
+  }                                                                           \
+  DISPATCH
+
+/// Implement a superinstruction that starts with GetByIdShort. A property read
+/// that hits the cache is done inline and followed by the second instruction
+/// \p second; everything else goes through the regular GetById path, which
+/// then dispatches the second instruction.
+#define GET_BY_ID_SHORT_FUSED(name, second)                                   \
+  CASE(name) {                                                                \
+    if (LLVM_LIKELY(O2REG(name).isObject())) {                                \
+      auto *obj = vmcast<JSObject>(O2REG(name));                              \
+      auto *entry = curCodeBlock->getReadCacheEntry(ip->i##name.op3);         \
+      if (LLVM_LIKELY(entry->clazz == obj->getClass(runtime))) {              \
+        ++NumGetByIdCacheHits;                                                \
+        O1REG(name) = JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(  \
+            obj, runtime, entry->slot);                                       \
+        DISPATCH_FUSED(name, second);                                         \
+      }                                                                       \
+    }                                                                         \
+    tryProp = false;                                                          \
+    idVal = ip->i##name.op4;                                                  \
+    nextIP = NEXTINST(name);                                                  \
+    goto getById;                                                             \
+  }
+
       CASE(Mov) {
         O1REG(Mov) = O2REG(Mov);
         ip = NEXTINST(Mov);
@@ -1340,6 +1400,7 @@ tailCall:
         DISPATCH;
       }
 
+    fused_LoadParam:
       CASE(LoadParam) {
         if (LLVM_LIKELY(ip->iLoadParam.op2 <= FRAME.getArgCount())) {
           // index 0 must load 'this'. Index 1 the first argument, etc.
@@ -1423,6 +1484,7 @@ tailCall:
       // argument index -1.
       // Also note that we are writing to callNewTarget last, to avoid the
       // possibility of it being aliased by the arg writes.
+    fused_Call1:
       CASE(Call1) {
         callArgCount = 1;
         nextIP = NEXTINST(Call1);
@@ -1432,6 +1494,7 @@ tailCall:
         goto doCall;
       }
 
+    fused_Call2:
       CASE(Call2) {
         callArgCount = 2;
         nextIP = NEXTINST(Call2);
@@ -1442,6 +1505,7 @@ tailCall:
         goto doCall;
       }
 
+    fused_Call3:
       CASE(Call3) {
         callArgCount = 3;
         nextIP = NEXTINST(Call3);
@@ -1709,6 +1773,7 @@ tailCall:
         DISPATCH;
       }
 
+    fused_Ret:
       CASE(Ret) {
 #ifdef HERMES_ENABLE_DEBUGGER
         // Check for an async debugger request.
@@ -3106,6 +3171,7 @@ tailCall:
       CASE(CreateRegExp) {
         {
           // Create the RegExp object.
+          runtime->initLazyBuiltins(LazyBuiltins::RegExp);
           res = JSRegExp::create(
               runtime, Handle<JSObject>::vmcast(&runtime->regExpPrototype));
           if (res == ExecutionStatus::EXCEPTION) {
@@ -3207,6 +3273,7 @@ tailCall:
       JCOND(Greater, >, greaterOp_RJS);
       JCOND(GreaterEqual, >=, greaterEqualOp_RJS);
 
+    fused_JStrictEqual:
       JCOND_STRICT_EQ_IMPL(
           JStrictEqual, , IPADD(ip->iJStrictEqual.op1), NEXTINST(JStrictEqual));
       JCOND_STRICT_EQ_IMPL(
@@ -3240,6 +3307,39 @@ tailCall:
       CASE_OUTOFLINE(PutOwnGetterSetterByVal);
       CASE_OUTOFLINE(DirectEval);
 
+      GET_BY_ID_SHORT_FUSED(GetByIdShortCall1, Call1);
+      GET_BY_ID_SHORT_FUSED(GetByIdShortCall2, Call2);
+      GET_BY_ID_SHORT_FUSED(GetByIdShortCall3, Call3);
+
+      CASE(LoadParamLoadParam) {
+        if (LLVM_LIKELY(ip->iLoadParamLoadParam.op2 <= FRAME.getArgCount())) {
+          O1REG(LoadParamLoadParam) =
+              FRAME.getArgRef((int32_t)ip->iLoadParamLoadParam.op2 - 1);
+        } else {
+          O1REG(LoadParamLoadParam) = HermesValue::encodeUndefinedValue();
+        }
+        DISPATCH_FUSED(LoadParamLoadParam, LoadParam);
+      }
+
+      CASE(LoadConstUndefinedRet) {
+        O1REG(LoadConstUndefinedRet) = HermesValue::encodeUndefinedValue();
+        DISPATCH_FUSED(LoadConstUndefinedRet, Ret);
+      }
+
+      CASE(LoadConstUInt8JStrictEqual) {
+        O1REG(LoadConstUInt8JStrictEqual) =
+            HermesValue::encodeDoubleValue(ip->iLoadConstUInt8JStrictEqual.op2);
+        DISPATCH_FUSED(LoadConstUInt8JStrictEqual, JStrictEqual);
+      }
+
+      CASE(LoadConstStringJStrictEqual) {
+        O1REG(LoadConstStringJStrictEqual) = HermesValue::encodeStringValue(
+            curCodeBlock->getRuntimeModule()
+                ->getStringPrimFromStringIDMayAllocate(
+                    ip->iLoadConstStringJStrictEqual.op2));
+        DISPATCH_FUSED(LoadConstStringJStrictEqual, JStrictEqual);
+      }
+
       CASE(_last) {
         llvm_unreachable("Invalid opcode _last");
       }
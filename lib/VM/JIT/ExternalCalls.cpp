@@ -848,6 +848,7 @@ CallResult<HermesValue> externCreateRegExpMayAllocate(
   GCScopeMarkerRAII marker{runtime};
 
   // Create the RegExp object.
+  runtime->initLazyBuiltins(LazyBuiltins::RegExp);
   auto regRes = JSRegExp::create(
       runtime, Handle<JSObject>::vmcast(&runtime->regExpPrototype));
   if (regRes == ExecutionStatus::EXCEPTION) {
@@ -300,6 +300,21 @@ Emitters FastJIT::emitEpilogue(Emitters emit) {
 // one.
 #define NEXTINST(name) ((const Inst *)(&ip->i##name + 1))
 
+/// \return the first instruction of the pair fused by the superinstruction
+/// \p opCode, or \p opCode itself if it isn't one. A superinstruction has the
+/// operands of its first instruction and is followed by the second one, so
+/// the JIT compiles the two separately.
+static OpCode unfuseSuperinstruction(OpCode opCode) {
+  switch (opCode) {
+#define DEFINE_SUPERINSTRUCTION(name, first, second) \
+  case OpCode::name:                                 \
+    return OpCode::first;
+#include "hermes/BCGen/HBC/BytecodeList.def"
+    default:
+      return opCode;
+  }
+}
+
 Emitters FastJIT::compileBB(Emitters emit) {
   auto *ip = reinterpret_cast<const Inst *>(
       codeBlock_->begin() + bcBasicBlocks_[curBytecodeBBIndex_]);
@@ -315,7 +330,7 @@ Emitters FastJIT::compileBB(Emitters emit) {
     auto sav = emit;
 #endif
 
-    switch (ip->opCode) {
+    switch (unfuseSuperinstruction(ip->opCode)) {
 #define CASE(name)                  \
   case OpCode::name:                \
     emit = compile##name(emit, ip); \
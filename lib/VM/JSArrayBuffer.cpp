@@ -122,11 +122,19 @@ void JSArrayBuffer::_finalizeImpl(GCCell *cell, GC *gc) {
 
 size_t JSArrayBuffer::_mallocSizeImpl(GCCell *cell) {
   const auto *buffer = static_cast<JSArrayBuffer *>(cell);
-  return buffer->size_;
+  return buffer->isExternal() ? 0 : buffer->size_;
 }
 
 void JSArrayBuffer::detach(GC *gc) {
-  if (data_) {
+  if (externalFinalize_) {
+    // The block isn't ours: it was neither allocated nor charged here.
+    FinalizeDataBlockPtr finalize = externalFinalize_;
+    externalFinalize_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    finalize(externalContext_);
+    externalContext_ = nullptr;
+  } else if (data_) {
     gc->debitExternalMemory(this, size_);
     free(data_);
     data_ = nullptr;
@@ -139,6 +147,21 @@ void JSArrayBuffer::detach(GC *gc) {
   attached_ = false;
 }
 
+void JSArrayBuffer::setExternalDataBlock(
+    Runtime *runtime,
+    char *data,
+    size_type size,
+    void *context,
+    FinalizeDataBlockPtr finalize) {
+  assert(finalize && "an external data block needs a finalizer");
+  detach(&runtime->getHeap());
+  data_ = data;
+  size_ = size;
+  attached_ = true;
+  externalFinalize_ = finalize;
+  externalContext_ = context;
+}
+
 ExecutionStatus
 JSArrayBuffer::createDataBlock(Runtime *runtime, size_type size, bool zero) {
   detach(&runtime->getHeap());
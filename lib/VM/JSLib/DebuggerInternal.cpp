@@ -50,7 +50,7 @@ Handle<JSObject> createDebuggerInternalObject(Runtime *runtime) {
       true,
       false);
 
-  JSObject::preventExtensions(*intern);
+  JSObject::preventExtensions(intern, runtime);
   runtime->debuggerInternalObject_ = intern.getHermesValue();
 
   return intern;
@@ -249,6 +249,131 @@ throwTypeError(void *ctx, Runtime *runtime, NativeArgs) {
   return runtime->raiseTypeError(TwineChar16(message));
 }
 
+/// The global properties defined by each group of builtins whose creation can
+/// be deferred.
+static const struct {
+  Predefined::Str name;
+  LazyBuiltins group;
+} lazyGlobals[] = {
+    {Predefined::Date, LazyBuiltins::Date},
+    {Predefined::RegExp, LazyBuiltins::RegExp},
+    {Predefined::ArrayBuffer, LazyBuiltins::TypedArray},
+    {Predefined::DataView, LazyBuiltins::TypedArray},
+#define TYPED_ARRAY(name, type) \
+  {Predefined::name##Array, LazyBuiltins::TypedArray},
+#include "hermes/VM/TypedArrays.def"
+    {Predefined::Set, LazyBuiltins::Set},
+    {Predefined::Map, LazyBuiltins::Map},
+    {Predefined::WeakMap, LazyBuiltins::WeakMap},
+    {Predefined::WeakSet, LazyBuiltins::WeakSet},
+    {Predefined::Symbol, LazyBuiltins::Symbol},
+};
+
+llvm::Optional<LazyBuiltins> getLazyBuiltinsOfGlobal(SymbolID name) {
+  for (const auto &global : lazyGlobals) {
+    if (Predefined::getSymbolID(global.name) == name)
+      return global.group;
+  }
+  return llvm::None;
+}
+
+void createLazyBuiltins(Runtime *runtime, LazyBuiltins group) {
+  GCScope gcScope{runtime, "createLazyBuiltins"};
+
+  switch (group) {
+    case LazyBuiltins::Date:
+      // Date.prototype, populated by the constructor.
+      runtime->datePrototype =
+          JSObject::create(
+              runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
+              .getHermesValue();
+      createDateConstructor(runtime);
+      break;
+
+    case LazyBuiltins::RegExp:
+      // ES6: 21.2.5 "The RegExp prototype object is an ordinary object. It is
+      // not a RegExp instance..."
+      runtime->regExpPrototype =
+          JSObject::create(
+              runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
+              .getHermesValue();
+      createRegExpConstructor(runtime);
+      break;
+
+    case LazyBuiltins::TypedArray:
+      runtime->arrayBufferPrototype =
+          JSObject::create(
+              runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
+              .getHermesValue();
+      runtime->dataViewPrototype =
+          JSObject::create(
+              runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
+              .getHermesValue();
+      runtime->typedArrayBasePrototype =
+          JSTypedArrayBase::create(
+              runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
+              .getHermesValue();
+// NOTE: a TypedArray's prototype is a normal object, not a TypedArray.
+#define TYPED_ARRAY(name, type)                                        \
+  runtime->name##ArrayPrototype =                                      \
+      JSObject::create(                                                \
+          runtime,                                                     \
+          Handle<JSObject>::vmcast(&runtime->typedArrayBasePrototype)) \
+          .getHermesValue();
+#include "hermes/VM/TypedArrays.def"
+
+      createArrayBufferConstructor(runtime);
+      createDataViewConstructor(runtime);
+      runtime->typedArrayBaseConstructor =
+          createTypedArrayBaseConstructor(runtime).getHermesValue();
+#define TYPED_ARRAY(name, type)                                             \
+  runtime->name##ArrayConstructor =                                         \
+      createTypedArrayConstructor<type, CellKind::name##ArrayKind>(runtime) \
+          .getHermesValue();                                                \
+  gcScope.clearAllHandles();
+#include "hermes/VM/TypedArrays.def"
+      break;
+
+    case LazyBuiltins::Set:
+      runtime->setPrototype = runtime->ignoreAllocationFailure(JSSet::create(
+          runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype)));
+      runtime->setIteratorPrototype =
+          createSetIteratorPrototype(runtime).getHermesValue();
+      createSetConstructor(runtime);
+      break;
+
+    case LazyBuiltins::Map:
+      runtime->mapPrototype = runtime->ignoreAllocationFailure(JSMap::create(
+          runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype)));
+      runtime->mapIteratorPrototype =
+          createMapIteratorPrototype(runtime).getHermesValue();
+      createMapConstructor(runtime);
+      break;
+
+    case LazyBuiltins::WeakMap:
+      runtime->weakMapPrototype = JSObject::create(runtime).getHermesValue();
+      createWeakMapConstructor(runtime);
+      break;
+
+    case LazyBuiltins::WeakSet:
+      runtime->weakSetPrototype = JSObject::create(runtime).getHermesValue();
+      createWeakSetConstructor(runtime);
+      break;
+
+    case LazyBuiltins::Symbol:
+      // Symbol.prototype is needed to box symbols even without the
+      // constructor.
+      runtime->symbolPrototype = JSObject::create(runtime).getHermesValue();
+      if (LLVM_UNLIKELY(runtime->hasES6Symbol())) {
+        createSymbolConstructor(runtime);
+      }
+      break;
+
+    case LazyBuiltins::_count:
+      llvm_unreachable("invalid group of builtins");
+  }
+}
+
 // NOTE: when declaring more global symbols, don't forget to update
 // "Libhermes.h".
 void initGlobalObject(Runtime *runtime) {
@@ -279,6 +404,16 @@ void initGlobalObject(Runtime *runtime) {
   clearConfigurableDPF.setConfigurable = 1;
   clearConfigurableDPF.configurable = 0;
 
+  // Create the builtins of \p group, unless their creation is deferred until
+  // first use. The global object then intercepts lookups of missing
+  // properties, to create them.
+  auto createUnlessDeferred = [runtime](LazyBuiltins group) {
+    if (!runtime->areBuiltinsDeferred(group))
+      createLazyBuiltins(runtime, group);
+    else
+      runtime->getGlobal()->setLazy(true);
+  };
+
   // Define a function on the global object with name \p name.
   // Allocates a NativeObject and puts it in the global object.
   auto defineGlobalFunc =
@@ -407,17 +542,6 @@ void initGlobalObject(Runtime *runtime) {
       runtime->ignoreAllocationFailure(JSBoolean::create(
           runtime, false, Handle<JSObject>::vmcast(&runtime->objectPrototype)));
 
-  // "Forward declaration" of Symbol.prototype. Its properties will be
-  // populated later.
-  runtime->symbolPrototype = JSObject::create(runtime).getHermesValue();
-
-  // "Forward declaration" of Date.prototype. Its properties will be
-  // populated later.
-  runtime->datePrototype =
-      JSObject::create(
-          runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
-          .getHermesValue();
-
   // "Forward declaration" of %IteratorPrototype%.
   runtime->iteratorPrototype = JSObject::create(runtime).getHermesValue();
 
@@ -440,67 +564,6 @@ void initGlobalObject(Runtime *runtime) {
           .getHermesValue();
   runtime->arrayClassRawPtr = vmcast<HiddenClass>(runtime->arrayClass);
 
-  // "Forward declaration" of ArrayBuffer.prototype. Its properties will be
-  // populated later.
-  runtime->arrayBufferPrototype =
-      JSObject::create(
-          runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
-          .getHermesValue();
-
-  // "Forward declaration" of DataView.prototype. Its properties will be
-  // populated later.
-  runtime->dataViewPrototype =
-      JSObject::create(
-          runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
-          .getHermesValue();
-
-  // "Forward declaration" of TypedArrayBase.prototype. Its properties will be
-  // populated later.
-  runtime->typedArrayBasePrototype =
-      JSTypedArrayBase::create(
-          runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
-          .getHermesValue();
-
-// Typed arrays
-// NOTE: a TypedArray's prototype is a normal object, not a TypedArray.
-#define TYPED_ARRAY(name, type)                                        \
-  runtime->name##ArrayPrototype =                                      \
-      JSObject::create(                                                \
-          runtime,                                                     \
-          Handle<JSObject>::vmcast(&runtime->typedArrayBasePrototype)) \
-          .getHermesValue();
-#include "hermes/VM/TypedArrays.def"
-
-  // "Forward declaration" of Set.prototype. Its properties will be
-  // populated later.
-  runtime->setPrototype = runtime->ignoreAllocationFailure(JSSet::create(
-      runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype)));
-
-  runtime->setIteratorPrototype =
-      createSetIteratorPrototype(runtime).getHermesValue();
-
-  // "Forward declaration" of Map.prototype. Its properties will be
-  // populated later.
-  runtime->mapPrototype = runtime->ignoreAllocationFailure(JSMap::create(
-      runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype)));
-
-  runtime->mapIteratorPrototype =
-      createMapIteratorPrototype(runtime).getHermesValue();
-
-  // "Forward declaration" of RegExp.prototype.
-  // ES6: 21.2.5 "The RegExp prototype object is an ordinary object. It is not a
-  // RegExp instance..."
-  runtime->regExpPrototype =
-      JSObject::create(
-          runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype))
-          .getHermesValue();
-
-  // "Forward declaration" of WeakMap.prototype.
-  runtime->weakMapPrototype = JSObject::create(runtime).getHermesValue();
-
-  // "Forward declaration" of WeakSet.prototype.
-  runtime->weakSetPrototype = JSObject::create(runtime).getHermesValue();
-
   // "Forward declaration" of %ArrayIteratorPrototype%.
   runtime->arrayIteratorPrototype =
       JSObject::create(
@@ -549,49 +612,33 @@ void initGlobalObject(Runtime *runtime) {
   createBooleanConstructor(runtime);
 
   // Date constructor.
-  createDateConstructor(runtime);
+  createUnlessDeferred(LazyBuiltins::Date);
 
   // RegExp constructor
-  createRegExpConstructor(runtime);
+  createUnlessDeferred(LazyBuiltins::RegExp);
   runtime->regExpLastInput = HermesValue::encodeUndefinedValue();
   runtime->regExpLastRegExp = HermesValue::encodeUndefinedValue();
 
   // Array constructor.
   createArrayConstructor(runtime);
 
-  // ArrayBuffer constructor.
-  createArrayBufferConstructor(runtime);
-
-  // DataView constructor.
-  createDataViewConstructor(runtime);
-
-  // TypedArrayBase constructor.
-  runtime->typedArrayBaseConstructor =
-      createTypedArrayBaseConstructor(runtime).getHermesValue();
-
-#define TYPED_ARRAY(name, type)                                             \
-  runtime->name##ArrayConstructor =                                         \
-      createTypedArrayConstructor<type, CellKind::name##ArrayKind>(runtime) \
-          .getHermesValue();                                                \
-  gcScope.clearAllHandles();
-#include "hermes/VM/TypedArrays.def"
+  // ArrayBuffer, DataView, TypedArrayBase and typed array constructors.
+  createUnlessDeferred(LazyBuiltins::TypedArray);
 
   // Set constructor.
-  createSetConstructor(runtime);
+  createUnlessDeferred(LazyBuiltins::Set);
 
   // Map constructor.
-  createMapConstructor(runtime);
+  createUnlessDeferred(LazyBuiltins::Map);
 
   // WeakMap constructor.
-  createWeakMapConstructor(runtime);
+  createUnlessDeferred(LazyBuiltins::WeakMap);
 
   // WeakSet constructor.
-  createWeakSetConstructor(runtime);
+  createUnlessDeferred(LazyBuiltins::WeakSet);
 
   // Symbol constructor.
-  if (LLVM_UNLIKELY(runtime->hasES6Symbol())) {
-    createSymbolConstructor(runtime);
-  }
+  createUnlessDeferred(LazyBuiltins::Symbol);
 
   /// %IteratorPrototype%.
   populateIteratorPrototype(runtime);
@@ -69,6 +69,7 @@ hermesInternalGetEpilogues(void *, Runtime *runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   // Set each element to a Uint8Array holding the epilogue for that module.
+  runtime->initLazyBuiltins(LazyBuiltins::TypedArray);
   for (unsigned i = 0; i < outerLen; ++i) {
     auto innerLen = eps[i].size();
     if (innerLen != 0) {
@@ -116,12 +117,14 @@ CallResult<HermesValue>
 hermesInternalGetWeakSize(void *, Runtime *runtime, NativeArgs args) {
   auto M = args.dyncastArg<JSWeakMap>(runtime, 0);
   if (M) {
-    return HermesValue::encodeNumberValue(JSWeakMap::debugGetSize(*M));
+    return HermesValue::encodeNumberValue(
+        JSWeakMap::debugGetSize(*M, runtime));
   }
 
   auto S = args.dyncastArg<JSWeakSet>(runtime, 0);
   if (S) {
-    return HermesValue::encodeNumberValue(JSWeakSet::debugGetSize(*S));
+    return HermesValue::encodeNumberValue(
+        JSWeakSet::debugGetSize(*S, runtime));
   }
 
   return runtime->raiseTypeError(
@@ -508,7 +511,7 @@ hermesInternalGetTemplateObject(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Failed to set 'length' property on the raw object read-only.");
   }
-  JSObject::preventExtensions(rawObj.get());
+  JSObject::preventExtensions(rawObj, runtime);
 
   // Set raw object as a read-only non-enumerable property of the template
   // object.
@@ -540,7 +543,7 @@ hermesInternalGetTemplateObject(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Failed to set 'length' property on the raw object read-only.");
   }
-  JSObject::preventExtensions(templateObj.get());
+  JSObject::preventExtensions(templateObj, runtime);
 
   // Cache the template object.
   runtimeModule->cacheTemplateObject(templateObjID, templateObj);
@@ -921,7 +924,7 @@ Handle<JSObject> createHermesInternalObject(Runtime *runtime) {
       "Failed to set HermesInternal.concat.");
   (void)putRes;
 
-  JSObject::preventExtensions(*intern);
+  JSObject::preventExtensions(intern, runtime);
 
   return intern;
 }
@@ -311,7 +311,10 @@ mapPrototypeClear(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Map.prototype.clear called on incompatible receiver");
   }
-  JSMap::clear(selfHandle, runtime);
+  if (LLVM_UNLIKELY(
+          JSMap::clear(selfHandle, runtime) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return HermesValue::encodeUndefinedValue();
 }
 
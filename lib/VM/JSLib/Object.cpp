@@ -984,13 +984,13 @@ objectFreeze(void *, Runtime *runtime, NativeArgs args) {
 
 static CallResult<HermesValue>
 objectPreventExtensions(void *, Runtime *runtime, NativeArgs args) {
-  auto *obj = dyn_vmcast<JSObject>(args.getArg(0));
+  auto objHandle = args.dyncastArg<JSObject>(runtime, 0);
 
-  if (!obj) {
+  if (!objHandle) {
     return args.getArg(0);
   }
 
-  JSObject::preventExtensions(obj);
+  JSObject::preventExtensions(objHandle, runtime);
   return args.getArg(0);
 }
 
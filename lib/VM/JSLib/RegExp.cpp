@@ -316,6 +316,8 @@ static CallResult<Handle<JSRegExp>> regExpInitialize(
 /// ES6.0 21.2.3.2.3 Runtime Semantics: RegExpCreate ( P, F )
 CallResult<Handle<JSRegExp>>
 regExpCreate(Runtime *runtime, Handle<> P, Handle<> F) {
+  // This is also used by String.prototype, before RegExp may exist.
+  runtime->initLazyBuiltins(LazyBuiltins::RegExp);
   auto objRes =
       regExpAlloc(runtime, createPseudoHandle(runtime->regExpPrototype));
   if (LLVM_UNLIKELY(objRes == ExecutionStatus::EXCEPTION)) {
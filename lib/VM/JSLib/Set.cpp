@@ -293,7 +293,10 @@ setPrototypeClear(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Set.prototype.clear called on incompatible receiver");
   }
-  JSSet::clear(selfHandle, runtime);
+  if (LLVM_UNLIKELY(
+          JSSet::clear(selfHandle, runtime) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return HermesValue::encodeUndefinedValue();
 }
 
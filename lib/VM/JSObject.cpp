@@ -140,11 +140,28 @@ void JSObject::initializeLazyObject(
   // object is now assumed to be a regular object.
   lazyObject->flags_.lazyObject = 0;
 
+  // The global object is lazy while some of its builtins are deferred.
+  if (lazyObject.get() == runtime->getGlobal().get()) {
+    runtime->initAllLazyBuiltins();
+    return;
+  }
+
   // only functions can be lazy.
   assert(vmisa<Callable>(lazyObject.get()) && "unexpected lazy object");
   Callable::defineLazyProperties(Handle<Callable>::vmcast(lazyObject), runtime);
 }
 
+bool JSObject::initializeLazyProperty(
+    Runtime *runtime,
+    Handle<JSObject> lazyObject,
+    SymbolID name) {
+  assert(lazyObject->flags_.lazyObject && "object must be lazy");
+  if (lazyObject.get() == runtime->getGlobal().get())
+    return runtime->initLazyGlobal(name);
+  initializeLazyObject(runtime, lazyObject);
+  return true;
+}
+
 ObjectID JSObject::getObjectID(JSObject *self, Runtime *runtime) {
   if (LLVM_LIKELY(self->flags_.objectID))
     return self->flags_.objectID;
@@ -692,8 +709,8 @@ CallResult<bool> JSObject::getOwnComputedPrimitiveDescriptor(
     }
   }
 
-  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject)) {
-    JSObject::initializeLazyObject(runtime, selfHandle);
+  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject) &&
+      JSObject::initializeLazyProperty(runtime, selfHandle, id)) {
     return getOwnComputedPrimitiveDescriptor(
         selfHandle, runtime, nameValHandle, desc);
   }
@@ -737,9 +754,8 @@ JSObject *JSObject::getNamedDescriptor(
 
   if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject)) {
     // Initialize the object and perform the lookup again.
-    JSObject::initializeLazyObject(runtime, selfHandle);
-
-    if (findProperty(selfHandle, runtime, name, expectedFlags, desc))
+    if (JSObject::initializeLazyProperty(runtime, selfHandle, name) &&
+        findProperty(selfHandle, runtime, name, expectedFlags, desc))
       return *selfHandle;
   }
   if (selfHandle->parent_) {
@@ -761,7 +777,7 @@ JSObject *JSObject::getNamedDescriptor(
           return *mutableSelfHandle;
         }
       } else if (LLVM_UNLIKELY(mutableSelfHandle->flags_.lazyObject)) {
-        JSObject::initializeLazyObject(runtime, mutableSelfHandle);
+        JSObject::initializeLazyProperty(runtime, mutableSelfHandle, name);
         goto findProp;
       } else {
         assert(
@@ -1377,8 +1393,8 @@ CallResult<bool> JSObject::deleteNamed(
   if (!pos) {
     if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject)) {
       // object is lazy, initialize and read again.
-      initializeLazyObject(runtime, selfHandle);
-      pos = findProperty(selfHandle, runtime, name, desc);
+      if (initializeLazyProperty(runtime, selfHandle, name))
+        pos = findProperty(selfHandle, runtime, name, desc);
       if (!pos) // still not there, return true.
         return true;
     } else {
@@ -1451,16 +1467,16 @@ CallResult<bool> JSObject::deleteComputed(
     return false;
   }
 
+  // Convert the string to an SymbolID;
+  LAZY_TO_IDENTIFIER(runtime, nameValPrimitiveHandle, strPrim, id);
+
   // slow path, check if object is lazy before continuing.
-  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject)) {
+  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject) &&
+      initializeLazyProperty(runtime, selfHandle, id)) {
     // initialize and try again.
-    initializeLazyObject(runtime, selfHandle);
     return deleteComputed(selfHandle, runtime, nameValHandle, opFlags);
   }
 
-  // Convert the string to an SymbolID;
-  LAZY_TO_IDENTIFIER(runtime, nameValPrimitiveHandle, strPrim, id);
-
   // Find the property by name.
   NamedPropertyDescriptor desc;
   auto pos = findProperty(selfHandle, runtime, id, desc);
@@ -1550,8 +1566,8 @@ CallResult<bool> JSObject::defineOwnProperty(
 
   // if the property was not found and the object is lazy we need to initialize
   // it and try again.
-  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject)) {
-    JSObject::initializeLazyObject(runtime, selfHandle);
+  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject) &&
+      JSObject::initializeLazyProperty(runtime, selfHandle, name)) {
     return defineOwnProperty(
         selfHandle, runtime, name, dpFlags, valueOrAccessor, opFlags);
   }
@@ -1858,14 +1874,22 @@ bool JSObject::_checkAllOwnIndexedImpl(
   return true;
 }
 
-void JSObject::preventExtensions(JSObject *self) {
-  self->flags_.noExtend = true;
+void JSObject::preventExtensions(
+    Handle<JSObject> selfHandle,
+    Runtime *runtime) {
+  // Lazy properties can't be added once the object is non-extensible, so
+  // create them now.
+  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject))
+    initializeLazyObject(runtime, selfHandle);
+  selfHandle->flags_.noExtend = true;
 }
 
 void JSObject::seal(Handle<JSObject> selfHandle, Runtime *runtime) {
   // Already sealed?
   if (selfHandle->flags_.sealed)
     return;
+  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject))
+    initializeLazyObject(runtime, selfHandle);
 
   auto newClazz = HiddenClass::makeAllNonConfigurable(
       runtime->makeHandle(selfHandle->clazz_), runtime);
@@ -1879,6 +1903,8 @@ void JSObject::freeze(Handle<JSObject> selfHandle, Runtime *runtime) {
   // Already frozen?
   if (selfHandle->flags_.frozen)
     return;
+  if (LLVM_UNLIKELY(selfHandle->flags_.lazyObject))
+    initializeLazyObject(runtime, selfHandle);
 
   auto newClazz = HiddenClass::makeAllReadOnly(
       runtime->makeHandle(selfHandle->clazz_), runtime);
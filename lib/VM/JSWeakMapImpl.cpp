@@ -6,17 +6,23 @@
  */
 #include "hermes/VM/JSWeakMapImpl.h"
 
-#include "hermes/VM/WeakRefHolder.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
 
 namespace hermes {
 namespace vm {
 
+constexpr uint32_t JSWeakMapImplBase::kNotFound;
+constexpr uint32_t JSWeakMapImplBase::kMinCapacity;
+
 void JSWeakMapImplBase::WeakMapImplBaseBuildMeta(
     const GCCell *cell,
     Metadata::Builder &mb) {
   ObjectBuildMeta(cell, mb);
   const auto *self = static_cast<const JSWeakMapImplBase *>(cell);
-  mb.addField("@valueStorage", &self->valueStorage_);
+  mb.addField("@chunks", &self->chunks_);
 }
 
 /// Set a key/value, overwriting the previous value at that key,
@@ -26,33 +32,25 @@ ExecutionStatus JSWeakMapImplBase::setValue(
     Runtime *runtime,
     Handle<JSObject> key,
     Handle<> value) {
-  WeakRefHolder<JSObject> weakRef(runtime, key);
-  WeakRefKey mapKey(*weakRef, runtime->gcStableHashHermesValue(key));
-  DenseMapT::iterator it = self->map_.find(mapKey);
-
-  if (it != self->map_.end()) {
+  const uint32_t hash = hashKey(runtime, *key);
+  const uint32_t index = self->lookup(runtime, *key, hash);
+  if (index != kNotFound) {
     // Key already exists, update existing value.
-    assert(
-        it->second < self->valueStorage_.get(runtime)->size() &&
-        "invalid index");
-    self->valueStorage_.get(runtime)
-        ->at(it->second)
+    self->chunkFor(runtime, index)
+        ->value(index % EphemeronChunk::kMaxEntries)
         .set(*value, &runtime->getHeap());
     return ExecutionStatus::RETURNED;
   }
 
-  // Index in valueStorage_ in which to place the new element.
-  auto cr = getFreeValueStorageIndex(self, runtime);
-  if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
+  // Keep at least a quarter of the entries empty, so that probe sequences
+  // stay short and always end.
+  if (static_cast<uint64_t>(self->occupied_ + 1) * 4 >
+      static_cast<uint64_t>(self->capacity_) * 3) {
+    if (LLVM_UNLIKELY(rehash(self, runtime) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
   }
-  uint32_t i = *cr;
-
-  auto result = self->map_.try_emplace(mapKey, i);
-  (void)result;
-  assert(result.second && "unable to add a new value to map");
-
-  self->valueStorage_.get(runtime)->at(i).set(*value, &runtime->getHeap());
+  self->insertNew(runtime, key.getHermesValue(), hash, *value);
   return ExecutionStatus::RETURNED;
 }
 
@@ -62,13 +60,17 @@ bool JSWeakMapImplBase::deleteValue(
     Handle<JSWeakMapImplBase> self,
     Runtime *runtime,
     Handle<JSObject> key) {
-  WeakRefHolder<JSObject> weakRef(runtime, key);
-  WeakRefKey mapKey(*weakRef, runtime->gcStableHashHermesValue(key));
-  DenseMapT::iterator it = self->map_.find(mapKey);
-  if (it == self->map_.end()) {
+  const uint32_t index = self->lookup(runtime, *key, hashKey(runtime, *key));
+  if (index == kNotFound) {
     return false;
   }
-  self->deleteInternal(runtime, it);
+  // Leave a deleted entry, which doesn't end the probe sequences running
+  // through it. It stays occupied until the next rehash.
+  EphemeronChunk *chunk = self->chunkFor(runtime, index);
+  chunk->key(index % EphemeronChunk::kMaxEntries)
+      .setNonPtr(HermesValue::encodeNullValue());
+  chunk->value(index % EphemeronChunk::kMaxEntries)
+      .setNonPtr(HermesValue::encodeEmptyValue());
   return true;
 }
 
@@ -77,118 +79,145 @@ bool JSWeakMapImplBase::hasValue(
     Handle<JSWeakMapImplBase> self,
     Runtime *runtime,
     Handle<JSObject> key) {
-  WeakRefHolder<JSObject> weakRef(runtime, key);
-  WeakRefKey mapKey(*weakRef, runtime->gcStableHashHermesValue(key));
-  DenseMapT::iterator it = self->map_.find_as(mapKey);
-  return it != self->map_.end();
+  return self->lookup(runtime, *key, hashKey(runtime, *key)) != kNotFound;
 }
 
 HermesValue JSWeakMapImplBase::getValue(
     Handle<JSWeakMapImplBase> self,
     Runtime *runtime,
     Handle<JSObject> key) {
-  WeakRefHolder<JSObject> weakRef(runtime, key);
-  WeakRefKey mapKey(*weakRef, runtime->gcStableHashHermesValue(key));
-  DenseMapT::iterator it = self->map_.find(mapKey);
-  if (it == self->map_.end()) {
+  const uint32_t index = self->lookup(runtime, *key, hashKey(runtime, *key));
+  if (index == kNotFound) {
     return HermesValue::encodeUndefinedValue();
   }
-  return self->valueStorage_.get(runtime)->at(it->second);
-}
-
-/// Mark weak references and remove any invalid weak refs.
-void JSWeakMapImplBase::markWeakRefs(GC *gc) {
-  for (auto it = map_.begin(); it != map_.end(); ++it) {
-    // We must mark the weak ref regardless of whether the ref is valid here,
-    // because JSWeakMapImplBase still has a pointer from map_ into the
-    // reference. If we were to skip marking this particular ref, it could be
-    // freed before we have a chance to remove the pointer from map_.
-    // Then, if the GC runs before we call deleteInternal on the ref,
-    // we would attempt to call markWeakRef on a freed ref, which is a violation
-    // of the markWeakRef contract.
-    gc->markWeakRef(it->first.ref);
-    if (!it->first.ref.isValid()) {
-      // Set the hasFreeableSlots_ to indicate that this slot can be
-      // cleaned up the next time we add an element to this map.
-      hasFreeableSlots_ = true;
+  return self->chunkFor(runtime, index)
+      ->value(index % EphemeronChunk::kMaxEntries);
+}
+
+uint32_t JSWeakMapImplBase::debugGetSize(
+    JSWeakMapImplBase *self,
+    PointerBase *base) {
+  return self->countLive(base);
+}
+
+uint32_t JSWeakMapImplBase::hashKey(Runtime *runtime, JSObject *key) {
+  // The ID doesn't change when the GC moves the object, unlike its address.
+  return static_cast<uint32_t>(
+      llvm::hash_value(JSObject::getObjectID(key, runtime)));
+}
+
+EphemeronChunk *JSWeakMapImplBase::chunkFor(
+    PointerBase *base,
+    uint32_t index) const {
+  assert(index < capacity_ && "index out of range");
+  return vmcast<EphemeronChunk>(
+      chunks_.get(base)->at(index / EphemeronChunk::kMaxEntries));
+}
+
+uint32_t JSWeakMapImplBase::lookup(
+    PointerBase *base,
+    JSObject *key,
+    uint32_t hash) const {
+  if (capacity_ == 0) {
+    return kNotFound;
+  }
+  const uint32_t mask = capacity_ - 1;
+  for (uint32_t index = hash & mask;; index = (index + 1) & mask) {
+    const HermesValue &entryKey =
+        chunkFor(base, index)->key(index % EphemeronChunk::kMaxEntries);
+    if (entryKey.isEmpty()) {
+      return kNotFound;
+    }
+    // Deleted entries have null keys, and are skipped.
+    if (entryKey.isObject() && entryKey.getObject() == key) {
+      return index;
     }
   }
 }
 
-/// Mark weak references and remove any invalid weak refs.
-void JSWeakMapImplBase::findAndDeleteFreeSlots(PointerBase *base) {
-  for (auto it = map_.begin(); it != map_.end(); ++it) {
-    if (!it->first.ref.isValid()) {
-      // If invalid, clear the value and remove the key from the map.
-      deleteInternal(base, it);
+uint32_t JSWeakMapImplBase::countLive(PointerBase *base) const {
+  uint32_t count = 0;
+  for (uint32_t index = 0; index < capacity_; ++index) {
+    if (chunkFor(base, index)
+            ->key(index % EphemeronChunk::kMaxEntries)
+            .isObject()) {
+      ++count;
     }
   }
-  hasFreeableSlots_ = false;
+  return count;
 }
 
-void JSWeakMapImplBase::deleteInternal(
-    PointerBase *base,
-    JSWeakMapImplBase::DenseMapT::iterator it) {
-  assert(it != map_.end() && "Invalid iterator to deleteInternal");
-  valueStorage_.get(base)
-      ->at(it->second)
-      .setNonPtr(HermesValue::encodeNativeUInt32(freeListHead_));
-  freeListHead_ = it->second;
-  map_.erase(it);
+void JSWeakMapImplBase::insertNew(
+    Runtime *runtime,
+    HermesValue key,
+    uint32_t hash,
+    HermesValue value) {
+  assert(occupied_ < capacity_ && "no free entry in the table");
+  const uint32_t mask = capacity_ - 1;
+  for (uint32_t index = hash & mask;; index = (index + 1) & mask) {
+    EphemeronChunk *chunk = chunkFor(runtime, index);
+    GCHermesValue &entryKey = chunk->key(index % EphemeronChunk::kMaxEntries);
+    if (entryKey.isObject()) {
+      continue;
+    }
+    // Reuse a deleted entry if there is one before an empty entry.
+    if (entryKey.isEmpty()) {
+      ++occupied_;
+    }
+    entryKey.set(key, &runtime->getHeap());
+    chunk->value(index % EphemeronChunk::kMaxEntries)
+        .set(value, &runtime->getHeap());
+    return;
+  }
 }
 
-CallResult<uint32_t> JSWeakMapImplBase::getFreeValueStorageIndex(
+ExecutionStatus JSWeakMapImplBase::rehash(
     Handle<JSWeakMapImplBase> self,
     Runtime *runtime) {
-  if (self->freeListHead_ == kFreeListInvalid && self->hasFreeableSlots_) {
-    // No elements in the free list and there are freeable slots.
-    // Try to find some.
-    self->findAndDeleteFreeSlots(runtime);
+  // Leave the new table at most half full once the new key is in.
+  const uint64_t needed =
+      (static_cast<uint64_t>(self->countLive(runtime)) + 1) * 2;
+  if (LLVM_UNLIKELY(needed > (1u << 31))) {
+    return runtime->raiseRangeError("Out of space for elements in map");
   }
+  const uint32_t capacity =
+      std::max<uint32_t>(kMinCapacity, llvm::PowerOf2Ceil(needed));
+  const uint32_t chunkEntries =
+      std::min(capacity, EphemeronChunk::kMaxEntries);
+  const uint32_t numChunks = capacity / chunkEntries;
 
-  // Index in valueStorage_ in which to place the new element.
-  uint32_t i;
-  // True if using the nextIndex field to get i.
-  bool useNextIndex;
-
-  if (self->freeListHead_ == kFreeListInvalid) {
-    // No elements in the free list.
-    i = self->nextIndex_;
-    if (LLVM_UNLIKELY(self->nextIndex_ == UINT32_MAX)) {
-      return runtime->raiseRangeError("Out of space for elements in map");
-    }
-    useNextIndex = true;
-  } else {
-    // Free list has an element, use it.
-    i = self->freeListHead_;
-    useNextIndex = false;
+  auto arrRes = ArrayStorage::create(runtime, numChunks, numChunks);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
   }
-
-  auto storageHandle = runtime->makeMutableHandle(self->valueStorage_);
-  if (i >= storageHandle->size()) {
-    if (LLVM_UNLIKELY(
-            BigStorage::resize(
-                storageHandle,
-                runtime,
-                std::max(i + 1, storageHandle->size() * 2)) ==
-            ExecutionStatus::EXCEPTION)) {
+  auto chunks = runtime->makeHandle<ArrayStorage>(*arrRes);
+  for (uint32_t i = 0; i < numChunks; ++i) {
+    auto chunkRes = EphemeronChunk::create(runtime, chunkEntries);
+    if (LLVM_UNLIKELY(chunkRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
+    chunks->at(i).set(*chunkRes, &runtime->getHeap());
   }
 
-  // Update internal state here to ensure we don't corrupt it on exception.
-  if (useNextIndex) {
-    ++self->nextIndex_;
-  } else {
-    // Set the start of the free list to the next element.
-    // If the next element is kFreeListInvalid, the free list is now empty.
-    self->freeListHead_ = storageHandle->at(i).getNativeUInt32();
+  // Nothing below allocates, so the GC can't run while the entries move.
+  ArrayStorage *oldChunks = self->chunks_.get(runtime);
+  const uint32_t oldCapacity = self->capacity_;
+  self->chunks_.set(runtime, *chunks, &runtime->getHeap());
+  self->capacity_ = capacity;
+  self->occupied_ = 0;
+  for (uint32_t index = 0; index < oldCapacity; ++index) {
+    auto *chunk = vmcast<EphemeronChunk>(
+        oldChunks->at(index / EphemeronChunk::kMaxEntries));
+    const uint32_t entry = index % EphemeronChunk::kMaxEntries;
+    const HermesValue key = chunk->key(entry);
+    if (!key.isObject()) {
+      continue;
+    }
+    const uint32_t hash = static_cast<uint32_t>(llvm::hash_value(
+        vmcast<JSObject>(key)->getAlreadyAssignedObjectID()));
+    self->insertNew(runtime, key, hash, chunk->value(entry));
   }
-
-  assert(i < storageHandle->size() && "invalid index");
-  self->valueStorage_.set(runtime, *storageHandle, &runtime->getHeap());
-
-  return i;
+  return ExecutionStatus::RETURNED;
 }
 
 template <CellKind C>
@@ -211,9 +240,9 @@ const ObjectVTable JSWeakMapImpl<C>::vt{
     VTable(
         C,
         sizeof(JSWeakMapImpl),
-        JSWeakMapImpl::_finalizeImpl,
-        JSWeakMapImpl::_markWeakImpl,
-        JSWeakMapImpl::_mallocSizeImpl),
+        nullptr,
+        nullptr,
+        nullptr),
     JSWeakMapImpl::_getOwnIndexedRangeImpl,
     JSWeakMapImpl::_haveOwnIndexedImpl,
     JSWeakMapImpl::_getOwnIndexedPropertyFlagsImpl,
@@ -227,21 +256,13 @@ template <CellKind C>
 CallResult<HermesValue> JSWeakMapImpl<C>::create(
     Runtime *runtime,
     Handle<JSObject> parentHandle) {
-  auto valueRes = BigStorage::create(runtime, 1);
-  if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto valueStorage = runtime->makeHandle<BigStorage>(*valueRes);
-
-  void *mem = runtime->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
-      sizeof(JSWeakMapImpl<C>));
+  void *mem = runtime->alloc</*fixedSize*/ true>(sizeof(JSWeakMapImpl<C>));
   return HermesValue::encodeObjectValue(
       JSObject::allocateSmallPropStorage<NEEDED_PROPERTY_SLOTS>(
           new (mem) JSWeakMapImpl<C>(
               runtime,
               *parentHandle,
-              runtime->getHiddenClassForPrototypeRaw(*parentHandle),
-              *valueStorage)));
+              runtime->getHiddenClassForPrototypeRaw(*parentHandle))));
 }
 
 template class JSWeakMapImpl<CellKind::WeakMapKind>;
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#define DEBUG_TYPE "codeblock"
+
+#ifndef HERMESVM_LEAN
+#include "hermes/VM/LazyCompilationThread.h"
+
+#include "hermes/AST/Context.h"
+#include "hermes/BCGen/HBC/HBC.h"
+#include "hermes/IR/IR.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// Maximum number of functions waiting to be compiled.
+constexpr size_t kMaxQueued = 1024;
+
+/// Maximum number of compiled functions waiting to be called. The thread
+/// stops compiling once there are this many.
+constexpr size_t kMaxDone = 16;
+
+/// Remove \p key from \p keys, if it is there.
+void removeKey(std::deque<const char *> &keys, const char *key) {
+  auto it = std::find(keys.begin(), keys.end(), key);
+  if (it != keys.end())
+    keys.erase(it);
+}
+
+} // namespace
+
+std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
+    hbc::LazyCompilationData *lazyData) {
+  assert(lazyData);
+  LLVM_DEBUG(
+      llvm::dbgs() << "Compiling lazy function " << lazyData->originalName
+                   << "\n");
+
+  std::lock_guard<std::mutex> lock{
+      lazyData->context->getLazyCompilationMutex()};
+  Module M{lazyData->context};
+  Function *entryPoint = hermes::generateLazyFunctionIR(lazyData, &M);
+
+  auto bytecodeModule = hbc::generateBytecodeModule(
+      &M, entryPoint, BytecodeGenerationOptions::defaults());
+
+  return bytecodeModule;
+}
+
+LazyCompilationThread::LazyCompilationThread()
+    : thread_(&LazyCompilationThread::run, this) {}
+
+LazyCompilationThread::~LazyCompilationThread() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_ = true;
+  }
+  cond_.notify_all();
+  thread_.join();
+}
+
+void LazyCompilationThread::prefetch(const hbc::LazyCompilationData &lazyData) {
+  const char *key = keyOf(lazyData);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!jobs_.try_emplace(key, llvm::make_unique<Job>(lazyData)).second)
+      return;
+    queue_.push_back(key);
+    if (queue_.size() > kMaxQueued) {
+      jobs_.erase(queue_.front());
+      queue_.pop_front();
+    }
+    // Make room for the new function if the thread is waiting for results to
+    // be taken.
+    if (done_.size() >= kMaxDone) {
+      jobs_.erase(done_.front());
+      done_.pop_front();
+    }
+  }
+  cond_.notify_all();
+}
+
+std::unique_ptr<hbc::BytecodeModule> LazyCompilationThread::compile(
+    hbc::LazyCompilationData *lazyData) {
+  const char *key = keyOf(*lazyData);
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    auto it = jobs_.find(key);
+    // Wait for the thread if it is compiling the function.
+    while (it != jobs_.end() && it->second->compiling) {
+      cond_.wait(lock);
+      it = jobs_.find(key);
+    }
+    if (it != jobs_.end()) {
+      std::unique_ptr<hbc::BytecodeModule> result =
+          std::move(it->second->result);
+      // If it hasn't been compiled yet, the thread skips it once it is
+      // removed from jobs_.
+      if (result)
+        removeKey(done_, key);
+      jobs_.erase(it);
+      if (result)
+        return result;
+    }
+    // Keep the thread from starting another function, which would make this
+    // one wait for the lock of the Context.
+    ++compilingOnCaller_;
+  }
+  auto result = compileLazyFunction(lazyData);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    --compilingOnCaller_;
+  }
+  cond_.notify_all();
+  return result;
+}
+
+void LazyCompilationThread::dropPending() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  llvm::SmallVector<const char *, 16> dropped;
+  for (const auto &entry : jobs_) {
+    // The thread uses the job without the lock while it is compiling it.
+    if (!entry.second->compiling)
+      dropped.push_back(entry.first);
+  }
+  for (const char *key : dropped)
+    jobs_.erase(key);
+  queue_.clear();
+  done_.clear();
+}
+
+void LazyCompilationThread::run() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (true) {
+    // Don't compile too far ahead of the functions which are called.
+    cond_.wait(lock, [this]() {
+      return stop_ ||
+          (!queue_.empty() && !compilingOnCaller_ && done_.size() < kMaxDone);
+    });
+    if (stop_)
+      return;
+    const char *key = queue_.front();
+    queue_.pop_front();
+    auto it = jobs_.find(key);
+    if (it == jobs_.end() || it->second->compiling || it->second->result)
+      continue;
+    Job *job = it->second.get();
+    job->compiling = true;
+
+    // The job stays in jobs_ while it is compiling, so it can be used
+    // without the lock.
+    lock.unlock();
+    std::unique_ptr<hbc::BytecodeModule> result =
+        compileLazyFunction(&job->data);
+    lock.lock();
+
+    job->compiling = false;
+    job->result = std::move(result);
+    done_.push_back(key);
+    cond_.notify_all();
+  }
+}
+
+} // namespace vm
+} // namespace hermes
+#endif // HERMESVM_LEAN
@@ -702,6 +702,7 @@ CallResult<Handle<JSObject>> getPrimitivePrototype(
     case BoolTag:
       return Handle<JSObject>::vmcast(&runtime->booleanPrototype);
     case SymbolTag:
+      runtime->initLazyBuiltins(LazyBuiltins::Symbol);
       return Handle<JSObject>::vmcast(&runtime->symbolPrototype);
     default:
       assert(base->isNumber() && "Unknown tag in getPrimitivePrototype.");
@@ -734,6 +735,7 @@ CallResult<HermesValue> toObject(Runtime *runtime, Handle<> valueHandle) {
           runtime->makeHandle(value.getString()),
           Handle<JSObject>::vmcast(&runtime->stringPrototype));
     case SymbolTag:
+      runtime->initLazyBuiltins(LazyBuiltins::Symbol);
       return JSSymbol::create(
           runtime,
           *Handle<SymbolID>::vmcast(valueHandle),
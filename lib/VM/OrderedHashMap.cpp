@@ -14,170 +14,172 @@
 namespace hermes {
 namespace vm {
 //===----------------------------------------------------------------------===//
-// class HashMapEntry
+// class OrderedHashTable
+
+constexpr OrderedHashTable::size_type OrderedHashTable::kEnd;
+constexpr OrderedHashTable::size_type OrderedHashTable::kLogEntriesPerChunk;
+constexpr OrderedHashTable::size_type OrderedHashTable::kEntriesPerChunk;
+constexpr OrderedHashTable::size_type OrderedHashTable::kMaxBuckets;
+constexpr OrderedHashTable::size_type OrderedHashTable::kMaxCapacity;
+
+VTable OrderedHashTable::vt(
+    CellKind::OrderedHashTableKind,
+    0,
+    nullptr,
+    nullptr,
+    nullptr);
+
+void OrderedHashTableBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  const auto *self = static_cast<const OrderedHashTable *>(cell);
+  mb.addField("@nextTable", &self->nextTable_);
+  mb.addNonPointerField("@numEntries", &self->numEntries_);
+  mb.addArray<Metadata::ArrayData::ArrayType::HermesValue>(
+      "@chunks", self->chunks(), &self->numChunks_, sizeof(GCHermesValue));
+}
+
+OrderedHashTable::OrderedHashTable(Runtime *runtime, size_type capacity)
+    : VariableSizeRuntimeCell(
+          &runtime->getHeap(),
+          &vt,
+          allocationSize(capacity)),
+      capacity_(capacity),
+      numChunks_(numChunksFor(capacity)),
+      numBuckets_(numBucketsFor(capacity)) {
+  GCHermesValue::fill(
+      chunks(), chunks() + numChunks_, HermesValue::encodeEmptyValue());
+  std::fill(buckets(), buckets() + numBuckets_, kEnd);
+}
 
-VTable HashMapEntry::vt{CellKind::HashMapEntryKind, sizeof(HashMapEntry)};
+CallResult<HermesValue> OrderedHashTable::create(
+    Runtime *runtime,
+    size_type capacity) {
+  assert(
+      llvm::isPowerOf2_32(capacity) && capacity <= kMaxCapacity &&
+      "capacity must be a power of 2");
+  void *mem = runtime->alloc</*fixedSize*/ false>(allocationSize(capacity));
+  auto self =
+      runtime->makeHandle(new (mem) OrderedHashTable(runtime, capacity));
 
-void HashMapEntryBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
-  const auto *self = static_cast<const HashMapEntry *>(cell);
-  mb.addField("@key", &self->key);
-  mb.addField("@value", &self->value);
-  mb.addField("@prevIterationEntry", &self->prevIterationEntry);
-  mb.addField("@nextIterationEntry", &self->nextIterationEntry);
-  mb.addField("@nextEntryInBucket", &self->nextEntryInBucket);
+  GCScopeMarkerRAII marker{runtime};
+  for (size_type i = 0; i < self->numChunks_; ++i) {
+    marker.flush();
+    size_type numSlots =
+        std::min(capacity - (i << kLogEntriesPerChunk), kEntriesPerChunk) *
+        NumSlotsPerEntry;
+    auto arrRes = ArrayStorage::create(runtime, numSlots, numSlots);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self->chunks()[i].set(*arrRes, &runtime->getHeap());
+  }
+  return self.getHermesValue();
 }
 
-CallResult<HermesValue> HashMapEntry::create(Runtime *runtime) {
-  void *mem = runtime->alloc(sizeof(HashMapEntry));
-  return HermesValue::encodeObjectValue(new (mem) HashMapEntry(runtime));
+OrderedHashTable::size_type OrderedHashTable::find(
+    HermesValue key,
+    uint32_t hash) {
+  for (size_type index = buckets()[bucketFor(hash)]; index != kEnd;
+       index = slot(index, NextSlot).getNativeUInt32()) {
+    HermesValue entryKey = slot(index, KeySlot);
+    // Deleted entries remain in their chain until the next rehash.
+    if (!entryKey.isEmpty() && isSameValueZero(entryKey, key)) {
+      return index;
+    }
+  }
+  return kEnd;
+}
+
+void OrderedHashTable::append(
+    Runtime *runtime,
+    HermesValue key,
+    HermesValue value,
+    uint32_t hash) {
+  assert(!nextTable_ && "Appending to an obsolete table");
+  assert(numEntries_ < capacity_ && "The table is full");
+  size_type index = numEntries_++;
+  size_type bucket = bucketFor(hash);
+  slot(index, KeySlot).set(key, &runtime->getHeap());
+  slot(index, ValueSlot).set(value, &runtime->getHeap());
+  slot(index, NextSlot)
+      .setNonPtr(HermesValue::encodeNativeUInt32(buckets()[bucket]));
+  buckets()[bucket] = index;
+}
+
+OrderedHashTable::size_type OrderedHashTable::numMovedBefore(
+    size_type index) {
+  assert(nextTable_ && "Only obsolete tables have moved entries");
+  size_type count = 0;
+  for (size_type i = 0, e = std::min(index, numEntries_); i < e; ++i) {
+    if (!slot(i, KeySlot).isEmpty()) {
+      ++count;
+    }
+  }
+  return count;
 }
 
 //===----------------------------------------------------------------------===//
 // class OrderedHashMap
 
+constexpr OrderedHashMap::size_type OrderedHashMap::INITIAL_CAPACITY;
+
 VTable OrderedHashMap::vt{CellKind::OrderedHashMapKind, sizeof(OrderedHashMap)};
 
 void OrderedHashMapBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   const auto *self = static_cast<const OrderedHashMap *>(cell);
-  mb.addField("@hashTable", &self->hashTable_);
-  mb.addField("@firstIterationEntry", &self->firstIterationEntry_);
-  mb.addField("@lastIterationEntry", &self->lastIterationEntry_);
+  mb.addField("@table", &self->table_);
 }
 
 OrderedHashMap::OrderedHashMap(
     Runtime *runtime,
-    Handle<ArrayStorage> hashTableStorage)
+    Handle<OrderedHashTable> table)
     : GCCell(&runtime->getHeap(), &vt),
-      hashTable_(runtime, hashTableStorage.get(), &runtime->getHeap()) {
-  ArrayStorage::resizeWithinCapacity(
-      hashTableStorage, runtime, INITIAL_CAPACITY);
-}
+      table_(runtime, table.get(), &runtime->getHeap()) {}
 
 CallResult<HermesValue> OrderedHashMap::create(Runtime *runtime) {
-  auto arrRes = ArrayStorage::create(runtime, INITIAL_CAPACITY);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+  auto tableRes = OrderedHashTable::create(runtime, INITIAL_CAPACITY);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto hashTableStorage = runtime->makeHandle<ArrayStorage>(*arrRes);
+  auto table = runtime->makeHandle<OrderedHashTable>(*tableRes);
 
   void *mem = runtime->alloc(sizeof(OrderedHashMap));
   return HermesValue::encodeObjectValue(
-      new (mem) OrderedHashMap(runtime, hashTableStorage));
-}
-
-void OrderedHashMap::removeLinkedListNode(
-    Runtime *runtime,
-    HashMapEntry *entry,
-    GC *gc) {
-  assert(
-      entry != lastIterationEntry_.get(runtime) &&
-      "Cannot remove the last entry");
-  if (entry->prevIterationEntry) {
-    entry->prevIterationEntry.get(runtime)->nextIterationEntry.set(
-        runtime, entry->nextIterationEntry, gc);
-  }
-  if (entry->nextIterationEntry) {
-    entry->nextIterationEntry.get(runtime)->prevIterationEntry.set(
-        runtime, entry->prevIterationEntry, gc);
-  }
-  if (entry == firstIterationEntry_.get(runtime)) {
-    firstIterationEntry_.set(runtime, entry->nextIterationEntry, gc);
-  }
-  entry->prevIterationEntry = nullptr;
+      new (mem) OrderedHashMap(runtime, table));
 }
 
-HashMapEntry *OrderedHashMap::lookupInBucket(
-    Runtime *runtime,
-    uint32_t bucket,
-    HermesValue key) {
-  assert(
-      hashTable_.get(runtime)->size() == capacity_ && "Inconsistent capacity");
-  auto *entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key)) {
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  return entry;
-}
-
-ExecutionStatus OrderedHashMap::rehashIfNecessary(
+ExecutionStatus OrderedHashMap::rehash(
     Handle<OrderedHashMap> self,
-    Runtime *runtime) {
-  uint32_t newCapacity = self->capacity_;
-  // NOTE: we have ensured that self->capacity_ * 4 never overflows uint32_t by
-  // setting MAX_CAPACITY to the apropriate value. self->size_ is always <=
-  // self->capacity_, so this applies to self->size_ as well.
-  static_assert(
-      MAX_CAPACITY < UINT32_MAX / 4,
-      "Avoid overflow checks on multiplying capacity by 4");
-  if (self->size_ * 4 > self->capacity_ * 3) {
-    // Load factor is more than 0.75, need to increase the capacity.
-    newCapacity = self->capacity_ * 2;
-    if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
-      // We maintain the invariant that the capacity_ is a power of two.
-      // Therefore, if doubling would exceed the max, we revert to the
-      // previous value.  (Assert the invariant to make it clear.)
-      assert(
-          (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-          "capacity_ must be power of 2");
-      newCapacity = self->capacity_;
-    }
-  } else if (
-      self->size_ * 4 < self->capacity_ && self->capacity_ > INITIAL_CAPACITY) {
-    // Load factor is less than 0.25, and we are not at initial cap.
-    newCapacity = self->capacity_ / 2;
-  }
-  if (newCapacity == self->capacity_) {
-    // No need to rehash.
-    return ExecutionStatus::RETURNED;
-  }
-  assert(
-      self->size_ && self->firstIterationEntry_ && self->lastIterationEntry_ &&
-      "We should never be rehashing when there are no elements");
-
-  // Set new capacity first to update the hash function.
-  self->capacity_ = newCapacity;
-
-  // Create a new hash table.
-  auto arrRes = ArrayStorage::create(runtime, newCapacity, newCapacity);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    Runtime *runtime,
+    size_type newCapacity) {
+  assert(newCapacity > self->size_ && "New table is too small");
+  auto tableRes = OrderedHashTable::create(runtime, newCapacity);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto newHashTable = runtime->makeHandle<ArrayStorage>(*arrRes);
+  auto newTable = runtime->makeHandle<OrderedHashTable>(*tableRes);
+  auto oldTable = runtime->makeHandle<OrderedHashTable>(self->table_);
 
-  // Now re-add all entries to the hash table.
-  MutableHandle<HashMapEntry> entry{runtime};
-  MutableHandle<HashMapEntry> oldNextInBucket{runtime};
+  // Copy the live entries over in order, and mark them as moved in the old
+  // table, which also releases the references it holds.
   MutableHandle<> keyHandle{runtime};
   GCScopeMarkerRAII marker{runtime};
-  for (unsigned i = 0, len = self->hashTable_.get(runtime)->size(); i < len;
-       ++i) {
-    entry = dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(i));
-    while (entry) {
-      marker.flush();
-      keyHandle = entry->key;
-      uint32_t bucket = hashToBucket(self, runtime, keyHandle);
-      oldNextInBucket = entry->nextEntryInBucket.get(runtime);
-      if (newHashTable->at(bucket).isEmpty()) {
-        // Empty bucket.
-        entry->nextEntryInBucket = nullptr;
-      } else {
-        // There are already a bucket head.
-        entry->nextEntryInBucket.set(
-            runtime,
-            vmcast<HashMapEntry>(newHashTable->at(bucket)),
-            &runtime->getHeap());
-      }
-      // Update bucket head to the new entry.
-      newHashTable->at(bucket).set(entry.getHermesValue(), &runtime->getHeap());
-
-      entry = *oldNextInBucket;
+  for (size_type i = 0, e = oldTable->numEntries_; i < e; ++i) {
+    marker.flush();
+    keyHandle = oldTable->key(i);
+    if (keyHandle->isEmpty()) {
+      continue;
     }
+    uint32_t keyHash = hash(runtime, keyHandle);
+    newTable->append(runtime, keyHandle.get(), oldTable->value(i), keyHash);
+    oldTable->slot(i, OrderedHashTable::KeySlot)
+        .setNonPtr(HermesValue::encodeUndefinedValue());
+    oldTable->slot(i, OrderedHashTable::ValueSlot)
+        .setNonPtr(HermesValue::encodeUndefinedValue());
   }
+  assert(newTable->numEntries_ == self->size_ && "Inconsistent size");
 
-  self->hashTable_.set(runtime, newHashTable.get(), &runtime->getHeap());
-  assert(
-      self->hashTable_.get(runtime)->size() == self->capacity_ &&
-      "Inconsistent capacity");
+  oldTable->nextTable_.set(runtime, newTable.get(), &runtime->getHeap());
+  self->table_.set(runtime, newTable.get(), &runtime->getHeap());
   return ExecutionStatus::RETURNED;
 }
 
@@ -185,27 +187,22 @@ bool OrderedHashMap::has(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
-}
-
-HashMapEntry *OrderedHashMap::find(
-    Handle<OrderedHashMap> self,
-    Runtime *runtime,
-    Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  uint32_t keyHash = hash(runtime, key);
+  return self->table_.get(runtime)->find(key.get(), keyHash) !=
+      OrderedHashTable::kEnd;
 }
 
 HermesValue OrderedHashMap::get(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto *entry = find(self, runtime, key);
-  if (!entry) {
+  uint32_t keyHash = hash(runtime, key);
+  OrderedHashTable *table = self->table_.get(runtime);
+  size_type index = table->find(key.get(), keyHash);
+  if (index == OrderedHashTable::kEnd) {
     return HermesValue::encodeUndefinedValue();
   }
-  return entry->value;
+  return table->value(index);
 }
 
 ExecutionStatus OrderedHashMap::insert(
@@ -213,158 +210,109 @@ ExecutionStatus OrderedHashMap::insert(
     Runtime *runtime,
     Handle<> key,
     Handle<> value) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  if (auto *entry =
-          self->lookupInBucket(runtime, bucket, key.getHermesValue())) {
+  uint32_t keyHash = hash(runtime, key);
+  OrderedHashTable *table = self->table_.get(runtime);
+  size_type index = table->find(key.get(), keyHash);
+  if (index != OrderedHashTable::kEnd) {
     // Element already exists, update value and return.
-    entry->value.set(value.get(), &runtime->getHeap());
+    table->slot(index, OrderedHashTable::ValueSlot)
+        .set(value.get(), &runtime->getHeap());
     return ExecutionStatus::RETURNED;
   }
-  // Create a new entry, set the key and value.
-  auto crtRes = HashMapEntry::create(runtime);
-  if (LLVM_UNLIKELY(crtRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto newMapEntry = runtime->makeHandle<HashMapEntry>(*crtRes);
-  newMapEntry->key.set(key.get(), &runtime->getHeap());
-  newMapEntry->value.set(value.get(), &runtime->getHeap());
-  auto *curBucketFront =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  if (curBucketFront) {
-    // If the bucket we are inserting to is not empty, we maintain the
-    // linked list properly.
-    newMapEntry->nextEntryInBucket.set(
-        runtime, curBucketFront, &runtime->getHeap());
-  }
-  // Set the newly inserted entry as the front of this bucket chain.
-  self->hashTable_.get(runtime)->at(bucket).set(
-      newMapEntry.getHermesValue(), &runtime->getHeap());
-
-  if (!self->firstIterationEntry_) {
-    // If we are inserting the first ever element, update
-    // first iteration entry pointer.
-    self->firstIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-  } else {
-    // Connect the new entry with the last entry.
-    self->lastIterationEntry_.get(runtime)->nextIterationEntry.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    newMapEntry->prevIterationEntry.set(
-        runtime, self->lastIterationEntry_, &runtime->getHeap());
-
-    HashMapEntry *previousLastEntry = self->lastIterationEntry_.get(runtime);
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-
-    if (previousLastEntry && previousLastEntry->isDeleted()) {
-      // If the last entry was a deleted entry, we no longer need to keep it.
-      self->removeLinkedListNode(
-          runtime, previousLastEntry, &runtime->getHeap());
+
+  if (table->numEntries_ == table->capacity_) {
+    // The table is full. Rehash it to twice the number of live entries, which
+    // only grows it if few of its entries have been deleted.
+    if (LLVM_UNLIKELY(self->size_ >= OrderedHashTable::kMaxCapacity / 2)) {
+      return runtime->raiseRangeError("Out of space for elements in map");
+    }
+    if (LLVM_UNLIKELY(
+            rehash(self, runtime, capacityFor(self->size_)) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
+    table = self->table_.get(runtime);
   }
 
+  table->append(runtime, key.get(), value.get(), keyHash);
   self->size_++;
-  return self->rehashIfNecessary(self, runtime);
+  return ExecutionStatus::RETURNED;
 }
 
 bool OrderedHashMap::erase(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  HashMapEntry *prevEntry = nullptr;
-  auto *entry =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key.getHermesValue())) {
-    prevEntry = entry;
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  if (!entry) {
+  uint32_t keyHash = hash(runtime, key);
+  OrderedHashTable *table = self->table_.get(runtime);
+  size_type index = table->find(key.get(), keyHash);
+  if (index == OrderedHashTable::kEnd) {
     // Element does not exist.
     return false;
   }
 
-  if (prevEntry) {
-    // The entry we are deleting has a previous entry, update the link.
-    prevEntry->nextEntryInBucket.set(
-        runtime, entry->nextEntryInBucket, &runtime->getHeap());
-  } else {
-    // The entry we are erasing is the front entry in the bucket, we need
-    // to update the bucket head to the next entry in the bucket, if not
-    // any, set to empty value.
-    self->hashTable_.get(runtime)->at(bucket).set(
-        entry->nextEntryInBucket ? HermesValue::encodeObjectValue(
-                                       entry->nextEntryInBucket.get(runtime))
-                                 : HermesValue::encodeEmptyValue(),
-        &runtime->getHeap());
-  }
-
-  entry->markDeleted();
+  table->markDeleted(index);
   self->size_--;
 
-  // Now delete the entry from the iteration linked list.
-  // If we are deleting the last entry, don't remove it from the list yet.
-  // This will ensure that if any iterator out there is currently pointing to
-  // this entry, it will be able to follow on if we add new entries in the
-  // future.
-  if (entry != self->lastIterationEntry_.get(runtime)) {
-    self->removeLinkedListNode(runtime, entry, &runtime->getHeap());
+  // Shrink the table when less than a quarter of it is in use. Shrinking is
+  // only an optimization: if the smaller table can't be allocated, keep using
+  // the current one, which rehash() leaves untouched on failure.
+  if (self->size_ < table->capacity_ / 4 &&
+      table->capacity_ > INITIAL_CAPACITY) {
+    if (LLVM_UNLIKELY(
+            rehash(self, runtime, capacityFor(self->size_)) ==
+            ExecutionStatus::EXCEPTION)) {
+      runtime->clearThrownValue();
+    }
   }
 
-  self->rehashIfNecessary(self, runtime);
-
   return true;
 }
 
-HashMapEntry *OrderedHashMap::iteratorNext(
-    Runtime *runtime,
-    HashMapEntry *entry) const {
-  if (entry == nullptr) {
-    // Starting a new iteration from the first entry.
-    entry = firstIterationEntry_.get(runtime);
-  } else {
-    // Advance to the next entry.
-    entry = entry->nextIterationEntry.get(runtime);
+OrderedHashMap::size_type OrderedHashMap::iteratorNext(
+    PointerBase *base,
+    OrderedHashTable *&table,
+    size_type index) {
+  // Follow the tables which replaced this one. The entries which were moved
+  // keep their order, so the iteration resumes after those it has visited.
+  while (OrderedHashTable *nextTable = table->nextTable_.get(base)) {
+    index = table->numMovedBefore(index);
+    table = nextTable;
   }
 
-  // Make sure the entry we returned (if not nullptr) must not be deleted.
-  while (entry && entry->isDeleted()) {
-    entry = entry->nextIterationEntry.get(runtime);
+  // Skip the deleted entries.
+  for (size_type e = table->numEntries_; index < e; ++index) {
+    if (!table->key(index).isEmpty()) {
+      return index;
+    }
   }
-  return entry;
+  return OrderedHashTable::kEnd;
 }
 
-void OrderedHashMap::clear(Runtime *runtime) {
-  if (!firstIterationEntry_) {
+ExecutionStatus OrderedHashMap::clear(
+    Handle<OrderedHashMap> self,
+    Runtime *runtime) {
+  if (self->table_.get(runtime)->numEntries_ == 0) {
     // Empty set.
-    return;
+    return ExecutionStatus::RETURNED;
   }
 
-  // Clear the hash table.
-  for (unsigned i = 0; i < capacity_; ++i) {
-    auto entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(i));
-    // Delete every element reachable from the hash table.
-    while (entry) {
-      entry->markDeleted();
-      entry = entry->nextEntryInBucket.get(runtime);
-    }
-    // Clear every element in the hash table.
-    hashTable_.get(runtime)->at(i).setNonPtr(HermesValue::encodeEmptyValue());
+  auto tableRes = OrderedHashTable::create(runtime, INITIAL_CAPACITY);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto *newTable = vmcast<OrderedHashTable>(*tableRes);
+
+  // Delete every entry of the old table, so that the iterations still in it
+  // resume from the start of the new one.
+  OrderedHashTable *oldTable = self->table_.get(runtime);
+  for (size_type i = 0, e = oldTable->numEntries_; i < e; ++i) {
+    oldTable->markDeleted(i);
   }
-  // Resize the hash table to the initial size.
-  ArrayStorage::resizeWithinCapacity(
-      createPseudoHandle(hashTable_.get(runtime)), runtime, INITIAL_CAPACITY);
-  capacity_ = INITIAL_CAPACITY;
-
-  // After clearing, we will still keep the last deleted entry
-  // in case there is an iterator out there
-  // pointing to the middle of the iteration chain. We need it to be
-  // able to merge back eventually.
-  firstIterationEntry_.set(runtime, lastIterationEntry_, &runtime->getHeap());
-  firstIterationEntry_.get(runtime)->prevIterationEntry = nullptr;
-  size_ = 0;
+  oldTable->nextTable_.set(runtime, newTable, &runtime->getHeap());
+  self->table_.set(runtime, newTable, &runtime->getHeap());
+  self->size_ = 0;
+  return ExecutionStatus::RETURNED;
 }
 
 } // namespace vm
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/Profiler/AllocationProfiler.h"
+
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeModule-inline.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hermes {
+namespace vm {
+
+constexpr uint32_t AllocationProfiler::kNoFrame;
+
+AllocationProfiler::AllocationProfiler(
+    Runtime *runtime,
+    uint32_t samplingInterval)
+    : runtime_(runtime),
+      samplingInterval_(std::max<uint32_t>(samplingInterval, 1)),
+      randomEngine_(std::random_device()()),
+      distribution_(1.0 / samplingInterval_) {
+  nodes_.emplace_back(kNoFrame, kNoFrame);
+  bytesBeforeSample_ = nextSampleDistance();
+}
+
+uint64_t AllocationProfiler::nextSampleDistance() {
+  // A distance of zero would sample the next allocation whatever its size.
+  return std::max<uint64_t>(
+      static_cast<uint64_t>(distribution_(randomEngine_)), 1);
+}
+
+void AllocationProfiler::takeSample(uint32_t size) {
+  // The distribution is memoryless, so the bytes of this allocation past the
+  // sampling point don't count towards the next one.
+  bytesBeforeSample_ = nextSampleDistance();
+
+  // Walk the stack like SamplingProfiler does, but symbolicate the frames
+  // right away: this runs on the runtime's thread outside of a signal handler,
+  // so it can, and it means that no RuntimeModule needs to be kept alive for
+  // the profile.
+  stackFrames_.clear();
+  for (ConstStackFramePtr frame : runtime_->getStackFrames()) {
+    if (stackFrames_.size() >= kMaxStackDepth)
+      break;
+    Frame info{{}, {}, -1, -1};
+    if (auto *codeBlock = frame.getCalleeCodeBlock()) {
+      if (!codeBlock->getNameString(runtime_, info.functionName))
+        info.functionName = "<UTF16 string>";
+      RuntimeModule *module = codeBlock->getRuntimeModule();
+      info.url = module->getSourceURL().str();
+      // The location of a function is that of its first instruction.
+      OptValue<uint32_t> debugOffset =
+          codeBlock->getDebugSourceLocationsOffset();
+      if (debugOffset.hasValue()) {
+        auto *debugInfo = module->getBytecode()->getDebugInfo();
+        OptValue<hbc::DebugSourceLocation> loc =
+            debugInfo->getLocationForAddress(debugOffset.getValue(), 0);
+        if (loc.hasValue()) {
+          info.url = debugInfo->getFilenameByID(loc.getValue().filenameId);
+          info.line = static_cast<int>(loc.getValue().line) - 1;
+          info.column = static_cast<int>(loc.getValue().column) - 1;
+        }
+      }
+    } else if (dyn_vmcast_or_null<NativeFunction>(
+                   frame.getCalleeClosure())) {
+      info.functionName = "(native)";
+    } else if (dyn_vmcast_or_null<BoundFunction>(frame.getCalleeClosure())) {
+      // The target runs in the next frame, so this one only needs a name.
+      info.functionName = "(bound function)";
+    } else {
+      // Keep the frame anyway, so that its callees stay under their caller.
+      info.functionName = "(unknown)";
+    }
+    stackFrames_.push_back(internFrame(std::move(info)));
+  }
+
+  // The tree grows from the outermost frame.
+  uint32_t node = 0;
+  for (auto it = stackFrames_.rbegin(), e = stackFrames_.rend(); it != e; ++it)
+    node = childNode(node, *it);
+  nodes_[node].selfSize += scaledSize(size);
+  samples_.push_back({size, node});
+}
+
+uint32_t AllocationProfiler::internFrame(Frame &&frame) {
+  auto it = frameIndices_.find(frame);
+  if (it != frameIndices_.end())
+    return it->second;
+  uint32_t index = frames_.size();
+  frames_.push_back(frame);
+  frameIndices_.emplace(std::move(frame), index);
+  return index;
+}
+
+uint32_t AllocationProfiler::childNode(uint32_t parent, uint32_t frame) {
+  auto result =
+      childIndices_.emplace(std::make_pair(parent, frame), nodes_.size());
+  if (result.second) {
+    nodes_.emplace_back(frame, parent);
+    nodes_[parent].children.push_back(result.first->second);
+  }
+  return result.first->second;
+}
+
+double AllocationProfiler::scaledSize(uint32_t size) const {
+  return size / -std::expm1(-static_cast<double>(size) / samplingInterval_);
+}
+
+void AllocationProfiler::serialize(llvm::raw_ostream &os) const {
+  JSONEmitter json(os);
+  json.openDict();
+  json.emitKey("head");
+  serializeNode(json, 0);
+  json.emitKey("samples");
+  json.openArray();
+  for (size_t i = 0, e = samples_.size(); i < e; ++i) {
+    json.openDict();
+    json.emitKeyValue("size", samples_[i].size);
+    // Chrome numbers nodes from 1.
+    json.emitKeyValue("nodeId", samples_[i].node + 1);
+    json.emitKeyValue("ordinal", i + 1);
+    json.closeDict();
+  }
+  json.closeArray();
+  json.closeDict();
+}
+
+void AllocationProfiler::serializeNode(JSONEmitter &json, uint32_t index)
+    const {
+  const Node &node = nodes_[index];
+  json.openDict();
+  json.emitKey("callFrame");
+  json.openDict();
+  if (node.frame == kNoFrame) {
+    json.emitKeyValue("functionName", "(root)");
+    json.emitKeyValue("scriptId", "0");
+    json.emitKeyValue("url", "");
+    json.emitKeyValue("lineNumber", -1);
+    json.emitKeyValue("columnNumber", -1);
+  } else {
+    const Frame &frame = frames_[node.frame];
+    json.emitKeyValue("functionName", frame.functionName);
+    // Frames are only told apart by their URLs, so use the URL as the script.
+    json.emitKeyValue("scriptId", frame.url);
+    json.emitKeyValue("url", frame.url);
+    json.emitKeyValue("lineNumber", frame.line);
+    json.emitKeyValue("columnNumber", frame.column);
+  }
+  json.closeDict();
+  json.emitKeyValue("selfSize", std::round(node.selfSize));
+  json.emitKeyValue("id", index + 1);
+  json.emitKey("children");
+  json.openArray();
+  for (uint32_t child : node.children)
+    serializeNode(json, child);
+  json.closeArray();
+  json.closeDict();
+}
+
+} // namespace vm
+} // namespace hermes
@@ -66,6 +66,32 @@ void Runtime::dumpOpcodeStats(llvm::raw_ostream &os) const {
            << inst::getOpCodeString(static_cast<inst::OpCode>(op)).data()
            << std::setw(22) << t[op] << std::setw(11) << f[op] << "\n";
   }
+
+  // Get all non-zero occurence pairs of adjacent opcodes, which are the
+  // candidates for superinstructions.
+  std::vector<size_t> pairs;
+  for (size_t i = 0; i < opcodePairFrequency.size(); ++i) {
+    if (opcodePairFrequency[i])
+      pairs.push_back(i);
+  }
+  const auto &pf = opcodePairFrequency;
+  sort(pairs.begin(), pairs.end(), [&pf](size_t i1, size_t i2) {
+    return pf[i1] > pf[i2];
+  });
+
+  stream << "\nAdjacent opcode pairs sorted by frequency:\n"
+         << std::left << std::setfill(' ') << std::setw(25) << "==First=="
+         << std::setw(25) << "==Second==" << std::setw(11) << "==Frequency=="
+         << "\n";
+  for (size_t pair : pairs) {
+    stream << std::left << std::setfill(' ') << std::setw(25)
+           << inst::getOpCodeString(static_cast<inst::OpCode>(pair / 256))
+                  .data()
+           << std::setw(25)
+           << inst::getOpCodeString(static_cast<inst::OpCode>(pair % 256))
+                  .data()
+           << std::setw(11) << pf[pair] << "\n";
+  }
   os << stream.str();
 }
 #endif
@@ -31,9 +31,11 @@
 #include "hermes/VM/JSError.h"
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
+#include "hermes/VM/LazyCompilationThread.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/PointerBase.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
+#include "hermes/VM/RuntimeImage.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/StackFrame-inline.h"
 #include "hermes/VM/StringView.h"
@@ -109,7 +111,10 @@ std::shared_ptr<Runtime> Runtime::create(const RuntimeConfig &runtimeConfig) {
 #else
   // TODO(T31421960): This can become a unique_ptr with C++14 lambda
   // initializers.
-  std::shared_ptr<StorageProvider> provider{StorageProvider::mmapProvider()};
+  std::shared_ptr<StorageProvider> provider{
+      gcConfig.getUseHugePages()
+          ? StorageProvider::hugePageProvider(gcConfig.getPreferLocalNUMANode())
+          : StorageProvider::mmapProvider()};
   // When not using the flat address space, allocate runtime normally.
   Runtime *rt = new Runtime(provider.get(), runtimeConfig);
   // Return a shared pointer with a custom deleter to delete the underlying
@@ -197,6 +202,8 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
       shouldRandomizeMemoryLayout_(runtimeConfig.getRandomizeMemoryLayout()),
       bytecodeWarmupPercent_(runtimeConfig.getBytecodeWarmupPercent()),
       trackIO_(runtimeConfig.getTrackIO()),
+      backgroundLazyCompilation_(
+          runtimeConfig.getBackgroundLazyCompilation()),
       vmExperimentFlags_(runtimeConfig.getVMExperimentFlags()),
       runtimeStats_(runtimeConfig.getEnableSampledStats()),
       commonStorage_(createRuntimeCommonStorage()),
@@ -239,9 +246,18 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
       StackFrameLayout::CalleeExtraRegistersAtStart,
       HermesValue::encodeUndefinedValue());
 
-  // Initialize Predefined Strings.
+  if (runtimeConfig.getLazyBuiltins())
+    lazyBuiltins_ = (1u << static_cast<unsigned>(LazyBuiltins::_count)) - 1;
+
+  // The image of an initialized heap, if one should be used.
+  std::shared_ptr<const RuntimeImage> image;
+  if (runtimeConfig.getUseRuntimeImage())
+    image = RuntimeImage::get(hasES6Symbol_, lazyBuiltins_ != 0);
+
+  // Initialize Predefined Strings, unless the image restores them.
   // This function does not do any allocations.
-  initPredefinedStrings();
+  if (!image)
+    initPredefinedStrings();
 
   // Initialize special code blocks pointing to their own runtime module.
   // specialCodeBlockRuntimeModule_ will be owned by runtimeModuleList_.
@@ -257,7 +273,8 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
   // At this point, allocations can begin, as all the roots are markable.
 
   // Initialize the pre-allocated character strings.
-  initCharacterStrings();
+  if (!image)
+    initCharacterStrings();
 
   GCScope scope(this);
 
@@ -271,6 +288,20 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
   returnThisCodeBlock_ =
       specialCodeBlockRuntimeModule_->getCodeBlockMayAllocate(1);
 
+  if (image) {
+    // Copy the builtin objects instead of creating them.
+    image->restore(this);
+  } else {
+    initBuiltinObjects();
+  }
+
+  LLVM_DEBUG(llvm::dbgs() << "Runtime initialized\n");
+
+  samplingProfiler_ = SamplingProfiler::getInstance();
+  samplingProfiler_->registerRuntime(this);
+}
+
+void Runtime::initBuiltinObjects() {
   // Initialize the root hidden class.
   rootClazz_ = ignoreAllocationFailure(HiddenClass::createRoot(this));
   rootClazzRawPtr_ = vmcast<HiddenClass>(rootClazz_);
@@ -294,15 +325,14 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
       vmcast<JSObject>(global_), this, vmcast<JSObject>(objectPrototype)));
 
   symbolRegistry_.init(this);
-
-  LLVM_DEBUG(llvm::dbgs() << "Runtime initialized\n");
-
-  samplingProfiler_ = SamplingProfiler::getInstance();
-  samplingProfiler_->registerRuntime(this);
 }
 
 Runtime::~Runtime() {
   samplingProfiler_->unregisterRuntime(this);
+#ifndef HERMESVM_LEAN
+  // Stop compiling functions which won't run anymore.
+  lazyCompilationThread_.reset();
+#endif
 
   heap_.finalizeAll();
   crashMgr_->unregisterCallback(crashCallbackKey_);
@@ -368,15 +398,7 @@ void Runtime::markRoots(
 
   {
     MarkRootsPhaseTimer timer(this, MarkRootsPhase::RuntimeInstanceVars);
-    acceptor.accept(thrownValue_, "@thrownValue");
-    acceptor.accept(nullPointer_, "@nullPointer");
-    acceptor.accept(rootClazz_, "@rootClass");
-    acceptor.acceptPtr(rootClazzRawPtr_, "@rootClass");
-    acceptor.accept(stringCycleCheckVisited_, "@stringCycleCheckVisited");
-    acceptor.accept(global_, "@global");
-#ifdef HERMES_ENABLE_DEBUGGER
-    acceptor.accept(debuggerInternalObject_, "@debuggerInternal");
-#endif // HERMES_ENABLE_DEBUGGER
+    markInstanceVarRoots(acceptor);
   }
 
   {
@@ -403,63 +425,9 @@ void Runtime::markRoots(
       acceptor.accept((void *&)nf);
   }
 
-#ifdef MARK
-#error "Shouldn't have defined mark already"
-#endif
-#define MARK(field) acceptor.accept((field), "@" #field)
   {
     MarkRootsPhaseTimer timer(this, MarkRootsPhase::Prototypes);
-    // Prototypes.
-    MARK(objectPrototype);
-    acceptor.acceptPtr(objectPrototypeRawPtr, "@objectPrototype");
-    MARK(functionPrototype);
-    acceptor.acceptPtr(functionPrototypeRawPtr, "@functionPrototype");
-    MARK(stringPrototype);
-    MARK(numberPrototype);
-    MARK(booleanPrototype);
-    MARK(symbolPrototype);
-    MARK(datePrototype);
-    MARK(arrayPrototype);
-    acceptor.acceptPtr(arrayPrototypeRawPtr, "@arrayPrototype");
-    MARK(arrayBufferPrototype);
-    MARK(dataViewPrototype);
-    MARK(typedArrayBasePrototype);
-    MARK(setPrototype);
-    MARK(setIteratorPrototype);
-    MARK(mapPrototype);
-    MARK(mapIteratorPrototype);
-    MARK(weakMapPrototype);
-    MARK(weakSetPrototype);
-    MARK(regExpPrototype);
-    // Constructors.
-    MARK(typedArrayBaseConstructor);
-    // Miscellaneous.
-    MARK(regExpLastInput);
-    MARK(regExpLastRegExp);
-    MARK(throwTypeErrorAccessor);
-    MARK(arrayClass);
-    acceptor.acceptPtr(arrayClassRawPtr, "@arrayClass");
-    MARK(iteratorPrototype);
-    MARK(arrayIteratorPrototype);
-    MARK(arrayPrototypeValues);
-    MARK(stringIteratorPrototype);
-    MARK(generatorFunctionPrototype);
-    MARK(generatorPrototype);
-    MARK(jsErrorStackAccessor);
-    MARK(parseIntFunction);
-    MARK(parseFloatFunction);
-    MARK(requireFunction);
-
-#define TYPED_ARRAY(name, type)                                      \
-  acceptor.accept(name##ArrayPrototype, "@" #name "ArrayPrototype"); \
-  acceptor.accept(name##ArrayConstructor, "@" #name "ArrayConstructor");
-#include "hermes/VM/TypedArrays.def"
-
-    MARK(errorConstructor);
-#define ALL_ERROR_TYPE(name) \
-  acceptor.accept(name##Prototype, "@" #name "Prototype");
-#include "hermes/VM/NativeErrorTypes.def"
-#undef MARK
+    markPrototypeRoots(acceptor);
   }
 
   {
@@ -494,10 +462,91 @@ void Runtime::markRoots(
   {
     MarkRootsPhaseTimer timer(this, MarkRootsPhase::Custom);
     for (auto &fn : customMarkRootFuncs_)
-      fn(gc, acceptor);
+      fn(gc, acceptor, markLongLived);
   }
 }
 
+void Runtime::markInstanceVarRoots(SlotAcceptorWithNames &acceptor) {
+  acceptor.accept(thrownValue_, "@thrownValue");
+  acceptor.accept(nullPointer_, "@nullPointer");
+  acceptor.accept(rootClazz_, "@rootClass");
+  acceptor.acceptPtr(rootClazzRawPtr_, "@rootClass");
+  acceptor.accept(stringCycleCheckVisited_, "@stringCycleCheckVisited");
+  acceptor.accept(global_, "@global");
+#ifdef HERMES_ENABLE_DEBUGGER
+  acceptor.accept(debuggerInternalObject_, "@debuggerInternal");
+#endif // HERMES_ENABLE_DEBUGGER
+}
+
+void Runtime::markPrototypeRoots(SlotAcceptorWithNames &acceptor) {
+#ifdef MARK
+#error "Shouldn't have defined mark already"
+#endif
+#define MARK(field) acceptor.accept((field), "@" #field)
+  // Prototypes.
+  MARK(objectPrototype);
+  acceptor.acceptPtr(objectPrototypeRawPtr, "@objectPrototype");
+  MARK(functionPrototype);
+  acceptor.acceptPtr(functionPrototypeRawPtr, "@functionPrototype");
+  MARK(stringPrototype);
+  MARK(numberPrototype);
+  MARK(booleanPrototype);
+  MARK(symbolPrototype);
+  MARK(datePrototype);
+  MARK(arrayPrototype);
+  acceptor.acceptPtr(arrayPrototypeRawPtr, "@arrayPrototype");
+  MARK(arrayBufferPrototype);
+  MARK(dataViewPrototype);
+  MARK(typedArrayBasePrototype);
+  MARK(setPrototype);
+  MARK(setIteratorPrototype);
+  MARK(mapPrototype);
+  MARK(mapIteratorPrototype);
+  MARK(weakMapPrototype);
+  MARK(weakSetPrototype);
+  MARK(regExpPrototype);
+  // Constructors.
+  MARK(typedArrayBaseConstructor);
+  // Miscellaneous.
+  MARK(regExpLastInput);
+  MARK(regExpLastRegExp);
+  MARK(throwTypeErrorAccessor);
+  MARK(arrayClass);
+  acceptor.acceptPtr(arrayClassRawPtr, "@arrayClass");
+  MARK(iteratorPrototype);
+  MARK(arrayIteratorPrototype);
+  MARK(arrayPrototypeValues);
+  MARK(stringIteratorPrototype);
+  MARK(generatorFunctionPrototype);
+  MARK(generatorPrototype);
+  MARK(jsErrorStackAccessor);
+  MARK(parseIntFunction);
+  MARK(parseFloatFunction);
+  MARK(requireFunction);
+
+#define TYPED_ARRAY(name, type)                                      \
+  acceptor.accept(name##ArrayPrototype, "@" #name "ArrayPrototype"); \
+  acceptor.accept(name##ArrayConstructor, "@" #name "ArrayConstructor");
+#include "hermes/VM/TypedArrays.def"
+
+  MARK(errorConstructor);
+#define ALL_ERROR_TYPE(name) \
+  acceptor.accept(name##Prototype, "@" #name "Prototype");
+#include "hermes/VM/NativeErrorTypes.def"
+#undef MARK
+}
+
+void Runtime::markImageRoots(SlotAcceptorWithNames &acceptor) {
+  markInstanceVarRoots(acceptor);
+  for (auto &hv : charStrings_)
+    acceptor.accept(hv);
+  for (NativeFunction *&nf : builtins_)
+    acceptor.accept((void *&)nf);
+  markPrototypeRoots(acceptor);
+  identifierTable_.markIdentifiers(acceptor, &getHeap());
+  symbolRegistry_.markRoots(acceptor);
+}
+
 void Runtime::markWeakRoots(GCBase *gc, SlotAcceptorWithNames &acceptor) {
   for (auto &rm : runtimeModuleList_)
     rm.markWeakRoots(acceptor);
@@ -565,6 +614,38 @@ size_t Runtime::mallocSize() const {
   return totalSize;
 }
 
+void Runtime::startAllocationSampling(uint32_t samplingInterval) {
+  allocationProfiler_ =
+      llvm::make_unique<AllocationProfiler>(this, samplingInterval);
+}
+
+size_t Runtime::handleMemoryPressure(MemoryPressureLevel level) {
+  size_t moduleSizeBefore = 0;
+  for (RuntimeModule &rtm : runtimeModuleList_) {
+    moduleSizeBefore += rtm.additionalMemorySize();
+    rtm.clearCaches();
+  }
+#ifndef HERMESVM_LEAN
+  if (lazyCompilationThread_)
+    lazyCompilationThread_->dropPending();
+#endif
+  if (level == MemoryPressureLevel::Critical) {
+    // Property maps are the largest of the caches, but recreating them slows
+    // down property accesses for a while, so only drop them when critical.
+    heap_.forAllObjs([this](GCCell *cell) {
+      if (auto *clazz = dyn_vmcast<HiddenClass>(cell))
+        clazz->clearRecreatableCaches(this);
+    });
+  }
+  size_t freed = heap_.handleMemoryPressure(level);
+  size_t moduleSizeAfter = 0;
+  for (const RuntimeModule &rtm : runtimeModuleList_)
+    moduleSizeAfter += rtm.additionalMemorySize();
+  if (moduleSizeBefore > moduleSizeAfter)
+    freed += moduleSizeBefore - moduleSizeAfter;
+  return freed;
+}
+
 #ifdef HERMESVM_SANITIZE_HANDLES
 void Runtime::potentiallyMoveHeap() {
   // Do a dummy allocation which could force a heap move if handle sanitization
@@ -828,6 +909,15 @@ Handle<JSObject> Runtime::getGlobal() {
   return Handle<JSObject>::vmcast(&global_);
 }
 
+#ifndef HERMESVM_LEAN
+LazyCompilationThread *Runtime::getLazyCompilationThread() {
+  if (LLVM_UNLIKELY(backgroundLazyCompilation_ && !lazyCompilationThread_)) {
+    lazyCompilationThread_ = llvm::make_unique<LazyCompilationThread>();
+  }
+  return lazyCompilationThread_.get();
+}
+#endif
+
 std::vector<llvm::ArrayRef<uint8_t>> Runtime::getEpilogues() {
   std::vector<llvm::ArrayRef<uint8_t>> result;
   for (const auto &m : runtimeModuleList_) {
@@ -1235,12 +1325,25 @@ void Runtime::initBuiltinTable() {
 
   builtins_.resize(inst::BuiltinMethod::_count);
 
-  (void)forEachBuiltin([this](
-                           unsigned methodIndex,
-                           Predefined::Str /* objectName */,
-                           Handle<JSObject> &currentObject,
-                           SymbolID methodID) {
-    auto cr = JSObject::getNamed_RJS(currentObject, this, methodID);
+  // Don't use forEachBuiltin(), which would create the deferred builtins by
+  // looking them up.
+  MutableHandle<JSObject> object{this};
+  for (unsigned methodIndex = 0; methodIndex < inst::BuiltinMethod::_count;
+       ++methodIndex) {
+    if (builtins_[methodIndex])
+      continue;
+    GCScopeMarkerRAII marker{this};
+    auto objectID = Predefined::getSymbolID(
+        (Predefined::Str)builtinMethods[methodIndex].object);
+    NamedPropertyDescriptor desc;
+    if (!JSObject::getOwnNamedDescriptor(getGlobal(), this, objectID, desc))
+      continue;
+    object = vmcast<JSObject>(
+        JSObject::getNamedSlotValue(getGlobal().get(), this, desc));
+
+    auto methodID = Predefined::getSymbolID(
+        (Predefined::Str)builtinMethods[methodIndex].method);
+    auto cr = JSObject::getNamed_RJS(object, this, methodID);
     assert(
         cr.getStatus() != ExecutionStatus::EXCEPTION &&
         "getNamed() of builtin method failed");
@@ -1248,8 +1351,44 @@ void Runtime::initBuiltinTable() {
         vmisa<NativeFunction>(cr.getValue()) &&
         "getNamed() of builtin method must be a NativeFunction");
     builtins_[methodIndex] = vmcast<NativeFunction>(cr.getValue());
-    return ExecutionStatus::RETURNED;
-  });
+  }
+}
+
+NativeFunction *Runtime::getLazyBuiltinNativeFunction(
+    unsigned builtinMethodID) {
+  auto objectID = Predefined::getSymbolID(
+      (Predefined::Str)builtinMethods[builtinMethodID].object);
+  bool created = initLazyGlobal(objectID);
+  (void)created;
+  assert(created && "builtin method of an object which isn't deferred");
+  assert(builtins_[builtinMethodID] && "builtin method not created");
+  return builtins_[builtinMethodID];
+}
+
+bool Runtime::initLazyGlobal(SymbolID name) {
+  auto group = getLazyBuiltinsOfGlobal(name);
+  if (!group || !areBuiltinsDeferred(*group))
+    return false;
+  createDeferredBuiltins(*group);
+  return true;
+}
+
+void Runtime::initAllLazyBuiltins() {
+  for (unsigned i = 0; i < static_cast<unsigned>(LazyBuiltins::_count); ++i)
+    initLazyBuiltins(static_cast<LazyBuiltins>(i));
+}
+
+void Runtime::createDeferredBuiltins(LazyBuiltins group) {
+  assert(areBuiltinsDeferred(group) && "builtins are not deferred");
+  // Clear the bit first, so that defining the properties of the group on the
+  // global object doesn't try to create it again.
+  lazyBuiltins_ &= ~(1u << static_cast<unsigned>(group));
+  createLazyBuiltins(this, group);
+  initBuiltinTable();
+  // The global object doesn't need to intercept lookups of missing properties
+  // anymore.
+  if (!lazyBuiltins_)
+    getGlobal()->setLazy(false);
 }
 
 ExecutionStatus Runtime::assertBuiltinsUnmodified() {
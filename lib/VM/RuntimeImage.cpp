@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/RuntimeImage.h"
+
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCBase-inline.h"
+#include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/Handle-inline.h"
+#include "hermes/VM/HermesValue-inline.h"
+#include "hermes/VM/JSError.h"
+#include "hermes/VM/SlotAcceptor.h"
+#include "hermes/VM/SlotVisitor.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace hermes {
+namespace vm {
+
+struct RuntimeImage::SlotRecorder final : public SlotAcceptorWithNames {
+  /// Weak references are not followed: the transitions of hidden classes are
+  /// recorded separately, and no other cell may hold weak references.
+  static constexpr bool shouldMarkWeak = false;
+
+  struct Slot {
+    /// The location of the slot.
+    void *loc;
+    /// The cell the slot points to, or nullptr.
+    GCCell *target;
+    SlotKind kind;
+    /// The value of a HermesValue slot.
+    HermesValue value;
+  };
+
+  PointerBase *const base;
+  std::vector<Slot> slots{};
+  /// Set if a slot can't be recorded.
+  bool unsupported{false};
+
+  explicit SlotRecorder(PointerBase *base) : base(base) {}
+
+  using SlotAcceptorWithNames::accept;
+
+  void accept(void *&ptr, const char *) override {
+    slots.push_back({&ptr,
+                     static_cast<GCCell *>(ptr),
+                     SlotKind::Raw,
+                     HermesValue::encodeEmptyValue()});
+  }
+
+  void accept(BasedPointer &, const char *) override {
+    unsupported = true;
+  }
+
+  void accept(GCPointerBase &ptr, const char *) override {
+    slots.push_back({&ptr,
+                     static_cast<GCCell *>(ptr.get(base)),
+                     SlotKind::Pointer,
+                     HermesValue::encodeEmptyValue()});
+  }
+
+  void accept(HermesValue &hv, const char *) override {
+    slots.push_back(
+        {&hv,
+         hv.isPointer() ? static_cast<GCCell *>(hv.getPointer()) : nullptr,
+         SlotKind::Value,
+         hv});
+  }
+
+  void accept(WeakRefBase &, const char *) override {
+    unsupported = true;
+  }
+};
+
+struct RuntimeImage::RootWriter final : public SlotAcceptorWithNames {
+  const std::vector<Root> &roots;
+  const std::vector<GCCell *> &cells;
+  PointerBase *const base;
+  GC *const gc;
+  /// The index of the next root to write.
+  size_t next{0};
+
+  RootWriter(
+      const std::vector<Root> &roots,
+      const std::vector<GCCell *> &cells,
+      PointerBase *base,
+      GC *gc)
+      : roots(roots), cells(cells), base(base), gc(gc) {}
+
+  using SlotAcceptorWithNames::accept;
+
+  /// \return the next root, advancing to the one after it.
+  const Root &nextRoot() {
+    assert(next < roots.size() && "more roots than in the image");
+    return roots[next++];
+  }
+
+  GCCell *targetOf(const Root &root) const {
+    return root.target == kNoTarget ? nullptr : cells[root.target];
+  }
+
+  void accept(void *&ptr, const char *) override {
+    ptr = targetOf(nextRoot());
+  }
+
+  void accept(BasedPointer &, const char *) override {
+    llvm_unreachable("the image does not contain based pointers");
+  }
+
+  void accept(GCPointerBase &ptr, const char *) override {
+    ptr.set(base, targetOf(nextRoot()), gc);
+  }
+
+  void accept(HermesValue &hv, const char *) override {
+    // All the image roots are PinnedHermesValues.
+    const Root &root = nextRoot();
+    static_cast<PinnedHermesValue &>(hv) = root.target == kNoTarget
+        ? root.value
+        : root.value.updatePointer(targetOf(root));
+  }
+};
+
+/// \return whether the bytes of \p cell can be copied to another heap.
+static bool canCopy(GCCell *cell) {
+  const VTable *vt = cell->getVT();
+  if (!vt->finalize_ && !vt->markWeak_)
+    return true;
+  // A finalizer means that the cell owns memory outside of the heap, or refers
+  // to state of the runtime (e.g. a Domain owning RuntimeModules). Hidden
+  // classes only use theirs for the transition table, which is rebuilt after
+  // the copy, and errors for the stack trace, which Error.prototype lacks.
+  if (vmisa<HiddenClass>(cell))
+    return true;
+  if (auto *error = dyn_vmcast<JSError>(cell))
+    return !error->getStackTrace();
+  return false;
+}
+
+std::shared_ptr<const RuntimeImage> RuntimeImage::get(
+    bool hasES6Symbol,
+    bool lazyBuiltins) {
+  static std::mutex mutex;
+  static std::shared_ptr<const RuntimeImage> images[4];
+  static bool captured[4];
+
+  std::lock_guard<std::mutex> lock{mutex};
+  const unsigned index = (hasES6Symbol ? 1 : 0) | (lazyBuiltins ? 2 : 0);
+  if (!captured[index]) {
+    captured[index] = true;
+    // These are the only options which affect the initial heap.
+    auto runtime = Runtime::create(RuntimeConfig::Builder()
+                                       .withES6Symbol(hasES6Symbol)
+                                       .withLazyBuiltins(lazyBuiltins)
+                                       .withUseRuntimeImage(false)
+                                       .build());
+    images[index] = capture(runtime.get());
+  }
+  return images[index];
+}
+
+std::unique_ptr<RuntimeImage> RuntimeImage::capture(Runtime *runtime) {
+  GC *gc = &runtime->getHeap();
+  std::unique_ptr<RuntimeImage> image{new RuntimeImage()};
+
+  SlotRecorder recorder{runtime};
+  runtime->markImageRoots(recorder);
+  std::vector<SlotRecorder::Slot> rootSlots = std::move(recorder.slots);
+
+  // Find every cell reachable from the roots.
+  llvm::DenseMap<GCCell *, uint32_t> indices{};
+  std::vector<GCCell *> cells{};
+  auto addCell = [&indices, &cells](GCCell *cell) {
+    if (cell && indices.try_emplace(cell, 0).second)
+      cells.push_back(cell);
+  };
+  for (const auto &slot : rootSlots)
+    addCell(slot.target);
+  for (size_t i = 0; i < cells.size(); ++i) {
+    if (!canCopy(cells[i]))
+      return nullptr;
+    recorder.slots.clear();
+    GCBase::markCell(cells[i], gc, recorder);
+    for (const auto &slot : recorder.slots)
+      addCell(slot.target);
+  }
+  if (recorder.unsupported)
+    return nullptr;
+
+  // Copy the cells in address order, which is usually the order in which they
+  // were allocated, so that they are allocated in the same order on restore.
+  std::sort(cells.begin(), cells.end(), std::less<GCCell *>());
+  for (uint32_t i = 0, e = cells.size(); i != e; ++i)
+    indices[cells[i]] = i;
+
+  for (uint32_t i = 0, e = cells.size(); i != e; ++i) {
+    GCCell *cell = cells[i];
+    const uint32_t size = cell->getAllocatedSize();
+    const uint32_t offset = image->heap_.size();
+    const char *bytes = reinterpret_cast<const char *>(cell);
+    image->cells_.push_back({offset, size, cell->getVT()->finalize_ != nullptr});
+    image->heap_.insert(image->heap_.end(), bytes, bytes + size);
+
+    recorder.slots.clear();
+    GCBase::markCell(cell, gc, recorder);
+    for (const auto &slot : recorder.slots) {
+      if (!slot.target)
+        continue;
+      const uint32_t slotOffset = static_cast<const char *>(slot.loc) - bytes;
+      char *copy = image->heap_.data() + offset + slotOffset;
+      // Clear the pointer in the copy so that the restored cell is valid in
+      // case of a collection before it is relocated.
+      switch (slot.kind) {
+        case SlotKind::Raw:
+          std::memset(copy, 0, sizeof(void *));
+          break;
+        case SlotKind::Pointer:
+          std::memset(copy, 0, sizeof(GCPointerBase));
+          break;
+        case SlotKind::Value: {
+          const HermesValue empty = HermesValue::encodeEmptyValue();
+          std::memcpy(copy, &empty, sizeof(HermesValue));
+          break;
+        }
+      }
+      image->relocations_.push_back(
+          {i, slotOffset, indices[slot.target], slot.kind, slot.value});
+    }
+
+    if (auto *clazz = dyn_vmcast<HiddenClass>(cell)) {
+      for (auto &entry : clazz->transitionMap_) {
+        auto *child = static_cast<GCCell *>(
+            entry.second.unsafeGetHermesValue().getPointer());
+        auto it = indices.find(child);
+        if (it != indices.end())
+          image->transitions_.push_back({i, it->second, entry.first});
+      }
+    }
+  }
+
+  image->roots_.reserve(rootSlots.size());
+  for (const auto &slot : rootSlots) {
+    image->roots_.push_back(
+        {slot.target ? indices[slot.target] : kNoTarget, slot.value});
+  }
+
+  image->identifiers_ = runtime->identifierTable_;
+  image->numCharStrings_ = runtime->charStrings_.size();
+  image->numBuiltins_ = runtime->builtins_.size();
+  image->nextObjectID_ = runtime->nextObjectID_;
+  image->lazyBuiltins_ = runtime->lazyBuiltins_;
+  return image;
+}
+
+void RuntimeImage::restore(Runtime *runtime) const {
+  assert(
+      runtime->identifierTable_.getSymbolsEnd() == 0 &&
+      "identifiers registered before restoring the image");
+  GC *gc = &runtime->getHeap();
+  GCScope gcScope(runtime, "RuntimeImage::restore", UINT_MAX);
+
+  // Allocate and copy the cells. Their pointers are still cleared, and each
+  // one is held by a handle, so a collection here is harmless. The cells do
+  // contain SymbolIDs, which a full collection marks, so the identifier table
+  // must already cover them.
+  runtime->identifierTable_.reserveSymbolIDs(identifiers_.getSymbolsEnd());
+  std::vector<Handle<HermesValue>> handles{};
+  handles.reserve(cells_.size());
+  for (const CellInfo &info : cells_) {
+    void *mem = info.hasFinalizer
+        ? runtime->allocLongLived<HasFinalizer::Yes>(info.size)
+        : runtime->allocLongLived<HasFinalizer::No>(info.size);
+    std::memcpy(mem, heap_.data() + info.offset, info.size);
+    auto *cell = static_cast<GCCell *>(mem);
+    cell->initAfterCopy(gc);
+    if (auto *clazz = dyn_vmcast<HiddenClass>(cell)) {
+      // The copied transition table belongs to the captured runtime.
+      new (&clazz->transitionMap_)
+          WeakValueMap<HiddenClass::Transition, HiddenClass>();
+    }
+    handles.push_back(
+        runtime->makeHandle(HermesValue::encodeObjectValue(cell)));
+  }
+
+  // Nothing below allocates in the heap, so the cells don't move anymore.
+  std::vector<GCCell *> cells{};
+  cells.reserve(handles.size());
+  for (const auto &handle : handles)
+    cells.push_back(static_cast<GCCell *>(handle->getPointer()));
+
+  runtime->identifierTable_ = identifiers_;
+  runtime->charStrings_.resize(numCharStrings_);
+  runtime->builtins_.resize(numBuiltins_);
+  RootWriter writer{roots_, cells, runtime, gc};
+  runtime->markImageRoots(writer);
+  assert(writer.next == roots_.size() && "fewer roots than in the image");
+
+  for (const Relocation &reloc : relocations_) {
+    char *loc = reinterpret_cast<char *>(cells[reloc.cell]) + reloc.offset;
+    GCCell *target = cells[reloc.target];
+    switch (reloc.kind) {
+      case SlotKind::Raw:
+        *reinterpret_cast<void **>(loc) = target;
+        break;
+      case SlotKind::Pointer:
+        reinterpret_cast<GCPointerBase *>(loc)->set(runtime, target, gc);
+        break;
+      case SlotKind::Value:
+        reinterpret_cast<GCHermesValue *>(loc)->set(
+            reloc.value.updatePointer(target), gc);
+        break;
+    }
+  }
+
+  for (const Transition &transition : transitions_) {
+    vmcast<HiddenClass>(cells[transition.from])
+        ->transitionMap_.insertNew(
+            gc,
+            transition.key,
+            Handle<HiddenClass>::vmcast(handles[transition.to]));
+  }
+
+  runtime->nextObjectID_ = nextObjectID_;
+  runtime->lazyBuiltins_ = lazyBuiltins_;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -10,12 +10,16 @@
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/Domain.h"
 #include "hermes/VM/HiddenClass.h"
+#include "hermes/VM/LazyCompilationThread.h"
 #include "hermes/VM/Predefined.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/RuntimeModule-inline.h"
+#include "hermes/VM/SerializedLiteralParser.h"
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/VM/StringView.h"
 
+#include <algorithm>
+
 namespace hermes {
 namespace vm {
 
@@ -112,6 +116,9 @@ ExecutionStatus RuntimeModule::initializeMayAllocate(
 }
 
 CodeBlock *RuntimeModule::getCodeBlockSlowPath(unsigned index) {
+  if (LLVM_UNLIKELY(flags_.recordsFunctionOrder)) {
+    functionOrder_.push_back(index);
+  }
 #ifndef HERMESVM_LEAN
   if (bcProvider_->isFunctionLazy(index)) {
     auto *lazyModule = RuntimeModule::createLazyModule(
@@ -145,6 +152,12 @@ RuntimeModule *RuntimeModule::createLazyModule(
 
   RM->bcProvider_ = hbc::BCProviderLazy::createBCProviderLazy(bcFunction);
 
+  // A closure is being created for the function, so it is likely to be called
+  // soon.
+  if (LazyCompilationThread *thread = runtime->getLazyCompilationThread()) {
+    thread->prefetch(*bcFunction->getLazyCompilationData());
+  }
+
   // We don't know which function index this block will eventually represent,
   // so just add it as 0 to ensure ownership. We'll move it later in
   // `initializeLazy`.
@@ -221,10 +234,16 @@ void RuntimeModule::importStringIDMapMayAllocate() {
   // Populate the string ID map with empty identifiers.
   stringIDMap_.resize(strTableSize, SymbolID::empty());
 
-  // Preallocate enough space to store all identifiers to prevent
-  // unnecessary allocations.
-  runtime_->getIdentifierTable().reserve(strTableSize);
+  // Get the array of pre-computed translations from identifiers in the bytecode
+  // to their runtime representation as SymbolIDs.
+  auto kinds = bcProvider_->getStringKinds();
+  auto translations = bcProvider_->getIdentifierTranslations();
+  assert(
+      translations.size() <= strTableSize &&
+      "Should not have more strings than identifiers");
 
+  // The advice applies to persistent modules too, which import their
+  // identifiers lazily from the same string table.
   if (runtime_->getVMExperimentFlags() &
       experiments::MAdviseStringsSequential) {
     bcProvider_->adviseStringTableSequential();
@@ -234,13 +253,36 @@ void RuntimeModule::importStringIDMapMayAllocate() {
     bcProvider_->willNeedStringTable();
   }
 
-  // Get the array of pre-computed translations from identifiers in the bytecode
-  // to their runtime representation as SymbolIDs.
-  auto kinds = bcProvider_->getStringKinds();
-  auto translations = bcProvider_->getIdentifierTranslations();
-  assert(
-      translations.size() <= strTableSize &&
-      "Should not have more strings than identifiers");
+  if (flags_.persistent) {
+    // The identifiers of a persistent module are lazy identifiers pointing
+    // into the bytecode, and registering one doesn't allocate, so they can be
+    // imported when first used instead of all at once. Only record where they
+    // are, to find their precomputed hashes.
+    StringID strID = 0;
+    uint32_t trnID = 0;
+    stringRuns_.reserve(kinds.size());
+    for (auto entry : kinds) {
+      stringRuns_.push_back({strID, trnID, entry.kind()});
+      strID += entry.count();
+      if (entry.kind() != StringKind::String)
+        trnID += entry.count();
+    }
+    assert(strID == strTableSize && "Should map every string in the bytecode.");
+    assert(trnID == translations.size() && "Should translate all identifiers.");
+    if (runtime_->getVMExperimentFlags() & experiments::MAdviseStringsRandom) {
+      bcProvider_->adviseStringTableRandom();
+    }
+    if (strTableSize == 0)
+      mapEmptyString();
+    return;
+  }
+
+  // Preallocate enough space to store all identifiers to prevent
+  // unnecessary allocations. Only identifiers are added to the table; the
+  // other strings are only mapped when first used, so reserving for the whole
+  // string table would waste memory in every runtime using the bytecode.
+  runtime_->getIdentifierTable().reserve(translations.size());
+
   {
     StringID strID = 0;
     uint32_t trnID = 0;
@@ -276,20 +318,59 @@ void RuntimeModule::importStringIDMapMayAllocate() {
     bcProvider_->adviseStringTableRandom();
   }
 
-  if (strTableSize == 0) {
-    // If the string table turns out to be empty,
-    // we always add one empty string to it.
-    // Note that this can only happen when we are creating the RuntimeModule
-    // in a non-standard way, either in unit tests or the special
-    // emptyCodeBlockRuntimeModule_ in Runtime where the creation happens
-    // manually instead of going through bytecode module generation.
-    // In those cases, functions will be created with a default nameID=0
-    // without adding the name string into the string table. Hence here
-    // we need to add it manually and it will have index 0.
-    ASCIIRef s;
-    stringIDMap_.push_back({});
-    mapStringMayAllocate(s, hashString(s));
-  }
+  if (strTableSize == 0)
+    mapEmptyString();
+}
+
+void RuntimeModule::mapEmptyString() {
+  // If the string table turns out to be empty,
+  // we always add one empty string to it.
+  // Note that this can only happen when we are creating the RuntimeModule
+  // in a non-standard way, either in unit tests or the special
+  // emptyCodeBlockRuntimeModule_ in Runtime where the creation happens
+  // manually instead of going through bytecode module generation.
+  // In those cases, functions will be created with a default nameID=0
+  // without adding the name string into the string table. Hence here
+  // we need to add it manually and it will have index 0.
+  ASCIIRef s;
+  stringIDMap_.push_back({});
+  mapStringMayAllocate(s, hashString(s));
+}
+
+const RuntimeModule::StringRun *RuntimeModule::findStringRun(
+    StringID stringID) const {
+  if (stringRuns_.empty())
+    return nullptr;
+  auto it = std::upper_bound(
+      stringRuns_.begin(),
+      stringRuns_.end(),
+      stringID,
+      [](StringID id, const StringRun &run) { return id < run.first; });
+  assert(it != stringRuns_.begin() && "the first run starts at 0");
+  return &*(it - 1);
+}
+
+SymbolID RuntimeModule::importIdentifier(StringID stringID) {
+  const StringRun *run = findStringRun(stringID);
+  assert(
+      run && run->kind != StringKind::String &&
+      "Symbol must exist for this string ID");
+  const uint32_t translation =
+      bcProvider_
+          ->getIdentifierTranslations()[run->firstTranslation + stringID -
+                                        run->first];
+  if (run->kind == StringKind::Predefined)
+    return mapPredefined(stringID, translation);
+  return createSymbolFromStringIDMayAllocate(
+      stringID, bcProvider_->getStringTableEntry(stringID), translation);
+}
+
+SymbolID RuntimeModule::importStringMayAllocate(StringID stringID) {
+  const StringRun *run = findStringRun(stringID);
+  if (run && run->kind != StringKind::String)
+    return importIdentifier(stringID);
+  return createSymbolFromStringIDMayAllocate(
+      stringID, bcProvider_->getStringTableEntry(stringID), llvm::None);
 }
 
 void RuntimeModule::initializeFunctionMap() {
@@ -427,11 +508,46 @@ void RuntimeModule::tryCacheLiteralHiddenClass(
   }
 }
 
+llvm::Optional<llvm::ArrayRef<HermesValue>>
+RuntimeModule::getLiteralValuesMayAllocate(
+    unsigned valBufferIndex,
+    unsigned numLiterals) {
+  if (!canGenerateLiteralHiddenClassCacheKey(valBufferIndex, numLiterals))
+    return llvm::None;
+  const uint32_t key =
+      getLiteralHiddenClassCacheHashKey(valBufferIndex, numLiterals);
+  auto it = objectLiteralValues_.find(key);
+  if (it != objectLiteralValues_.end())
+    return llvm::ArrayRef<HermesValue>(it->second);
+
+  // Without a RuntimeModule, the parser returns the string IDs of strings
+  // encoded as symbols.
+  std::vector<HermesValue> values{};
+  values.reserve(numLiterals);
+  SerializedLiteralParser parser{
+      getBytecode()->getObjectValueBuffer().slice(valBufferIndex),
+      numLiterals,
+      nullptr};
+  while (parser.hasNext()) {
+    const HermesValue val = parser.get(runtime_);
+    values.push_back(
+        val.isSymbol() ? HermesValue::encodeSymbolValue(
+                             getSymbolIDFromStringIDMayAllocate(
+                                 val.getSymbol().unsafeGetIndex()))
+                       : val);
+  }
+  return llvm::ArrayRef<HermesValue>(
+      objectLiteralValues_.try_emplace(key, std::move(values)).first->second);
+}
+
 size_t RuntimeModule::additionalMemorySize() const {
   size_t total = stringIDMap_.capacity() * sizeof(SymbolID) +
+      stringRuns_.capacity() * sizeof(StringRun) +
       functionMap_.capacity() * sizeof(CodeBlock *) +
       objectLiteralHiddenClasses_.getMemorySize() +
-      templateMap_.getMemorySize();
+      objectLiteralValues_.getMemorySize() + templateMap_.getMemorySize();
+  for (const auto &entry : objectLiteralValues_)
+    total += entry.second.capacity() * sizeof(HermesValue);
   // Add the size of each CodeBlock
   for (const CodeBlock *cb : functionMap_) {
     // Skip the null code blocks, they are lazily inserted the first time
@@ -444,6 +560,11 @@ size_t RuntimeModule::additionalMemorySize() const {
   return total;
 }
 
+void RuntimeModule::clearCaches() {
+  objectLiteralHiddenClasses_.shrink_and_clear();
+  objectLiteralValues_.shrink_and_clear();
+}
+
 namespace detail {
 
 StringID mapStringMayAllocate(RuntimeModule &module, const char *str) {
@@ -11,7 +11,7 @@ namespace vm {
 
 void SnapshotEdgeAcceptor::accept(void *&ptr, const char *name) {
   if (ptr) {
-    snap.addEdge(V8HeapSnapshot::Edge{
+    addEdge(V8HeapSnapshot::Edge{
         V8HeapSnapshot::Edge::Named{},
         V8HeapSnapshot::Edge ::Type::Internal,
         static_cast<V8HeapSnapshot::Node::ID>(ptrToOffset(ptr)),
@@ -18,6 +18,7 @@
 #include <cassert>
 #include <limits>
 #include <stack>
+#include <vector>
 
 namespace hermes {
 namespace vm {
@@ -79,6 +80,41 @@ class PreAllocatedStorageProvider final : public StorageProvider {
   std::stack<char *, std::vector<char *>> freeList_;
 };
 
+class HugePageStorageProvider final : public StorageProvider {
+ public:
+  explicit HugePageStorageProvider(int numaNode) : numaNode_(numaNode) {}
+  ~HugePageStorageProvider();
+
+  llvm::ErrorOr<void *> newStorage(const char *name) override;
+  void deleteStorage(void *storage) override;
+
+ private:
+  /// Number of storages reserved at a time. Larger regions let the OS use
+  /// huge pages across storage boundaries, at the cost of address space.
+  static constexpr size_t kStoragesPerRegion = 8;
+
+  /// The size of the huge pages on the platforms which have them (2MB on
+  /// x86-64 and ARM64 with 4KB base pages).
+  static constexpr size_t kHugePageSize = 2 << 20;
+
+  static_assert(
+      AlignedStorage::size() % kHugePageSize == 0,
+      "Storages must cover whole huge pages");
+
+  /// Reserve a new region, and add its storages to freeList_.
+  /// \return an error if no storage at all could be reserved.
+  std::error_code reserveRegion();
+
+  /// The NUMA node on which to place pages, or -1 to leave it to the OS.
+  const int numaNode_;
+
+  /// The regions reserved so far, and their sizes.
+  std::vector<std::pair<void *, size_t>> regions_;
+
+  /// Storages that are not in use, and can be re-assigned.
+  std::stack<char *, std::vector<char *>> freeList_;
+};
+
 llvm::ErrorOr<void *> VMAllocateStorageProvider::newStorage(const char *name) {
   assert(AlignedStorage::size() % oscompat::page_size() == 0);
   // Allocate the space, hoping it will be the correct alignment.
@@ -171,6 +207,63 @@ void PreAllocatedStorageProvider::deleteStorage(void *storage) {
   oscompat::vm_name(storage, AlignedStorage::size(), "hermes-freelist");
 }
 
+HugePageStorageProvider::~HugePageStorageProvider() {
+  for (const auto &region : regions_) {
+    oscompat::vm_free_aligned(region.first, region.second);
+  }
+}
+
+std::error_code HugePageStorageProvider::reserveRegion() {
+  // Take a smaller region if address space is short, down to one storage.
+  auto result = vmAllocateAllowLess(
+      kStoragesPerRegion * AlignedStorage::size(),
+      AlignedStorage::size(),
+      AlignedStorage::size());
+  if (!result) {
+    return result.getError();
+  }
+  char *region = static_cast<char *>(result->first);
+  const size_t size = result->second;
+  regions_.push_back(*result);
+  // Both of these are hints: if the OS doesn't support them, the storages
+  // still work, with regular pages on whichever node the OS picks. They must
+  // be given before any page of the region is touched.
+  oscompat::vm_madvise(region, size, oscompat::MAdvice::HugePage);
+  if (numaNode_ >= 0) {
+    oscompat::vm_prefer_numa_node(region, size, numaNode_);
+  }
+  // Push in reverse, so that storages are handed out in address order.
+  for (char *storage = region + size; storage != region;) {
+    storage -= AlignedStorage::size();
+    freeList_.push(storage);
+  }
+  return std::error_code{};
+}
+
+llvm::ErrorOr<void *> HugePageStorageProvider::newStorage(const char *name) {
+  if (freeList_.empty()) {
+    if (auto err = reserveRegion()) {
+      return err;
+    }
+  }
+  char *storage = freeList_.top();
+  freeList_.pop();
+  assert(isAligned(storage) && "Storage should be aligned");
+  oscompat::vm_name(storage, AlignedStorage::size(), name);
+  return static_cast<void *>(storage);
+}
+
+void HugePageStorageProvider::deleteStorage(void *storage) {
+  if (!storage) {
+    return;
+  }
+  freeList_.push(static_cast<char *>(storage));
+  // Storages cover whole huge pages, so this gives them back to the OS
+  // without splitting the huge pages of the storages around it.
+  oscompat::vm_unused(storage, AlignedStorage::size());
+  oscompat::vm_name(storage, AlignedStorage::size(), "hermes-freelist");
+}
+
 } // namespace
 
 /* static */
@@ -216,6 +309,13 @@ std::unique_ptr<StorageProvider> StorageProvider::mallocProvider() {
   return std::unique_ptr<StorageProvider>(new MallocStorageProvider);
 }
 
+/* static */
+std::unique_ptr<StorageProvider> StorageProvider::hugePageProvider(
+    bool preferLocalNUMANode) {
+  return std::unique_ptr<StorageProvider>(new HugePageStorageProvider(
+      preferLocalNUMANode ? oscompat::numa_node_of_current_thread() : -1));
+}
+
 llvm::ErrorOr<std::pair<void *, size_t>>
 vmAllocateAllowLess(size_t sz, size_t minSz, size_t alignment) {
   assert(sz >= minSz && "Shouldn't supply a lower size than the minimum");
@@ -13,6 +13,7 @@
 #include "hermes/VM/CompleteMarkState-inline.h"
 #include "hermes/VM/CompleteMarkState.h"
 #include "hermes/VM/DeadRegion.h"
+#include "hermes/VM/FillerCell.h"
 #include "hermes/VM/GC.h"
 #include "hermes/VM/GCBase-inline.h"
 #include "hermes/VM/GCBase.h"
@@ -88,6 +89,16 @@ void AlignedHeapSegment::resetLevel() {
 template void AlignedHeapSegment::resetLevel<AdviseUnused::Yes>();
 template void AlignedHeapSegment::resetLevel<AdviseUnused::No>();
 
+void AlignedHeapSegment::markUnusedAboveLevel() {
+#ifdef NDEBUG
+  auto nextPageAfter = reinterpret_cast<char *>(llvm::alignTo(
+      reinterpret_cast<uintptr_t>(level_), oscompat::page_size()));
+  if (nextPageAfter < hiLim()) {
+    storage_.markUnused(nextPageAfter, hiLim());
+  }
+#endif
+}
+
 void AlignedHeapSegment::setEffectiveEnd(char *effectiveEnd) {
   assert(
       start() <= effectiveEnd && effectiveEnd <= end() &&
@@ -181,22 +192,18 @@ void AlignedHeapSegment::completeMarking(GC *gc, CompleteMarkState *markState) {
     GCCell *cell = reinterpret_cast<GCCell *>(ptr);
 
     markState->currentParPointer = cell;
-    if (cell->isVariableSize()) {
-      markState->varSizeMarkStack_.push_back(cell);
-    } else {
-      markState->markStack_.push_back(cell);
-    }
+    markState->pushCell(cell);
     markState->drainMarkStack(gc, acceptor);
 
     if (LLVM_UNLIKELY(markState->markStackOverflow_)) {
-      markState->markStack_.clear();
-      markState->varSizeMarkStack_.clear();
+      markState->clearMarkStacks();
       break;
     }
   }
 
   assert(markState->markStack_.empty());
   assert(markState->varSizeMarkStack_.empty());
+  assert(markState->largeCellMarkStack_.empty());
 }
 
 void AlignedHeapSegment::sweepAndInstallForwardingPointers(
@@ -349,6 +356,47 @@ void AlignedHeapSegment::compact(SweepResult::VTablesRemaining &vTables) {
   }
 }
 
+char *AlignedHeapSegment::sweepInPlace(
+    GC *gc,
+    bool fillTail,
+    llvm::function_ref<void(char *, char *)> onDead) {
+  CardTable &cards = cardTable();
+  const auto fill = [gc, &cards, onDead](char *start, char *end) {
+    // A run smaller than a FillerCell is a single cell without any fields,
+    // which can be left as it is.
+    if (static_cast<size_t>(end - start) >= sizeof(FillerCell)) {
+      new (start) FillerCell(gc, end - start);
+      CardTable::Boundary boundary = cards.nextBoundary(start);
+      if (boundary.address() < end) {
+        cards.updateBoundaries(&boundary, start, end);
+      }
+    }
+    onDead(start, end);
+  };
+
+  char *liveEnd = start();
+  forMarkedObjs([&fill, &liveEnd](GCCell *cell) {
+    char *ptr = reinterpret_cast<char *>(cell);
+    if (ptr != liveEnd) {
+      fill(liveEnd, ptr);
+    }
+    liveEnd = ptr + cell->getAllocatedSize();
+  });
+  if (fillTail && liveEnd < level()) {
+    fill(liveEnd, level());
+  }
+  return liveEnd;
+}
+
+bool AlignedHeapSegment::hasMarkedCells() const {
+  if (used() == 0) {
+    return false;
+  }
+  MarkBitArrayNC &markBits = markBitArray();
+  return markBits.findNextMarkedBitFrom(markBits.addressToIndex(start())) <=
+      markBits.addressToIndex(level() - 1);
+}
+
 size_t AlignedHeapSegment::countMallocSize() const {
   size_t sum = 0;
   for (char *ptr = start(); ptr < level();) {
@@ -8,6 +8,9 @@
 #include "hermes/VM/CompleteMarkState-inline.h"
 #include "hermes/VM/GCBase-inline.h"
 #include "hermes/VM/GCBase.h"
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+#include "hermes/VM/LargeObjectSpace.h"
+#endif
 
 namespace hermes {
 namespace vm {
@@ -110,23 +113,62 @@ void CompleteMarkState::markTransitive(void *ptr) {
   // wouldn't make it past the earlier check for a false value if the
   // indices were equal.
   if (ptr < reinterpret_cast<void *>(currentParPointer)) {
-    GCCell *cell = reinterpret_cast<GCCell *>(ptr);
-    // Push cell to the correct mark stack.
-    std::vector<GCCell *> *stack =
-        (cell->isVariableSize() ? &varSizeMarkStack_ : &markStack_);
-    if (stack->size() == kMarkStackLimit) {
+    pushCell(reinterpret_cast<GCCell *>(ptr));
+  }
+}
+
+void CompleteMarkState::pushCell(GCCell *cell) {
+  if (!cell->isVariableSize()) {
+    if (markStack_.size() == kMarkStackLimit) {
       markStackOverflow_ = true;
-    } else {
-      stack->push_back(cell);
-      numPtrsPushedByParent++;
+      return;
     }
+    markStack_.push_back(cell);
+  } else if (cell->getAllocatedSize() >= LargeObjectSpace::kMinCellSize) {
+    largeCellMarkStack_.push_back(
+        {cell, reinterpret_cast<const char *>(cell)});
+  } else {
+    if (varSizeMarkStack_.size() == kMarkStackLimit) {
+      markStackOverflow_ = true;
+      return;
+    }
+    varSizeMarkStack_.push_back(cell);
   }
+  numPtrsPushedByParent++;
+}
+
+void CompleteMarkState::clearMarkStacks() {
+  markStack_.clear();
+  varSizeMarkStack_.clear();
+  largeCellMarkStack_.clear();
 }
 
 void CompleteMarkState::drainMarkStack(
     GC *gc,
     FullMSCMarkTransitiveAcceptor &acceptor) {
-  while (!markStack_.empty() || !varSizeMarkStack_.empty()) {
+  while (!markStack_.empty() || !varSizeMarkStack_.empty() ||
+         !largeCellMarkStack_.empty()) {
+    if (markStack_.empty() && varSizeMarkStack_.empty()) {
+      // Scan the next slice of the large cell on top of its stack.
+      LargeCellCursor &top = largeCellMarkStack_.back();
+      GCCell *cell = top.cell;
+      const char *begin = top.next;
+      const char *end =
+          reinterpret_cast<const char *>(cell) + cell->getAllocatedSize();
+      if (static_cast<size_t>(end - begin) > kLargeCellSliceSize) {
+        end = begin + kLargeCellSliceSize;
+        top.next = end;
+      } else {
+        // Pop it before marking, which may push another large cell.
+        largeCellMarkStack_.pop_back();
+      }
+      markingVarSizeCell = false;
+      SlotVisitor<FullMSCMarkTransitiveAcceptor> visitor(acceptor);
+      GCBase::markCellWithinRange(
+          visitor, cell, cell->getVT(), gc, begin, end);
+      continue;
+    }
+
     GCCell *cell;
     if (markStack_.size() >= varSizeMarkStack_.size()) {
       cell = markStack_.back();
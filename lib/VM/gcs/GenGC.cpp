@@ -13,6 +13,7 @@
 #include "hermes/VM/AllocSource.h"
 #include "hermes/VM/Casting.h"
 #include "hermes/VM/CheckHeapWellFormedAcceptor.h"
+#include "hermes/VM/CompleteMarkState-inline.h"
 #include "hermes/VM/GCBase-inline.h"
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/HeapSnapshot.h"
@@ -178,6 +179,29 @@ void GenGC::finalizeAll() {
   oldGen_.finalizeUnreachableObjects(this, &markBits_);
 }
 
+size_t GenGC::collectWhileIdle(TimePoint deadline) {
+  if (!expectedToCompleteBy(
+          fullCollectionCumStats_, deadline, /* ifUnknown */ false)) {
+    return 0;
+  }
+  const size_t usedBefore = used();
+  collect();
+  const size_t usedAfter = used();
+  return usedBefore > usedAfter ? usedBefore - usedAfter : 0;
+}
+
+size_t GenGC::handleMemoryPressure(MemoryPressureLevel) {
+  const size_t usedBefore = used();
+  collect();
+  const size_t usedAfter = used();
+  return usedBefore > usedAfter ? usedBefore - usedAfter : 0;
+}
+
+void GenGC::forAllObjs(const std::function<void(GCCell *)> &callback) {
+  youngGen_.forAllObjs(callback);
+  oldGen_.forAllObjs(callback);
+}
+
 void GenGC::collect() {
   PerfSection fullGCSystraceRegion("Full collection");
   auto wallStart = steady_clock::now();
@@ -428,6 +452,7 @@ void GenGC::markPhase() {
   FullMSCMarkInitialAcceptor acceptor(*this);
   DroppingAcceptor<FullMSCMarkInitialAcceptor> nameAcceptor{acceptor};
   markBits_.clear();
+  beginEphemeronMarking();
 
 #ifdef HERMES_SLOW_DEBUG
   {
@@ -449,6 +474,7 @@ void GenGC::markPhase() {
   {
     PerfSection fullGCCompleteMarkingSystraceRegion("fullGCCompleteMarking");
     completeMarking();
+    completeEphemeronMarking();
   }
   auto completeMarkingEnd = steady_clock::now();
   markRootsSecs_ +=
@@ -474,6 +500,31 @@ void GenGC::completeMarking() {
   }
 }
 
+void GenGC::completeEphemeronMarking() {
+  CompleteMarkState::FullMSCMarkTransitiveAcceptor acceptor(
+      *this, &markBits_, &markState_);
+  const auto isMarked = [this](GCCell *cell) {
+    return markBits_.at(markBits_.addressToIndex(cell));
+  };
+  const auto markValue = [this, &acceptor](HermesValue &value) {
+    // There is no scan in address order left to pick up the cells above the
+    // finger, so push everything.
+    markState_.currentParPointer = reinterpret_cast<GCCell *>(UINTPTR_MAX);
+    markState_.markingVarSizeCell = false;
+    acceptor.accept(value);
+    markState_.drainMarkStack(this, &markBits_, acceptor);
+    if (LLVM_UNLIKELY(markState_.markStackOverflow_)) {
+      // Some marked cells were not scanned: rescan all of them.
+      markState_.markStack_.clear();
+      markState_.varSizeMarkStack_.clear();
+      completeMarking();
+    }
+  };
+  while (markEphemeronValues(isMarked, markValue)) {
+  }
+  clearUnreachableEphemerons(isMarked, [](HermesValue &) {});
+}
+
 std::vector<SweepResult> GenGC::sweepAndInstallForwardingPointers() {
   auto sweepStart = steady_clock::now();
   // The sweep results for the generations, to be filled in.
@@ -22,6 +22,7 @@
 #include "hermes/VM/GCBase-inline.h"
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/HeapSnapshot.h"
+#include "hermes/VM/HiddenClass.h"
 #include "hermes/VM/HermesValue-inline.h"
 #include "hermes/VM/SnapshotAcceptor.h"
 #include "hermes/VM/SnapshotEdgeAcceptor.h"
@@ -99,8 +100,10 @@ GenGC::GenGC(
           this,
           generationSizes_.oldGenSize(),
           gcConfig.getShouldReleaseUnused()),
+      largeObjects_(gcConfig.getMaxHeapSize()),
       allocContextFromYG_(gcConfig.getAllocInYoung()),
       revertToYGAtTTI_(gcConfig.getRevertToYGAtTTI()),
+      oldGenMarkRegion_(gcConfig.getOldGenMarkRegion()),
       oomThreshold_(gcConfig.getEffectiveOOMThreshold()),
       weightedUsed_(static_cast<double>(gcConfig.getInitHeapSize())) {
   growTo(gcConfig.getInitHeapSize());
@@ -311,28 +314,49 @@ void GenGC::collect(bool canEffectiveOOM) {
 
     finalizeUnreachableObjects();
 
-    auto ygExtMem = youngGen_.externalMemory();
-    auto ogExtMem = oldGen_.externalMemory();
+    lastFullCollectionInPlace_ = oldGenMarkRegion_ && !forceCompaction_ &&
+        sweepOldGenInPlace();
+    fullCollection.addArg(
+        "fullGCInPlace", static_cast<size_t>(lastFullCollectionInPlace_));
 
-    // TODO (T37170733) Treat external charge like any other allocation.
-    // Remove external charge for the duration of collection.
-    youngGen_.debitExternalMemory(ygExtMem);
-    oldGen_.debitExternalMemory(ogExtMem);
+    unsigned numAllocatedObjectsBefore;
+    if (lastFullCollectionInPlace_) {
+      numAllocatedObjectsBefore = evacuateYoungGenAfterInPlaceSweep();
+    } else {
+      oldGen_.clearHoles();
+
+      auto ygExtMem = youngGen_.externalMemory();
+      auto ogExtMem = oldGen_.externalMemory();
+
+      // TODO (T37170733) Treat external charge like any other allocation.
+      // Remove external charge for the duration of collection.
+      youngGen_.debitExternalMemory(ygExtMem);
+      oldGen_.debitExternalMemory(ogExtMem);
 
-    // The sweep results for the generations, to be filled in.
-    SweepResult sweepResult({oldGen_.allSegments(), youngGen_.allSegments()});
+      // The sweep results for the generations, to be filled in.
+      SweepResult sweepResult(
+          {oldGen_.allSegments(), youngGen_.allSegments()});
 
-    sweepAndInstallForwardingPointers(&sweepResult);
-    updateReferences(sweepResult);
+      sweepAndInstallForwardingPointers(&sweepResult);
+      updateReferences(sweepResult);
 
-    // Re-instate the external charge.
-    youngGen_.creditExternalMemory(ygExtMem);
-    oldGen_.creditExternalMemory(ogExtMem);
+      // Re-instate the external charge.
+      youngGen_.creditExternalMemory(ygExtMem);
+      oldGen_.creditExternalMemory(ogExtMem);
 
-    compact(sweepResult);
+      compact(sweepResult);
 
-    oldGen_.updateCardTablesAfterCompaction(
-        /* youngGenIsEmpty */ youngGen_.usedDirect() == 0);
+      oldGen_.updateCardTablesAfterCompaction(
+          /* youngGenIsEmpty */ youngGen_.usedDirect() == 0);
+      // The dirty cards of the large objects are kept while the young gen may
+      // still hold objects they point to.
+      if (youngGen_.usedDirect() == 0) {
+        largeObjects_.clearCards();
+      }
+
+      // Update the statistics.
+      numAllocatedObjectsBefore = recordStatsNC(sweepResult.compactionResult);
+    }
 
     gcCallbacks_->freeSymbols(markedSymbols_);
 
@@ -353,10 +377,6 @@ void GenGC::collect(bool canEffectiveOOM) {
     sizeAfter = sizeDirect();
     cumPostBytes_ += usedAfter;
 
-    // Update the statistics.
-    const unsigned numAllocatedObjectsBefore =
-        recordStatsNC(sweepResult.compactionResult);
-
     fullCollection.recordGCStats(sizeDirect(), &fullCollectionCumStats_);
 
     fullCollection.addArg("fullGCUsedAfter", usedAfter);
@@ -372,6 +392,68 @@ void GenGC::collect(bool canEffectiveOOM) {
 #endif
 }
 
+size_t GenGC::collectWhileIdle(TimePoint deadline) {
+  AllocContextYieldThenClaim yielder(this);
+  const auto freeSpace = [this]() {
+    const size_t used = usedDirect();
+    const size_t size = sizeDirect();
+    return used < size ? size - used : 0;
+  };
+  const size_t freeBefore = freeSpace();
+
+  // A young-gen collection is bounded by the size of the young gen, so it is
+  // attempted even before its duration is known.  It is skipped if it could
+  // require a full collection, which is only done below if it fits.  Only the
+  // old gen's capacity is queried here: ensureFits() would allocate segments,
+  // which is left to the collection itself.
+  if (allocContextFromYG_ && youngGen_.usedDirect() > 0 &&
+      youngGen_.usedDirect() <= oldGen_.available() &&
+      expectedToCompleteBy(
+          youngGenCollectionCumStats_, deadline, /* ifUnknown */ true)) {
+    youngGen_.collect();
+  }
+
+  // A full collection is worth doing now if the next young-gen collection
+  // would otherwise have to start with one.
+  if (youngGen_.sizeDirect() > oldGen_.available() &&
+      expectedToCompleteBy(
+          fullCollectionCumStats_, deadline, /* ifUnknown */ false)) {
+    collect();
+  }
+
+  const size_t freeAfter = freeSpace();
+  return freeAfter > freeBefore ? freeAfter - freeBefore : 0;
+}
+
+size_t GenGC::handleMemoryPressure(MemoryPressureLevel level) {
+  AllocContextYieldThenClaim yielder(this);
+  const size_t usedBefore = usedDirect();
+
+  // Compacting gathers the free space of the old gen after its level, where
+  // it can be returned to the OS.
+  forceCompaction_ = true;
+  collect();
+  forceCompaction_ = false;
+
+  // The heap can only shrink below the young gen's level when it is empty,
+  // which is the common case after a full collection.  It grows back as the
+  // live data does.
+  if (level == MemoryPressureLevel::Critical && youngGen_.usedDirect() == 0) {
+    weightedUsed_ = std::min(weightedUsed_, static_cast<double>(usedDirect()));
+    shrinkTo(usedDirect());
+  }
+
+  const size_t usedAfter = usedDirect();
+  size_t freed = usedBefore > usedAfter ? usedBefore - usedAfter : 0;
+  freed += oldGen_.releaseSegmentCache();
+  const auto markUnused = [](AlignedHeapSegment &segment) {
+    segment.markUnusedAboveLevel();
+  };
+  youngGen_.forUsedSegments(markUnused);
+  oldGen_.forUsedSegments(markUnused);
+  return freed;
+}
+
 unsigned GenGC::recordStatsNC(const CompactionResult &compactionResult) {
 #ifndef NDEBUG
   // Report current status to the GCBase variables.
@@ -412,17 +494,26 @@ void GenGC::checkInvariants(
 
 #ifndef NDEBUG
 bool GenGC::dbgContains(const void *ptr) const {
+  if (largeObjects_.contains(ptr)) {
+    return true;
+  }
   AlignedHeapSegment *segment = segmentIndex_.segmentCovering(ptr);
   assert(!segment || segment->contains(ptr));
   return segment;
 }
 
 bool GenGC::validPointer(const void *ptr) const {
+  if (largeObjects_.contains(ptr)) {
+    return largeObjects_.validPointer(ptr);
+  }
   AlignedHeapSegment *segment = segmentIndex_.segmentCovering(ptr);
   return segment && segment->validPointer(ptr);
 }
 
 bool GenGC::isMostRecentFinalizableObj(const GCCell *cell) const {
+  if (largeObjects_.contains(cell)) {
+    return largeObjects_.isMostRecentFinalizableObj(cell);
+  }
   if (GCBase::isMostRecentCellInFinalizerVector(
           allocContext_.cellsWithFinalizers, cell)) {
     return true;
@@ -511,6 +602,7 @@ void GenGC::markPhase() {
   FullMSCMarkInitialAcceptor acceptor(*this);
   DroppingAcceptor<FullMSCMarkInitialAcceptor> nameAcceptor{acceptor};
   clearMarkBits();
+  beginEphemeronMarking();
 
 #ifdef HERMES_SLOW_DEBUG
   {
@@ -532,6 +624,7 @@ void GenGC::markPhase() {
   {
     PerfSection fullGCCompleteMarkingSystraceRegion("fullGCCompleteMarking");
     completeMarking();
+    completeEphemeronMarking();
   }
   auto completeMarkingEnd = steady_clock::now();
   markRootsSecs_ +=
@@ -544,6 +637,7 @@ void GenGC::clearMarkBits() {
   for (auto segment : segmentIndex_) {
     segment->markBitArray().clear();
   }
+  largeObjects_.clearMarkBits();
 }
 
 void GenGC::completeMarking() {
@@ -554,17 +648,53 @@ void GenGC::completeMarking() {
   // marking process is guaranteed to terminate.
   do {
     markState_.markStackOverflow_ = false;
+    // The large objects are visited in address order along with the segments,
+    // since the marking of an object depends on whether it is above the one
+    // being visited.
+    size_t nextLarge = 0;
     for (auto *segment : segmentIndex_) {
+      nextLarge = largeObjects_.completeMarking(
+          this, &markState_, nextLarge, segment->lowLim());
+      if (markState_.markStackOverflow_)
+        break;
       segment->completeMarking(this, &markState_);
       if (markState_.markStackOverflow_)
         break;
     }
+    if (!markState_.markStackOverflow_) {
+      largeObjects_.completeMarking(this, &markState_, nextLarge, nullptr);
+    }
   } while (markState_.markStackOverflow_);
 }
 
+void GenGC::completeEphemeronMarking() {
+  CompleteMarkState::FullMSCMarkTransitiveAcceptor acceptor(*this, &markState_);
+  const auto isMarked = [](GCCell *cell) {
+    return AlignedHeapSegment::getCellMarkBit(cell);
+  };
+  const auto markValue = [this, &acceptor](HermesValue &value) {
+    // There is no scan in address order left to pick up the cells above the
+    // finger, so push everything.
+    markState_.currentParPointer = reinterpret_cast<GCCell *>(UINTPTR_MAX);
+    markState_.markingVarSizeCell = false;
+    acceptor.accept(value);
+    markState_.drainMarkStack(this, acceptor);
+    if (LLVM_UNLIKELY(markState_.markStackOverflow_)) {
+      // Some marked cells were not scanned: rescan all of them.
+      markState_.clearMarkStacks();
+      completeMarking();
+    }
+  };
+  while (markEphemeronValues(isMarked, markValue)) {
+  }
+  clearUnreachableEphemerons(isMarked, [](HermesValue &) {});
+}
+
 void GenGC::finalizeUnreachableObjects() {
   youngGen_.finalizeUnreachableObjects();
   oldGen_.finalizeUnreachableObjects();
+  // Large objects are charged to the old gen.
+  oldGen_.debitExternalMemory(largeObjects_.finalizeUnreachableObjects(this));
 }
 
 void GenGC::sweepAndInstallForwardingPointers(SweepResult *sweepResult) {
@@ -574,6 +704,7 @@ void GenGC::sweepAndInstallForwardingPointers(SweepResult *sweepResult) {
 
   oldGen_.sweepAndInstallForwardingPointers(this, sweepResult);
   youngGen_.sweepAndInstallForwardingPointers(this, sweepResult);
+  largeObjects_.installForwardingPointers();
 
   sweepSecs_ += GCBase::clockDiffSeconds(sweepStart, steady_clock::now());
 }
@@ -600,6 +731,7 @@ void GenGC::updateReferences(const SweepResult &sweepResult) {
   // pointers.
   oldGen_.updateReferences(this, vTables);
   youngGen_.updateReferences(this, vTables);
+  largeObjects_.updateReferences(this, *acceptor);
 
   updateWeakReferences(/*fullGC*/ true);
   updateReferencesSecs_ +=
@@ -634,13 +766,18 @@ void GenGC::compact(const SweepResult &sweepResult) {
   oldGen_.recordLevelAfterCompaction(chunks);
   youngGen_.recordLevelAfterCompaction(chunks);
 
+  // Large objects are not moved.
+  largeObjects_.restoreVTables();
+
   assert(!vTables.hasNext() && "Not all vtable pointers replaced.");
   assert(!chunks.hasNext() && "Not all chunks written back to their segments.");
 
   youngGen_.compactFinalizableObjectList();
 
   assert(youngGen_.extSizeFromFinalizerList() == youngGen_.externalMemory());
-  assert(oldGen_.extSizeFromFinalizerList() == oldGen_.externalMemory());
+  assert(
+      oldGen_.extSizeFromFinalizerList() + largeObjects_.used() ==
+      oldGen_.externalMemory());
 
   // At this point, finalizers have been run, and any unreachable objects with
   // external memory charges have had those charges adjusted.  So the
@@ -652,6 +789,128 @@ void GenGC::compact(const SweepResult &sweepResult) {
   compactSecs_ += GCBase::clockDiffSeconds(compactStart, steady_clock::now());
 }
 
+bool GenGC::sweepOldGenInPlace() {
+  // The holes could not be scanned without the card object boundaries, which
+  // are not maintained while allocating directly in the old gen.
+  if (!allocContextFromYG_) {
+    return false;
+  }
+  auto sweepStart = steady_clock::now();
+  PerfSection fullGCSweepInPlaceSystraceRegion("fullGCSweepInPlace");
+
+  const OldGen::InPlaceSweepResult swept = oldGen_.sweepInPlace(this);
+  size_t youngLiveBytes = 0;
+  youngGen_.forUsedSegments([&youngLiveBytes](AlignedHeapSegment &segment) {
+    segment.forMarkedObjs([&youngLiveBytes](GCCell *cell) {
+      youngLiveBytes += cell->getAllocatedSize();
+    });
+  });
+
+  const bool inPlace =
+      swept.deadBytes <=
+          (swept.liveBytes + swept.deadBytes) * kMaxInPlaceDeadFraction &&
+      oldGen_.ensureFits(youngLiveBytes);
+  if (!inPlace) {
+    // The live cells are compacted, FillerCells and all.
+    oldGen_.clearHoles();
+  }
+  sweepSecs_ += GCBase::clockDiffSeconds(sweepStart, steady_clock::now());
+  return inPlace;
+}
+
+unsigned GenGC::evacuateYoungGenAfterInPlaceSweep() {
+  auto evacuateStart = steady_clock::now();
+  PerfSection fullGCEvacuateYoungSystraceRegion("fullGCEvacuateYoung");
+  numInPlaceCollections_++;
+
+#ifndef NDEBUG
+  // The reachable cells of the young gen are counted as they are evacuated.
+  oldGen_.forUsedSegments([this](AlignedHeapSegment &segment) {
+    segment.forMarkedObjs([this](GCCell *cell) {
+      oldGen_.incNumReachableObjects();
+      if (auto *hiddenClass = dyn_vmcast<HiddenClass>(cell)) {
+        oldGen_.incNumHiddenClasses();
+        oldGen_.incNumLeafHiddenClasses(hiddenClass->isKnownLeaf());
+      }
+      trackReachable(cell->getKind(), cell->getAllocatedSize());
+    });
+  });
+  youngGen_.forUsedSegments([this](AlignedHeapSegment &segment) {
+    segment.forMarkedObjs([this](GCCell *cell) {
+      trackReachable(cell->getKind(), cell->getAllocatedSize());
+    });
+  });
+  const unsigned numAllocatedObjectsBefore = computeNumAllocatedObjects();
+  // Evacuating the young gen resets its count of finalized objects.
+  const unsigned numFinalizedObjects = computeNumFinalizedObjects();
+#endif
+
+  // The references to dead cells must be cleared before their space is
+  // reused.
+  updateWeakReferencesInPlace();
+  struct ClearDeadWeakRootsAcceptor final : public SlotAcceptorDefault {
+    using SlotAcceptorDefault::accept;
+    using SlotAcceptorDefault::SlotAcceptorDefault;
+    void accept(void *&ptr) override {
+      if (ptr &&
+          !AlignedHeapSegment::getCellMarkBit(static_cast<GCCell *>(ptr))) {
+        ptr = nullptr;
+      }
+    }
+    void accept(HermesValue &hv) override {
+      if (!hv.isPointer()) {
+        return;
+      }
+      void *ptr = hv.getPointer();
+      accept(ptr);
+      hv.setInGC(hv.updatePointer(ptr), &gc);
+    }
+  };
+  ClearDeadWeakRootsAcceptor weakAcceptor(*this);
+  DroppingAcceptor<SlotAcceptor> nameWeakAcceptor{weakAcceptor};
+  markWeakRoots(nameWeakAcceptor);
+
+  // The young gen is evacuated like in a young-gen collection, which finds
+  // the cells that are still reachable, in holes of the old gen or at its
+  // level.
+  youngGen_.evacuate();
+  oldGen_.updateCardTablesAfterCompaction(/* youngGenIsEmpty */ true);
+  largeObjects_.clearCards();
+  oldGen_.updateEffectiveEndForExternalMemory();
+
+#ifndef NDEBUG
+  recordNumReachableObjects(computeNumReachableObjects());
+  recordNumHiddenClasses(
+      computeNumHiddenClasses(), computeNumLeafHiddenClasses());
+  recordNumCollectedObjects(numAllocatedObjectsBefore - numReachableObjects_);
+  recordNumFinalizedObjects(
+      numFinalizedObjects + youngGen_.numFinalizedObjects());
+
+  // All the reachable objects are now in the old gen.
+  youngGen_.resetNumAllocatedObjects();
+  oldGen_.resetNumAllocatedObjects();
+  oldGen_.incNumAllocatedObjects(numReachableObjects_);
+#endif
+
+  evacuateYoungSecs_ +=
+      GCBase::clockDiffSeconds(evacuateStart, steady_clock::now());
+#ifndef NDEBUG
+  return numAllocatedObjectsBefore;
+#else
+  return 0;
+#endif
+}
+
+bool GenGC::compactAfterInPlaceCollection() {
+  if (!lastFullCollectionInPlace_) {
+    return false;
+  }
+  forceCompaction_ = true;
+  collect();
+  forceCompaction_ = false;
+  return true;
+}
+
 void GenGC::markSymbol(SymbolID symbolID) {
   if (LLVM_UNLIKELY(symbolID.isInvalid()))
     return;
@@ -688,6 +947,7 @@ void GenGC::checkWellFormedHeap() const {
   gc->markRoots(nameAcceptor, /*markLongLived*/ true);
   youngGen_.checkWellFormed(gc);
   oldGen_.checkWellFormed(gc);
+  largeObjects_.checkWellFormed(gc);
 }
 #endif
 
@@ -813,6 +1073,15 @@ void GenGC::updateWeakReferences(bool fullGC) {
       updateWeakReference(slotPtr, fullGC); // fullGC is false.
     }
   }
+  filterWeakRefSlotsWithPossibleYoungReferent();
+
+  if (fullGC) {
+    // For now, we only free slots during full GC.
+    shrinkWeakSlots();
+  }
+}
+
+void GenGC::filterWeakRefSlotsWithPossibleYoungReferent() {
   // This loop "filters" weakRefSlotsWithPossibleYoungReferent_, removing
   // any entries whose  values are not pointers into the young gen.
   // The "retainedIndex" variable counts the number of such entries below the
@@ -832,11 +1101,30 @@ void GenGC::updateWeakReferences(bool fullGC) {
   }
   weakRefSlotsWithPossibleYoungReferent_.resize(retainedIndex);
   weakRefSlotsWithPossibleYoungReferent_.shrink_to_fit();
+}
 
-  if (fullGC) {
-    // For now, we only free slots during full GC.
-    shrinkWeakSlots();
+void GenGC::updateWeakReferencesInPlace() {
+  for (auto &slot : weakSlots_) {
+    // Skip free slots.
+    if (slot.extra == WeakSlotState::Free) {
+      continue;
+    }
+    // A slot which is no longer reachable. Add it to the free list.
+    if (slot.extra == WeakSlotState::Unmarked) {
+      freeWeakSlot(&slot);
+      continue;
+    }
+    assert(slot.extra == WeakSlotState::Marked && "invalid marked slot state");
+    slot.extra = WeakSlotState::Unmarked;
+
+    if (slot.value.isPointer() &&
+        !AlignedHeapSegment::getCellMarkBit(
+            static_cast<GCCell *>(slot.value.getPointer()))) {
+      slot.value = HermesValue::encodeEmptyValue();
+    }
   }
+  filterWeakRefSlotsWithPossibleYoungReferent();
+  shrinkWeakSlots();
 }
 
 WeakRefSlot *GenGC::allocWeakSlot(HermesValue init) {
@@ -910,6 +1198,7 @@ void GenGC::updateHeapSize() {
 void GenGC::forAllObjs(const std::function<void(GCCell *)> &callback) {
   youngGen_.forAllObjs(callback);
   oldGen_.forAllObjs(callback);
+  largeObjects_.forAllObjs(callback);
 }
 
 #ifndef NDEBUG
@@ -978,19 +1267,29 @@ bool GenGC::needsWriteBarrier(void *loc, void *value) {
 #endif
 
 LLVM_ATTRIBUTE_NOINLINE
-void GenGC::writeBarrier(void *loc, HermesValue value) {
-  countWriteBarrier(/*hv*/ true, kNumWriteBarrierTotalCountIdx);
-  if (!value.isPointer()) {
+void GenGC::writeBarrierImpl(void *loc, void *value, bool hv) {
+  HERMES_SLOW_ASSERT(dbgContains(loc));
+  assert(!youngGen_.contains(loc) && "Stores into the YG need no barrier");
+
+  char *locPtr = reinterpret_cast<char *>(loc);
+
+  // value may be null.  But if that occurs: locPtr and value will not
+  // be in the same AlignedStorage, so the first test below will fail,
+  // and we will not return early.  But youngGen_.contains(value) will
+  // fail, so we will (correctly) not dirty the card for loc.
+  HERMES_SLOW_ASSERT(value == nullptr || dbgContains(value));
+  if (AlignedStorage::containedInSame(locPtr, value)) {
     return;
   }
-  countWriteBarrier(/*hv*/ true, kNumWriteBarrierOfObjectPtrIdx);
-  writeBarrierImpl(loc, value.getPointer(), /*hv*/ true);
-}
-
-LLVM_ATTRIBUTE_NOINLINE
-void GenGC::writeBarrier(void *loc, void *value) {
-  countWriteBarrier(/*hv*/ false, kNumWriteBarrierTotalCountIdx);
-  writeBarrierImpl(loc, value, /*hv*/ false);
+  countWriteBarrier(hv, kNumWriteBarrierWithDifferentSegsIdx);
+  if (youngGen_.contains(value)) {
+    countWriteBarrier(hv, kNumWriteBarrierPtrInYGIdx);
+    if (LLVM_UNLIKELY(largeObjects_.contains(locPtr))) {
+      largeObjects_.dirtyCardForAddress(locPtr);
+      return;
+    }
+    AlignedHeapSegment::cardTableCovering(locPtr)->dirtyCardForAddress(locPtr);
+  }
 }
 
 void GenGC::writeBarrierRange(HermesValue *start, uint32_t numHVs) {
@@ -999,13 +1298,21 @@ void GenGC::writeBarrierRange(HermesValue *start, uint32_t numHVs) {
   // For now, in this case, we'll just dirty the cards in the range.  We could
   // look at the copied contents, or change the interface to take the "from"
   // range, and dirty the cards if the from range has any dirty cards.  But just
-  // dirtying the cards will probably be fine.  We could also check to make sure
-  // that the range to dirty is not in the young generation, but expect that in
-  // most cases the cost of the check will be similar to the cost of dirtying
-  // those addresses.
+  // dirtying the cards will probably be fine.  Ranges in the young generation
+  // are skipped: most copies go into freshly allocated storage, and the check
+  // is cheaper than dirtying the cards of a long range.
   char *firstPtr = reinterpret_cast<char *>(start);
   char *lastPtr = reinterpret_cast<char *>(start + numHVs) - 1;
 
+  if (youngGen_.contains(firstPtr)) {
+    return;
+  }
+
+  if (LLVM_UNLIKELY(largeObjects_.contains(firstPtr))) {
+    largeObjects_.dirtyCardsForAddressRange(firstPtr, lastPtr);
+    return;
+  }
+
   assert(
       AlignedStorage::start(firstPtr) == AlignedStorage::start(lastPtr) &&
       "Range should be contained in the same segment");
@@ -1027,14 +1334,20 @@ void GenGC::writeBarrierRangeFill(
   char *lastPtr = reinterpret_cast<char *>(start + numHVs) - 1;
   char *valuePtr = reinterpret_cast<char *>(value.getPointer());
 
+  if (youngGen_.contains(firstPtr) || !youngGen_.contains(valuePtr)) {
+    return;
+  }
+  if (LLVM_UNLIKELY(largeObjects_.contains(firstPtr))) {
+    largeObjects_.dirtyCardsForAddressRange(firstPtr, lastPtr);
+    return;
+  }
+
   assert(
       AlignedStorage::start(firstPtr) == AlignedStorage::start(lastPtr) &&
       "Range should be contained in the same segment");
 
-  if (youngGen_.contains(valuePtr)) {
-    AlignedHeapSegment::cardTableCovering(firstPtr)->dirtyCardsForAddressRange(
-        firstPtr, lastPtr);
-  }
+  AlignedHeapSegment::cardTableCovering(firstPtr)->dirtyCardsForAddressRange(
+      firstPtr, lastPtr);
 }
 
 void GenGC::getHeapInfo(HeapInfo &info) {
@@ -1043,7 +1356,8 @@ void GenGC::getHeapInfo(HeapInfo &info) {
   info.allocatedBytes = usedDirect();
   info.heapSize = sizeDirect();
   info.totalAllocatedBytes = totalAllocatedBytes_ + bytesAllocatedSinceLastGC();
-  info.va = segmentIndex_.size() * AlignedStorage::size();
+  info.va =
+      segmentIndex_.size() * AlignedStorage::size() + largeObjects_.size();
   info.fullStats = fullCollectionCumStats_;
   info.youngGenStats = youngGenCollectionCumStats_;
 }
@@ -1056,10 +1370,12 @@ void GenGC::getHeapInfoWithMallocSize(HeapInfo &info) {
   // First add the usage by the runtime's roots.
   info.mallocSizeEstimate += gcCallbacks_->mallocSize();
 
-  // Then add the contributions from all segments.
+  // Then add the contributions from all segments, which must be walkable.
+  oldGen_.sealHole();
   for (auto *segment : segmentIndex_) {
     info.mallocSizeEstimate += segment->countMallocSize();
   }
+  info.mallocSizeEstimate += largeObjects_.countMallocSize();
 
   // Assume that the vector implementation doesn't use a separate bool for each
   // bool, but groups them together as bits.
@@ -1097,6 +1413,8 @@ void GenGC::dump(llvm::raw_ostream &os, bool verbose) {
      << "\n"
      << "   HV:    " << numWriteBarriers_[true][kNumWriteBarrierTotalCountIdx]
      << "\n"
+     << "      Loc outside YG:       "
+     << numWriteBarriers_[true][kNumWriteBarrierLocOutsideYGIdx] << "\n"
      << "      Value is obj ptr:     "
      << numWriteBarriers_[true][kNumWriteBarrierOfObjectPtrIdx] << "\n"
      << "      Val/loc in diff segs: "
@@ -1105,6 +1423,8 @@ void GenGC::dump(llvm::raw_ostream &os, bool verbose) {
      << numWriteBarriers_[true][kNumWriteBarrierPtrInYGIdx] << "\n"
      << "   void*: " << numWriteBarriers_[false][kNumWriteBarrierTotalCountIdx]
      << "\n"
+     << "      Loc outside YG:       "
+     << numWriteBarriers_[false][kNumWriteBarrierLocOutsideYGIdx] << "\n"
      << "      Val/loc in diff segs: "
      << numWriteBarriers_[false][kNumWriteBarrierWithDifferentSegsIdx] << "\n"
      << "      Value in YG:          "
@@ -1116,11 +1436,12 @@ void GenGC::dump(llvm::raw_ostream &os, bool verbose) {
 
 gcheapsize_t GenGC::bytesAllocatedSinceLastGC() const {
   return youngGen_.bytesAllocatedSinceLastGC() +
-      oldGen_.bytesAllocatedSinceLastGC();
+      oldGen_.bytesAllocatedSinceLastGC() + largeObjects_.bytesAllocated();
 }
 
 void GenGC::updateTotalAllocStats() {
   totalAllocatedBytes_ += bytesAllocatedSinceLastGC();
+  largeObjects_.resetBytesAllocated();
 }
 
 void GenGC::yieldAllocContext() {
@@ -1145,7 +1466,11 @@ void GenGC::claimAllocContext() {
   targetGen->setTrueAllocContext(&allocContext_);
 }
 
-void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
+template <typename Snapshot>
+void GenGC::writeSnapshotGraph(
+    Snapshot &snap,
+    const std::function<V8HeapSnapshot::StringID(llvm::StringRef)>
+        &stringToID) {
   // We need to yield/claim at outer scope, to cover the calls to
   // forUsedSegments below.
   AllocContextYieldThenClaim yielder(this);
@@ -1165,11 +1490,11 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
 
     youngGen_.forUsedSegments(registerSegment);
     oldGen_.forUsedSegments(registerSegment);
+    largeObjects_.forAllObjs(
+        [&segmentAddressToIndex, &segmentNum](GCCell *cell) {
+          segmentAddressToIndex[AlignedStorage::start(cell)] = segmentNum++;
+        });
   }
-  HeapInfo info;
-  getHeapInfo(info);
-  JSONEmitter json(os, !compact);
-  V8HeapSnapshot snap(json);
   auto ptrToOffset = [&segmentAddressToIndex](const void *ptr) -> uintptr_t {
     // Turn a pointer into the combo of its segment number, and its offset
     // within the segment.
@@ -1181,12 +1506,6 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
         AlignedStorage::offset(p);
   };
 
-  StringSetVector snapshotStringTable;
-  auto stringToID =
-      [&snapshotStringTable](llvm::StringRef str) -> V8HeapSnapshot::StringID {
-    str = llvm::StringRef::withNullAsEmpty(str.data());
-    return snapshotStringTable.insert(str);
-  };
   SnapshotNodeAcceptor snapshotNodeAcceptor(*this);
   SlotVisitorWithNames<SnapshotNodeAcceptor> nodeVisitor(snapshotNodeAcceptor);
 
@@ -1224,10 +1543,14 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
   });
   youngGen_.forAllObjs(writeNodesToSnapshot);
   oldGen_.forAllObjs(writeNodesToSnapshot);
+  largeObjects_.forAllObjs(writeNodesToSnapshot);
   snap.endNodes();
 
   SnapshotEdgeAcceptor snapshotEdgeAcceptor(
-      *this, snap, ptrToOffset, stringToID);
+      *this,
+      [&snap](V8HeapSnapshot::Edge &&edge) { snap.addEdge(std::move(edge)); },
+      ptrToOffset,
+      stringToID);
   SlotVisitorWithNames<SnapshotEdgeAcceptor> edgeVisitor(snapshotEdgeAcceptor);
 
   auto writeEdgesToSnapshot = [&edgeVisitor, this](const GCCell *cell) {
@@ -1239,8 +1562,26 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
   markRoots(snapshotEdgeAcceptor, true);
   youngGen_.forAllObjs(writeEdgesToSnapshot);
   oldGen_.forAllObjs(writeEdgesToSnapshot);
+  largeObjects_.forAllObjs(writeEdgesToSnapshot);
   snap.endEdges();
 
+#ifdef HERMES_SLOW_DEBUG
+  checkWellFormedHeap();
+#endif
+}
+
+void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
+  JSONEmitter json(os, !compact);
+  V8HeapSnapshot snap(json);
+
+  StringSetVector snapshotStringTable;
+  auto stringToID =
+      [&snapshotStringTable](llvm::StringRef str) -> V8HeapSnapshot::StringID {
+    str = llvm::StringRef::withNullAsEmpty(str.data());
+    return snapshotStringTable.insert(str);
+  };
+  writeSnapshotGraph(snap, stringToID);
+
   snap.beginTraceFunctionInfos();
   snap.endTraceFunctionInfos();
   snap.beginTraceTree();
@@ -1255,10 +1596,16 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
     snap.addString(str);
   }
   snap.endStrings();
+}
 
-#ifdef HERMES_SLOW_DEBUG
-  checkWellFormedHeap();
-#endif
+bool GenGC::createBinarySnapshot(llvm::raw_ostream &os) {
+  BinaryHeapSnapshot snap(os);
+  // The strings are written as they are first used, rather than gathered into
+  // a table, so that the memory used does not grow with the heap.
+  writeSnapshotGraph(snap, [&snap](llvm::StringRef str) {
+    return snap.addString(llvm::StringRef::withNullAsEmpty(str.data()));
+  });
+  return true;
 }
 
 void GenGC::printStats(llvm::raw_ostream &os, bool trailingComma) {
@@ -1330,6 +1677,8 @@ void GenGC::printFullCollectionStats(llvm::raw_ostream &os, bool trailingComma)
      << "\t\t\t\"fullSweepTime\": " << sweepSecs_ << ",\n"
      << "\t\t\t\"fullUpdateRefsTime\": " << updateReferencesSecs_ << ",\n"
      << "\t\t\t\"fullCompactTime\": " << compactSecs_ << ",\n"
+     << "\t\t\t\"fullEvacuateYoungTime\": " << evacuateYoungSecs_ << ",\n"
+     << "\t\t\t\"fullNumInPlace\": " << numInPlaceCollections_ << ",\n"
      << "\t\t\t\"fullSurvivalPct\": " << fullSurvivalPct;
 
   if (trailingComma) {
@@ -1345,6 +1694,9 @@ GenGC::CollectionSection::CollectionSection(GenGC *gc, const char *name)
       wallStart_(steady_clock::now()),
       cpuStart_(oscompat::thread_cpu_time()),
       yielder_(gc) {
+  // Allocations in a hole of the old gen leave the rest of it unparseable.
+  gc_->oldGen_.sealHole();
+
 #ifdef HERMES_SLOW_DEBUG
   gc_->checkWellFormedHeap();
 #endif
@@ -1948,5 +2300,29 @@ void *GenGC::allocSlow(uint32_t sz, bool fixedSize, HasFinalizer hasFinalizer) {
   return res.ptr;
 }
 
+void *GenGC::allocLarge(uint32_t sz, HasFinalizer hasFinalizer) {
+  AllocContextYieldThenClaim yielder(this);
+  // The cell is charged to the old gen, so collect first if it has no room
+  // for the cell, like an allocation in the old gen would.
+  if (oldGen_.available() < sz) {
+    collect(/* canEffectiveOOM */ true);
+  }
+  if (usedDirect() + sz > maxSize()) {
+    oom(make_error_code(OOMError::MaxHeapReached));
+  }
+  GCCell *cell = largeObjects_.alloc(sz, hasFinalizer);
+  if (LLVM_UNLIKELY(!cell)) {
+    // The range reserved for large objects may be full of garbage.
+    collect(/* canEffectiveOOM */ true);
+    cell = largeObjects_.alloc(sz, hasFinalizer);
+  }
+  if (LLVM_UNLIKELY(!cell)) {
+    // The range is full, or could not be reserved.
+    oom(make_error_code(OOMError::SuperSegmentAlloc));
+  }
+  oldGen_.creditExternalMemory(sz);
+  return cell;
+}
+
 } // namespace vm
 } // namespace hermes
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#define DEBUG_TYPE "gc"
+#include "hermes/VM/LargeObjectSpace.h"
+
+#include "hermes/Support/OSCompat.h"
+#ifdef HERMES_SLOW_DEBUG
+#include "hermes/VM/CheckHeapWellFormedAcceptor.h"
+#endif
+#include "hermes/VM/CompleteMarkState-inline.h"
+#include "hermes/VM/CompleteMarkState.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCBase-inline.h"
+
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <cstring>
+
+using llvm::dbgs;
+
+namespace hermes {
+namespace vm {
+
+LargeObjectSpace::LargeObjectSpace(size_t maxHeapSize)
+    // Cells use up to twice their size in chunks, and a chunk more for the
+    // space before the cell.
+    : reservationSize_(
+          llvm::alignTo(2 * maxHeapSize, AlignedStorage::size()) +
+          AlignedStorage::size()) {}
+
+LargeObjectSpace::~LargeObjectSpace() {
+  if (!lowLim_) {
+    return;
+  }
+  oscompat::vm_free(cards_, cardsSize_);
+  oscompat::vm_free_aligned(lowLim_, hiLim_ - lowLim_);
+}
+
+bool LargeObjectSpace::reserve() {
+  if (reservationFailed_) {
+    return false;
+  }
+  // The whole range may not be available, for instance in a 32-bit address
+  // space, so try smaller ones, down to a single chunk.
+  size_t size = reservationSize_;
+  while (true) {
+    auto result = oscompat::vm_allocate_aligned(size, AlignedStorage::size());
+    if (result) {
+      lowLim_ = static_cast<char *>(*result);
+      break;
+    }
+    if (size == AlignedStorage::size()) {
+      reservationFailed_ = true;
+      return false;
+    }
+    size = std::max<size_t>(
+        AlignedStorage::size(),
+        llvm::alignDown(size / 2, AlignedStorage::size()));
+  }
+  hiLim_ = lowLim_ + size;
+
+  cardsSize_ = llvm::alignTo(size >> kLogCardSize, oscompat::page_size());
+  auto cards = oscompat::vm_allocate(cardsSize_);
+  if (!cards) {
+    oscompat::vm_free_aligned(lowLim_, size);
+    lowLim_ = hiLim_ = nullptr;
+    reservationFailed_ = true;
+    return false;
+  }
+  cards_ = static_cast<uint8_t *>(*cards);
+
+  oscompat::vm_name(lowLim_, size, "hermes-large-objects");
+  usedChunks_.resize(size >> AlignedStorage::kLogSize, false);
+  LLVM_DEBUG(
+      dbgs() << "Reserved " << size << " bytes for large objects at "
+             << static_cast<void *>(lowLim_) << "\n");
+  return true;
+}
+
+GCCell *LargeObjectSpace::alloc(uint32_t size, HasFinalizer hasFinalizer) {
+  assert(isSizeHeapAligned(size) && "size must be heap aligned");
+  if (!lowLim_ && !reserve()) {
+    return nullptr;
+  }
+
+  const size_t numChunks =
+      llvm::alignTo(
+          AlignedHeapSegment::offsetOfAllocRegion + size,
+          AlignedStorage::size()) >>
+      AlignedStorage::kLogSize;
+
+  // Find the first run of enough free chunks.
+  size_t first = 0;
+  size_t runLength = 0;
+  for (size_t i = 0, e = usedChunks_.size(); i < e && runLength < numChunks;
+       ++i) {
+    if (usedChunks_[i]) {
+      first = i + 1;
+      runLength = 0;
+    } else {
+      ++runLength;
+    }
+  }
+  if (runLength < numChunks) {
+    return nullptr;
+  }
+  std::fill(
+      usedChunks_.begin() + first,
+      usedChunks_.begin() + first + numChunks,
+      true);
+  numUsedChunks_ += numChunks;
+
+  char *chunk = lowLim_ + (first << AlignedStorage::kLogSize);
+  auto *cell = reinterpret_cast<GCCell *>(
+      chunk + AlignedHeapSegment::offsetOfAllocRegion);
+  Object object{cell,
+                size,
+                static_cast<uint32_t>(numChunks),
+                hasFinalizer == HasFinalizer::Yes,
+                nullptr};
+
+  // The cards may still be dirty from a cell which used the same chunks.
+  clearCards(object);
+
+  objects_.insert(
+      std::upper_bound(
+          objects_.begin(),
+          objects_.end(),
+          cell,
+          [](const GCCell *cell, const Object &object) {
+            return cell < object.cell;
+          }),
+      object);
+  used_ += size;
+  bytesAllocated_ += size;
+#ifndef NDEBUG
+  lastAllocated_ = cell;
+#endif
+  return cell;
+}
+
+void LargeObjectSpace::free(const Object &object) {
+  char *chunk = firstChunk(object);
+  // Only the pages that may have been written need to be released.
+  oscompat::vm_unused(
+      chunk, llvm::alignTo(object.end() - chunk, oscompat::page_size()));
+  const size_t first = chunkIndex(chunk);
+  std::fill(
+      usedChunks_.begin() + first,
+      usedChunks_.begin() + first + object.numChunks,
+      false);
+  numUsedChunks_ -= object.numChunks;
+  used_ -= object.size;
+#ifndef NDEBUG
+  if (lastAllocated_ == object.cell) {
+    lastAllocated_ = nullptr;
+  }
+#endif
+}
+
+void LargeObjectSpace::dirtyCardsForAddressRange(
+    const void *low,
+    const void *high) {
+  assert(contains(low) && contains(high) && "range must be in the space");
+  const size_t first = cardIndex(low);
+  std::memset(cards_ + first, 1, cardIndex(high) - first + 1);
+}
+
+void LargeObjectSpace::forAllObjs(
+    const std::function<void(GCCell *)> &callback) {
+  for (const Object &object : objects_) {
+    callback(object.cell);
+  }
+}
+
+void LargeObjectSpace::scanDirtyCards(
+    llvm::function_ref<void(GCCell *, const char *, const char *)> visit) {
+  auto isDirty = [](uint8_t card) { return card != 0; };
+  for (const Object &object : objects_) {
+    const char *cellStart = reinterpret_cast<const char *>(object.cell);
+    const char *cellEnd = object.end();
+    uint8_t *card = cards_ + cardIndex(cellStart);
+    uint8_t *const cardsEnd = cards_ + cardIndex(cellEnd - 1) + 1;
+    while ((card = std::find_if(card, cardsEnd, isDirty)) != cardsEnd) {
+      uint8_t *const runEnd = std::find(card, cardsEnd, 0);
+      const char *begin = lowLim_ + ((card - cards_) << kLogCardSize);
+      const char *end = lowLim_ + ((runEnd - cards_) << kLogCardSize);
+      visit(object.cell, std::max(begin, cellStart), std::min(end, cellEnd));
+      std::fill(card, runEnd, 0);
+      card = runEnd;
+    }
+  }
+}
+
+void LargeObjectSpace::clearCards() {
+  for (const Object &object : objects_) {
+    clearCards(object);
+  }
+}
+
+void LargeObjectSpace::clearCards(const Object &object) {
+  const size_t first = cardIndex(object.cell);
+  std::memset(cards_ + first, 0, cardIndex(object.end() - 1) - first + 1);
+}
+
+void LargeObjectSpace::clearMarkBits() {
+  for (const Object &object : objects_) {
+    MarkBitArrayNC *markBits =
+        AlignedHeapSegment::markBitArrayCovering(object.cell);
+    markBits->unmark(markBits->addressToIndex(object.cell));
+  }
+}
+
+size_t LargeObjectSpace::completeMarking(
+    GC *gc,
+    CompleteMarkState *markState,
+    size_t from,
+    const void *limit) {
+  assert(!markState->markStackOverflow_);
+  CompleteMarkState::FullMSCMarkTransitiveAcceptor acceptor(*gc, markState);
+
+  size_t i = from;
+  for (; i < objects_.size() && (!limit || objects_[i].cell < limit); ++i) {
+    GCCell *cell = objects_[i].cell;
+    if (!AlignedHeapSegment::getCellMarkBit(cell)) {
+      continue;
+    }
+    markState->currentParPointer = cell;
+    markState->pushCell(cell);
+    markState->drainMarkStack(gc, acceptor);
+
+    if (LLVM_UNLIKELY(markState->markStackOverflow_)) {
+      markState->clearMarkStacks();
+      return i;
+    }
+  }
+  return i;
+}
+
+size_t LargeObjectSpace::finalizeUnreachableObjects(GC *gc) {
+  size_t freed = 0;
+  auto isDead = [](const Object &object) {
+    return !AlignedHeapSegment::getCellMarkBit(object.cell);
+  };
+  for (const Object &object : objects_) {
+    if (!isDead(object)) {
+      continue;
+    }
+    if (object.hasFinalizer) {
+      object.cell->getVT()->finalize(object.cell, gc);
+    }
+    freed += object.size;
+    free(object);
+  }
+  objects_.erase(
+      std::remove_if(objects_.begin(), objects_.end(), isDead),
+      objects_.end());
+  return freed;
+}
+
+void LargeObjectSpace::installForwardingPointers() {
+  for (Object &object : objects_) {
+    assert(
+        AlignedHeapSegment::getCellMarkBit(object.cell) &&
+        "Unmarked cells should have been freed");
+    object.savedVT = object.cell->getVT();
+    object.cell->setForwardingPointer(object.cell);
+  }
+}
+
+void LargeObjectSpace::updateReferences(
+    GC *gc,
+    FullMSCUpdateAcceptor &acceptor) {
+  for (const Object &object : objects_) {
+    GCBase::markCell(object.cell, object.savedVT, gc, acceptor);
+  }
+}
+
+void LargeObjectSpace::restoreVTables() {
+  for (Object &object : objects_) {
+    object.cell->setForwardingPointer(
+        reinterpret_cast<const GCCell *>(object.savedVT));
+    object.savedVT = nullptr;
+    assert(object.cell->isValid() && "Cell was invalid after restoring it");
+  }
+}
+
+size_t LargeObjectSpace::countMallocSize() const {
+  size_t sum = 0;
+  for (const Object &object : objects_) {
+    sum += object.cell->getVT()->getMallocSize(object.cell);
+  }
+  return sum;
+}
+
+#ifndef NDEBUG
+bool LargeObjectSpace::validPointer(const void *ptr) const {
+  if (!contains(ptr)) {
+    return false;
+  }
+  auto it = std::upper_bound(
+      objects_.begin(),
+      objects_.end(),
+      ptr,
+      [](const void *ptr, const Object &object) { return ptr < object.cell; });
+  if (it == objects_.begin()) {
+    return false;
+  }
+  --it;
+  return ptr < it->end() && static_cast<const GCCell *>(ptr)->isValid();
+}
+
+bool LargeObjectSpace::isMostRecentFinalizableObj(const GCCell *cell) const {
+  if (!cell || cell != lastAllocated_) {
+    return false;
+  }
+  assert(!objects_.empty() && "the last cell allocated must be alive");
+  auto it = std::lower_bound(
+      objects_.begin(),
+      objects_.end(),
+      cell,
+      [](const Object &object, const GCCell *cell) {
+        return object.cell < cell;
+      });
+  return it != objects_.end() && it->cell == cell && it->hasFinalizer;
+}
+#endif
+
+#ifdef HERMES_SLOW_DEBUG
+void LargeObjectSpace::checkWellFormed(GC *gc) const {
+  CheckHeapWellFormedAcceptor acceptor(*gc);
+  size_t used = 0;
+  for (const Object &object : objects_) {
+    assert(object.cell->isValid() && "Invalid large object");
+    assert(
+        object.cell->getAllocatedSize() == object.size &&
+        "Large object changed size");
+    GCBase::markCell(object.cell, gc, acceptor);
+    used += object.size;
+  }
+  assert(used == used_ && "Large object sizes don't add up");
+}
+#endif
+
+} // namespace vm
+} // namespace hermes
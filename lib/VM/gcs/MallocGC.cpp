@@ -22,6 +22,8 @@ namespace hermes {
 namespace vm {
 
 struct MallocGC::MarkingAcceptor final : public SlotAcceptorDefault {
+  static constexpr bool shouldDeferEphemerons = true;
+
   std::vector<CellHeader *> worklist_;
 
   /// markedSymbols_ represents which symbols have been proven live so far in
@@ -216,6 +218,29 @@ void MallocGC::checkWellFormed() {
 }
 #endif
 
+size_t MallocGC::collectWhileIdle(TimePoint deadline) {
+  if (!expectedToCompleteBy(cumStats_, deadline, /* ifUnknown */ false)) {
+    return 0;
+  }
+  const gcheapsize_t allocatedBefore = allocatedBytes_;
+  collect();
+  return allocatedBefore > allocatedBytes_ ? allocatedBefore - allocatedBytes_
+                                           : 0;
+}
+
+size_t MallocGC::handleMemoryPressure(MemoryPressureLevel) {
+  const gcheapsize_t allocatedBefore = allocatedBytes_;
+  collect();
+  return allocatedBefore > allocatedBytes_ ? allocatedBefore - allocatedBytes_
+                                           : 0;
+}
+
+void MallocGC::forAllObjs(const std::function<void(GCCell *)> &callback) {
+  for (CellHeader *header : pointers_) {
+    callback(header->data());
+  }
+}
+
 void MallocGC::collect() {
   using std::chrono::steady_clock;
   LLVM_DEBUG(llvm::dbgs() << "Beginning collection");
@@ -233,17 +258,39 @@ void MallocGC::collect() {
     GCCycle cycle{this};
     MarkingAcceptor acceptor(*this);
     DroppingAcceptor<MarkingAcceptor> nameAcceptor{acceptor};
+    beginEphemeronMarking();
     markRoots(nameAcceptor);
-    while (!acceptor.worklist_.empty()) {
-      CellHeader *header = acceptor.worklist_.back();
-      acceptor.worklist_.pop_back();
-      assert(header->isMarked() && "Pointer on the worklist isn't marked");
-      GCCell *cell = header->data();
-      // Since `markCell` adds onto worklist_, this cannot be expressed as a
-      // normal loop.
-      GCBase::markCell(cell, this, acceptor);
-      allocatedBytes_ += cell->getAllocatedSize();
+    const auto drainWorklist = [this, &acceptor]() {
+      while (!acceptor.worklist_.empty()) {
+        CellHeader *header = acceptor.worklist_.back();
+        acceptor.worklist_.pop_back();
+        assert(header->isMarked() && "Pointer on the worklist isn't marked");
+        GCCell *cell = header->data();
+        // Since `markCell` adds onto worklist_, this cannot be expressed as a
+        // normal loop.
+        GCBase::markCell(cell, this, acceptor);
+        allocatedBytes_ += cell->getAllocatedSize();
+      }
+    };
+    drainWorklist();
+
+    // Mark the values of the ephemerons whose keys are reachable, until no
+    // more keys become reachable, then clear the others.
+    const auto isMarked = [](GCCell *cell) {
+      return CellHeader::from(cell)->isMarked();
+    };
+    const auto markValue = [&acceptor](HermesValue &value) {
+      // Mark a copy: with handle sanitization the entries must keep pointing
+      // to the old locations until clearUnreachableEphemerons updates them,
+      // since isMarked looks at the old headers.
+      HermesValue copy = value;
+      acceptor.accept(copy);
+    };
+    while (markEphemeronValues(isMarked, markValue)) {
+      drainWorklist();
     }
+    clearUnreachableEphemerons(
+        isMarked, [&acceptor](HermesValue &hv) { acceptor.accept(hv); });
 
     // Update weak roots references.
     MallocGC::FullMSCUpdateWeakRootsAcceptor weakAcceptor(*this);
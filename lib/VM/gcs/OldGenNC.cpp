@@ -12,6 +12,7 @@
 #include "hermes/VM/AllocResult.h"
 #include "hermes/VM/CompactionResult-inline.h"
 #include "hermes/VM/CompleteMarkState-inline.h"
+#include "hermes/VM/FillerCell.h"
 #include "hermes/VM/GC.h"
 #include "hermes/VM/GCBase-inline.h"
 #include "hermes/VM/GCPointer-inline.h"
@@ -181,10 +182,11 @@ gcheapsize_t OldGen::bytesAllocatedSinceLastGC() const {
     res += seg->used();
   }
 
-  return res;
+  return res + bytesAllocatedInHoles_;
 }
 
 void OldGen::forAllObjs(const std::function<void(GCCell *)> &callback) {
+  sealHole();
   forUsedSegments([&callback](AlignedHeapSegment &segment) {
     segment.forAllObjs(callback);
   });
@@ -211,6 +213,26 @@ void OldGen::forObjsAllocatedSinceGC(
   while ((seg = segs->next())) {
     seg->forAllObjs(callback);
   }
+
+  // Then the cells allocated in holes, skipping the FillerCells that cover
+  // the rest of the holes.
+  sealHole();
+  size_t holeNum = holeLevelAtEndOfLastGC_.holeNum;
+  char *ptr = holeLevelAtEndOfLastGC_.ptr;
+  for (; holeNum < holes_.size() && holeNum <= holeIndex_; ++holeNum) {
+    if (holeNum != holeLevelAtEndOfLastGC_.holeNum) {
+      ptr = holes_[holeNum].start;
+    }
+    char *const end =
+        holeNum == holeIndex_ ? holeLevel_ : holes_[holeNum].end;
+    while (ptr < end) {
+      GCCell *cell = reinterpret_cast<GCCell *>(ptr);
+      ptr += cell->getAllocatedSize();
+      if (!vmisa<FillerCell>(cell)) {
+        callback(cell);
+      }
+    }
+  }
 }
 #endif // !NDEBUG
 
@@ -442,13 +464,51 @@ void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
     cardTable.clear();
     i++;
   }
+
+  // Large objects are not in the segments, and have their own cards.
+  GenGC *gc = gc_;
+  gc_->largeObjects_.scanDirtyCards(
+      [gc, &visitor](GCCell *cell, const char *begin, const char *end) {
+        GCBase::markCellWithinRange(
+            visitor, cell, cell->getVT(), gc, begin, end);
+      });
 }
 
 void OldGen::youngGenTransitiveClosure(
     const Location &toScanLoc,
+    const HoleLocation &holeToScanLoc,
     YoungGen::EvacAcceptor &acceptor) {
   size_t toScanSegmentNum = toScanLoc.segmentNum;
   char *toScanPtr = toScanLoc.ptr;
+  size_t holeToScanNum = holeToScanLoc.holeNum;
+  char *holeToScanPtr = holeToScanLoc.ptr;
+
+  // Scan the objects promoted into holes since the last call, which may
+  // promote more objects, in holes or at the level.  A hole before the
+  // current one has been sealed, and is scanned up to its end, FillerCell
+  // included.  \return whether any object was scanned.
+  const auto scanHoles = [this, &holeToScanNum, &holeToScanPtr, &acceptor]() {
+    bool scanned = false;
+    while (holeToScanNum < holes_.size() &&
+           (holeToScanNum < holeIndex_ || holeToScanPtr < holeLevel_)) {
+      const char *const end =
+          holeToScanNum < holeIndex_ ? holes_[holeToScanNum].end : holeLevel_;
+      while (holeToScanPtr < end) {
+        GCCell *cell = reinterpret_cast<GCCell *>(holeToScanPtr);
+        holeToScanPtr += cell->getAllocatedSize();
+        GCBase::markCell(cell, gc_, acceptor);
+        scanned = true;
+      }
+      // Scanning may have filled and sealed the hole, in which case the rest
+      // of it is scanned before moving on.
+      if (holeToScanNum < holeIndex_ &&
+          holeToScanPtr == holes_[holeToScanNum].end &&
+          ++holeToScanNum < holes_.size()) {
+        holeToScanPtr = holes_[holeToScanNum].start;
+      }
+    }
+    return scanned;
+  };
 
   // Predicate to check whether the the index \p ix refers to a segment that has
   // already been "filled", which implies that its level will not change.
@@ -457,9 +517,11 @@ void OldGen::youngGenTransitiveClosure(
   };
 
   // We must scan until the to-scan segment number and pointer reach the current
-  // allocation point.  This loop nest is maximally specialized for
-  // performance, see T26274987 for details.
-  while (isFilled(toScanSegmentNum) || toScanPtr < activeSegment().level()) {
+  // allocation point, and there is nothing left to scan in the holes.  This
+  // loop nest is maximally specialized for performance, see T26274987 for
+  // details.
+  while (isFilled(toScanSegmentNum) || toScanPtr < activeSegment().level() ||
+         scanHoles()) {
     // Now we have two interior loops: we can be faster for already
     // filled segments, since their levels won't change.
     while (isFilled(toScanSegmentNum)) {
@@ -558,6 +620,131 @@ void OldGen::recordLevelAfterCompaction(
   updateCardTableBoundary();
 }
 
+OldGen::InPlaceSweepResult OldGen::sweepInPlace(GC *gc) {
+  clearHoles();
+
+  // The dead space after the last live cell is freed by lowering the level,
+  // rather than kept as holes.
+  size_t lastLiveSegNum = 0;
+  size_t segNum = 0;
+  forUsedSegments([&lastLiveSegNum, &segNum](AlignedHeapSegment &segment) {
+    if (segment.hasMarkedCells()) {
+      lastLiveSegNum = segNum;
+    }
+    segNum++;
+  });
+
+  InPlaceSweepResult result{0, 0};
+  char *liveEnd = nullptr;
+  segNum = 0;
+  whileUsedSegments([&](AlignedHeapSegment &segment) {
+    if (segNum > lastLiveSegNum) {
+      return false;
+    }
+    const bool isLastLive = segNum++ == lastLiveSegNum;
+    liveEnd = segment.sweepInPlace(
+        gc, /* fillTail */ !isLastLive, [&result, this](char *start, char *end) {
+          result.deadBytes += end - start;
+          if (static_cast<size_t>(end - start) >= kMinHoleSize) {
+            holes_.push_back({start, end});
+          }
+        });
+    result.liveBytes += (isLastLive ? liveEnd : segment.level()) -
+        segment.start();
+    return true;
+  });
+  result.liveBytes -= result.deadBytes;
+
+  releaseSegments(lastLiveSegNum + 1);
+  if (releaseUnused_)
+    activeSegment().setLevel<AdviseUnused::Yes>(liveEnd);
+  else
+    activeSegment().setLevel<AdviseUnused::No>(liveEnd);
+
+  usedInFilledSegments_ = 0;
+  for (const auto &filled : filledSegments_) {
+    usedInFilledSegments_ += filled.used();
+  }
+  updateCardTableBoundary();
+  updateEffectiveEndForExternalMemory();
+
+  if (!holes_.empty()) {
+    holeLevel_ = holes_.front().start;
+    holeBoundary_ = AlignedHeapSegment::cardTableCovering(holeLevel_)
+                        ->nextBoundary(holeLevel_);
+  }
+  return result;
+}
+
+size_t OldGen::releaseSegmentCache() {
+  const size_t released = segmentCache_.size() * AlignedHeapSegment::maxSize();
+  segmentCache_.clear();
+  return released;
+}
+
+void OldGen::clearHoles() {
+  assert(holeSealed_ && "The current hole must be sealed.");
+  holes_.clear();
+  holeIndex_ = 0;
+  holeLevel_ = nullptr;
+}
+
+AllocResult OldGen::allocInHole(uint32_t size, HasFinalizer hasFinalizer) {
+  size = heapAlignSize(size);
+  while (holeIndex_ < holes_.size()) {
+    const size_t remaining = holes_[holeIndex_].end - holeLevel_;
+    // What is left of the hole after the allocation must fit a FillerCell.
+    if (size == remaining || size + sizeof(FillerCell) <= remaining) {
+      char *ptr = holeLevel_;
+      holeLevel_ += size;
+      holeSealed_ = false;
+      bytesAllocatedInHoles_ += size;
+      if (holeBoundary_.address() < holeLevel_) {
+        AlignedHeapSegment::cardTableCovering(ptr)->updateBoundaries(
+            &holeBoundary_, ptr, holeLevel_);
+      }
+      if (hasFinalizer == HasFinalizer::Yes) {
+        addToFinalizerList(reinterpret_cast<GCCell *>(ptr));
+      }
+#ifndef NDEBUG
+      incNumAllocatedObjects();
+#endif
+      return {ptr, true};
+    }
+    if (remaining >= kMinHoleSize) {
+      return {nullptr, false};
+    }
+    nextHole();
+  }
+  return {nullptr, false};
+}
+
+void OldGen::nextHole() {
+  sealHole();
+  if (++holeIndex_ < holes_.size()) {
+    holeLevel_ = holes_[holeIndex_].start;
+    holeBoundary_ = AlignedHeapSegment::cardTableCovering(holeLevel_)
+                        ->nextBoundary(holeLevel_);
+  }
+}
+
+void OldGen::sealHole() {
+  if (holeSealed_) {
+    return;
+  }
+  holeSealed_ = true;
+  char *const end = holes_[holeIndex_].end;
+  if (holeLevel_ == end) {
+    return;
+  }
+  new (holeLevel_) FillerCell(gc_, end - holeLevel_);
+  CardTable::Boundary boundary = holeBoundary_;
+  if (boundary.address() < end) {
+    AlignedHeapSegment::cardTableCovering(holeLevel_)->updateBoundaries(
+        &boundary, holeLevel_, end);
+  }
+}
+
 AllocResult OldGen::fullCollectThenAlloc(
     uint32_t allocSize,
     HasFinalizer hasFinalizer) {
@@ -575,6 +762,20 @@ AllocResult OldGen::fullCollectThenAlloc(
     return res;
   }
 
+  // The collection may have left the live cells in place, with the free space
+  // split into holes that are too small.  Compacting may make enough room.
+  if (gc_->compactAfterInPlaceCollection()) {
+    AllocResult res = allocRaw(allocSize, hasFinalizer);
+    if (res.success) {
+      return res;
+    }
+    if (growToFit(allocSize)) {
+      res = allocRaw(allocSize, hasFinalizer);
+      assert(res.success && "preceding test should guarantee success.");
+      return res;
+    }
+  }
+
   gc_->oom(make_error_code(OOMError::MaxHeapReached));
 }
 
@@ -597,6 +798,7 @@ void OldGen::updateCardTablesAfterCompaction(bool youngIsEmpty) {
 }
 
 void OldGen::recreateCardTableBoundaries() {
+  sealHole();
   forUsedSegments([](AlignedHeapSegment &segment) {
     segment.recreateCardTableBoundaries();
   });
@@ -766,13 +968,19 @@ void OldGen::checkWellFormed(const GC *gc) const {
     totalExtSize += extSize;
   });
 
-  assert(totalExtSize == externalMemory());
+  // Large objects are charged to the old gen as external memory.
+  assert(totalExtSize + gc->largeObjects_.used() == externalMemory());
   checkFinalizableObjectsListWellFormed();
 }
 #endif
 
 void OldGen::didFinishGC() {
+  sealHole();
   levelAtEndOfLastGC_ = levelDirect();
+  bytesAllocatedInHoles_ = 0;
+#ifndef NDEBUG
+  holeLevelAtEndOfLastGC_ = holeLevel();
+#endif
 }
 
 } // namespace vm
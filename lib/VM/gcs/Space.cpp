@@ -491,6 +491,7 @@ void ContigAllocGCSpace::forObjsAllocatedSinceGC(
     std::function<void(GCCell *)> callback) {
   forObjsInRange(callback, levelAtEndOfLastGC_, level_);
 }
+#endif
 
 void ContigAllocGCSpace::forObjsInRange(
     std::function<void(GCCell *)> callback,
@@ -505,7 +506,6 @@ void ContigAllocGCSpace::forObjsInRange(
     ptr += cell->getAllocatedSize();
   }
 }
-#endif
 
 } // namespace vm
 } // namespace hermes
@@ -252,9 +252,12 @@ AllocResult YoungGen::fullCollectThenAlloc(
   }
 
   // The allocation is not going to fit into the young generation, if it is not
-  // a fixed size allocation, try and fit it into the old generation.
+  // a fixed size allocation, try and fit it into the old generation, after
+  // compacting it if the collection left its live cells in place.
   if (!fixedSizeAlloc) {
-    if (nextGen_->growToFit(allocSize)) {
+    if (nextGen_->growToFit(allocSize) ||
+        (gc_->compactAfterInPlaceCollection() &&
+         nextGen_->growToFit(allocSize))) {
       AllocResult res = nextGen_->allocRaw(allocSize, hasFinalizer);
       assert(res.success && "preceding test should guarantee success.");
       return res;
@@ -296,6 +299,7 @@ void YoungGen::collect() {
   // Remember the point in the older generation into which we started
   // promoting objects.
   OldGen::Location toScan = nextGen_->levelDirect();
+  OldGen::HoleLocation holeToScan = nextGen_->holeLevel();
 
   // We do this first, before marking from the roots, so that we can take
   // a "snapshot" of the level of the old gen, and only iterate over pointers
@@ -317,7 +321,7 @@ void YoungGen::collect() {
   auto scanTransitiveStart = steady_clock::now();
   {
     PerfSection ygScanTransitiveSystraceRegion("ygScanTransitive");
-    nextGen_->youngGenTransitiveClosure(toScan, acceptor);
+    nextGen_->youngGenTransitiveClosure(toScan, holeToScan, acceptor);
   }
 
   // We've now determined reachability; find weak refs to young-gen
@@ -475,6 +479,21 @@ GCCell *YoungGen::forwardPointer(GCCell *ptr) {
   return newCell;
 }
 
+void YoungGen::evacuate() {
+  OldGen::Location toScan = nextGen_->levelDirect();
+  OldGen::HoleLocation holeToScan = nextGen_->holeLevel();
+  nextGen_->markYoungGenPointers(toScan);
+
+  EvacAcceptor acceptor(*gc_, *this);
+  DroppingAcceptor<EvacAcceptor> nameAcceptor{acceptor};
+  gc_->markRoots(nameAcceptor, /*markLongLived*/ false);
+  nextGen_->youngGenTransitiveClosure(toScan, holeToScan, acceptor);
+
+  gc_->updateWeakReferences(/*fullGC*/ false);
+  finalizeUnreachableAndTransferReachableObjects();
+  activeSegment().resetLevel();
+}
+
 void YoungGen::finalizeUnreachableAndTransferReachableObjects() {
   numFinalizedObjects_ = 0;
   for (const auto &cell : cellsWithFinalizers()) {
@@ -29,6 +29,18 @@ namespace vm {
 /// it 32-bit).
 using gcheapsize_t = uint32_t;
 
+/// How urgently the embedder needs a runtime to give back memory, e.g. in
+/// response to a low-memory notification from the OS.
+enum class MemoryPressureLevel {
+  /// Drop caches that are outside the heap, compact the heap, and return its
+  /// free pages to the OS.
+  Moderate,
+  /// Also drop the caches inside the heap, and shrink the heap down to what
+  /// its live data needs, at the cost of slower execution and more frequent
+  /// collections until they have been rebuilt.
+  Critical,
+};
+
 /// Parameters to control a tripwire function called when the live set size
 /// surpasses a given threshold after collections.  Check documentation in
 /// README.md
@@ -101,6 +113,19 @@ _HERMES_CTORCONFIG_STRUCT(GCSanitizeConfig, GC_HANDLESAN_FIELDS, {});
   /* Whether to revert, if necessary, to young-gen allocation at TTI. */   \
   F(bool, RevertToYGAtTTI, false)                                          \
                                                                            \
+  /* Whether full collections leave the live cells of the old gen in */    \
+  /* place, and reuse the gaps between them for allocation, compacting */  \
+  /* only when it is too fragmented. */                                    \
+  F(bool, OldGenMarkRegion, false)                                         \
+                                                                           \
+  /* Whether to ask the OS to back the heap with transparent huge */       \
+  /* pages, reserving its segments several at a time. */                   \
+  F(bool, UseHugePages, false)                                             \
+                                                                           \
+  /* With UseHugePages, whether to ask the OS to place the heap on the */  \
+  /* NUMA node of the thread which creates the runtime. */                 \
+  F(bool, PreferLocalNUMANode, false)                                      \
+                                                                           \
   /* Pointer to the memory profiler (Memory Event Tracker). */             \
   F(std::shared_ptr<MemoryEventTracker>, MemEventTracker, nullptr)         \
   /* GC_FIELDS END */
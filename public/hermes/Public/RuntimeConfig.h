@@ -62,6 +62,18 @@ class PinnedHermesValue;
                                                                        \
   /* The flags passed from a VM experiment */                          \
   F(uint32_t, VMExperimentFlags, 0)                                    \
+                                                                       \
+  /* Initialize the heap from a process-wide image of an */            \
+  /* initialized runtime, instead of creating the builtins. */         \
+  F(bool, UseRuntimeImage, false)                                      \
+                                                                       \
+  /* Create the Date, RegExp, typed array, Set, Map, WeakMap, */       \
+  /* WeakSet and Symbol builtins when they are first used. */          \
+  F(bool, LazyBuiltins, false)                                         \
+                                                                       \
+  /* Compile lazy functions on a background thread once a closure */  \
+  /* is created for them, before they are first called. */            \
+  F(bool, BackgroundLazyCompilation, false)                            \
   /* RUNTIME_FIELDS END */
 
 _HERMES_CTORCONFIG_STRUCT(RuntimeConfig, RUNTIME_FIELDS, {});
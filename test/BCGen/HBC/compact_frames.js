@@ -0,0 +1,89 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -fcompact-frames %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -fcompact-frames %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -fcompact-frames -g %s | %FileCheck --match-full-lines %s
+
+function holes(a, b, n) {
+  // x is dead in the middle of the function, so its register can be reused.
+  var x = a * 2;
+  var sum = 0;
+  if (b) {
+    sum = x + 1;
+  } else {
+    for (var i = 0; i < n; ++i) {
+      var y = i * b + a;
+      sum += y;
+    }
+  }
+  var z = sum * 3;
+  for (var j = 0; j < n; ++j) {
+    z = z + j;
+  }
+  return z + x;
+}
+print(holes(1, 0, 4), holes(2, 1, 3));
+// CHECK: 20 22
+
+function swap(a, b, n) {
+  // Phis whose values are exchanged on every iteration.
+  for (var i = 0; i < n; ++i) {
+    var t = a;
+    a = b;
+    b = t;
+  }
+  return a + ',' + b;
+}
+print(swap('a', 'b', 3), swap('a', 'b', 4));
+// CHECK-NEXT: b,a a,b
+
+function catchUse(f, v) {
+  var before = v + 1;
+  try {
+    var inside = f(before);
+    var other = inside + 1;
+    f(other);
+    return other;
+  } catch (e) {
+    return before + ':' + e;
+  }
+}
+print(catchUse(function(x) { return x; }, 1));
+print(catchUse(function(x) { throw 'err' + x; }, 1));
+// CHECK-NEXT: 3
+// CHECK-NEXT: 2:err2
+
+function calls(a, b, c) {
+  function add3(x, y, z) {
+    return x + y + z;
+  }
+  var r1 = add3(a, b, c);
+  var r2 = add3(r1, a, b);
+  var r3 = add3(r2, r1, c);
+  return add3(r3, r2, r1);
+}
+print(calls(1, 2, 3));
+// CHECK-NEXT: 33
+
+function sw(k) {
+  var res = 'none';
+  var pre = k * 10;
+  switch (k) {
+    case 0:
+      res = 'zero' + pre;
+      break;
+    case 1:
+      res = 'one' + pre;
+      break;
+    case 2:
+      var tmp = pre + 5;
+      res = 'two' + tmp;
+      break;
+  }
+  return res + pre;
+}
+print(sw(0), sw(1), sw(2), sw(3));
+// CHECK-NEXT: zero00 one1010 two2520 none30
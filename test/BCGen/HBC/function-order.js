@@ -0,0 +1,57 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermesc -O -emit-binary -out %t.plain.hbc %s
+// RUN: %hermes -dump-function-order=%t.dumped %t.plain.hbc | %FileCheck --match-full-lines %s
+// RUN: %FileCheck --match-full-lines --check-prefix=DUMP %s < %t.dumped
+//
+// RUN: %hermesc -O -function-order=%t.dumped -emit-binary -out %t.dumped.hbc %s
+// RUN: %hermes %t.dumped.hbc | %FileCheck --match-full-lines %s
+//
+// RUN: echo '# startup' > %t.order && echo 5 >> %t.order && echo 3 >> %t.order
+// RUN: echo 5 >> %t.order && echo 0 >> %t.order && echo 99 >> %t.order
+// RUN: %hermesc -O -function-order=%t.order -emit-binary -out %t.hbc %s
+// RUN: %hermes %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hbcdump -show-section-ranges %t.hbc > %t.layout
+// RUN: %hbcdump %t.hbc -c "offsets 5;quit" >> %t.layout
+// RUN: %FileCheck --match-full-lines --check-prefix=LAYOUT %s < %t.layout
+// RUN: %hermesc -b -dump-bytecode %t.hbc | %FileCheck --match-full-lines --check-prefix=STRINGS %s
+
+function unused1() {
+  return 'never-called-1';
+}
+function makeInner() {
+  function inner() {
+    return 'inner-result';
+  }
+  return inner;
+}
+function unused2() {
+  return 'never-called-2';
+}
+function startup() {
+  return 'startup-result';
+}
+print(startup(), makeInner()());
+// CHECK: startup-result inner-result
+
+// The global function first, then the functions in the order in which their
+// closures were created.
+// DUMP: 0
+// DUMP-NEXT: 1
+// DUMP-NEXT: 2
+// DUMP-NEXT: 4
+// DUMP-NEXT: 5
+// DUMP-NEXT: 3
+
+// LAYOUT: Function body: {{\[}}[[START:[0-9]+]], {{[0-9]+}})
+// LAYOUT: FunctionID: 5
+// LAYOUT-NEXT: Offset: [[START]]
+
+// The strings of the functions run at startup come before the others.
+// STRINGS: s{{[0-9]+}}[ASCII, {{.*}}]: inner-result
+// STRINGS-NEXT: s{{[0-9]+}}[ASCII, {{.*}}]: startup-result
+// STRINGS: s{{[0-9]+}}[ASCII, {{.*}}]: never-called-1
+// STRINGS-NEXT: s{{[0-9]+}}[ASCII, {{.*}}]: never-called-2
@@ -0,0 +1,62 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Verify that the output doesn't depend on the number of threads.
+// RUN: %hermesc -O -emit-binary -out %t.1.hbc %s && %hermesc -O -j=4 -emit-binary -out %t.4.hbc %s && cmp %t.1.hbc %t.4.hbc
+// RUN: %hermesc -emit-binary -out %t.1.hbc %s && %hermesc -j=4 -emit-binary -out %t.4.hbc %s && cmp %t.1.hbc %t.4.hbc
+// RUN: diff <(%hermesc -O -dump-bytecode %s) <(%hermesc -O -j=0 -dump-bytecode %s)
+
+function fib(n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+function sum(arr) {
+  var total = 0;
+  for (var i = 0; i < arr.length; ++i) {
+    total += arr[i];
+  }
+  return total;
+}
+
+function literals() {
+  return [{a: 1, b: 'two'}, [3, 4, 'five'], {c: null, d: true}];
+}
+
+function closures(x) {
+  function inner(y) {
+    return function(z) {
+      return x + y + z + 'str';
+    };
+  }
+  return inner(1)(2);
+}
+
+function phis(a, b) {
+  var x = 0, y = 1;
+  while (a-- > 0) {
+    var t = x;
+    x = y;
+    y = t + (b ? 1 : 2);
+  }
+  switch (b) {
+    case 1: return x;
+    case 2: return y;
+    case 3: return 'three';
+    default: return undefined;
+  }
+}
+
+function tryCatch(f) {
+  try {
+    return f();
+  } catch (e) {
+    return e.message;
+  } finally {
+    print('done');
+  }
+}
+
+print(fib(10), sum([1, 2, 3]), literals().length, closures(3), phis(5, 1));
+print(tryCatch(function() { throw new Error('err'); }));
@@ -0,0 +1,103 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermesc -O -fsuperinstructions -dump-bytecode %s | %FileCheck --match-full-lines --check-prefix=BC %s
+// RUN: %hermesc -O -fsuperinstructions -g -dump-bytecode %s | %FileCheck --match-full-lines --check-prefix=NOFUSE %s
+// RUN: %hermes -O -fsuperinstructions %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// NOFUSE-NOT: {{.*(GetByIdShortCall|LoadParamLoadParam|Undefined.*Ret|JStrictEqual r).*}}
+
+function method0(o) {
+  return o.f();
+}
+// BC-LABEL: Function<method0>{{.*}}
+// BC:          GetByIdShortCall1 r0, r1, 1, "f"
+// BC-NEXT:     Call1             r0, r0, r1
+
+function method1(o, x) {
+  x = x + '';
+  return o.f(x);
+}
+// BC-LABEL: Function<method1>{{.*}}
+// BC:          LoadParamLoadParam r2, 1
+// BC-NEXT:     LoadParam         r0, 2
+// BC:          GetByIdShortCall2 r0, r2, 1, "f"
+// BC-NEXT:     Call2             r0, r0, r2, r1
+
+function noReturn(o) {
+  o.x = 1;
+}
+// BC-LABEL: Function<noReturn>{{.*}}
+// BC:          LoadConstUndefinedRet r0
+// BC-NEXT:     Ret               r0
+
+function sw(s) {
+  switch (s) {
+    case 'a':
+      return 1;
+    case 'b':
+      return 2;
+    case 7:
+      return 3;
+  }
+  return 0;
+}
+// BC-LABEL: Function<sw>{{.*}}
+// BC:          LoadConstStringJStrictEqual r0, "a"
+// BC-NEXT:     JStrictEqual      L1, r0, r1
+// BC-NEXT:     LoadConstStringJStrictEqual r0, "b"
+// BC-NEXT:     JStrictEqual      L2, r0, r1
+// BC-NEXT:     LoadConstUInt8JStrictEqual r0, 7
+// BC-NEXT:     JStrictEqual      L3, r0, r1
+
+var obj = {
+  n: 0,
+  f: function(x) {
+    return ++this.n + (x === undefined ? '' : x);
+  },
+};
+for (var i = 0; i < 3; ++i) {
+  // Cached and uncached property reads, including the second iteration where
+  // the cache hits.
+  print(method0(obj), method1(obj, '!'));
+}
+// CHECK: 1 2!
+// CHECK-NEXT: 3 4!
+// CHECK-NEXT: 5 6!
+
+// Non-object receivers go through the regular GetById path.
+Number.prototype.f = function() {
+  return typeof this;
+};
+print(method0(5));
+// CHECK-NEXT: object
+print(method1({f: Math.abs}, -5));
+// CHECK-NEXT: 5
+
+// Exceptions thrown by the second instruction of a pair.
+try {
+  method0({f: 12});
+} catch (e) {
+  print(e.constructor.name);
+}
+// CHECK-NEXT: TypeError
+try {
+  method1({
+    f: function() {
+      throw new Error('thrown');
+    },
+  });
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: thrown
+
+var o2 = {};
+print(noReturn(o2), o2.x);
+// CHECK-NEXT: undefined 1
+
+print(sw('a'), sw('b'), sw(7), sw('7'), sw(undefined));
+// CHECK-NEXT: 1 2 3 0 0
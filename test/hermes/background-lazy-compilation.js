@@ -0,0 +1,86 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -lazy -Xbackground-lazy-compilation %s | %FileCheck --match-full-lines %s
+// Lazy functions compiled on a background thread before they are called.
+
+print('background lazy compilation');
+// CHECK-LABEL: background lazy compilation
+
+function outer(n) {
+  function inner(x) {
+    return 'inner ' + x;
+    /* Some text to pad out the function so that it won't be eagerly compiled
+     * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+     * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+     */
+  }
+  var makers = [];
+  for (var i = 0; i < n; ++i) {
+    makers.push(function(y) {
+      return inner(y) + ' from closure';
+      /* Some text to pad out the function so that it won't be eagerly
+       * compiled for being too short. Lorem ipsum dolor sit amet, consectetur
+       * adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore.
+       */
+    });
+  }
+  return makers;
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+var makers = outer(3);
+print(makers[0](1), makers[2](2));
+// CHECK-NEXT: inner 1 from closure inner 2 from closure
+
+function neverCalled() {
+  print('never called');
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+function withError() {
+  break;
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+try {
+  withError();
+} catch (e) {
+  print('caught', e);
+}
+// CHECK-NEXT: caught SyntaxError: 50:2:'break' not within a loop or a switch
+
+function thrower() {
+  throw new Error('thrown');
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+try {
+  thrower();
+} catch (e) {
+  print(e.stack.split('\n')[1].trim());
+}
+// CHECK-NEXT: at thrower ({{.*}}background-lazy-compilation.js:65:18)
+
+// Closures of the same functions created many times.
+var results = [];
+for (var i = 0; i < 200; ++i) {
+  var f = outer(1)[0];
+  results.push(f(i));
+}
+print(results.length, results[199]);
+// CHECK-NEXT: 200 inner 199 from closure
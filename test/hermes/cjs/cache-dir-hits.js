@@ -0,0 +1,20 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// REQUIRES: debug_options
+// After an edit, the segments before the edited one are taken from the
+// compilation cache, and the edited one is compiled again.
+// RUN: rm -rf %t && mkdir -p %t && cp -r %S/subdir-segments %t/src
+// RUN: %hermesc -commonjs -cache-dir=%t/cache %t/src/ -emit-binary -out %t/cold.hbc -debug-only=hermes 2>&1 | %FileCheck %s -check-prefix=COLD
+// RUN: sed -e 's/exports.y = 15/exports.y = 16/' %t/src/bar/cjs-subdir-bar.js > %t/edited.js && mv %t/edited.js %t/src/bar/cjs-subdir-bar.js
+// RUN: %hermesc -commonjs -cache-dir=%t/cache %t/src/ -emit-binary -out %t/edited.hbc -debug-only=hermes 2>&1 | %FileCheck %s -check-prefix=EDITED
+// RUN: %hermes %t/edited.hbc | %FileCheck --match-full-lines %s
+
+// COLD-NOT: in the compilation cache
+
+// EDITED: Found segment 0 in the compilation cache
+// EDITED-NOT: Found segment 1 in the compilation cache
+
+// CHECK: foo: bar.y = 16
@@ -0,0 +1,47 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Verify that segments taken from the compilation cache are identical to
+// freshly compiled ones, both when nothing changed and after editing a single
+// segment.
+// RUN: rm -rf %t && mkdir -p %t && cp -r %S/subdir-segments %t/src
+// RUN: %hermesc -commonjs %t/src/ -emit-binary -out %t/expected.hbc
+// RUN: %hermesc -commonjs -cache-dir=%t/cache %t/src/ -emit-binary -out %t/cold.hbc
+// RUN: %hermesc -commonjs -cache-dir=%t/cache %t/src/ -emit-binary -out %t/warm.hbc
+// RUN: cmp %t/expected.hbc %t/cold.hbc && cmp %t/expected.hbc.1 %t/cold.hbc.1
+// RUN: cmp %t/expected.hbc %t/warm.hbc && cmp %t/expected.hbc.1 %t/warm.hbc.1
+// RUN: %hermes %t/warm.hbc | %FileCheck --match-full-lines %s -check-prefix=BEFORE
+//
+// RUN: sed -e 's/exports.y = 15/exports.y = 16/' %t/src/bar/cjs-subdir-bar.js > %t/edited.js && mv %t/edited.js %t/src/bar/cjs-subdir-bar.js
+// RUN: %hermesc -commonjs %t/src/ -emit-binary -out %t/expected.hbc
+// RUN: %hermesc -commonjs -cache-dir=%t/cache %t/src/ -emit-binary -out %t/edited.hbc
+// RUN: cmp %t/expected.hbc %t/edited.hbc && cmp %t/expected.hbc.1 %t/edited.hbc.1
+// RUN: %hermes %t/edited.hbc | %FileCheck --match-full-lines %s -check-prefix=AFTER
+//
+// Editing the first segment must not serve a stale second segment.
+// RUN: sed -e 's/exports.alpha = 144/exports.beta = exports.alpha = 144/' %t/src/cjs-subdir-2.js > %t/edited.js && mv %t/edited.js %t/src/cjs-subdir-2.js
+// RUN: %hermesc -commonjs %t/src/ -emit-binary -out %t/expected.hbc
+// RUN: %hermesc -commonjs -cache-dir=%t/cache %t/src/ -emit-binary -out %t/edited.hbc
+// RUN: cmp %t/expected.hbc %t/edited.hbc && cmp %t/expected.hbc.1 %t/edited.hbc.1
+// RUN: %hermes %t/edited.hbc | %FileCheck --match-full-lines %s -check-prefix=AFTER
+//
+// RUN: %hermesc -O -commonjs -fstatic-require %t/src/ -emit-binary -out %t/expected.hbc
+// RUN: %hermesc -O -commonjs -fstatic-require -cache-dir=%t/cache %t/src/ -emit-binary -out %t/cold.hbc
+// RUN: %hermesc -O -commonjs -fstatic-require -cache-dir=%t/cache %t/src/ -emit-binary -out %t/warm.hbc
+// RUN: cmp %t/expected.hbc %t/cold.hbc && cmp %t/expected.hbc.1 %t/cold.hbc.1
+// RUN: cmp %t/expected.hbc %t/warm.hbc && cmp %t/expected.hbc.1 %t/warm.hbc.1
+// RUN: %hermes %t/warm.hbc | %FileCheck --match-full-lines %s -check-prefix=AFTER
+
+// BEFORE-LABEL: main: init
+// BEFORE-NEXT: foo: init
+// BEFORE-NEXT: bar: init
+// BEFORE-NEXT: foo: bar.y = 15
+// BEFORE-NEXT: main: foo.x = 15
+
+// AFTER-LABEL: main: init
+// AFTER-NEXT: foo: init
+// AFTER-NEXT: bar: init
+// AFTER-NEXT: foo: bar.y = 16
+// AFTER-NEXT: main: foo.x = 16
@@ -0,0 +1,56 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// REQUIRES: zlib
+// RUN: %hermes -O -emit-binary -compress-bytecode -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// Pad the function bodies, so that they are spread over many blocks.
+// RUN: %hermes -O -emit-binary -compress-bytecode -pad-function-bodies-percent=10000 -out %t.pad.hbc %s && %hermes %t.pad.hbc | %FileCheck --match-full-lines %s
+// Tracking I/O doesn't get in the way of decompressing function bodies.
+// RUN: %hermes -track-io %t.pad.hbc | %FileCheck --match-full-lines %s
+// The decompressed bytecode is the same as the uncompressed one.
+// RUN: %hermes -O -emit-binary -out %t.plain.hbc %s
+// RUN: %hbcdump -c disassemble %t.plain.hbc > %t.plain.dis
+// RUN: %hbcdump -c disassemble %t.hbc | diff %t.plain.dis -
+// Bytecode whose function bodies are decompressed when they first run.
+
+print('compressed bytecode');
+// CHECK-LABEL: compressed bytecode
+
+function withSwitch(x) {
+  switch (x) {
+    case 0: return 'zero';
+    case 1: return 'one';
+    case 2: return 'two';
+    case 3: return 'three';
+    case 4: return 'four';
+    case 5: return 'five';
+    default: return 'many';
+  }
+}
+
+function withCatch(f) {
+  try {
+    return f();
+  } catch (e) {
+    return 'caught ' + e.message;
+  }
+}
+
+function neverCalled() {
+  return 'never';
+}
+
+var results = [];
+for (var i = 0; i < 7; ++i)
+  results.push(withSwitch(i));
+print(results.join());
+// CHECK-NEXT: zero,one,two,three,four,five,many
+
+print(withCatch(function() { throw new Error('from a closure'); }));
+// CHECK-NEXT: caught from a closure
+
+var obj = {compressedProp: 'é', other: [1, 2, 3]};
+print(obj.compressedProp, obj.other.length, Object.keys(obj).join());
+// CHECK-NEXT: é 3 compressedProp,other
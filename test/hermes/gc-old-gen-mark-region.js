@@ -0,0 +1,62 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -gc-old-gen-mark-region %s | %FileCheck --match-full-lines %s
+// Full collections which leave the live objects of the old gen in place, and
+// allocation in the gaps left between them.
+
+print('mark region');
+// CHECK-LABEL: mark region
+
+// Old objects with a dead neighbour between each pair of live ones.
+var live = [];
+var dead = [];
+for (var i = 0; i < 20000; i++) {
+  live.push({index: i, name: 'live' + i});
+  dead.push({index: i, name: 'dead' + i, pad: [i, i, i, i, i, i, i, i]});
+}
+gc();
+dead = null;
+gc();
+
+// New objects fill the gaps, and point to young objects.
+var fresh = [];
+for (var i = 0; i < 20000; i++) {
+  fresh.push({index: i, inner: {value: 'fresh' + i}});
+  live[i].next = {value: i};
+}
+gc();
+var ok = true;
+for (var i = 0; i < 20000; i++) {
+  if (live[i].index !== i || live[i].name !== 'live' + i ||
+      live[i].next.value !== i || fresh[i].inner.value !== 'fresh' + i) {
+    ok = false;
+  }
+}
+print(ok);
+// CHECK-NEXT: true
+
+// Weak references to dead objects are cleared.
+var key = {};
+var wm = new WeakMap();
+wm.set(key, 'value');
+for (var i = 0; i < 1000; i++) {
+  wm.set({}, i);
+}
+gc();
+print(wm.get(key));
+// CHECK-NEXT: value
+
+// Freeing most of the old gen makes the next collection compact it.
+live = null;
+fresh = null;
+gc();
+var again = [];
+for (var i = 0; i < 20000; i++) {
+  again.push('again' + i);
+}
+gc();
+print(again[19999]);
+// CHECK-NEXT: again19999
@@ -0,0 +1,61 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// Cells too large for a heap segment, and a large array with pointers to young
+// objects. Pointers from a large cell to young objects are tested by
+// ArrayStorageBigHeapTest.YoungPointersInLargeCell.
+
+print('large objects');
+// CHECK-LABEL: large objects
+
+var strs = [];
+for (var i = 0; i < 5; i++) {
+  strs.push('x'.repeat(6000000 + i));
+}
+gc();
+print(strs.length, strs[4].length, strs[0][5999999]);
+// CHECK-NEXT: 5 6000004 x
+
+// The elements of this array are in a segmented storage of many old-gen cells.
+var a = [];
+for (var i = 0; i < 600000; i++) {
+  a.push(i);
+}
+gc();
+print(a.length);
+// CHECK-NEXT: 600000
+
+// Store young entries into the old storage, then make garbage so that young
+// collections run before the next full collection.
+for (var round = 0; round < 5; round++) {
+  for (var i = 0; i < 300000; i += 97) {
+    a[i] = {v: i, r: round};
+  }
+  var garbage = [];
+  for (var k = 0; k < 200000; k++) {
+    garbage.push({k: k});
+  }
+  garbage = null;
+}
+
+function sum() {
+  var s = 0;
+  for (var i = 0; i < 300000; i += 97) {
+    s += a[i].v + a[i].r;
+  }
+  return s;
+}
+print(sum());
+// CHECK-NEXT: 463844838
+gc();
+print(sum());
+// CHECK-NEXT: 463844838
+
+a = null;
+strs = null;
+gc();
+print('freed');
+// CHECK-NEXT: freed
@@ -0,0 +1,33 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -Xlazy-builtins %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -Xlazy-builtins -O %s | %FileCheck --match-full-lines %s
+// Deferred builtins are still available after the global object is frozen.
+// Everything runs in a function, since global vars are read-only after this.
+
+(function(global) {
+print('freeze global');
+// CHECK-LABEL: freeze global
+
+Object.freeze(global);
+print(Object.isFrozen(global), Object.isExtensible(global));
+// CHECK-NEXT: true false
+
+print(typeof Map, typeof Set, typeof WeakMap, typeof WeakSet);
+// CHECK-NEXT: function function function function
+print(new Map([[1, 2]]).get(1), new Set([1, 1, 2]).size);
+// CHECK-NEXT: 2 2
+print(new Date(0).getTime(), /a(b)/.exec('xab')[1]);
+// CHECK-NEXT: 0 b
+print(typeof Symbol.iterator, new Uint8Array(new ArrayBuffer(4)).length);
+// CHECK-NEXT: symbol 4
+print(new DataView(new ArrayBuffer(8)).byteLength);
+// CHECK-NEXT: 8
+
+var desc = Object.getOwnPropertyDescriptor(global, 'RegExp');
+print(desc.writable, desc.configurable);
+// CHECK-NEXT: false false
+})(this);
@@ -0,0 +1,38 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -Xlazy-builtins %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -Xlazy-builtins -fstatic-builtins %s | %FileCheck --match-full-lines %s
+// Builtins created on first use behave as if they had always existed.
+
+print('lazy builtins');
+// CHECK-LABEL: lazy builtins
+
+// Builtins used by native code before their constructor is looked up.
+print(/a(b)/.exec('xab')[1], 'xyz'.search('z'));
+// CHECK-NEXT: b 2
+print(Symbol.iterator.toString());
+// CHECK-NEXT: Symbol(Symbol.iterator)
+
+// Static builtins of deferred objects.
+print(Date.now() > 0, ArrayBuffer.isView(new Uint8Array(2)));
+// CHECK-NEXT: true true
+
+print(typeof Map, 'Set' in this, this.hasOwnProperty('WeakMap'));
+// CHECK-NEXT: function true true
+var desc = Object.getOwnPropertyDescriptor(this, 'Int16Array');
+print(desc.writable, desc.enumerable, desc.configurable);
+// CHECK-NEXT: true false true
+print(new DataView(new ArrayBuffer(8)).byteLength);
+// CHECK-NEXT: 8
+
+print(delete WeakSet, typeof WeakSet);
+// CHECK-NEXT: true undefined
+var Float32Array = 1;
+print(Float32Array);
+// CHECK-NEXT: 1
+
+print(Object.getOwnPropertyNames(this).indexOf('Uint32Array') >= 0);
+// CHECK-NEXT: true
@@ -0,0 +1,33 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// The identifiers of a bytecode file are imported when first used. They must
+// resolve to the same symbols as strings created at runtime.
+
+print('lazy identifiers');
+// CHECK-LABEL: lazy identifiers
+
+// Created at runtime before the identifier is first used.
+var computed = {};
+computed['lazy' + 'Prop'] = 1;
+print(computed.lazyProp, Object.keys(computed)[0] === 'lazyProp');
+// CHECK-NEXT: 1 true
+
+// Used as an identifier before the string is created at runtime.
+var literal = {otherProp: 2};
+print(literal['other' + 'Prop'], 'otherProp' in literal);
+// CHECK-NEXT: 2 true
+
+// Predefined identifiers.
+print([1, 2, 3].length, typeof Object.prototype.toString);
+// CHECK-NEXT: 3 function
+
+// Identifiers that are only used after a collection.
+gc();
+var late = {afterCollection: 3, 'été': 4};
+print(late.afterCollection, late['été'], Object.keys(late).join());
+// CHECK-NEXT: 3 4 afterCollection,été
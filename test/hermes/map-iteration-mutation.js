@@ -0,0 +1,85 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// Iterations over Maps and Sets which are modified while they are iterated,
+// including when the modifications replace the underlying table.
+
+print('delete');
+// CHECK-LABEL: delete
+var m = new Map([[1, 'a'], [2, 'b'], [3, 'c'], [4, 'd']]);
+var seen = [];
+m.forEach(function(v, k) {
+  seen.push(k + v);
+  if (k === 1) {
+    m.delete(1);
+    m.delete(2);
+  }
+});
+print(seen.join());
+// CHECK-NEXT: 1a,3c,4d
+
+print('grow');
+// CHECK-LABEL: grow
+var s = new Set([0, 1, 2, 3]);
+seen = [];
+for (var x of s) {
+  seen.push(x);
+  if (x < 20) {
+    s.add(x + 10);
+  }
+}
+print(seen.join());
+// CHECK-NEXT: 0,1,2,3,10,11,12,13,20,21,22,23
+
+print('shrink');
+// CHECK-LABEL: shrink
+s = new Set();
+for (var i = 0; i < 100; i++) {
+  s.add(i);
+}
+var it = s.values();
+print(it.next().value, it.next().value);
+// CHECK-NEXT: 0 1
+for (var i = 0; i < 95; i++) {
+  s.delete(i);
+}
+print(Array.from(it).join());
+// CHECK-NEXT: 95,96,97,98,99
+
+print('clear');
+// CHECK-LABEL: clear
+m = new Map([['a', 1], ['b', 2]]);
+it = m.keys();
+print(it.next().value);
+// CHECK-NEXT: a
+m.clear();
+m.set('c', 3);
+print(it.next().value);
+// CHECK-NEXT: c
+print(it.next().done);
+// CHECK-NEXT: true
+m.set('d', 4);
+print(it.next().done);
+// CHECK-NEXT: true
+
+print('reinsert');
+// CHECK-LABEL: reinsert
+s = new Set([1, 2, 3]);
+it = s.values();
+s.delete(1);
+s.add(1);
+print(Array.from(it).join());
+// CHECK-NEXT: 2,3,1
+
+print('churn');
+// CHECK-LABEL: churn
+m = new Map();
+for (var i = 0; i < 10000; i++) {
+  m.set(i, i);
+  m.delete(i - 1);
+}
+print(m.size, m.get(9999), m.has(9998));
+// CHECK-NEXT: 1 9999 false
@@ -0,0 +1,57 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// Object literals created again from their cached hidden class and values.
+
+print('object literal cache');
+// CHECK-LABEL: object literal cache
+
+function make() {
+  return {str: 'abc', num: 1.5, int: 7, t: true, f: false, n: null,
+          length: 'length', 'é': 'ü'};
+}
+
+var objs = [];
+for (var i = 0; i < 3; ++i) {
+  objs.push(make());
+  gc();
+}
+for (var i = 0; i < objs.length; ++i) {
+  var o = objs[i];
+  print(o.str, o.num, o.int, o.t, o.f, o.n, o.length, o['é'],
+        Object.keys(o).join());
+}
+// CHECK-NEXT: abc 1.5 7 true false null length ü str,num,int,t,f,n,length,é
+// CHECK-NEXT: abc 1.5 7 true false null length ü str,num,int,t,f,n,length,é
+// CHECK-NEXT: abc 1.5 7 true false null length ü str,num,int,t,f,n,length,é
+
+// The objects don't share their values.
+objs[0].str = 'changed';
+print(objs[1].str, make().str, objs[0].str === objs[1].str);
+// CHECK-NEXT: abc abc false
+
+// Literals with the same keys and different values.
+function pair(a) {
+  return a ? {x: 'first', y: 1} : {x: 'second', y: 2};
+}
+for (var i = 0; i < 2; ++i)
+  print(JSON.stringify(pair(true)), JSON.stringify(pair(false)));
+// CHECK-NEXT: {"x":"first","y":1} {"x":"second","y":2}
+// CHECK-NEXT: {"x":"first","y":1} {"x":"second","y":2}
+
+// Literals in eval'ed code.
+var geval = eval;
+for (var i = 0; i < 3; ++i)
+  print(JSON.stringify(geval("({a: 'from eval', b: " + i + ", c: 'x'})")));
+// CHECK-NEXT: {"a":"from eval","b":0,"c":"x"}
+// CHECK-NEXT: {"a":"from eval","b":1,"c":"x"}
+// CHECK-NEXT: {"a":"from eval","b":2,"c":"x"}
+var evalFn = geval("(function() { return {p: 'q', r: 's'}; })");
+for (var i = 0; i < 2; ++i)
+  print(JSON.stringify(evalFn()));
+// CHECK-NEXT: {"p":"q","r":"s"}
+// CHECK-NEXT: {"p":"q","r":"s"}
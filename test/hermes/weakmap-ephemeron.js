@@ -0,0 +1,71 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// The entries of WeakMaps and WeakSets are ephemerons: a value is kept alive
+// by its key being reachable from elsewhere, not by the map.
+
+print('cycle');
+// CHECK-LABEL: cycle
+var m = new WeakMap();
+(function() {
+  for (var i = 0; i < 100; ++i) {
+    var k = {};
+    // The value refers to its own key.
+    m.set(k, {key: k});
+  }
+})();
+gc();
+print(HermesInternal.getWeakSize(m));
+// CHECK-NEXT: 0
+
+print('chain');
+// CHECK-LABEL: chain
+var head = {};
+var chain = new WeakMap();
+(function() {
+  var key = head;
+  for (var i = 0; i < 100; ++i) {
+    var next = {};
+    chain.set(key, next);
+    key = next;
+  }
+  chain.set(key, 'end');
+})();
+gc();
+// Every key is only reachable through the value of the previous one.
+print(HermesInternal.getWeakSize(chain));
+// CHECK-NEXT: 101
+var k = head;
+var n = 0;
+while (typeof chain.get(k) === 'object') {
+  k = chain.get(k);
+  ++n;
+}
+print(n, chain.get(k));
+// CHECK-NEXT: 100 end
+k = null;
+head = null;
+gc();
+print(HermesInternal.getWeakSize(chain));
+// CHECK-NEXT: 0
+
+print('across maps');
+// CHECK-LABEL: across maps
+var set = new WeakSet();
+var owner = {};
+var holder = new WeakMap();
+(function() {
+  var o = {};
+  set.add(o);
+  holder.set(owner, o);
+})();
+gc();
+print(HermesInternal.getWeakSize(set));
+// CHECK-NEXT: 1
+holder.delete(owner);
+gc();
+print(HermesInternal.getWeakSize(set));
+// CHECK-NEXT: 0
@@ -111,9 +111,7 @@ m.set(a, 10);
   print(m.get(a));
 // CHECK-NEXT: 10
 })();
-// b can be freed now.
-// Run the GC twice - first to invalidate the WeakRef,
-// second to delete the invalid WeakRef from the map.
+// b can be freed now, and its entry is cleared by the next collection.
 print(m.get(a));
 // CHECK-NEXT: 10
 gc();
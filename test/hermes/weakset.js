@@ -88,15 +88,12 @@ m.add(a);
   print(HermesInternal.getWeakSize(m));
 // CHECK-NEXT: 2
 })();
-// b can be freed now.
-// Run the GC twice - first to invalidate the WeakRef,
-// second to delete the invalid WeakRef from the map.
+// b can be freed now, and its entry is cleared by the next collection.
 gc();
 gc();
 print(m.has(a));
 // CHECK-NEXT: true
 
-// Add element to clean up internal DenseMap.
 m.add(c);
 
 print(HermesInternal.getWeakSize(m));
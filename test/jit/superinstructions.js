@@ -0,0 +1,24 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+/*
+RUN: %hermes -O -fsuperinstructions -jit -jit-crash-on-error %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+// The JIT compiles a superinstruction as the first instruction of its pair.
+
+function f(a, b) {
+  var o = {g: function() { return a; }};
+  if (o.g() === 1) {
+    return b;
+  }
+}
+
+var sum = 0;
+for (var i = 0; i < 10000; i++) {
+  sum += f(i & 1, 2) === undefined ? 0 : 1;
+}
+print(sum);
+//CHECK: 5000
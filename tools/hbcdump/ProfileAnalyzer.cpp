@@ -647,10 +647,16 @@ void ProfileAnalyzer::dumpIO() {
   os_ << executionInfo.size() << " functions accessed out of total "
       << funcCount << " functions\n";
 
-  uint32_t funcRegionStartOffset = bcProvider->getFunctionHeader(0).offset();
-  uint32_t funcRegionEndOffset =
-      bcProvider->getFunctionHeader(funcCount - 1).offset() +
-      bcProvider->getFunctionHeader(funcCount - 1).bytecodeSizeInBytes() - 1;
+  // Function bodies may be laid out in any order.
+  uint32_t funcRegionStartOffset = UINT32_MAX;
+  uint32_t funcRegionEndOffset = 0;
+  for (uint32_t i = 0; i < funcCount; ++i) {
+    auto header = bcProvider->getFunctionHeader(i);
+    funcRegionStartOffset = std::min(funcRegionStartOffset, header.offset());
+    funcRegionEndOffset = std::max(
+        funcRegionEndOffset,
+        header.offset() + header.bytecodeSizeInBytes() - 1);
+  }
 
   uint32_t funcRegionStartPage = getPageIndexFromOffset(funcRegionStartOffset);
   uint32_t funcRegionEndPage = getPageIndexFromOffset(funcRegionEndOffset);
@@ -394,13 +394,14 @@ int main(int argc, char **argv) {
 
   auto buffer =
       llvm::make_unique<hermes::MemoryBuffer>(fileBufOrErr.get().get());
-  const uint8_t *bytecodeStart = buffer->data();
   auto ret =
       hbc::BCProviderFromBuffer::createBCProviderFromBuffer(std::move(buffer));
   if (!ret.first) {
     llvm::errs() << "Error: fail to deserializing bytecode: " << ret.second;
     return 1;
   }
+  // The decompressed file, if it is compressed.
+  const uint8_t *bytecodeStart = ret.first->getRawBuffer().data();
 
   // Parse startup commands list(separated by semicolon).
   std::vector<std::string> startupCommands;
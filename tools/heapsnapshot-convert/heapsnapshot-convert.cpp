@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/VM/HeapSnapshot.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+/*
+ * heapsnapshot-convert converts a binary heap snapshot, written by
+ * HermesRuntime::createBinaryHeapSnapshotToFD, to the JSON format of Chrome's
+ * .heapsnapshot files, which can be loaded into the Memory tab of DevTools.
+ */
+
+using namespace hermes;
+
+static llvm::cl::opt<std::string> InputFilename(
+    llvm::cl::Positional,
+    llvm::cl::desc("<binary heap snapshot>"),
+    llvm::cl::init("-"));
+
+static llvm::cl::opt<std::string> OutputFilename(
+    "o",
+    llvm::cl::desc("Output .heapsnapshot file"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::init("-"));
+
+static llvm::cl::opt<bool> Pretty(
+    "pretty",
+    llvm::cl::desc("Pretty print the JSON output"),
+    llvm::cl::init(false));
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM initLLVM(argc, argv);
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Convert a binary Hermes heap snapshot to a .heapsnapshot\n");
+
+  auto inputOrErr = llvm::MemoryBuffer::getFileOrSTDIN(InputFilename);
+  if (!inputOrErr) {
+    llvm::errs() << "Error! Failed to open file: " << InputFilename << ": "
+                 << inputOrErr.getError().message() << "\n";
+    return 1;
+  }
+
+  std::error_code ec;
+  llvm::raw_fd_ostream os(OutputFilename, ec, llvm::sys::fs::F_None);
+  if (ec) {
+    llvm::errs() << "Error! Failed to open file: " << OutputFilename << ": "
+                 << ec.message() << "\n";
+    return 1;
+  }
+
+  JSONEmitter json(os, Pretty);
+  std::string error;
+  if (!vm::convertBinaryHeapSnapshot(
+          inputOrErr.get()->getBuffer(), json, error)) {
+    llvm::errs() << "Error! Invalid binary heap snapshot: " << error << "\n";
+    return 1;
+  }
+  os << "\n";
+  return 0;
+}
@@ -66,6 +66,26 @@ static opt<bool> GCRevertToYGAtTTI(
     cat(GCCategory),
     init(false));
 
+static opt<bool> GCOldGenMarkRegion(
+    "gc-old-gen-mark-region",
+    desc("Leave the live objects of the old generation in place in full "
+         "collections, and allocate in the gaps between them"),
+    cat(GCCategory),
+    init(false));
+
+static opt<bool> GCHugePages(
+    "gc-huge-pages",
+    desc("Ask the OS to back the heap with transparent huge pages"),
+    cat(GCCategory),
+    init(false));
+
+static opt<bool> GCLocalNUMANode(
+    "gc-local-numa-node",
+    desc("With -gc-huge-pages, ask the OS to place the heap on the NUMA node "
+         "of the thread which creates the runtime"),
+    cat(GCCategory),
+    init(false));
+
 static opt<bool> GCPrintStats(
     "gc-print-stats",
     desc("Output summary garbage collection statistics at exit"),
@@ -97,12 +117,18 @@ static int executeHBCBytecodeFromCL(
                   .withShouldReleaseUnused(false)
                   .withAllocInYoung(cl::GCAllocYoung)
                   .withRevertToYGAtTTI(cl::GCRevertToYGAtTTI)
+                  .withOldGenMarkRegion(cl::GCOldGenMarkRegion)
+                  .withUseHugePages(cl::GCHugePages)
+                  .withPreferLocalNUMANode(cl::GCLocalNUMANode)
                   .build())
           .withEnableJIT(cl::DumpJITCode || cl::EnableJIT)
           .withEnableEval(cl::EnableEval)
           .withVerifyEvalIR(cl::VerifyIR)
           .withVMExperimentFlags(cl::VMExperimentFlags)
           .withES6Symbol(cl::ES6Symbol)
+          .withUseRuntimeImage(cl::UseRuntimeImage)
+          .withLazyBuiltins(cl::LazyBuiltins)
+          .withBackgroundLazyCompilation(cl::BackgroundLazyCompilation)
           .withEnableSampleProfiling(cl::SampleProfiling)
           .withRandomizeMemoryLayout(cl::RandomizeMemoryLayout)
           .withTrackIO(cl::TrackBytecodeIO)
@@ -118,6 +144,7 @@ static int executeHBCBytecodeFromCL(
   options.dumpJITCode = cl::DumpJITCode;
   options.jitCrashOnError = cl::JITCrashOnError;
   options.stopAfterInit = cl::StopAfterInit;
+  options.functionOrderFile = cl::DumpFunctionOrder;
 
   bool success;
   if (cl::Repeat <= 1) {
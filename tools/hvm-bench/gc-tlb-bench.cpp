@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+//===----------------------------------------------------------------------===//
+/// \file
+/// This benchmark measures the effect of backing the heap with transparent
+/// huge pages (GCConfig::UseHugePages) on full collections.
+///
+/// It builds a large graph of objects whose links are shuffled, so that the
+/// marking traversal jumps all over the heap, and then times a number of full
+/// collections, once with regular pages and once with huge pages. The Linux
+/// performance counters, including dTLB-load-misses, are reported with each
+/// set of numbers when they are available (see PerfEvents).
+//===----------------------------------------------------------------------===//
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/instrumentation/PerfEvents.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+using namespace hermes::vm;
+
+static llvm::cl::opt<unsigned> NumObjects{
+    llvm::cl::Positional,
+    llvm::cl::init(2000000),
+    llvm::cl::desc("(number of objects in the graph)")};
+
+static llvm::cl::opt<unsigned> NumCollections{
+    "collections",
+    llvm::cl::init(10),
+    llvm::cl::desc("Number of full collections to time")};
+
+static llvm::cl::opt<bool> LocalNUMANode{
+    "local-numa-node",
+    llvm::cl::init(false),
+    llvm::cl::desc("Place the huge page heap on the local NUMA node")};
+
+namespace {
+
+/// Link every object to two others picked at random, so that neither the
+/// allocation order nor the traversal order says anything about the
+/// addresses visited next.
+const char *const kGraphCode = R"(
+  var graph = (function(n) {
+    var objs = [];
+    for (var i = 0; i < n; i++) {
+      objs.push({a: null, b: null, i: i});
+    }
+    var seed = 1;
+    function random() {
+      seed = (seed * 16807) % 2147483647;
+      return seed % n;
+    }
+    for (var i = 0; i < n; i++) {
+      objs[i].a = objs[random()];
+      objs[i].b = objs[random()];
+    }
+    return objs;
+  })(NUM_OBJECTS);
+)";
+
+/// Build the graph in a runtime with \p useHugePages, and time the full
+/// collections of its heap.
+/// \return a JSON object with the average time per collection in
+///   milliseconds, and the performance counters if they could be read.
+std::string measure(bool useHugePages) {
+  // Leave room for the graph and for the copy made by compaction.
+  const auto heapSize = static_cast<gcheapsize_t>(std::min<uint64_t>(
+      static_cast<uint64_t>(NumObjects) * 256 + (64 << 20), 3u << 30));
+  auto runtime = Runtime::create(
+      RuntimeConfig::Builder()
+          .withGCConfig(GCConfig::Builder()
+                            .withInitHeapSize(heapSize)
+                            .withMaxHeapSize(heapSize)
+                            .withShouldReleaseUnused(false)
+                            .withUseHugePages(useHugePages)
+                            .withPreferLocalNUMANode(LocalNUMANode)
+                            .build())
+          .build());
+
+  std::string code = kGraphCode;
+  code.replace(
+      code.find("NUM_OBJECTS"),
+      sizeof("NUM_OBJECTS") - 1,
+      std::to_string(NumObjects));
+  hermes::hbc::CompileFlags flags;
+  {
+    GCScope scope(runtime.get());
+    if (runtime->run(code, "gc-tlb-bench", flags) ==
+        ExecutionStatus::EXCEPTION) {
+      llvm::errs() << "Could not build the object graph\n";
+      exit(1);
+    }
+  }
+
+  // One collection to warm up, and to fault in the pages of the old gen.
+  runtime->collect();
+
+  instrumentation::PerfEvents::begin();
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < NumCollections; ++i)
+    runtime->collect();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::string stats;
+  llvm::raw_string_ostream os{stats};
+  os << "{\n\t\t\"totalTime\": "
+     << llvm::format("%.3f", elapsed.count() / NumCollections) << "\n}";
+  os.flush();
+  instrumentation::PerfEvents::endAndInsertStats(stats);
+  return stats;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Print a stack trace if we signal out.
+  llvm::sys::PrintStackTraceOnErrorSignal("Hermes driver");
+  llvm::PrettyStackTraceProgram X(argc, argv);
+  // Call llvm_shutdown() on exit to print stats and free memory.
+  llvm::llvm_shutdown_obj Y;
+  llvm::cl::ParseCommandLineOptions(argc, argv, "Hermes GC TLB bench\n");
+
+  llvm::outs() << "Timing " << NumCollections << " full collections of "
+               << NumObjects << " objects (ms per collection)\n";
+  llvm::outs() << "Regular pages: " << measure(false) << "\n";
+  llvm::outs() << "Huge pages: " << measure(true) << "\n";
+  return 0;
+}
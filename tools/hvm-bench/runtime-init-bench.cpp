@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+//===----------------------------------------------------------------------===//
+/// \file
+/// This benchmark measures the time it takes to construct and destroy a
+/// Runtime, with the builtins created from scratch and with the heap restored
+/// from the process-wide runtime image (RuntimeConfig::UseRuntimeImage).
+///
+/// The image is captured before the timed loop, so the numbers only include
+/// the per-runtime cost.
+//===----------------------------------------------------------------------===//
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeImage.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+
+using namespace hermes::vm;
+
+static llvm::cl::opt<unsigned> NumRuntimes{
+    llvm::cl::Positional,
+    llvm::cl::init(1000),
+    llvm::cl::desc("(number of runtimes to create)")};
+
+static llvm::cl::opt<bool> ES6Symbol{
+    "es6-symbol",
+    llvm::cl::init(true),
+    llvm::cl::desc("Enable support for ES6 Symbol")};
+
+static llvm::cl::opt<bool> LazyBuiltinsOpt{
+    "lazy-builtins",
+    llvm::cl::init(false),
+    llvm::cl::desc("Create some builtins when they are first used")};
+
+namespace {
+
+/// Create and destroy NumRuntimes runtimes with \p useImage.
+/// \return the average time per runtime in microseconds.
+double measure(bool useImage) {
+  auto config = RuntimeConfig::Builder()
+                    .withES6Symbol(ES6Symbol)
+                    .withLazyBuiltins(LazyBuiltinsOpt)
+                    .withUseRuntimeImage(useImage)
+                    .build();
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < NumRuntimes; ++i)
+    Runtime::create(config);
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / NumRuntimes;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Print a stack trace if we signal out.
+  llvm::sys::PrintStackTraceOnErrorSignal("Hermes driver");
+  llvm::PrettyStackTraceProgram X(argc, argv);
+  // Call llvm_shutdown() on exit to print stats and free memory.
+  llvm::llvm_shutdown_obj Y;
+  llvm::cl::ParseCommandLineOptions(argc, argv, "Hermes runtime init bench\n");
+
+  auto captureStart = std::chrono::steady_clock::now();
+  auto image = RuntimeImage::get(ES6Symbol, LazyBuiltinsOpt);
+  std::chrono::duration<double, std::micro> captureTime =
+      std::chrono::steady_clock::now() - captureStart;
+  if (!image) {
+    llvm::errs() << "Could not capture a runtime image\n";
+    return 1;
+  }
+  llvm::outs() << "Image: " << image->getNumCells() << " cells, "
+               << image->getHeapSize() << " bytes, captured in "
+               << llvm::format("%.1f", captureTime.count()) << " us\n";
+
+  // Warm up the allocator and the caches before measuring.
+  measure(false);
+  measure(true);
+
+  double scratch = measure(false);
+  double restored = measure(true);
+  llvm::outs() << "Created " << NumRuntimes << " runtimes\n";
+  llvm::outs() << "  from scratch: " << llvm::format("%.1f", scratch)
+               << " us/runtime\n";
+  llvm::outs() << "  from image:   " << llvm::format("%.1f", restored)
+               << " us/runtime\n";
+  return 0;
+}
@@ -0,0 +1,47 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// A companion to wb-perf.js: every store here initializes an object that was
+// just allocated, so it is in the young generation and needs no write barrier,
+// whether the stored value is young or old.
+function Point(x, y, next) {
+    this.x = x;
+    this.y = y;
+    this.next = next;
+}
+
+function wbPerfYoung(n) {
+    var ogObj = { x: 2 };
+    // Get it to the old gen: allocate enough to cause at least one YG GC.
+    var a;
+    for (var i = 0; i < 1000; i++) {
+        a = new Array(1000);
+    }
+    var last = null;
+    var sum = 0;
+    for (var i = 0; i < n; i++) {
+        for (var j = 0; j < 100000; j++) {
+            // Object literal: 3 stores, 2 with YG values, 1 with an OG value.
+            var lit = { a: last, b: ogObj, c: lit };
+            // Constructor: 3 stores into this, 1 with a YG value.
+            var p = new Point(i, j, lit);
+            // Array: 4 element stores, 2 with YG values, 2 with OG values.
+            var arr = new Array(4);
+            arr[0] = p;
+            arr[1] = ogObj;
+            arr[2] = lit;
+            arr[3] = ogObj;
+            // Property stores into the fresh objects.
+            lit.a = arr;
+            p.x = ogObj;
+            p.y = lit;
+            last = p;
+            sum += arr.length;
+        }
+    }
+    return sum + last.x.x;
+}
+
+print(wbPerfYoung(100));
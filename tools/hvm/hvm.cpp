@@ -119,10 +119,13 @@ int main(int argc, char **argv) {
                   .withName("hvm")
                   .build())
           .withES6Symbol(cl::ES6Symbol)
+          .withUseRuntimeImage(cl::UseRuntimeImage)
+          .withLazyBuiltins(cl::LazyBuiltins)
           .withTrackIO(cl::TrackBytecodeIO)
           .build();
 
   options.stopAfterInit = cl::StopAfterInit;
+  options.functionOrderFile = cl::DumpFunctionOrder;
 #ifdef HERMESVM_PROFILER_EXTERN
   options.patchProfilerSymbols = cl::PatchProfilerSymbols;
   options.profilerSymbolsFile = cl::ProfilerSymbolsFile;
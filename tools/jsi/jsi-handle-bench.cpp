@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+//===----------------------------------------------------------------------===//
+/// \file
+/// This benchmark measures the cost of the JSI handles of a HermesRuntime:
+/// creating and releasing many short-lived jsi::Objects and jsi::Strings,
+/// with and without a large number of long-lived handles which every
+/// collection has to treat as roots.
+//===----------------------------------------------------------------------===//
+#include "hermes/hermes.h"
+
+#include <jsi/instrumentation.h>
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace facebook;
+
+static llvm::cl::opt<unsigned> NumHandles{
+    llvm::cl::Positional,
+    llvm::cl::init(2000000),
+    llvm::cl::desc("(number of short-lived handles to create)")};
+
+static llvm::cl::opt<unsigned> NumRetained{
+    "retained",
+    llvm::cl::init(100000),
+    llvm::cl::desc("Number of long-lived handles held in the second run")};
+
+namespace {
+
+/// \return the number of collections so far in \p rt.
+int numCollections(jsi::Runtime &rt) {
+  return rt.instrumentation()
+      .getHeapInfo(false)
+      .getObject(rt)
+      .getProperty(rt, "hermes_numCollections")
+      .asNumber();
+}
+
+/// Create NumHandles short-lived handles in \p rt, and print the average time
+/// per handle with the description \p name.
+void measure(jsi::Runtime &rt, const char *name) {
+  jsi::Object global = rt.global();
+  jsi::PropNameID prop = jsi::PropNameID::forAscii(rt, "x");
+  const int collectionsBefore = numCollections(rt);
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < NumHandles; ++i) {
+    jsi::Object obj(rt);
+    obj.setProperty(rt, prop, jsi::String::createFromAscii(rt, "value"));
+    jsi::Value value = obj.getProperty(rt, prop);
+    (void)value;
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  llvm::outs() << "  " << name << ": "
+               << llvm::format("%.1f", elapsed.count() / NumHandles)
+               << " ns/iteration, "
+               << numCollections(rt) - collectionsBefore << " collections\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM initLLVM(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "Hermes JSI handle bench\n");
+
+  auto runtime = facebook::hermes::makeHermesRuntime();
+  jsi::Runtime &rt = *runtime;
+  llvm::outs() << "Created " << NumHandles.getValue()
+               << " objects and strings\n";
+
+  // Warm up the handle table and the heap before measuring.
+  measure(rt, "warm-up     ");
+  measure(rt, "no retained ");
+
+  std::vector<jsi::Object> retained{};
+  retained.reserve(NumRetained);
+  for (unsigned i = 0; i < NumRetained; ++i)
+    retained.emplace_back(rt);
+  measure(rt, "retained    ");
+  return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+//===----------------------------------------------------------------------===//
+/// \file
+/// This benchmark runs a bytecode file in a pool of workers, each one a thread
+/// with its own HermesRuntime, and reports the time it took and the peak
+/// memory use of the process.
+///
+/// With -share-bytecode (the default), the bytecode is prepared once and every
+/// runtime evaluates the same jsi::PreparedJavaScript. Otherwise each worker
+/// loads its own copy of the file, like independent runtimes would. Run it
+/// once in each mode to compare them, since the peak RSS covers the whole
+/// process.
+//===----------------------------------------------------------------------===//
+#include "hermes/Support/OSCompat.h"
+#include "hermes/hermes.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace facebook;
+
+static llvm::cl::opt<std::string> InputFilename{
+    llvm::cl::Positional,
+    llvm::cl::Required,
+    llvm::cl::desc("<bytecode file>")};
+
+static llvm::cl::opt<unsigned> NumWorkers{
+    "workers",
+    llvm::cl::init(8),
+    llvm::cl::desc("Number of worker threads, each with its own runtime")};
+
+static llvm::cl::opt<unsigned> NumIterations{
+    "iterations",
+    llvm::cl::init(10),
+    llvm::cl::desc("Number of runtimes each worker creates in turn")};
+
+static llvm::cl::opt<bool> ShareBytecode{
+    "share-bytecode",
+    llvm::cl::init(true),
+    llvm::cl::desc("Evaluate the same prepared bytecode in every runtime")};
+
+namespace {
+
+/// A jsi::Buffer with its own copy of some bytes.
+class CopiedBuffer : public jsi::Buffer {
+ public:
+  explicit CopiedBuffer(llvm::StringRef bytes) : bytes_(bytes.str()) {}
+
+  size_t size() const override {
+    return bytes_.size();
+  }
+
+  const uint8_t *data() const override {
+    return reinterpret_cast<const uint8_t *>(bytes_.data());
+  }
+
+ private:
+  std::string bytes_;
+};
+
+/// Makes the workers wait for each other, so that all their runtimes are
+/// alive at the same time when the peak memory is reached.
+class Barrier {
+ public:
+  explicit Barrier(unsigned count) : remaining_(count) {}
+
+  void arriveAndWait() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (--remaining_ == 0) {
+      cond_.notify_all();
+      return;
+    }
+    cond_.wait(lock, [this]() { return remaining_ == 0; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  unsigned remaining_;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM initLLVM(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "Hermes JSI workers bench\n");
+
+  auto fileBuffer = llvm::MemoryBuffer::getFile(InputFilename);
+  if (!fileBuffer) {
+    llvm::errs() << "Could not read " << InputFilename << "\n";
+    return 1;
+  }
+  llvm::StringRef bytes = (*fileBuffer)->getBuffer();
+  if (!facebook::hermes::HermesRuntime::isHermesBytecode(
+          reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size())) {
+    llvm::errs() << InputFilename
+                 << " is not a bytecode file, compile it with "
+                    "hermes -emit-binary -out\n";
+    return 1;
+  }
+
+  std::shared_ptr<const jsi::PreparedJavaScript> shared{};
+  if (ShareBytecode) {
+    shared = facebook::hermes::makeHermesRuntime()->prepareJavaScript(
+        std::make_shared<CopiedBuffer>(bytes), InputFilename);
+  }
+
+  // The last iteration of every worker waits for the others before
+  // destroying its runtime.
+  Barrier barrier{NumWorkers};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers{};
+  for (unsigned i = 0; i < NumWorkers; ++i) {
+    workers.emplace_back([&shared, &barrier, bytes]() {
+      for (unsigned j = 0; j < NumIterations; ++j) {
+        auto runtime = facebook::hermes::makeHermesRuntime();
+        std::shared_ptr<const jsi::PreparedJavaScript> prepared = shared
+            ? shared
+            : runtime->prepareJavaScript(
+                  std::make_shared<CopiedBuffer>(bytes), InputFilename);
+        runtime->evaluatePreparedJavaScript(prepared);
+        if (j + 1 == NumIterations)
+          barrier.arriveAndWait();
+      }
+    });
+  }
+  for (auto &worker : workers)
+    worker.join();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  const double peakRSS = ::hermes::oscompat::peak_rss() / (1024.0 * 1024.0);
+  llvm::outs() << NumWorkers << " workers x " << NumIterations
+               << " runtimes, " << (ShareBytecode ? "shared" : "private")
+               << " bytecode (" << bytes.size() << " bytes)\n";
+  llvm::outs() << "  time:     " << llvm::format("%.1f", elapsed.count())
+               << " ms\n";
+  llvm::outs() << "  peak RSS: " << llvm::format("%.1f", peakRSS) << " MB\n";
+  return 0;
+}
@@ -7,6 +7,16 @@
 #include <gtest/gtest.h>
 #include <hermes/CompileJS.h>
 #include <hermes/hermes.h>
+#include <jsi/instrumentation.h>
+
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/VM/HeapSnapshot.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <thread>
 
 using namespace facebook::jsi;
 using namespace facebook::hermes;
@@ -112,6 +122,38 @@ TEST_F(HermesRuntimeTest, PreparedJavaScriptBytecodeTest) {
   EXPECT_EQ(rt->global().getProperty(*rt, "q").getNumber(), 2);
 }
 
+TEST(HermesRuntimeSharedBytecodeTest, EvaluateInRuntimesOnManyThreads) {
+  std::string bytecode;
+  ASSERT_TRUE(hermes::compileJS(
+      "function sum(n) { var s = 0; for (var i = 0; i < n; ++i) s += i;"
+      "  return s; }"
+      "var result = sum(1000) + ':' + ['a', 'b'].join('');"
+      "try { undefinedFunction(); } catch (e) { result += e.stack.length > 0; }",
+      bytecode));
+  std::shared_ptr<const PreparedJavaScript> prep =
+      makeHermesRuntime()->prepareJavaScript(
+          std::make_unique<StringBuffer>(bytecode), "shared.js");
+
+  // Each thread has its own runtime, all of them using the same bytecode.
+  constexpr int kNumThreads = 4;
+  std::string results[kNumThreads];
+  std::vector<std::thread> threads{};
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&prep, &results, i]() {
+      for (int j = 0; j < 5; ++j) {
+        auto rt = makeHermesRuntime();
+        rt->evaluatePreparedJavaScript(prep);
+        results[i] = rt->global().getProperty(*rt, "result").getString(*rt).utf8(
+            *rt);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  for (const auto &result : results)
+    EXPECT_EQ("499500:abtrue", result);
+}
+
 TEST_F(HermesRuntimeTest, PreparedJavaScriptInvalidSourceThrows) {
   const char *badSource = "this is definitely not valid javascript";
   bool caught = false;
@@ -194,6 +236,268 @@ TEST_F(HermesRuntimeTest, ReferencesCanEscapeScope) {
   EXPECT_EQ(rootsDelta, 1);
 }
 
+TEST_F(HermesRuntimeTest, ReferencesSurviveCollections) {
+  // Hold objects created before and between collections, while enough
+  // short-lived ones are created to trigger young-gen collections.
+  std::vector<Object> held;
+  for (int i = 0; i < 2000; i++) {
+    Object obj(*rt);
+    obj.setProperty(*rt, "i", i);
+    if (i % 100 == 0) {
+      held.push_back(std::move(obj));
+    }
+    eval("var a = []; for (var j = 0; j < 100; j++) a.push({j: j});");
+  }
+  rt->instrumentation().collectGarbage();
+  for (size_t i = 0; i < held.size(); i++) {
+    EXPECT_EQ(held[i].getProperty(*rt, "i").getNumber(), i * 100);
+  }
+  // Reclaim the property names created above.
+  rt->instrumentation().collectGarbage();
+  auto rootsDelta = HermesTestHelper::calculateRootsListChange(*rt, [&]() {
+    held.clear();
+    rt->instrumentation().collectGarbage();
+  });
+  EXPECT_EQ(rootsDelta, -20);
+}
+
+TEST_F(HermesRuntimeTest, BatchedPropertiesTest) {
+  Object obj = eval("({a: 1, get b() { return 'b'; }, c: {}})").getObject(*rt);
+  PropNameID names[] = {PropNameID::forAscii(*rt, "a"),
+                        PropNameID::forAscii(*rt, "b"),
+                        PropNameID::forAscii(*rt, "c"),
+                        PropNameID::forAscii(*rt, "d")};
+  Value values[4];
+  rt->getProperties(obj, names, values, 4);
+  EXPECT_EQ(values[0].getNumber(), 1);
+  EXPECT_EQ(values[1].getString(*rt).utf8(*rt), "b");
+  EXPECT_TRUE(values[2].isObject());
+  EXPECT_TRUE(values[3].isUndefined());
+
+  Object target(*rt);
+  rt->setProperties(target, names, values, 4);
+  rt->global().setProperty(*rt, "target", target);
+  EXPECT_TRUE(eval("target.a === 1 && target.b === 'b' && "
+                   "typeof target.c === 'object' && 'd' in target")
+                  .getBool());
+
+  eval("Object.freeze(target)");
+  EXPECT_THROW(rt->setProperties(target, names, values, 1), JSError);
+}
+
+TEST_F(HermesRuntimeTest, BulkArrayTest) {
+  Array arr = eval("[1, 2, 'three', 4, , 6]").getObject(*rt).getArray(*rt);
+  Value values[3];
+  rt->getArrayElements(arr, 2, values, 3);
+  EXPECT_EQ(values[0].getString(*rt).utf8(*rt), "three");
+  EXPECT_EQ(values[1].getNumber(), 4);
+  EXPECT_TRUE(values[2].isUndefined());
+
+  double numbers[2];
+  rt->getArrayElements(arr, 0, numbers, 2);
+  EXPECT_EQ(numbers[0], 1);
+  EXPECT_EQ(numbers[1], 2);
+  EXPECT_THROW(rt->getArrayElements(arr, 1, numbers, 2), JSError);
+  EXPECT_THROW(rt->getArrayElements(arr, 5, values, 2), JSError);
+
+  const double doubles[] = {0.5, -1, 1e100};
+  rt->setArrayElements(arr, 3, doubles, 3);
+  rt->setArrayElements(arr, 0, values, 1);
+  rt->global().setProperty(*rt, "arr", arr);
+  EXPECT_TRUE(
+      eval("arr.length === 6 && arr.join() === 'three,2,three,0.5,-1,1e+100'")
+          .getBool());
+  EXPECT_THROW(rt->setArrayElements(arr, 4, doubles, 3), JSError);
+  rt->setArrayElements(arr, 6, doubles, 0);
+}
+
+TEST_F(HermesRuntimeTest, CollectGarbageWhileIdleTest) {
+  using std::chrono::steady_clock;
+  // Nothing can be done by a deadline which has already passed.
+  eval("var garbage = []; for (var i = 0; i < 1000; i++) garbage.push({i});");
+  EXPECT_EQ(rt->collectGarbageWhileIdle(steady_clock::now()), 0);
+}
+
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+TEST(HermesRuntimeIdleGCTest, CollectOldGenWhileIdleTest) {
+  using std::chrono::steady_clock;
+  // A fixed size heap, so that the old gen doesn't grow to make room.
+  auto rt = makeHermesRuntime(
+      ::hermes::vm::RuntimeConfig::Builder()
+          .withGCConfig(::hermes::vm::GCConfig::Builder()
+                            .withInitHeapSize(16 << 20)
+                            .withMaxHeapSize(16 << 20)
+                            .build())
+          .build());
+  const auto heapInfo = [&rt](const char *name) {
+    return rt->instrumentation()
+        .getHeapInfo(false)
+        .getObject(*rt)
+        .getProperty(*rt, name)
+        .getNumber();
+  };
+  const auto deadline = [] {
+    return steady_clock::now() + std::chrono::seconds(10);
+  };
+  // Time a full collection, so that one is known to fit in the deadline.
+  rt->instrumentation().collectGarbage();
+  const double fullBefore = heapInfo("hermes_full_numCollections");
+
+  // Each round allocates a chunk that is much smaller than the young gen,
+  // promotes it with an idle young-gen collection while it is still alive,
+  // and then drops it, so that the dead chunks pile up in the old gen.  Once
+  // the old gen can't take another young gen, the idle call must collect it.
+  Function eval = rt->global().getPropertyAsFunction(*rt, "eval");
+  eval.call(*rt, "var chunk;");
+  double usedBefore = 0;
+  size_t freed = 0;
+  for (int round = 0; round < 100; ++round) {
+    eval.call(
+        *rt, "chunk = []; for (var i = 0; i < 5000; i++) chunk.push({i});");
+    const double ygBefore = heapInfo("hermes_yg_numCollections");
+    usedBefore = heapInfo("hermes_allocatedBytes");
+    freed = rt->collectGarbageWhileIdle(deadline());
+    ASSERT_GT(heapInfo("hermes_yg_numCollections"), ygBefore);
+    if (heapInfo("hermes_full_numCollections") > fullBefore) {
+      break;
+    }
+    eval.call(*rt, "chunk = undefined;");
+  }
+  EXPECT_EQ(heapInfo("hermes_full_numCollections"), fullBefore + 1);
+  // The dead chunks were reclaimed from the old gen: at least half the heap
+  // had to be in use for the full collection to be needed.
+  EXPECT_GT(freed, 0u);
+  EXPECT_LT(heapInfo("hermes_allocatedBytes"), usedBefore / 2);
+}
+#endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
+
+TEST_F(HermesRuntimeTest, HandleMemoryPressureTest) {
+  using ::hermes::vm::MemoryPressureLevel;
+  eval(
+      "var garbage = []; for (var i = 0; i < 1000; i++) garbage.push({i});"
+      "function Point(x, y) { this.x = x; this.y = y; }"
+      "var p = new Point(1, 2);");
+  eval("garbage = undefined");
+  EXPECT_GT(rt->handleMemoryPressure(MemoryPressureLevel::Moderate), 0);
+
+  eval("garbage = []; for (var i = 0; i < 1000; i++) garbage.push({i});");
+  eval("garbage = undefined");
+  EXPECT_GT(rt->handleMemoryPressure(MemoryPressureLevel::Critical), 0);
+
+  // The dropped property maps are recreated when properties are looked up.
+  EXPECT_EQ(eval("p.x + p.y").getNumber(), 3);
+  EXPECT_EQ(eval("new Point(3, 4).y").getNumber(), 4);
+  EXPECT_EQ(eval("var q = new Point(5, 6); q.z = 7; q.z").getNumber(), 7);
+  EXPECT_EQ(
+      eval("var keys = []; for (var k in p) keys.push(k); keys.join()")
+          .getString(*rt)
+          .utf8(*rt),
+      "x,y");
+}
+
+TEST_F(HermesRuntimeTest, AllocationSamplingTest) {
+  // Dumping requires sampling to be started.
+  std::string profile;
+  llvm::raw_string_ostream os(profile);
+  EXPECT_THROW(rt->dumpAllocationProfile(os), JSINativeException);
+
+  rt->startAllocationSampling(1024);
+  eval(
+      "function allocateObjects() {"
+      "  var a = [];"
+      "  for (var i = 0; i < 10000; i++) a.push({i});"
+      "  return a.length;"
+      "}"
+      "allocateObjects();"
+      "allocateObjects.bind(null)();");
+  rt->dumpAllocationProfile(os);
+  os.flush();
+  EXPECT_EQ(
+      profile.find(R"#({"head":{"callFrame":{"functionName":"(root)")#"), 0);
+  EXPECT_NE(
+      profile.find(R"("functionName":"allocateObjects")"), std::string::npos);
+  EXPECT_NE(
+      profile.find(R"("functionName":"(bound function)")"), std::string::npos);
+  EXPECT_NE(profile.find(R"("samples":[{"size":)"), std::string::npos);
+
+  rt->stopAllocationSampling();
+  EXPECT_THROW(rt->dumpAllocationProfile(os), JSINativeException);
+}
+
+TEST_F(HermesRuntimeTest, BinaryHeapSnapshotTest) {
+  eval("var retained = {name: 'retainedObject', list: [1, 2, 3]};");
+  llvm::SmallString<64> fileName;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile(
+      "snapshot", "hbhs", fileName));
+  ASSERT_TRUE(rt->createBinaryHeapSnapshotToFile(fileName.str()));
+
+  auto input = llvm::MemoryBuffer::getFile(fileName);
+  llvm::sys::fs::remove(fileName);
+  ASSERT_TRUE(static_cast<bool>(input));
+  llvm::StringRef bytes = input.get()->getBuffer();
+  EXPECT_TRUE(bytes.startswith("HBHS"));
+
+  std::string snapshot;
+  std::string error;
+  llvm::raw_string_ostream os(snapshot);
+  ::hermes::JSONEmitter json(os);
+  EXPECT_TRUE(::hermes::vm::convertBinaryHeapSnapshot(bytes, json, error))
+      << error;
+  os.flush();
+  EXPECT_NE(snapshot.find(R"("nodes":[)"), std::string::npos);
+  EXPECT_NE(snapshot.find(R"("(GC Roots)")"), std::string::npos);
+  EXPECT_NE(snapshot.find(R"("retainedObject")"), std::string::npos);
+
+  // A truncated snapshot is rejected rather than half converted.
+  std::string truncated;
+  llvm::raw_string_ostream truncatedOS(truncated);
+  ::hermes::JSONEmitter truncatedJSON(truncatedOS);
+  EXPECT_FALSE(::hermes::vm::convertBinaryHeapSnapshot(
+      bytes.drop_back(1), truncatedJSON, error));
+}
+
+TEST_F(HermesRuntimeTest, ExternalArrayBufferTest) {
+  uint8_t data[16] = {1, 2, 3};
+  int released = 0;
+  {
+    ArrayBuffer buffer =
+        rt->createExternalArrayBuffer(data, sizeof(data), [&released]() {
+          ++released;
+        });
+    EXPECT_EQ(buffer.size(*rt), sizeof(data));
+    EXPECT_EQ(buffer.data(*rt), data);
+    rt->global().setProperty(*rt, "buffer", buffer);
+    // Writes from JS are visible in the native memory, and vice versa.
+    data[3] = 4;
+    eval("var view = new Uint8Array(buffer); view[15] = view[0] + view[3];");
+    EXPECT_EQ(data[15], 5);
+
+    rt->detachArrayBuffer(buffer);
+    EXPECT_EQ(released, 1);
+    EXPECT_EQ(buffer.size(*rt), 0);
+    EXPECT_EQ(eval("buffer.byteLength").getNumber(), 0);
+    // The view no longer reads from the native memory.
+    EXPECT_EQ(eval("view[0]").getNumber(), 0);
+  }
+  eval("buffer = view = undefined");
+  rt->instrumentation().collectGarbage();
+  EXPECT_EQ(released, 1);
+
+  // An external buffer is released when it is collected, or at the latest by
+  // the destruction of the runtime.
+  rt->createExternalArrayBuffer(data, sizeof(data), [&released]() {
+    ++released;
+  });
+  rt->instrumentation().collectGarbage();
+  EXPECT_EQ(released, 2);
+  rt->global().setProperty(
+      *rt,
+      "buffer",
+      rt->createExternalArrayBuffer(data, 0, [&released]() { ++released; }));
+  rt.reset();
+  EXPECT_EQ(released, 3);
+}
+
 TEST_F(HermesRuntimeTest, HostObjectWithOwnProperties) {
   class HostObjectWithPropertyNames : public HostObject {
     std::vector<PropNameID> getPropertyNames(Runtime &rt) override {
@@ -428,6 +428,37 @@ TEST(HBCBytecodeGen, BytecodeFields) {
   ASSERT_TRUE(fields.regExpStorage.empty());
 }
 
+TEST(HBCBytecodeGen, CompactFramesAreNotLarger) {
+  const char *source =
+      "function f(a, b, n) {\n"
+      "  var x = a * 2, sum = 0;\n"
+      "  if (b) sum = x + 1;\n"
+      "  else for (var i = 0; i < n; ++i) sum += i * b + a;\n"
+      "  var z = sum * 3;\n"
+      "  for (var j = 0; j < n; ++j) z = z + j;\n"
+      "  return z + x;\n"
+      "}\n"
+      "print(f(1, 0, 4));\n";
+  TestCompileFlags flags;
+  auto classic = bytecodeForSource(source, flags);
+  flags.compactFrames = true;
+  auto compact = bytecodeForSource(source, flags);
+
+  std::string error;
+  ConstBytecodeFileFields classicFields;
+  ConstBytecodeFileFields compactFields;
+  ASSERT_TRUE(classicFields.populateFromBuffer(classic, &error)) << error;
+  ASSERT_TRUE(compactFields.populateFromBuffer(compact, &error)) << error;
+  ASSERT_EQ(
+      classicFields.functionHeaders.size(),
+      compactFields.functionHeaders.size());
+  for (size_t i = 0; i < classicFields.functionHeaders.size(); ++i) {
+    EXPECT_LE(
+        compactFields.functionHeaders[i].frameSize,
+        classicFields.functionHeaders[i].frameSize);
+  }
+}
+
 TEST(HBCBytecodeGen, BytecodeFieldsFail) {
   std::string error;
   std::vector<uint8_t> bytecode = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
@@ -49,6 +49,7 @@ std::vector<uint8_t> hermes::bytecodeForSource(
   /* Generate bytecode module */
   auto bytecodeGenOpts = BytecodeGenerationOptions::defaults();
   bytecodeGenOpts.staticBuiltinsEnabled = flags.staticBuiltins;
+  bytecodeGenOpts.compactFrames = flags.compactFrames;
   auto BM =
       generateBytecodeModule(&M, M.getTopLevelFunction(), bytecodeGenOpts);
   assert(BM != nullptr && "Failed to generate bytecode module");
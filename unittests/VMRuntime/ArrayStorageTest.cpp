@@ -116,6 +116,51 @@ TEST_F(ArrayStorageBigHeapTest, AllocMaxSizeArray) {
   EXPECT_EQ(res, ExecutionStatus::RETURNED)
       << "Allocating a max size array failed";
 }
+
+TEST_F(ArrayStorageBigHeapTest, YoungPointersInLargeCell) {
+  // Enough elements that the storage doesn't fit in a segment, and is
+  // allocated in the large object space.
+  const ArrayStorage::size_type size =
+      LargeObjectSpace::kMinCellSize / sizeof(GCHermesValue);
+  ASSERT_LE(size, ArrayStorage::maxElements());
+  ASSERT_GE(ArrayStorage::allocationSize(size), LargeObjectSpace::kMinCellSize);
+  auto res = ArrayStorage::create(runtime, size, size);
+  ASSERT_EQ(res, ExecutionStatus::RETURNED);
+  auto st = runtime->makeHandle<ArrayStorage>(*res);
+  auto &gc = runtime->getHeap();
+  EXPECT_FALSE(gc.inYoungGen(st.get()));
+
+  // Pointers to young cells are only found by scanning the dirty cards of the
+  // large cell. Each young cell holds the index it was stored at.
+  const ArrayStorage::size_type stride = 4099;
+  const auto check = [&]() {
+    for (ArrayStorage::size_type i = 0; i < size; i += stride) {
+      auto *elem = vmcast<ArrayStorage>(st->at(i));
+      ASSERT_EQ(HermesValue::encodeDoubleValue(i), elem->at(0));
+    }
+  };
+  for (int round = 0; round < 3; ++round) {
+    GCScopeMarkerRAII marker{gcScope};
+    for (ArrayStorage::size_type i = 0; i < size; i += stride) {
+      marker.flush();
+      auto elemRes = ArrayStorage::create(runtime, 1, 1);
+      ASSERT_EQ(elemRes, ExecutionStatus::RETURNED);
+      vmcast<ArrayStorage>(*elemRes)->at(0).setNonPtr(
+          HermesValue::encodeDoubleValue(i));
+      st->at(i).set(*elemRes, &gc);
+    }
+    // Make garbage until a young-gen collection has moved the young cells.
+    const auto numYoungGCs = gc.numYoungGCs();
+    while (gc.numYoungGCs() == numYoungGCs) {
+      marker.flush();
+      ASSERT_EQ(
+          ArrayStorage::create(runtime, 64), ExecutionStatus::RETURNED);
+    }
+    check();
+  }
+  gc.collect();
+  check();
+}
 #endif
 
 TEST_F(ArrayStorageBigHeapTest, AllocLargeArrayThrowsRangeError) {
@@ -91,6 +91,18 @@ TEST_F(MarkBitArrayNCTest, MarkGet) {
   }
 }
 
+TEST_F(MarkBitArrayNCTest, Unmark) {
+  for (char *addr : addrs) {
+    mba->mark(mba->addressToIndex(addr));
+  }
+
+  size_t ind = mba->addressToIndex(addrs.at(2));
+  mba->unmark(ind);
+  EXPECT_FALSE(mba->at(ind));
+  EXPECT_TRUE(mba->at(mba->addressToIndex(addrs.at(1))));
+  EXPECT_TRUE(mba->at(mba->addressToIndex(addrs.at(3))));
+}
+
 TEST_F(MarkBitArrayNCTest, Initial) {
   for (char *addr : addrs) {
     size_t ind = mba->addressToIndex(addr);
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/RuntimeImage.h"
+
+#include "TestHelpers.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+using namespace hermes::hbc;
+
+namespace {
+
+const RuntimeConfig kImageRTConfig =
+    RuntimeConfig::Builder(kTestRTConfig).withUseRuntimeImage(true).build();
+
+/// \return whether \p code runs in \p runtime without throwing.
+bool runs(Runtime *runtime, llvm::StringRef code) {
+  CompileFlags flags;
+  flags.staticBuiltins = true;
+  return runtime->run(code, "source/url", flags) == ExecutionStatus::RETURNED;
+}
+
+const char *const kBuiltinsCode = R"(
+  function assert(condition) {
+    if (!condition) {
+      throw Error();
+    }
+  }
+  assert(Object.getPrototypeOf([]) === Array.prototype);
+  assert([3, 1, 2].sort().join() === '1,2,3');
+  assert(Math.abs(-1) === 1);
+  assert(String.fromCharCode(65, 66) === 'AB');
+  assert('a'.toUpperCase() === 'A');
+  assert(JSON.stringify({a: [1]}) === '{"a":[1]}');
+  assert(/a(b)/.exec('ab')[1] === 'b');
+  assert(new Map([[1, 2]]).get(1) === 2);
+  assert(Symbol.for('k') === Symbol.for('k'));
+  assert(Symbol.keyFor(Symbol.for('k')) === 'k');
+  assert(Object.prototype.toString.call(Error.prototype) === '[object Error]');
+  assert(new TypeError('m') instanceof Error);
+  var o = {};
+  o.prototype = 1;
+  assert(Object.keys(o).join() === 'prototype');
+)";
+
+TEST(RuntimeImageTest, Capture) {
+  for (bool hasES6Symbol : {false, true}) {
+    auto image = RuntimeImage::get(hasES6Symbol, false);
+    ASSERT_TRUE(image);
+    EXPECT_GT(image->getNumCells(), 0u);
+    EXPECT_EQ(image, RuntimeImage::get(hasES6Symbol, false));
+  }
+}
+
+TEST(RuntimeImageTest, Builtins) {
+  auto rt = Runtime::create(kImageRTConfig);
+  EXPECT_TRUE(runs(rt.get(), kBuiltinsCode));
+  rt->collect();
+  EXPECT_TRUE(runs(rt.get(), kBuiltinsCode));
+}
+
+TEST(RuntimeImageTest, NoES6Symbol) {
+  auto rt = Runtime::create(
+      RuntimeConfig::Builder(kImageRTConfig).withES6Symbol(false).build());
+  EXPECT_TRUE(runs(rt.get(), "if (typeof Symbol !== 'undefined') throw 0;"));
+}
+
+TEST(RuntimeImageTest, Independent) {
+  auto rt1 = Runtime::create(kImageRTConfig);
+  auto rt2 = Runtime::create(kImageRTConfig);
+  EXPECT_TRUE(runs(rt1.get(), "Array.prototype.extra = 1; Math.extra = 2;"));
+  EXPECT_TRUE(runs(
+      rt2.get(),
+      "if ([].extra !== undefined || Math.extra === 2) throw new Error();"));
+  rt1.reset();
+  rt2->collect();
+  EXPECT_TRUE(runs(rt2.get(), kBuiltinsCode));
+}
+
+} // anonymous namespace
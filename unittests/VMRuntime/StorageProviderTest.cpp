@@ -15,6 +15,8 @@
 
 #include "llvm/ADT/STLExtras.h"
 
+#include <vector>
+
 using namespace hermes;
 using namespace hermes::vm;
 
@@ -62,6 +64,36 @@ TEST(StorageProviderTest, LogSuccessStorageProviderSuccess) {
   EXPECT_EQ(0, provider.numLive());
 }
 
+TEST(StorageProviderTest, HugePageProvider) {
+  for (bool preferLocalNUMANode : {false, true}) {
+    auto provider = StorageProvider::hugePageProvider(preferLocalNUMANode);
+    // Take more storages than fit in one region.
+    std::vector<void *> storages;
+    for (int i = 0; i < 20; ++i) {
+      auto result = provider->newStorage("Test");
+      ASSERT_TRUE(result);
+      void *storage = result.get();
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(storage) % AlignedStorage::size());
+      EXPECT_EQ(storages.end(), llvm::find(storages, storage));
+      // The storage is writable all the way through.
+      static_cast<char *>(storage)[0] = 1;
+      static_cast<char *>(storage)[AlignedStorage::size() - 1] = 1;
+      storages.push_back(storage);
+    }
+    // A deleted storage is re-used before a new region is reserved.
+    void *deleted = storages.back();
+    storages.pop_back();
+    provider->deleteStorage(deleted);
+    auto result = provider->newStorage("Test");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(deleted, result.get());
+    storages.push_back(result.get());
+    for (void *storage : storages) {
+      provider->deleteStorage(storage);
+    }
+  }
+}
+
 TEST(StorageProviderTest, LogSuccessStorageProviderFail) {
   LogSuccessStorageProvider provider{NullStorageProvider::create()};
 